@@ -0,0 +1,183 @@
+#include <srl.hpp>
+#include <srl_collision.hpp>
+#include <srl_timer.hpp>
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+// Using to shorten names for input
+using namespace SRL::Input;
+
+/** @brief Number of moving bodies
+ */
+static constexpr size_t BodyCount = 500;
+
+/** @brief Body velocities
+ */
+static Vector3D Velocities[BodyCount];
+
+/** @brief Whether body touches anything
+ */
+static bool Touching[BodyCount];
+
+/** @brief Count touching pairs by testing every pair
+ * @param world Collision world holding the bodies
+ * @return Number of touching pairs
+ */
+static size_t BruteForce(SRL::CollisionWorld& world)
+{
+    size_t found = 0;
+
+    for (size_t first = 0; first < BodyCount; first++)
+    {
+        const SRL::CollisionWorld::Body& a = *world.Get(first);
+
+        for (size_t second = first + 1; second < BodyCount; second++)
+        {
+            const SRL::CollisionWorld::Body& b = *world.Get(second);
+
+            if ((a.Layer & b.Mask) != 0 && (b.Layer & a.Mask) != 0 && SRL::CollisionWorld::Test(a, b))
+            {
+                found++;
+            }
+        }
+    }
+
+    return found;
+}
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(20, 10, 50));
+    SRL::Debug::Print(1, 1, "Collision world benchmark");
+    SRL::Debug::Print(1, 3, "A: toggle slave CPU");
+    SRL::Debug::Print(1, 4, "B: toggle brute force");
+
+    SRL::CollisionWorld world(BodyCount, BodyCount * 2);
+    SRL::Math::Random rnd = SRL::Math::Random(11);
+
+    // Mix of all shapes, every fourth body is on a layer that ignores its own kind
+    for (size_t body = 0; body < BodyCount; body++)
+    {
+        const Vector3D position(
+            Fxp::BuildRaw(rnd.GetNumber(-150, 150) << 16),
+            Fxp::BuildRaw(rnd.GetNumber(-100, 100) << 16),
+            0.0);
+        const uint16_t layer = (body & 3) == 0 ? 2 : 1;
+        const uint16_t mask = (body & 3) == 0 ? 1 : 3;
+
+        switch (body % 3)
+        {
+        case 0:
+            world.Add(SRL::CollisionWorld::Body::Box(position, Vector3D(3.0, 2.0, 0.0), layer, mask));
+            break;
+
+        case 1:
+            world.Add(SRL::CollisionWorld::Body::Sphere(position, 2.5, layer, mask));
+            break;
+
+        default:
+            world.Add(SRL::CollisionWorld::Body::Capsule(position, Vector3D(0.0, 3.0, 0.0), 1.5, layer, mask));
+            break;
+        }
+
+        Velocities[body] = Vector3D(
+            Fxp::BuildRaw(rnd.GetNumber(-0x18000, 0x18000)),
+            Fxp::BuildRaw(rnd.GetNumber(-0x18000, 0x18000)),
+            0.0);
+    }
+
+    Digital port0(0);
+    SRL::Timer::Stopwatch stopwatch;
+    bool useSlave = true;
+    bool bruteForce = false;
+    size_t entered = 0;
+
+    // Main program loop
+    while (1)
+    {
+        if (port0.WasPressed(Digital::Button::A))
+        {
+            useSlave = !useSlave;
+        }
+
+        if (port0.WasPressed(Digital::Button::B))
+        {
+            bruteForce = !bruteForce;
+        }
+
+        // Bounce bodies inside of the screen
+        for (size_t body = 0; body < BodyCount; body++)
+        {
+            Vector3D& position = world.Get(body)->Position;
+            position += Velocities[body];
+
+            if (position.X > Fxp(150.0) || position.X < Fxp(-150.0))
+            {
+                Velocities[body].X = -Velocities[body].X;
+            }
+
+            if (position.Y > Fxp(100.0) || position.Y < Fxp(-100.0))
+            {
+                Velocities[body].Y = -Velocities[body].Y;
+            }
+
+            Touching[body] = false;
+        }
+
+        stopwatch.Start();
+        size_t pairs = 0;
+
+        if (bruteForce)
+        {
+            pairs = BruteForce(world);
+        }
+        else
+        {
+            world.Update(useSlave ? 128 : 0);
+            pairs = world.GetStatistics().Contacts;
+        }
+
+        const uint32_t updateTime = stopwatch.GetMicroseconds();
+
+        if (!bruteForce)
+        {
+            for (size_t index = 0; index < world.GetContactCount(); index++)
+            {
+                const SRL::CollisionWorld::Contact& contact = world.GetContacts()[index];
+
+                if (contact.State == SRL::CollisionWorld::ContactState::Enter)
+                {
+                    entered++;
+                }
+
+                if (contact.State != SRL::CollisionWorld::ContactState::Exit)
+                {
+                    Touching[contact.A] = true;
+                    Touching[contact.B] = true;
+                }
+            }
+        }
+
+        // Draw bodies as dots, touching ones in red
+        for (size_t body = 0; body < BodyCount; body++)
+        {
+            const Vector3D& position = world.Get(body)->Position;
+            const Vector2D point(position.X, position.Y);
+            SRL::Scene2D::DrawLine(point, point, Touching[body] ? HighColor::Colors::Red : HighColor::Colors::White, Fxp(500.0));
+        }
+
+        SRL::Debug::Print(1, 6, "Bodies     : %d   ", world.GetBodyCount());
+        SRL::Debug::Print(1, 7, "Mode       : %s   ", bruteForce ? "brute force " : (useSlave ? "master+slave" : "master only "));
+        SRL::Debug::Print(1, 8, "Update     : %d us   ", updateTime);
+        SRL::Debug::Print(1, 9, "Candidates : %d   ", bruteForce ? (BodyCount * (BodyCount - 1)) / 2 : world.GetStatistics().Candidates);
+        SRL::Debug::Print(1, 10, "Contacts   : %d   ", pairs);
+        SRL::Debug::Print(1, 11, "Entered    : %d   ", entered);
+
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <srl.hpp>
+#include <srl_entity.hpp>
+#include <srl_timer.hpp>
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+// Using to shorten names for input
+using namespace SRL::Input;
+
+/** @brief Number of entities to update each frame
+ */
+static constexpr size_t EntityCount = 2000;
+
+/** @brief Number of entities drawn on screen
+ */
+static constexpr size_t DrawnCount = 300;
+
+/** @brief Entity position
+ */
+struct Position
+{
+    Vector2D Value;
+};
+
+/** @brief Entity velocity
+ */
+struct Velocity
+{
+    Vector2D Value;
+};
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(20, 10, 50));
+    SRL::Debug::Print(1, 1, "Entity store benchmark");
+    SRL::Debug::Print(1, 3, "Press A to toggle slave CPU");
+
+    SRL::EntityStore<Position, Velocity> entities(EntityCount);
+    SRL::Math::Random rnd = SRL::Math::Random(7);
+
+    for (size_t entity = 0; entity < EntityCount; entity++)
+    {
+        auto handle = entities.Create();
+        entities.Get<Position>(handle)->Value = Vector2D(
+            Fxp::BuildRaw(rnd.GetNumber(-150, 150) << 16),
+            Fxp::BuildRaw(rnd.GetNumber(-100, 100) << 16));
+        entities.Get<Velocity>(handle)->Value = Vector2D(
+            Fxp::BuildRaw(rnd.GetNumber(-0x20000, 0x20000)),
+            Fxp::BuildRaw(rnd.GetNumber(-0x20000, 0x20000)));
+    }
+
+    // Bounce entities inside of the screen
+    auto update = [](Position& position, Velocity& velocity)
+    {
+        position.Value += velocity.Value;
+
+        if (position.Value.X > Fxp(150.0) || position.Value.X < Fxp(-150.0))
+        {
+            velocity.Value.X = -velocity.Value.X;
+        }
+
+        if (position.Value.Y > Fxp(100.0) || position.Value.Y < Fxp(-100.0))
+        {
+            velocity.Value.Y = -velocity.Value.Y;
+        }
+    };
+
+    Digital port0(0);
+    SRL::Timer::Stopwatch stopwatch;
+    bool useSlave = true;
+
+    // Main program loop
+    while (1)
+    {
+        if (port0.WasPressed(Digital::Button::A))
+        {
+            useSlave = !useSlave;
+        }
+
+        stopwatch.Start();
+
+        if (useSlave)
+        {
+            entities.ForEachParallel<Position, Velocity>(update);
+        }
+        else
+        {
+            entities.ForEach<Position, Velocity>(update);
+        }
+
+        const uint32_t updateTime = stopwatch.GetMicroseconds();
+
+        // Draw first few entities as dots
+        entities.ForEach<Position>(0, DrawnCount, [](Position& position)
+        {
+            SRL::Scene2D::DrawLine(position.Value, position.Value, HighColor::Colors::White, Fxp(500.0));
+        });
+
+        SRL::Debug::Print(1, 5, "Entities : %d   ", entities.GetCount());
+        SRL::Debug::Print(1, 6, "Mode     : %s   ", useSlave ? "master+slave" : "master only ");
+        SRL::Debug::Print(1, 7, "Update   : %d us   ", updateTime);
+
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
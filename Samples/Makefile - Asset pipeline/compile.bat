@@ -0,0 +1,3 @@
+:; "../../tools/scripts/make.sh" $1; exit;
+@ECHO Off
+"../../tools/scripts/make.bat" %1
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include <srl.hpp>
+
+/** @brief Load text file into buffer and print it
+ * @param line Line to print text on
+ * @param name File name
+ */
+void PrintFile(const uint8_t line, const char* name)
+{
+    char content[256] = { '\0' };
+    SRL::Cd::File file(name);
+
+    if (file.Exists())
+    {
+        file.LoadBytes(0, 255, content);
+        SRL::Debug::Print(2, line, "%s: %s", name, content);
+    }
+    else
+    {
+        SRL::Debug::Print(2, line, "%s: not found", name);
+    }
+}
+
+int main()
+{
+    SRL::Core::Initialize(SRL::Types::HighColor::Colors::Black);
+    SRL::Debug::Print(1, 1, "Asset pipeline");
+
+    // File without rule, copied as is
+    PrintFile(3, "README.TXT");
+
+    // Converted by extension rule (.txt -> .DAT)
+    SRL::Cd::ChangeDir("TEXT");
+    PrintFile(4, "HELLO.DAT");
+
+    // Converted by directory rule (UPPER/ -> .UPR)
+    SRL::Cd::ChangeDir("..");
+    SRL::Cd::ChangeDir("UPPER");
+    PrintFile(5, "SHOUT.UPR");
+
+    // Main program loop
+    while (1)
+    {
+        // Refresh screen
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
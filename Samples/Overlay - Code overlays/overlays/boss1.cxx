@@ -0,0 +1,18 @@
+#include "overlays.hpp"
+
+/** @brief Boss health, data of the overlay is reset every time the overlay is loaded
+ */
+static int32_t health = 1000;
+
+int32_t Boss1Update(uint32_t frame)
+{
+    if (health > 0 && (frame % 4) == 0)
+    {
+        health--;
+    }
+
+    SRL::Debug::Print(3, 10, "BOSS 1");
+    SRL::Debug::Print(3, 11, "Health: %d    ", health);
+    SRL::Debug::Print(3, 12, "          ");
+    return health;
+}
@@ -0,0 +1,19 @@
+#include "overlays.hpp"
+
+/** @brief Menu entries, stored in overlay together with the code
+ */
+static const char* menuEntries[] = {
+    "Start game",
+    "Options",
+    "Credits"
+};
+
+void MenuUpdate(uint32_t frame)
+{
+    const uint32_t selected = (frame / 60) % 3;
+
+    for (uint32_t entry = 0; entry < 3; entry++)
+    {
+        SRL::Debug::Print(3, 10 + entry, "%c %s", entry == selected ? '>' : ' ', menuEntries[entry]);
+    }
+}
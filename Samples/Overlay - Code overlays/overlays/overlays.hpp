@@ -0,0 +1,14 @@
+#pragma once
+
+#include <srl.hpp>
+
+/** @brief Update of the menu screen, lives in MENU overlay
+ * @param frame Frame counter
+ */
+void MenuUpdate(uint32_t frame);
+
+/** @brief Update of the boss fight, lives in BOSS1 overlay
+ * @param frame Frame counter
+ * @return Remaining boss health
+ */
+int32_t Boss1Update(uint32_t frame);
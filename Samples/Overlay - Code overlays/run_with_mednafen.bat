@@ -0,0 +1,3 @@
+:; "../../tools/scripts/run.sh" mednafen; exit;
+@ECHO Off
+"../../tools/scripts/run.bat" mednafen
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include <srl.hpp>
+#include <srl_overlay.hpp>
+
+#include "../overlays/overlays.hpp"
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+
+// Using to shorten names for input
+using namespace SRL::Input;
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(20, 10, 50));
+    SRL::Debug::Print(1, 1, "Code overlays");
+    SRL::Debug::Print(1, 3, "Press A to load MENU");
+    SRL::Debug::Print(1, 4, "Press B to load BOSS1");
+    SRL::Debug::Print(1, 6, "Overlay region: 0x%x (%d bytes)", (uint32_t)SRL::Overlay::GetRegionStart(), SRL::Overlay::GetRegionSize());
+
+    Digital port0(0);
+    SRL::Overlay::Load("MENU");
+    uint32_t frame = 0;
+
+    // Main program loop
+    while (1)
+    {
+        if (port0.WasPressed(Digital::Button::A))
+        {
+            SRL::Overlay::Load("MENU");
+        }
+        else if (port0.WasPressed(Digital::Button::B))
+        {
+            SRL::Overlay::Load("BOSS1");
+        }
+
+        SRL::Debug::Print(1, 7, "Loaded: %s (%d bytes)    ", SRL::Overlay::GetLoaded(), SRL::Overlay::GetLoadedSize());
+
+        // Calls are checked against the loaded overlay in DEBUG builds
+        if (SRL::Overlay::IsLoaded("MENU"))
+        {
+            SRL::Overlay::Call("MENU", MenuUpdate, frame);
+        }
+        else if (SRL::Overlay::IsLoaded("BOSS1"))
+        {
+            SRL::Overlay::Call("BOSS1", Boss1Update, frame);
+        }
+
+        frame++;
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <srl.hpp>
+#include <srl_particles.hpp>
+#include <srl_timer.hpp>
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+// Using to shorten names for input
+using namespace SRL::Input;
+
+/** @brief Maximal number of live particles
+ */
+static constexpr size_t MaxParticles = 3000;
+
+/** @brief Size of the particle texture
+ */
+static constexpr uint16_t SparkSize = 4;
+
+/** @brief Particle texture
+ */
+static HighColor spark[SparkSize * SparkSize];
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(20, 10, 50));
+    SRL::Debug::Print(1, 1, "Particle fountain");
+    SRL::Debug::Print(1, 3, "Press A to toggle slave CPU");
+
+    // Small round spark, corners are transparent
+    for (uint16_t y = 0; y < SparkSize; y++)
+    {
+        for (uint16_t x = 0; x < SparkSize; x++)
+        {
+            const bool corner = (x == 0 || x == SparkSize - 1) && (y == 0 || y == SparkSize - 1);
+            spark[(y * SparkSize) + x] = corner ? HighColor(0x0000) : HighColor(255, 200, 64);
+        }
+    }
+
+    const int32_t texture = SRL::VDP1::TryLoadTexture(SparkSize, SparkSize, SRL::CRAM::TextureColorMode::RGB555, 0, spark);
+
+    SRL::ParticleSystem particles(MaxParticles, SRL::ParticleSystem::Mode::Screen);
+    particles.SetTexture(texture);
+    particles.SetGravity(Vector3D(0.0, 0.05, 0.0));
+
+    SRL::ParticleSystem::Emitter fountain;
+    fountain.Position = Vector3D(0.0, 80.0, 0.0);
+    fountain.PositionSpread = Vector3D(4.0, 0.0, 0.0);
+    fountain.Velocity = Vector3D(0.0, -3.0, 0.0);
+    fountain.VelocitySpread = Vector3D(1.0, 0.5, 0.0);
+    fountain.Life = 100;
+    fountain.LifeSpread = 20;
+    fountain.ScaleSpeed = -0.005;
+    fountain.Rate = 40.0;
+
+    Digital port0(0);
+    SRL::Timer::Stopwatch stopwatch;
+    bool useSlave = true;
+
+    // Main program loop
+    while (1)
+    {
+        if (port0.WasPressed(Digital::Button::A))
+        {
+            useSlave = !useSlave;
+        }
+
+        particles.Emit(fountain);
+
+        stopwatch.Start();
+
+        if (useSlave)
+        {
+            // Slave integrates particles while master would run game logic
+            particles.BeginUpdate();
+            particles.EndUpdate();
+        }
+        else
+        {
+            particles.Update();
+        }
+
+        const uint32_t updateTime = stopwatch.GetMicroseconds();
+
+        stopwatch.Start();
+        const size_t drawn = particles.Draw();
+        const uint32_t drawTime = stopwatch.GetMicroseconds();
+
+        SRL::Debug::Print(1, 5, "Particles : %d   ", particles.GetCount());
+        SRL::Debug::Print(1, 6, "Drawn     : %d   ", drawn);
+        SRL::Debug::Print(1, 7, "Mode      : %s   ", useSlave ? "slave " : "master");
+        SRL::Debug::Print(1, 8, "Update    : %d us   ", updateTime);
+        SRL::Debug::Print(1, 9, "Draw      : %d us   ", drawTime);
+
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <srl.hpp>
+#include <srl_scudsp.hpp>
+#include <srl_timer.hpp>
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+/** @brief Number of points to transform each frame
+ */
+static constexpr size_t PointCount = 1200;
+
+/** @brief Source points
+ */
+static Vector3D points[PointCount];
+
+/** @brief Transformed points
+ */
+static Vector3D transformed[PointCount];
+
+/** @brief Reference points transformed by slCalcPoint
+ */
+static Vector3D reference[PointCount];
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(20, 10, 50));
+    SRL::Debug::Print(1, 1, "SCU DSP point transform benchmark");
+
+    // Generate point cloud
+    SRL::Math::Random rnd = SRL::Math::Random(15);
+
+    for (size_t point = 0; point < PointCount; point++)
+    {
+        points[point] = Vector3D(
+            Fxp::BuildRaw(rnd.GetNumber(-100, 100) << 16),
+            Fxp::BuildRaw(rnd.GetNumber(-100, 100) << 16),
+            Fxp::BuildRaw(rnd.GetNumber(-100, 100) << 16));
+    }
+
+    Angle rotation = 0;
+    SRL::Timer::Stopwatch stopwatch;
+
+    // Main program loop
+    while (1)
+    {
+        SRL::Scene3D::LoadIdentity();
+        SRL::Scene3D::Translate(Fxp(1.5), Fxp(-2.0), Fxp(40.0));
+        SRL::Scene3D::RotateY(rotation);
+        SRL::Scene3D::RotateX(rotation);
+        rotation += Angle::FromDegrees(1);
+
+        // slCalcPoint on master only
+        stopwatch.Start();
+
+        for (size_t point = 0; point < PointCount; point++)
+        {
+            reference[point] = SRL::Scene3D::TransformPoint(points[point]);
+        }
+
+        const uint32_t sglTime = stopwatch.GetMicroseconds();
+
+        // DSP only
+        stopwatch.Start();
+        SRL::ScuDsp::PointTransform::Load();
+        SRL::ScuDsp::PointTransform::Transform(points, transformed, PointCount);
+        const uint32_t dspTime = stopwatch.GetMicroseconds();
+
+        // DSP + slave + master
+        stopwatch.Start();
+        SRL::ScuDsp::PointTransform::TransformParallel(points, transformed, PointCount);
+        const uint32_t parallelTime = stopwatch.GetMicroseconds();
+
+        // Check largest error against reference
+        int32_t maxError = 0;
+
+        for (size_t point = 0; point < PointCount; point++)
+        {
+            maxError = SRL::Math::Max(maxError, SRL::Math::Abs(transformed[point].X.RawValue() - reference[point].X.RawValue()));
+            maxError = SRL::Math::Max(maxError, SRL::Math::Abs(transformed[point].Y.RawValue() - reference[point].Y.RawValue()));
+            maxError = SRL::Math::Max(maxError, SRL::Math::Abs(transformed[point].Z.RawValue() - reference[point].Z.RawValue()));
+        }
+
+        SRL::Debug::Print(1, 3, "Points           : %d   ", PointCount);
+        SRL::Debug::Print(1, 5, "slCalcPoint      : %d us   ", sglTime);
+        SRL::Debug::Print(1, 6, "DSP only         : %d us   ", dspTime);
+        SRL::Debug::Print(1, 7, "DSP+slave+master : %d us   ", parallelTime);
+        SRL::Debug::Print(1, 9, "Max raw error    : %d   ", maxError);
+
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include <srl.hpp>
+#include <srl_scratchpad.hpp>
+#include <srl_timer.hpp>
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+/** @brief Number of points, source and destination must fit into the scratchpad together with the kernel
+ */
+static constexpr size_t PointCount = 64;
+
+/** @brief How many times are the points transformed each frame
+ */
+static constexpr size_t Repeats = 32;
+
+/** @brief Source points
+ */
+static Vector3D points[PointCount];
+
+/** @brief Points transformed by kernel in HWRam
+ */
+static Vector3D transformed[PointCount];
+
+/** @brief Points transformed by kernel in scratchpad
+ */
+static Vector3D reference[PointCount];
+
+/** @brief Transform kernel body shared by both copies of the kernel
+ * @param matrix Transformation matrix in SGL layout
+ * @param source Points to transform
+ * @param destination Transformed points
+ * @param count Number of points
+ */
+__attribute__((always_inline)) static inline void Transform(const FIXED matrix[4][3], const Vector3D* source, Vector3D* destination, const size_t count)
+{
+    for (size_t point = 0; point < count; point++)
+    {
+        const int64_t x = source[point].X.RawValue();
+        const int64_t y = source[point].Y.RawValue();
+        const int64_t z = source[point].Z.RawValue();
+
+        destination[point] = Vector3D(
+            Fxp::BuildRaw(static_cast<int32_t>(((x * matrix[0][0]) + (y * matrix[1][0]) + (z * matrix[2][0])) >> 16) + matrix[3][0]),
+            Fxp::BuildRaw(static_cast<int32_t>(((x * matrix[0][1]) + (y * matrix[1][1]) + (z * matrix[2][1])) >> 16) + matrix[3][1]),
+            Fxp::BuildRaw(static_cast<int32_t>(((x * matrix[0][2]) + (y * matrix[1][2]) + (z * matrix[2][2])) >> 16) + matrix[3][2]));
+    }
+}
+
+/** @brief Transform kernel executed from HWRam
+ * @param matrix Transformation matrix in SGL layout
+ * @param source Points to transform
+ * @param destination Transformed points
+ * @param count Number of points
+ */
+__attribute__((noinline)) static void TransformInRam(const FIXED matrix[4][3], const Vector3D* source, Vector3D* destination, const size_t count)
+{
+    Transform(matrix, source, destination, count);
+}
+
+/** @brief Transform kernel executed from scratchpad
+ * @param matrix Transformation matrix in SGL layout
+ * @param source Points to transform
+ * @param destination Transformed points
+ * @param count Number of points
+ */
+SRL_SCRATCHPAD_CODE static void TransformInScratchpad(const FIXED matrix[4][3], const Vector3D* source, Vector3D* destination, const size_t count)
+{
+    Transform(matrix, source, destination, count);
+}
+
+/** @brief Copy matrix and points into scratchpad of the calling CPU and transform them there
+ * @param matrix Transformation matrix in SGL layout
+ * @param destination Transformed points in HWRam
+ */
+static void TransformScratchpadData(const FIXED matrix[4][3], Vector3D* destination)
+{
+    SRL::Scratchpad::Release();
+    const FIXED (*fastMatrix)[3] = reinterpret_cast<const FIXED (*)[3]>(SRL::Scratchpad::Copy(matrix, sizeof(FIXED) * 12));
+    const Vector3D* fastSource = reinterpret_cast<const Vector3D*>(SRL::Scratchpad::Copy(points, sizeof(points)));
+    Vector3D* fastDestination = reinterpret_cast<Vector3D*>(SRL::Scratchpad::Allocate(sizeof(points)));
+
+    for (size_t repeat = 0; repeat < Repeats; repeat++)
+    {
+        TransformInScratchpad(fastMatrix, fastSource, fastDestination, PointCount);
+    }
+
+    for (size_t point = 0; point < PointCount; point++)
+    {
+        destination[point] = fastDestination[point];
+    }
+}
+
+/** @brief Runs the whole scratchpad benchmark on slave
+ */
+class SlaveTransform : public ITask
+{
+public:
+    /** @brief Transformation matrix
+     */
+    FIXED Matrix[4][3];
+
+protected:
+    /** @brief Transform points in slave scratchpad
+     */
+    void Do() override
+    {
+        slCashPurge();
+        TransformScratchpadData(this->Matrix, transformed);
+    }
+};
+
+/** @brief Get largest difference between transformed and reference points
+ * @return Largest difference of raw values
+ */
+static int32_t GetMaxError()
+{
+    int32_t maxError = 0;
+
+    for (size_t point = 0; point < PointCount; point++)
+    {
+        maxError = SRL::Math::Max(maxError, SRL::Math::Abs(transformed[point].X.RawValue() - reference[point].X.RawValue()));
+        maxError = SRL::Math::Max(maxError, SRL::Math::Abs(transformed[point].Y.RawValue() - reference[point].Y.RawValue()));
+        maxError = SRL::Math::Max(maxError, SRL::Math::Abs(transformed[point].Z.RawValue() - reference[point].Z.RawValue()));
+    }
+
+    return maxError;
+}
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(20, 10, 50));
+    SRL::Debug::Print(1, 1, "SH2 cache scratchpad benchmark");
+
+    // Both CPUs have their own scratchpad
+    SRL::Scratchpad::Enable();
+    SRL::Scratchpad::EnableOnSlave();
+
+    // Generate point cloud
+    SRL::Math::Random rnd = SRL::Math::Random(15);
+
+    for (size_t point = 0; point < PointCount; point++)
+    {
+        points[point] = Vector3D(
+            Fxp::BuildRaw(rnd.GetNumber(-100, 100) << 16),
+            Fxp::BuildRaw(rnd.GetNumber(-100, 100) << 16),
+            Fxp::BuildRaw(rnd.GetNumber(-100, 100) << 16));
+    }
+
+    Angle rotation = 0;
+    SRL::Timer::Stopwatch stopwatch;
+    SlaveTransform task;
+
+    // Main program loop
+    while (1)
+    {
+        SRL::Scene3D::LoadIdentity();
+        SRL::Scene3D::Translate(Fxp(1.5), Fxp(-2.0), Fxp(40.0));
+        SRL::Scene3D::RotateY(rotation);
+        SRL::Scene3D::RotateX(rotation);
+        rotation += Angle::FromDegrees(1);
+
+        FIXED matrix[4][3];
+        slGetMatrix(matrix);
+
+        // Code and data in HWRam
+        stopwatch.Start();
+
+        for (size_t repeat = 0; repeat < Repeats; repeat++)
+        {
+            TransformInRam(matrix, points, reference, PointCount);
+        }
+
+        const uint32_t ramTime = stopwatch.GetMicroseconds();
+
+        // Code in scratchpad, data in HWRam
+        stopwatch.Start();
+
+        for (size_t repeat = 0; repeat < Repeats; repeat++)
+        {
+            TransformInScratchpad(matrix, points, transformed, PointCount);
+        }
+
+        const uint32_t codeTime = stopwatch.GetMicroseconds();
+        const int32_t codeError = GetMaxError();
+
+        // Code and data in scratchpad, includes copying data in and out
+        stopwatch.Start();
+        TransformScratchpadData(matrix, transformed);
+        const uint32_t dataTime = stopwatch.GetMicroseconds();
+        const int32_t dataError = GetMaxError();
+
+        // Same on slave, includes waiting for slave to start
+        for (size_t row = 0; row < 4; row++)
+        {
+            for (size_t column = 0; column < 3; column++)
+            {
+                task.Matrix[row][column] = matrix[row][column];
+            }
+        }
+
+        slCashPurge();
+        stopwatch.Start();
+        SRL::Slave::ExecuteOnSlave(task);
+        while (!task.IsDone());
+        const uint32_t slaveTime = stopwatch.GetMicroseconds();
+        slCashPurge();
+        const int32_t slaveError = GetMaxError();
+
+        SRL::Debug::Print(1, 3, "Points x repeats : %d x %d", PointCount, Repeats);
+        SRL::Debug::Print(1, 4, "Scratchpad used  : %d / %d   ", SRL::Scratchpad::GetUsed(), SRL::Scratchpad::Size);
+        SRL::Debug::Print(1, 6, "HWRam            : %d us   ", ramTime);
+        SRL::Debug::Print(1, 7, "Scratchpad code  : %d us   ", codeTime);
+        SRL::Debug::Print(1, 8, "Scratchpad all   : %d us   ", dataTime);
+        SRL::Debug::Print(1, 9, "Slave scratchpad : %d us   ", slaveTime);
+        SRL::Debug::Print(1, 11, "Max raw error    : %d %d %d   ", codeError, dataError, slaveError);
+
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
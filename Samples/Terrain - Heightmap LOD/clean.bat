@@ -0,0 +1,3 @@
+:; "../../tools/scripts/make.sh" clean; exit;
+@ECHO Off
+"../../tools/scripts/make.bat" clean
\ No newline at end of file
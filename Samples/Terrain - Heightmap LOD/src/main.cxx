@@ -0,0 +1,280 @@
+#include <srl.hpp>
+#include <srl_sky.hpp>
+#include <srl_terrain.hpp>
+#include <srl_timer.hpp>
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+// Using to shorten names for input
+using namespace SRL::Input;
+
+/** @brief Number of heightmap samples along each side
+ */
+static constexpr uint16_t MapSize = 512;
+
+/** @brief Distance between heightmap samples
+ */
+static constexpr Fxp CellSize = 8.0;
+
+/** @brief Sky panorama width in pixels (one full turn)
+ */
+static constexpr uint16_t SkyWidth = 512;
+
+/** @brief Sky panorama height in pixels
+ */
+static constexpr uint16_t SkyHeight = 256;
+
+/** @brief Row of the sky panorama on the horizon
+ */
+static constexpr uint16_t SkyHorizon = 200;
+
+/** @brief Procedural 16 color sky panorama with distant mountains
+ */
+struct SkyBitmap : public SRL::Bitmap::IBitmap
+{
+    /** @brief Pixel data, two pixels per byte
+     */
+    uint8_t* data;
+
+    /** @brief Sky colors
+     */
+    SRL::Bitmap::Palette palette;
+
+    /** @brief Draw the panorama
+     */
+    SkyBitmap() : palette(16)
+    {
+        this->data = new uint8_t[(SkyWidth * SkyHeight) >> 1];
+
+        // Color 0 is transparent, gradient from deep blue to haze uses colors 1 to 9
+        for (uint8_t color = 0; color < 10; color++)
+        {
+            this->palette.Colors[color] = HighColor::FromRGB555(4 + (color * 2), 8 + (color * 2), 20 + color);
+        }
+
+        this->palette.Colors[10] = HighColor::FromRGB555(8, 10, 16);
+        this->palette.Colors[11] = HighColor::FromRGB555(5, 7, 12);
+
+        for (uint16_t x = 0; x < SkyWidth; x++)
+        {
+            // Mountain profile repeats exactly after one turn
+            const Fxp wave = (SRL::Math::Trigonometry::Sin(Angle::BuildRaw(static_cast<uint16_t>(x * 384))) * 12.0) +
+                (SRL::Math::Trigonometry::Sin(Angle::BuildRaw(static_cast<uint16_t>(x * 896))) * 6.0);
+            const int32_t peak = SkyHorizon - 20 - (wave.RawValue() >> 16);
+
+            for (uint16_t y = 0; y < SkyHeight; y++)
+            {
+                uint8_t color = 1 + ((SRL::Math::Min<int32_t>(y, SkyHorizon - 1) * 9) / SkyHorizon);
+
+                if (y >= peak)
+                {
+                    color = y >= SkyHorizon ? 11 : 10;
+                }
+
+                uint8_t& pixels = this->data[((y * SkyWidth) + x) >> 1];
+                pixels = (x & 1) != 0 ? ((pixels & 0xf0) | color) : ((pixels & 0x0f) | (color << 4));
+            }
+        }
+    }
+
+    /** @brief Free pixel data
+     */
+    ~SkyBitmap()
+    {
+        delete[] this->data;
+    }
+
+    /** @brief Get image data
+     * @return Pointer to image data
+     */
+    uint8_t* GetData() override
+    {
+        return this->data;
+    }
+
+    /** @brief Get bitmap info
+     * @return Bitmap info
+     */
+    SRL::Bitmap::BitmapInfo GetInfo() override
+    {
+        return SRL::Bitmap::BitmapInfo(SkyWidth, SkyHeight, &this->palette);
+    }
+};
+
+/** @brief Add one octave of smooth random noise to the heightmap
+ * @param heights Heightmap
+ * @param spacing Distance between random points in samples
+ * @param amplitude Largest added value
+ * @param rnd Random generator
+ */
+static void AddNoise(uint8_t* heights, const int32_t spacing, const int32_t amplitude, SRL::Math::Random& rnd)
+{
+    const int32_t points = (MapSize / spacing) + 1;
+    int32_t* values = new int32_t[points * points];
+
+    for (int32_t point = 0; point < points * points; point++)
+    {
+        values[point] = rnd.GetNumber(0, amplitude);
+    }
+
+    // Blend random points bilinearly
+    for (int32_t y = 0; y < MapSize; y++)
+    {
+        for (int32_t x = 0; x < MapSize; x++)
+        {
+            const int32_t pointX = x / spacing;
+            const int32_t pointY = y / spacing;
+            const int32_t fractionX = x % spacing;
+            const int32_t fractionY = y % spacing;
+            const int32_t* row = values + (pointY * points) + pointX;
+            const int32_t top = (row[0] * (spacing - fractionX)) + (row[1] * fractionX);
+            const int32_t bottom = (row[points] * (spacing - fractionX)) + (row[points + 1] * fractionX);
+            const int32_t value = ((top * (spacing - fractionY)) + (bottom * fractionY)) / (spacing * spacing);
+
+            heights[(y * MapSize) + x] = SRL::Math::Min<int32_t>(255, heights[(y * MapSize) + x] + value);
+        }
+    }
+
+    delete[] values;
+}
+
+/** @brief Get polygon attribute for terrain
+ * @param wireframe Draw only polygon outlines
+ * @return Polygon attribute
+ */
+static Attribute GetAttribute(const bool wireframe)
+{
+    return Attribute(
+        Attribute::FaceVisibility::DoubleSided,
+        Attribute::SortMode::Center,
+        No_Texture,
+        HighColor::FromRGB555(6, 20, 8),
+        CL32KRGB,
+        CL32KRGB,
+        wireframe ? sprPolyLine : sprPolygon,
+        No_Option);
+}
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(20, 10, 50));
+    SRL::Debug::Print(1, 1, "Heightmap terrain");
+    SRL::Debug::Print(1, 3, "Left/Right: turn");
+    SRL::Debug::Print(1, 4, "Up/Down: speed");
+    SRL::Debug::Print(1, 5, "A: detail, B: wireframe");
+
+    // Heightmap is too large for HWRam, terrain keeps only a window of it in its own buffers
+    uint8_t* heights = reinterpret_cast<uint8_t*>(SRL::Memory::Malloc(MapSize * MapSize, SRL::Memory::Zone::LWRam));
+    SRL::Math::Random rnd = SRL::Math::Random(7);
+
+    for (size_t sample = 0; sample < MapSize * MapSize; sample++)
+    {
+        heights[sample] = 0;
+    }
+
+    AddNoise(heights, 128, 150, rnd);
+    AddNoise(heights, 32, 70, rnd);
+    AddNoise(heights, 8, 30, rnd);
+
+    SRL::Terrain terrain(heights, MapSize, MapSize, 4, CellSize, 0.5);
+
+    // Sky is drawn by VDP2, it costs no VDP1 polygons
+    SRL::Sky::Panorama<SRL::VDP2::NBG0> sky(SkyWidth, SkyHorizon);
+
+    {
+        SkyBitmap panorama;
+        sky.Load(panorama);
+    }
+
+    Vector3D camera(400.0, 0.0, 400.0);
+    Angle heading = Angle::FromDegrees(45.0);
+    Fxp speed = 2.0;
+    bool wireframe = true;
+    bool fineDetail = false;
+
+    terrain.SetAttribute(GetAttribute(wireframe));
+    terrain.Update(camera, 16);
+
+    Digital port0(0);
+    SRL::Timer::Stopwatch stopwatch;
+
+    // Main program loop
+    while (1)
+    {
+        if (port0.IsHeld(Digital::Button::Left))
+        {
+            heading -= Angle::FromDegrees(1.0);
+        }
+
+        if (port0.IsHeld(Digital::Button::Right))
+        {
+            heading += Angle::FromDegrees(1.0);
+        }
+
+        if (port0.IsHeld(Digital::Button::Up))
+        {
+            speed = SRL::Math::Min<Fxp>(speed + 0.125, 8.0);
+        }
+
+        if (port0.IsHeld(Digital::Button::Down))
+        {
+            speed = SRL::Math::Max<Fxp>(speed - 0.125, 0.0);
+        }
+
+        if (port0.WasPressed(Digital::Button::A))
+        {
+            fineDetail = !fineDetail;
+            terrain.SetTolerance(fineDetail ? 0.002 : 0.01);
+        }
+
+        if (port0.WasPressed(Digital::Button::B))
+        {
+            wireframe = !wireframe;
+            terrain.SetAttribute(GetAttribute(wireframe));
+        }
+
+        // Fly over the terrain, turn around at the edge of the map
+        const Fxp sin = SRL::Math::Trigonometry::Sin(heading);
+        const Fxp cos = SRL::Math::Trigonometry::Cos(heading);
+        camera.X += sin * speed;
+        camera.Z += cos * speed;
+
+        if (camera.X < Fxp(64.0) || camera.Z < Fxp(64.0) ||
+            camera.X > Fxp(MapSize * 8.0 - 64.0) || camera.Z > Fxp(MapSize * 8.0 - 64.0))
+        {
+            heading += Angle::FromDegrees(180.0);
+            camera.X -= sin * (speed + 1.0);
+            camera.Z -= cos * (speed + 1.0);
+        }
+
+        camera.Y = terrain.GetHeight(camera.X, camera.Z) - 60.0;
+
+        stopwatch.Start();
+        terrain.Update(camera);
+        const uint32_t updateTime = stopwatch.GetMicroseconds();
+
+        const Vector3D target(camera.X + (sin * 64.0), camera.Y + 20.0, camera.Z + (cos * 64.0));
+        SRL::Scene3D::LoadIdentity();
+        SRL::Scene3D::LookAt(camera, target, Angle::FromDegrees(0.0));
+        sky.Update(SRL::Sky::Orientation::FromLookAt(camera, target));
+
+        stopwatch.Start();
+        terrain.Draw(camera);
+        const uint32_t drawTime = stopwatch.GetMicroseconds();
+
+        const SRL::Terrain::Statistics& statistics = terrain.GetStatistics();
+        SRL::Debug::Print(1, 7, "Patches  : %d   ", statistics.Patches);
+        SRL::Debug::Print(1, 8, "Polygons : %d / %d   ", statistics.Polygons, SGL_MAX_POLYGONS);
+        SRL::Debug::Print(1, 9, "Culled   : %d   ", statistics.Culled);
+        SRL::Debug::Print(1, 10, "Pending  : %d   ", statistics.Pending);
+        SRL::Debug::Print(1, 11, "Update   : %d us   ", updateTime);
+        SRL::Debug::Print(1, 12, "Draw     : %d us   ", drawTime);
+
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
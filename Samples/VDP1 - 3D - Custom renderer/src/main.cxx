@@ -0,0 +1,142 @@
+#include <srl.hpp>
+#include <srl_renderer.hpp>
+#include <srl_timer.hpp>
+#include "modelObject.hpp"
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+// Using to shorten names for input
+using namespace SRL::Input;
+
+/** @brief Largest number of teapots drawn at once
+ */
+static constexpr uint8_t MaxTeapots = 4;
+
+/** @brief Distance between teapots
+ */
+static constexpr Fxp TeapotSpacing = 24.0;
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(0x31, 0x14, 0x32));
+    SRL::Debug::Print(1, 1, "VDP1 3D Custom renderer");
+    SRL::Debug::Print(1, 3, "A: SGL / renderer");
+    SRL::Debug::Print(1, 4, "L/R: teapot count");
+    SRL::Debug::Print(1, 5, "Up/Down: move camera");
+
+    // Same model as in the flat teapot sample
+    ModelObject teapot = ModelObject("FPOT.NYA");
+
+    // Renderer limits do not depend on SGL_MAX_POLYGONS, about half of the faces are always facing away
+    SRL::Renderer3D renderer(teapot.GetVertexCount(), (teapot.GetFaceCount() * MaxTeapots) >> 1);
+
+    // Both use the same light fixed to the camera, renderer expects unit vector
+    Vector3D lightDirection = Vector3D(0.2, 0.0, 0.2);
+    SRL::Scene3D::SetDirectionalLight(lightDirection);
+    renderer.SetDirectionalLight(Vector3D(0.7071, 0.0, 0.7071), 0);
+
+    Vector3D cameraLocation = Vector3D(0.0, -7.0, -60.0);
+    Angle rotation = 0;
+    uint8_t teapots = 1;
+    bool useRenderer = true;
+
+    Digital port0(0);
+    SRL::Timer::Stopwatch stopwatch;
+
+    // Main program loop
+    while (1)
+    {
+        if (port0.WasPressed(Digital::Button::A))
+        {
+            useRenderer = !useRenderer;
+        }
+
+        if (port0.WasPressed(Digital::Button::L) && teapots > 1)
+        {
+            teapots--;
+        }
+
+        if (port0.WasPressed(Digital::Button::R) && teapots < MaxTeapots)
+        {
+            teapots++;
+        }
+
+        // Camera can move through the teapots to show near plane clipping
+        if (port0.IsHeld(Digital::Button::Up))
+        {
+            cameraLocation.Z += 0.5;
+        }
+
+        if (port0.IsHeld(Digital::Button::Down))
+        {
+            cameraLocation.Z -= 0.5;
+        }
+
+        rotation += Angle::FromDegrees(1.0);
+        stopwatch.Start();
+
+        if (useRenderer)
+        {
+            renderer.Begin();
+        }
+
+        SRL::Scene3D::LoadIdentity();
+        SRL::Scene3D::LookAt(cameraLocation, Vector3D(cameraLocation.X, cameraLocation.Y, cameraLocation.Z + Fxp(40.0)), Angle::FromDegrees(0.0));
+
+        // Teapots in a row along X axis, centered around origin
+        for (uint8_t index = 0; index < teapots; index++)
+        {
+            SRL::Scene3D::PushMatrix();
+            const int32_t offset = index - ((teapots - 1) >> 1);
+            SRL::Scene3D::Translate(Fxp::BuildRaw(TeapotSpacing.RawValue() * offset), 0.0, 0.0);
+            SRL::Scene3D::RotateY(rotation);
+
+            for (size_t mesh = 0; mesh < teapot.GetMeshCount(); mesh++)
+            {
+                if (useRenderer)
+                {
+                    renderer.Draw(*teapot.GetMesh<Mesh>(mesh));
+                }
+                else
+                {
+                    SRL::Scene3D::DrawMesh(*teapot.GetMesh<Mesh>(mesh));
+                }
+            }
+
+            SRL::Scene3D::PopMatrix();
+        }
+
+        if (useRenderer)
+        {
+            renderer.End();
+        }
+
+        const uint32_t drawTime = stopwatch.GetMicroseconds();
+        SRL::Debug::Print(1, 7, "Pipeline : %s", useRenderer ? "renderer" : "SGL     ");
+        SRL::Debug::Print(1, 8, "Teapots  : %d  ", teapots);
+        SRL::Debug::Print(1, 9, "Faces    : %d / %d      ", teapot.GetFaceCount() * teapots, SGL_MAX_POLYGONS);
+        SRL::Debug::Print(1, 10, "Draw     : %d us     ", drawTime);
+
+        if (useRenderer)
+        {
+            const SRL::Renderer3D::Statistics& statistics = renderer.GetStatistics();
+            SRL::Debug::Print(1, 11, "Commands : %d   ", statistics.Commands);
+            SRL::Debug::Print(1, 12, "Clipped  : %d   ", statistics.Clipped);
+            SRL::Debug::Print(1, 13, "Dropped  : %d   ", statistics.Dropped);
+        }
+        else
+        {
+            SRL::Debug::Print(1, 11, "                ");
+            SRL::Debug::Print(1, 12, "                ");
+            SRL::Debug::Print(1, 13, "                ");
+        }
+
+        // Refresh screen
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
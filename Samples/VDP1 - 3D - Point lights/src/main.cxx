@@ -0,0 +1,164 @@
+#include <srl.hpp>
+#include <srl_lighting.hpp>
+#include <srl_timer.hpp>
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+// Using to shorten names for input
+using namespace SRL::Input;
+
+/** @brief Number of floor cells along each side
+ */
+static constexpr uint16_t FloorCells = 16;
+
+/** @brief Size of one floor cell
+ */
+static constexpr int32_t CellSize = 8;
+
+/** @brief Number of point lights circling above the floor
+ */
+static constexpr size_t PointLights = 3;
+
+/** @brief Build flat floor made of quads centered around origin
+ * @return Floor mesh with normals pointing up
+ */
+static SmoothMesh* CreateFloor()
+{
+    const uint16_t side = FloorCells + 1;
+    const int32_t offset = (FloorCells * CellSize) >> 1;
+    SmoothMesh* floor = new SmoothMesh(side * side, FloorCells * FloorCells);
+
+    for (uint16_t z = 0; z < side; z++)
+    {
+        for (uint16_t x = 0; x < side; x++)
+        {
+            floor->Vertices[(z * side) + x] = Vector3D(
+                Fxp::BuildRaw(((x * CellSize) - offset) << 16),
+                0.0,
+                Fxp::BuildRaw(((z * CellSize) - offset) << 16));
+
+            floor->Normals[(z * side) + x] = Vector3D(0.0, -1.0, 0.0);
+        }
+    }
+
+    for (uint16_t z = 0; z < FloorCells; z++)
+    {
+        for (uint16_t x = 0; x < FloorCells; x++)
+        {
+            const uint16_t vertices[4] = {
+                static_cast<uint16_t>((z * side) + x),
+                static_cast<uint16_t>((z * side) + x + 1),
+                static_cast<uint16_t>(((z + 1) * side) + x + 1),
+                static_cast<uint16_t>(((z + 1) * side) + x) };
+
+            // Checkerboard makes the light falloff easier to see
+            const uint8_t shade = ((x + z) & 1) != 0 ? 12 : 16;
+            floor->Faces[(z * FloorCells) + x] = Polygon(Vector3D(0.0, -1.0, 0.0), vertices);
+            floor->Attributes[(z * FloorCells) + x] = Attribute(
+                Attribute::FaceVisibility::SingleSided,
+                Attribute::SortMode::Center,
+                No_Texture,
+                HighColor::FromRGB555(shade, shade, shade),
+                0,
+                CL32KRGB,
+                sprPolygon,
+                No_Option);
+        }
+    }
+
+    return floor;
+}
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(0, 0, 0));
+    SRL::Debug::Print(1, 1, "VDP1 3D Point lights");
+    SRL::Debug::Print(1, 3, "A: toggle spot light");
+    SRL::Debug::Print(1, 4, "B: toggle slave CPU");
+
+    // Floor is lit by its own gouraud table entries, computed on the slave CPU
+    SmoothMesh* floor = CreateFloor();
+    SRL::MeshLighting lighting(*floor, 0);
+    lighting.SetAmbient(HighColor::FromRGB555(6, 6, 8));
+
+    // Warm, green and blue lamps circling the floor, spot light sweeping over it
+    const HighColor colors[PointLights] = {
+        HighColor::FromRGB555(20, 12, 4),
+        HighColor::FromRGB555(4, 18, 6),
+        HighColor::FromRGB555(4, 8, 22)
+    };
+
+    SRL::MeshLighting::Light lights[PointLights + 1];
+    lights[PointLights] = SRL::MeshLighting::Light(Vector3D(), Vector3D(0.0, 1.0, 0.0), 60.0, 0.9, HighColor::FromRGB555(14, 14, 14));
+
+    Vector3D cameraLocation = Vector3D(0.0, -60.0, -90.0);
+    Angle rotation = 0;
+    Angle sweep = 0;
+    bool useSpot = true;
+    bool useSlave = true;
+
+    Digital port0(0);
+    SRL::Timer::Stopwatch stopwatch;
+
+    // Main program loop
+    while (1)
+    {
+        if (port0.WasPressed(Digital::Button::A))
+        {
+            useSpot = !useSpot;
+        }
+
+        if (port0.WasPressed(Digital::Button::B))
+        {
+            useSlave = !useSlave;
+        }
+
+        // Move lights around
+        rotation += Angle::FromDegrees(1.0);
+        sweep += Angle::FromDegrees(2.0);
+
+        for (size_t light = 0; light < PointLights; light++)
+        {
+            const Angle angle = rotation + Angle::FromDegrees(120.0 * light);
+            lights[light] = SRL::MeshLighting::Light(
+                Vector3D(SRL::Math::Trigonometry::Sin(angle) * 40.0, -12.0, SRL::Math::Trigonometry::Cos(angle) * 40.0),
+                40.0,
+                colors[light]);
+        }
+
+        lights[PointLights].Position = Vector3D(SRL::Math::Trigonometry::Sin(sweep) * 30.0, -40.0, 0.0);
+
+        // Compute lighting while master sets up the camera
+        const size_t count = useSpot ? PointLights + 1 : PointLights;
+        stopwatch.Start();
+
+        if (useSlave)
+        {
+            lighting.BeginUpdate(lights, count, Vector3D());
+        }
+        else
+        {
+            lighting.Update(lights, count, Vector3D());
+        }
+
+        SRL::Scene3D::LoadIdentity();
+        SRL::Scene3D::LookAt(cameraLocation, Vector3D(), 0);
+
+        lighting.EndUpdate();
+        const uint32_t lightTime = stopwatch.GetMicroseconds();
+
+        lighting.Draw();
+
+        SRL::Debug::Print(1, 6, "Lights on floor : %d  ", lighting.GetLightCount());
+        SRL::Debug::Print(1, 7, "Lighting        : %d us   ", lightTime);
+        SRL::Debug::Print(1, 8, "CPU             : %s", useSlave ? "slave " : "master");
+
+        // Refresh screen, gouraud table is copied to VDP1 in vblank
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <srl.hpp>
+#include <srl_split_screen.hpp>
+#include <srl_timer.hpp>
+
+// Using to shorten names for Vector and HighColor
+using namespace SRL::Types;
+using namespace SRL::Math::Types;
+
+// Using to shorten names for input
+using namespace SRL::Input;
+
+/** @brief Number of cubes along each side of the field
+ */
+static constexpr int32_t FieldSize = 8;
+
+/** @brief Distance between cubes
+ */
+static constexpr Fxp CubeSpacing = 40.0;
+
+/** @brief Half of cube side
+ */
+static constexpr Fxp CubeSize = 8.0;
+
+/** @brief Build cube mesh
+ * @return Cube with differently colored sides
+ */
+static Mesh* CreateCube()
+{
+    Mesh* cube = new Mesh(8, 6);
+
+    for (uint8_t corner = 0; corner < 8; corner++)
+    {
+        cube->Vertices[corner] = Vector3D(
+            (corner & 1) != 0 ? CubeSize : -CubeSize,
+            (corner & 2) != 0 ? CubeSize : -CubeSize,
+            (corner & 4) != 0 ? CubeSize : -CubeSize);
+    }
+
+    // Corners of each side in clockwise order when looking at it from outside
+    const uint16_t sides[6][4] = { { 0, 1, 3, 2 }, { 5, 4, 6, 7 }, { 4, 0, 2, 6 }, { 1, 5, 7, 3 }, { 4, 5, 1, 0 }, { 2, 3, 7, 6 } };
+    const Vector3D normals[6] = {
+        Vector3D(0.0, 0.0, -1.0), Vector3D(0.0, 0.0, 1.0),
+        Vector3D(-1.0, 0.0, 0.0), Vector3D(1.0, 0.0, 0.0),
+        Vector3D(0.0, -1.0, 0.0), Vector3D(0.0, 1.0, 0.0) };
+
+    for (uint8_t side = 0; side < 6; side++)
+    {
+        cube->Faces[side] = Polygon(normals[side], sides[side]);
+        cube->Attributes[side] = Attribute(
+            Attribute::FaceVisibility::SingleSided,
+            Attribute::SortMode::Center,
+            No_Texture,
+            HighColor::FromRGB555(8 + (side * 4), 31 - (side * 4), 16),
+            No_Gouraud,
+            CL32KRGB,
+            sprPolygon,
+            No_Option);
+    }
+
+    return cube;
+}
+
+// Main program entry
+int main()
+{
+    SRL::Core::Initialize(HighColor(20, 10, 50));
+    SRL::Debug::Print(1, 1, "VDP1 3D Split screen");
+
+    Mesh* cube = CreateCube();
+    const uint16_t textures = SRL::VDP1::GetTextureCount();
+    uint8_t viewportCount = 2;
+    SRL::SplitScreen* screen = new SRL::SplitScreen(viewportCount, FieldSize * FieldSize, 8, 256);
+
+    const Angle cameraOffsets[SRL::SplitScreen::MaxViewports] = {
+        Angle::FromDegrees(0.0),
+        Angle::FromDegrees(90.0),
+        Angle::FromDegrees(180.0),
+        Angle::FromDegrees(270.0) };
+
+    Angle rotation = 0;
+    Digital port0(0);
+    SRL::Timer::Stopwatch stopwatch;
+
+    // Main program loop
+    while (1)
+    {
+        // Change number of players, each split screen allocates its own command tables
+        if ((port0.WasPressed(Digital::Button::L) && viewportCount > 1) || (port0.WasPressed(Digital::Button::R) && viewportCount < SRL::SplitScreen::MaxViewports))
+        {
+            viewportCount += port0.WasPressed(Digital::Button::R) ? 1 : -1;
+            delete screen;
+            SRL::VDP1::ResetTextureHeap(textures);
+            screen = new SRL::SplitScreen(viewportCount, FieldSize * FieldSize, 8, 256);
+        }
+
+        rotation += Angle::FromDegrees(0.5);
+        stopwatch.Start();
+
+        // Each player orbits the field from a different side
+        for (uint8_t viewport = 0; viewport < viewportCount; viewport++)
+        {
+            Angle angle = rotation;
+            angle += cameraOffsets[viewport];
+            const Vector3D camera(
+                SRL::Math::Trigonometry::Sin(angle) * 200.0,
+                Fxp(-60.0),
+                SRL::Math::Trigonometry::Cos(angle) * 200.0);
+
+            screen->SetCamera(viewport, camera, Vector3D(0.0, 0.0, 0.0), Angle::FromDegrees(0.0));
+        }
+
+        // World transformation of each cube is computed once and shared by all viewports
+        screen->Begin();
+
+        for (int32_t z = 0; z < FieldSize; z++)
+        {
+            for (int32_t x = 0; x < FieldSize; x++)
+            {
+                SRL::Scene3D::LoadIdentity();
+                SRL::Scene3D::Translate(
+                    Fxp::BuildRaw((CubeSpacing.RawValue() * ((x << 1) - FieldSize + 1)) >> 1),
+                    0.0,
+                    Fxp::BuildRaw((CubeSpacing.RawValue() * ((z << 1) - FieldSize + 1)) >> 1));
+
+                if (((x + z) & 1) != 0)
+                {
+                    SRL::Scene3D::RotateY(rotation);
+                }
+
+                screen->Add(*cube, CubeSize * 2.0);
+            }
+        }
+
+        screen->End();
+
+        const uint32_t drawTime = stopwatch.GetMicroseconds();
+        SRL::Debug::Print(1, 3, "L/R: players %d  ", viewportCount);
+        SRL::Debug::Print(1, 4, "Draw: %d us     ", drawTime);
+
+        for (uint8_t viewport = 0; viewport < SRL::SplitScreen::MaxViewports; viewport++)
+        {
+            if (viewport < viewportCount)
+            {
+                SRL::Debug::Print(1, 5 + viewport, "P%d culled %d cmds %d   ",
+                    viewport + 1,
+                    screen->GetCulledObjects(viewport),
+                    screen->GetRenderer(viewport).GetStatistics().Commands);
+            }
+            else
+            {
+                SRL::Debug::Print(1, 5 + viewport, "                        ");
+            }
+        }
+
+        // Refresh screen
+        SRL::Core::Synchronize();
+    }
+
+    return 0;
+}
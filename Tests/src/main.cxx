@@ -18,6 +18,22 @@
 #include "testsMemoryHWRam.hpp" // Include the header for memory HWRam tests
 #include "testsMemoryLWRam.hpp" // Include the header for memory LWRam tests
 #include "testsMemoryCartRam.hpp" // Include the header for memory Cart Ram tests
+#include "testsMemorySlave.hpp" // Include the header for slave memory tests
+#include "testsScuDsp.hpp" // Include the header for SCU DSP tests
+#include "testsResources.hpp" // Include the header for resource cache tests
+#include "testsSave.hpp" // Include the header for save tests
+#include "testsEntity.hpp" // Include the header for entity store tests
+#include "testsParticles.hpp" // Include the header for particle system tests
+#include "testsCollision.hpp" // Include the header for collision world tests
+#include "testsBvh.hpp" // Include the header for mesh BVH tests
+#include "testsPathfinder.hpp" // Include the header for path finder tests
+#include "testsTerrain.hpp" // Include the header for terrain tests
+#include "testsSky.hpp" // Include the header for sky tests
+#include "testsLighting.hpp" // Include the header for mesh lighting tests
+#include "testsRenderer.hpp" // Include the header for 3D renderer tests
+#include "testsTextureLod.hpp" // Include the header for texture LOD tests
+#include "testsScratchpad.hpp" // Include the header for cache scratchpad tests
+#include "testsStack.hpp" // Include the header for stack monitoring tests
 
 // Using to shorten names for Vector and HighColor
 using namespace SRL::Types;
@@ -102,6 +118,54 @@ int main()
     MU_RUN_SUITE(memory_CartRam_test_suite); // Add the memory CartRam test suite
     MU_DISPLAY_SATURN(memory_CartRam_test_suite);
 
+    MU_RUN_SUITE(memory_slave_test_suite); // Add the slave memory test suite
+    MU_DISPLAY_SATURN(memory_slave_test_suite);
+
+    MU_RUN_SUITE(scudsp_test_suite); // Add the SCU DSP test suite
+    MU_DISPLAY_SATURN(scudsp_test_suite);
+
+    MU_RUN_SUITE(resources_test_suite); // Add the resource cache test suite
+    MU_DISPLAY_SATURN(resources_test_suite);
+
+    MU_RUN_SUITE(save_test_suite); // Add the save test suite
+    MU_DISPLAY_SATURN(save_test_suite);
+
+    MU_RUN_SUITE(entity_test_suite); // Add the entity store test suite
+    MU_DISPLAY_SATURN(entity_test_suite);
+
+    MU_RUN_SUITE(particles_test_suite); // Add the particle system test suite
+    MU_DISPLAY_SATURN(particles_test_suite);
+
+    MU_RUN_SUITE(collision_test_suite); // Add the collision world test suite
+    MU_DISPLAY_SATURN(collision_test_suite);
+
+    MU_RUN_SUITE(bvh_test_suite); // Add the mesh BVH test suite
+    MU_DISPLAY_SATURN(bvh_test_suite);
+
+    MU_RUN_SUITE(pathfinder_test_suite); // Add the path finder test suite
+    MU_DISPLAY_SATURN(pathfinder_test_suite);
+
+    MU_RUN_SUITE(terrain_test_suite); // Add the terrain test suite
+    MU_DISPLAY_SATURN(terrain_test_suite);
+
+    MU_RUN_SUITE(sky_test_suite); // Add the sky test suite
+    MU_DISPLAY_SATURN(sky_test_suite);
+
+    MU_RUN_SUITE(lighting_test_suite); // Add the mesh lighting test suite
+    MU_DISPLAY_SATURN(lighting_test_suite);
+
+    MU_RUN_SUITE(renderer_test_suite); // Add the 3D renderer test suite
+    MU_DISPLAY_SATURN(renderer_test_suite);
+
+    MU_RUN_SUITE(texture_lod_test_suite); // Add the texture LOD test suite
+    MU_DISPLAY_SATURN(texture_lod_test_suite);
+
+    MU_RUN_SUITE(scratchpad_test_suite); // Add the cache scratchpad test suite
+    MU_DISPLAY_SATURN(scratchpad_test_suite);
+
+    MU_RUN_SUITE(stack_test_suite); // Add the stack monitoring test suite
+    MU_DISPLAY_SATURN(stack_test_suite);
+
     // Generate tests report
     MU_REPORT();
 
@@ -0,0 +1,193 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_bvh.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Number of floor cells along each axis
+     */
+    static constexpr size_t bvh_test_cells = 16;
+
+    /** @brief Size of one floor cell
+     */
+    static constexpr int32_t bvh_test_cell_size = 8;
+
+    /** @brief Floor mesh used by BVH tests
+     */
+    static Types::Mesh* bvh_test_floor = nullptr;
+
+    /**
+     * @brief Set up routine for BVH unit tests
+     */
+    void bvh_test_setup(void)
+    {
+        // Flat floor made of quads at Y = 0, centered around origin
+        const size_t side = bvh_test_cells + 1;
+        const int32_t offset = (bvh_test_cells * bvh_test_cell_size) >> 1;
+        bvh_test_floor = new Types::Mesh(side * side, bvh_test_cells * bvh_test_cells);
+
+        for (size_t z = 0; z < side; z++)
+        {
+            for (size_t x = 0; x < side; x++)
+            {
+                bvh_test_floor->Vertices[(z * side) + x] = Vector3D(
+                    Fxp::BuildRaw(((x * bvh_test_cell_size) - offset) << 16),
+                    0.0,
+                    Fxp::BuildRaw(((z * bvh_test_cell_size) - offset) << 16));
+            }
+        }
+
+        for (size_t z = 0; z < bvh_test_cells; z++)
+        {
+            for (size_t x = 0; x < bvh_test_cells; x++)
+            {
+                const uint16_t vertices[4] = {
+                    static_cast<uint16_t>((z * side) + x),
+                    static_cast<uint16_t>((z * side) + x + 1),
+                    static_cast<uint16_t>(((z + 1) * side) + x + 1),
+                    static_cast<uint16_t>(((z + 1) * side) + x) };
+
+                bvh_test_floor->Faces[(z * bvh_test_cells) + x] = Types::Polygon(Vector3D(0.0, -1.0, 0.0), vertices);
+            }
+        }
+    }
+
+    /**
+     * @brief Tear down routine for BVH unit tests
+     */
+    void bvh_test_teardown(void)
+    {
+        delete bvh_test_floor;
+        bvh_test_floor = nullptr;
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void bvh_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_BVH****");
+            }
+            else
+            {
+                LogInfo("****UT_BVH_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test hierarchy layout
+     *
+     * Verifies that every face ends up in exactly one leaf.
+     */
+    MU_TEST(bvh_test_build)
+    {
+        MeshBvh bvh(*bvh_test_floor);
+        const size_t faceCount = bvh_test_cells * bvh_test_cells;
+        uint8_t seen[bvh_test_cells * bvh_test_cells] = { 0 };
+
+        for (size_t node = 0; node < bvh.GetNodeCount(); node++)
+        {
+            const MeshBvh::Node& current = bvh.GetNodes()[node];
+
+            for (size_t entry = current.Offset; current.Count > 0 && entry < static_cast<size_t>(current.Offset + current.Count); entry++)
+            {
+                seen[bvh.GetFaceOrder()[entry]]++;
+            }
+        }
+
+        for (size_t face = 0; face < faceCount; face++)
+        {
+            snprintf(buffer, buffer_size, "Face %d is in %d leaves", face, seen[face]);
+            mu_assert(seen[face] == 1, buffer);
+        }
+    }
+
+    /**
+     * @brief Test segment query
+     *
+     * Verifies that segment hits the face under it at the right place, and visits only a few nodes.
+     */
+    MU_TEST(bvh_test_segment)
+    {
+        MeshBvh bvh(*bvh_test_floor);
+        MeshBvh::Hit hit;
+
+        // Center of cell (9, 4)
+        const Vector3D start(
+            Fxp::BuildRaw(((9 * bvh_test_cell_size) + 4 - 64) << 16),
+            -10.0,
+            Fxp::BuildRaw(((4 * bvh_test_cell_size) + 4 - 64) << 16));
+        const Vector3D end(start.X, 10.0, start.Z);
+
+        mu_assert(bvh.Segment(start, end, &hit), "Segment missed the floor");
+        snprintf(buffer, buffer_size, "Hit face %d", hit.Face);
+        mu_assert(hit.Face == (4 * bvh_test_cells) + 9, buffer);
+        snprintf(buffer, buffer_size, "Hit fraction %d", hit.Fraction.RawValue());
+        mu_assert(hit.Fraction == Fxp(0.5), buffer);
+        mu_assert(hit.Point.Y == Fxp(0.0), "Hit point is not on the floor");
+
+        snprintf(buffer, buffer_size, "Visited %d nodes", bvh.GetVisitedNodes());
+        mu_assert(bvh.GetVisitedNodes() < (bvh_test_cells * bvh_test_cells) / 8, buffer);
+
+        // Segment above the floor
+        mu_assert(!bvh.Segment(start, Vector3D(end.X, -1.0, end.Z)), "Segment above floor hit it");
+
+        // Ray going down from the same point
+        mu_assert(bvh.Ray(start, Vector3D(0.0, 1.0, 0.0), 100.0, &hit), "Ray missed the floor");
+        mu_assert(hit.Face == (4 * bvh_test_cells) + 9, "Ray hit wrong face");
+    }
+
+    /**
+     * @brief Test sphere query
+     *
+     * Verifies that sphere finds faces it touches and nothing else.
+     */
+    MU_TEST(bvh_test_sphere)
+    {
+        MeshBvh bvh(*bvh_test_floor);
+        uint16_t faces[8];
+
+        // Small sphere above cell center touches one face
+        size_t found = bvh.Sphere(Vector3D(4.0, -1.0, 4.0), 2.0, faces, 8);
+        snprintf(buffer, buffer_size, "Cell center: %d faces", found);
+        mu_assert(found == 1 && faces[0] == (8 * bvh_test_cells) + 8, buffer);
+
+        // Sphere above a corner touches four faces
+        found = bvh.Sphere(Vector3D(0.0, -1.0, 0.0), 2.0, faces, 8);
+        snprintf(buffer, buffer_size, "Corner: %d faces", found);
+        mu_assert(found == 4, buffer);
+
+        // Sphere high above the floor touches nothing
+        found = bvh.Sphere(Vector3D(0.0, -5.0, 0.0), 2.0, faces, 8);
+        snprintf(buffer, buffer_size, "Above: %d faces", found);
+        mu_assert(found == 0, buffer);
+    }
+
+    /**
+     * @brief BVH test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(bvh_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&bvh_test_setup,
+                                       &bvh_test_teardown,
+                                       &bvh_test_output_header);
+
+        MU_RUN_TEST(bvh_test_build);
+        MU_RUN_TEST(bvh_test_segment);
+        MU_RUN_TEST(bvh_test_sphere);
+    }
+}
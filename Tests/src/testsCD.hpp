@@ -508,6 +508,49 @@ extern "C"
     //     mu_assert(strcmp(currentDir, "/") == 0, buffer);
     // }
 
+    // Test: Verify that cached file is served from memory with same contents as on disc.
+    MU_TEST(cd_test_cache_file)
+    {
+        if (!SRL::Cd::Cache::IsAvailable())
+        {
+            LogWarning("RAM cartridge is not available, skipping");
+            return;
+        }
+
+        char expected[32];
+        char cached[32];
+        SRL::Memory::MemSet(expected, '\0', sizeof(expected));
+        SRL::Memory::MemSet(cached, '\0', sizeof(cached));
+
+        SRL::Cd::ChangeDir("ROOT");
+        SRL::Cd::File disc("FILE.TXT");
+        int32_t size = disc.LoadBytes(0, disc.Size.Bytes, expected);
+        SRL::Cd::ChangeDir(static_cast<const char*>(nullptr));
+
+        bool added = SRL::Cd::Cache::Add("ROOT/FILE.TXT");
+        snprintf(buffer, buffer_size, "File 'ROOT/FILE.TXT' was not cached");
+        mu_assert(added, buffer);
+
+        SRL::Cd::ChangeDir("ROOT");
+        SRL::Cd::File file("FILE.TXT");
+        snprintf(buffer, buffer_size, "File 'FILE.TXT' is not served from cache");
+        mu_assert(file.IsCached(), buffer);
+
+        file.Open();
+        int32_t read = file.Read(sizeof(cached), cached);
+        snprintf(buffer, buffer_size, "Cached read returned %d bytes instead of %d", read, size);
+        mu_assert(read == size, buffer);
+
+        snprintf(buffer, buffer_size, "Cached contents '%s' != '%s'", cached, expected);
+        mu_assert(strncmp(cached, expected, size) == 0, buffer);
+
+        snprintf(buffer, buffer_size, "Cached file is not at EOF after reading whole file");
+        mu_assert(file.IsEOF(), buffer);
+
+        file.Close();
+        SRL::Cd::Cache::Clear();
+    }
+
     // Test suite for CD-related tests
     MU_TEST_SUITE(cd_test_suite)
     {
@@ -527,6 +570,7 @@ extern "C"
         MU_RUN_TEST(cd_file_seek_test_relative);
         MU_RUN_TEST(cd_file_seek_test_invalid_negative);
         MU_RUN_TEST(cd_file_seek_test_invalid_beyond);
+        MU_RUN_TEST(cd_test_cache_file);
         //MU_RUN_TEST(cd_test_change_to_valid_directory);       // New test
         //MU_RUN_TEST(cd_test_change_to_invalid_directory);     // New test
         //MU_RUN_TEST(cd_test_navigate_to_parent_directory);    // New test
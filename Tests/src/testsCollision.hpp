@@ -0,0 +1,231 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_collision.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Number of bodies used by broadphase test
+     */
+    static constexpr size_t collision_test_count = 200;
+
+    /**
+     * @brief Set up routine for collision unit tests
+     */
+    void collision_test_setup(void)
+    {
+        // Nothing to set up
+    }
+
+    /**
+     * @brief Tear down routine for collision unit tests
+     */
+    void collision_test_teardown(void)
+    {
+        // Nothing to tear down
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void collision_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_COLLISION****");
+            }
+            else
+            {
+                LogInfo("****UT_COLLISION_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test shape pairs
+     *
+     * Verifies touching and separated results, contact depth and normal direction for each shape combination.
+     */
+    MU_TEST(collision_test_shapes)
+    {
+        CollisionWorld::Contact contact;
+        CollisionWorld::Body box = CollisionWorld::Body::Box(Vector3D(0.0, 0.0, 0.0), Vector3D(4.0, 4.0, 4.0));
+        CollisionWorld::Body sphere = CollisionWorld::Body::Sphere(Vector3D(5.0, 0.0, 0.0), 2.0);
+
+        mu_assert(CollisionWorld::Test(box, sphere, &contact), "Box and sphere do not touch");
+        snprintf(buffer, buffer_size, "Box sphere depth %d", contact.Depth.RawValue());
+        mu_assert(contact.Depth == Fxp(1.0), buffer);
+        mu_assert(contact.Normal.X == Fxp(1.0), "Box sphere normal is wrong");
+
+        mu_assert(CollisionWorld::Test(sphere, box, &contact), "Sphere and box do not touch");
+        mu_assert(contact.Normal.X == Fxp(-1.0), "Flipped normal is wrong");
+
+        sphere.Position = Vector3D(7.0, 0.0, 0.0);
+        mu_assert(!CollisionWorld::Test(box, sphere), "Separated box and sphere touch");
+
+        CollisionWorld::Body other = CollisionWorld::Body::Sphere(Vector3D(9.0, 0.0, 0.0), 3.0);
+        mu_assert(CollisionWorld::Test(sphere, other, &contact), "Spheres do not touch");
+        snprintf(buffer, buffer_size, "Sphere depth %d", contact.Depth.RawValue());
+        mu_assert(contact.Depth == Fxp(3.0), buffer);
+
+        // Crossing capsules, one above the other
+        CollisionWorld::Body capsule = CollisionWorld::Body::Capsule(Vector3D(0.0, 0.0, 0.0), Vector3D(10.0, 0.0, 0.0), 1.0);
+        CollisionWorld::Body crossing = CollisionWorld::Body::Capsule(Vector3D(5.0, 0.0, 1.5), Vector3D(0.0, 10.0, 0.0), 1.0);
+        mu_assert(CollisionWorld::Test(capsule, crossing, &contact), "Capsules do not touch");
+        snprintf(buffer, buffer_size, "Capsule depth %d", contact.Depth.RawValue());
+        mu_assert(contact.Depth == Fxp(0.5), buffer);
+        mu_assert(contact.Normal.Z == Fxp(1.0), "Capsule normal is wrong");
+
+        crossing.Position.Z = 2.5;
+        mu_assert(!CollisionWorld::Test(capsule, crossing), "Separated capsules touch");
+
+        mu_assert(CollisionWorld::Test(box, capsule), "Box and capsule do not touch");
+        crossing.Position.X = 8.0;
+        mu_assert(!CollisionWorld::Test(box, crossing), "Separated box and capsule touch");
+
+        // Tilted capsule grazing box edge, its segment point closest to the box center is far from the box
+        CollisionWorld::Body wide = CollisionWorld::Body::Box(Vector3D(0.0, 0.0, 0.0), Vector3D(8.0, 2.0, 2.0));
+        CollisionWorld::Body tilted = CollisionWorld::Body::Capsule(Vector3D(9.0, 3.0, 0.0), Vector3D(5.0, -5.0, 0.0), 1.5);
+        mu_assert(CollisionWorld::Test(wide, tilted, &contact), "Capsule grazing box edge does not touch");
+        snprintf(buffer, buffer_size, "Box capsule edge depth %d", contact.Depth.RawValue());
+        mu_assert(contact.Depth > Fxp(0.08) && contact.Depth < Fxp(0.09), buffer);
+        mu_assert(contact.Normal.X > Fxp(0.7) && contact.Normal.Y > Fxp(0.7), "Box capsule edge normal is wrong");
+
+        mu_assert(CollisionWorld::Test(tilted, wide, &contact), "Capsule and box grazing edge do not touch");
+        mu_assert(contact.Normal.X < Fxp(-0.7) && contact.Normal.Y < Fxp(-0.7), "Flipped box capsule edge normal is wrong");
+
+        tilted.Radius = 1.25;
+        mu_assert(!CollisionWorld::Test(wide, tilted), "Capsule passing box edge touches");
+
+        // Tilted capsule going through the box
+        tilted = CollisionWorld::Body::Capsule(Vector3D(0.0, 0.0, 5.0), Vector3D(3.0, 1.0, 4.0), 0.5);
+        mu_assert(CollisionWorld::Test(wide, tilted), "Capsule going through box does not touch");
+    }
+
+    /**
+     * @brief Test layer filtering and contact states
+     *
+     * Verifies that masked pairs are ignored, that touching pairs go through enter, stay and exit states
+     * and that exits not fitting into contact buffer are counted as dropped.
+     */
+    MU_TEST(collision_test_states)
+    {
+        CollisionWorld world(4, 8);
+        const int32_t first = world.Add(CollisionWorld::Body::Sphere(Vector3D(0.0, 0.0, 0.0), 2.0, 1, 2));
+        const int32_t second = world.Add(CollisionWorld::Body::Sphere(Vector3D(1.0, 0.0, 0.0), 2.0, 2, 1));
+        const int32_t ignored = world.Add(CollisionWorld::Body::Sphere(Vector3D(0.0, 1.0, 0.0), 2.0, 4, 0xffff));
+
+        mu_assert(first >= 0 && second >= 0 && ignored >= 0, "Add failed");
+
+        world.Update();
+        snprintf(buffer, buffer_size, "Contacts %d != 1", world.GetContactCount());
+        mu_assert(world.GetContactCount() == 1, buffer);
+        mu_assert(world.GetContacts()[0].A == first && world.GetContacts()[0].B == second, "Wrong pair");
+        mu_assert(world.GetContacts()[0].State == CollisionWorld::ContactState::Enter, "Pair did not enter");
+
+        world.Update();
+        mu_assert(world.GetContactCount() == 1, "Pair lost");
+        mu_assert(world.GetContacts()[0].State == CollisionWorld::ContactState::Stay, "Pair did not stay");
+
+        world.Get(second)->Position.X = 10.0;
+        world.Update();
+        mu_assert(world.GetContactCount() == 1, "Exit not reported");
+        mu_assert(world.GetContacts()[0].State == CollisionWorld::ContactState::Exit, "Pair did not exit");
+
+        world.Update();
+        mu_assert(world.GetContactCount() == 0, "Exit reported twice");
+
+        // Exit that does not fit into full contact buffer is counted as dropped
+        CollisionWorld full(4, 1);
+        full.Add(CollisionWorld::Body::Sphere(Vector3D(0.0, 0.0, 0.0), 2.0, 1, 1));
+        const int32_t leaving = full.Add(CollisionWorld::Body::Sphere(Vector3D(1.0, 0.0, 0.0), 2.0, 1, 1));
+        full.Update();
+        mu_assert(full.GetContactCount() == 1 && full.GetStatistics().Dropped == 0, "Pair did not enter");
+
+        full.Get(leaving)->Position.X = 50.0;
+        full.Add(CollisionWorld::Body::Sphere(Vector3D(100.0, 0.0, 0.0), 2.0, 1, 1));
+        full.Add(CollisionWorld::Body::Sphere(Vector3D(101.0, 0.0, 0.0), 2.0, 1, 1));
+        full.Update();
+        mu_assert(full.GetContactCount() == 1 && full.GetContacts()[0].State == CollisionWorld::ContactState::Enter, "New pair was not reported");
+        snprintf(buffer, buffer_size, "Dropped %d != 1", full.GetStatistics().Dropped);
+        mu_assert(full.GetStatistics().Dropped == 1, buffer);
+    }
+
+    /**
+     * @brief Test broadphase
+     *
+     * Verifies that sweep and prune split between both CPUs finds the same pairs as testing every pair.
+     */
+    MU_TEST(collision_test_broadphase)
+    {
+        CollisionWorld world(collision_test_count, collision_test_count * 4);
+        Math::Random random(1234);
+
+        for (size_t body = 0; body < collision_test_count; body++)
+        {
+            const Vector3D position(
+                Fxp::BuildRaw(random.GetNumber(-100, 100) << 16),
+                Fxp::BuildRaw(random.GetNumber(-60, 60) << 16),
+                0.0);
+
+            if ((body % 3) == 1)
+            {
+                world.Add(CollisionWorld::Body::Sphere(position, Fxp::BuildRaw(random.GetNumber(2, 8) << 16)));
+            }
+            else if ((body % 3) == 2)
+            {
+                const Vector3D halfAxis(
+                    Fxp::BuildRaw(random.GetNumber(-8, 8) << 16),
+                    Fxp::BuildRaw(random.GetNumber(-8, 8) << 16),
+                    0.0);
+                world.Add(CollisionWorld::Body::Capsule(position, halfAxis, Fxp::BuildRaw(random.GetNumber(1, 4) << 16)));
+            }
+            else
+            {
+                world.Add(CollisionWorld::Body::Box(position, Vector3D(Fxp::BuildRaw(random.GetNumber(2, 8) << 16), 4.0, 0.0)));
+            }
+        }
+
+        world.Update(128);
+
+        size_t expected = 0;
+
+        for (size_t first = 0; first < collision_test_count; first++)
+        {
+            for (size_t second = first + 1; second < collision_test_count; second++)
+            {
+                if (CollisionWorld::Test(*world.Get(first), *world.Get(second)))
+                {
+                    expected++;
+                }
+            }
+        }
+
+        snprintf(buffer, buffer_size, "Contacts %d != %d", world.GetContactCount(), expected);
+        mu_assert(world.GetContactCount() == expected && world.GetStatistics().Dropped == 0, buffer);
+    }
+
+    /**
+     * @brief Collision test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(collision_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&collision_test_setup,
+                                       &collision_test_teardown,
+                                       &collision_test_output_header);
+
+        MU_RUN_TEST(collision_test_shapes);
+        MU_RUN_TEST(collision_test_states);
+        MU_RUN_TEST(collision_test_broadphase);
+    }
+}
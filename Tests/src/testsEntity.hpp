@@ -0,0 +1,183 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_entity.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Position component used by entity tests
+     */
+    struct entity_test_position
+    {
+        int32_t X;
+        int32_t Y;
+    };
+
+    /** @brief Velocity component used by entity tests
+     */
+    struct entity_test_velocity
+    {
+        int32_t X;
+        int32_t Y;
+    };
+
+    /** @brief Entity store type used by entity tests
+     */
+    using entity_test_store = EntityStore<entity_test_position, entity_test_velocity>;
+
+    /** @brief Number of entities used by entity tests
+     */
+    static constexpr size_t entity_test_count = 300;
+
+    /**
+     * @brief Set up routine for entity unit tests
+     */
+    void entity_test_setup(void)
+    {
+        // Nothing to set up
+    }
+
+    /**
+     * @brief Tear down routine for entity unit tests
+     */
+    void entity_test_teardown(void)
+    {
+        // Nothing to tear down
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void entity_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_ENTITY****");
+            }
+            else
+            {
+                LogInfo("****UT_ENTITY_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test entity creation until the store is full
+     *
+     * Verifies that store hands out valid handles up to its capacity and refuses more.
+     */
+    MU_TEST(entity_test_create_full)
+    {
+        entity_test_store store(entity_test_count);
+
+        for (size_t entity = 0; entity < entity_test_count; entity++)
+        {
+            entity_test_store::Handle handle = store.Create();
+            snprintf(buffer, buffer_size, "Entity %d has invalid handle", entity);
+            mu_assert(handle.IsValid() && store.IsAlive(handle), buffer);
+        }
+
+        snprintf(buffer, buffer_size, "Count %d != %d", store.GetCount(), entity_test_count);
+        mu_assert(store.GetCount() == entity_test_count, buffer);
+        mu_assert(!store.Create().IsValid(), "Full store created an entity");
+    }
+
+    /**
+     * @brief Test handle stability
+     *
+     * Verifies that handles keep pointing to the same data after other entities are destroyed and moved.
+     */
+    MU_TEST(entity_test_stable_handles)
+    {
+        entity_test_store store(entity_test_count);
+        entity_test_store::Handle* handles = new entity_test_store::Handle[entity_test_count];
+
+        for (size_t entity = 0; entity < entity_test_count; entity++)
+        {
+            handles[entity] = store.Create();
+            store.Get<entity_test_position>(handles[entity])->X = entity;
+        }
+
+        for (size_t entity = 0; entity < entity_test_count; entity += 3)
+        {
+            mu_assert(store.Destroy(handles[entity]), "Destroy failed");
+        }
+
+        for (size_t entity = 0; entity < entity_test_count; entity++)
+        {
+            const bool alive = store.IsAlive(handles[entity]);
+            snprintf(buffer, buffer_size, "Entity %d alive state is wrong", entity);
+            mu_assert(alive == (entity % 3 != 0), buffer);
+
+            if (alive)
+            {
+                const int32_t x = store.Get<entity_test_position>(handles[entity])->X;
+                snprintf(buffer, buffer_size, "Entity %d X: %d", entity, x);
+                mu_assert(x == static_cast<int32_t>(entity), buffer);
+            }
+        }
+
+        // Reused slot must not revive old handle
+        entity_test_store::Handle reused = store.Create();
+        mu_assert(reused.IsValid(), "Create after destroy failed");
+        mu_assert(!store.IsAlive(handles[0]), "Old handle points to reused slot");
+        mu_assert(!store.Destroy(handles[0]), "Destroyed entity was destroyed again");
+
+        delete[] handles;
+    }
+
+    /**
+     * @brief Test parallel iteration
+     *
+     * Verifies that every entity is updated exactly once when work is split between CPUs.
+     */
+    MU_TEST(entity_test_for_each_parallel)
+    {
+        entity_test_store store(entity_test_count);
+
+        for (size_t entity = 0; entity < entity_test_count; entity++)
+        {
+            entity_test_store::Handle handle = store.Create();
+            store.Get<entity_test_position>(handle)->X = entity;
+            store.Get<entity_test_velocity>(handle)->X = 2;
+        }
+
+        store.ForEachParallel<entity_test_position, entity_test_velocity>([](entity_test_position& position, entity_test_velocity& velocity)
+        {
+            position.X += velocity.X;
+        });
+
+        int32_t sum = 0;
+        store.ForEach<entity_test_position>([&sum](entity_test_position& position)
+        {
+            sum += position.X;
+        });
+
+        const int32_t expected = ((entity_test_count * (entity_test_count - 1)) / 2) + (2 * entity_test_count);
+        snprintf(buffer, buffer_size, "Sum %d != %d", sum, expected);
+        mu_assert(sum == expected, buffer);
+    }
+
+    /**
+     * @brief Entity test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(entity_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&entity_test_setup,
+                                       &entity_test_teardown,
+                                       &entity_test_output_header);
+
+        MU_RUN_TEST(entity_test_create_full);
+        MU_RUN_TEST(entity_test_stable_handles);
+        MU_RUN_TEST(entity_test_for_each_parallel);
+    }
+}
@@ -0,0 +1,189 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_lighting.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Single quad facing up used by lighting tests
+     */
+    static Types::SmoothMesh* lighting_test_quad = nullptr;
+
+    /**
+     * @brief Set up routine for lighting unit tests
+     */
+    void lighting_test_setup(void)
+    {
+        // 10x10 quad at Y = 0 with one corner at origin
+        lighting_test_quad = new Types::SmoothMesh(4, 1);
+        lighting_test_quad->Vertices[0] = Vector3D(0.0, 0.0, 0.0);
+        lighting_test_quad->Vertices[1] = Vector3D(10.0, 0.0, 0.0);
+        lighting_test_quad->Vertices[2] = Vector3D(10.0, 0.0, 10.0);
+        lighting_test_quad->Vertices[3] = Vector3D(0.0, 0.0, 10.0);
+
+        for (size_t vertex = 0; vertex < 4; vertex++)
+        {
+            lighting_test_quad->Normals[vertex] = Vector3D(0.0, -1.0, 0.0);
+        }
+
+        const uint16_t vertices[4] = { 0, 1, 2, 3 };
+        lighting_test_quad->Faces[0] = Types::Polygon(Vector3D(0.0, -1.0, 0.0), vertices);
+    }
+
+    /**
+     * @brief Tear down routine for lighting unit tests
+     */
+    void lighting_test_teardown(void)
+    {
+        delete lighting_test_quad;
+        lighting_test_quad = nullptr;
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void lighting_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_LIGHTING****");
+            }
+            else
+            {
+                LogInfo("****UT_LIGHTING_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test point light falloff
+     *
+     * Verifies vertex colors under a point light and gouraud table entry assigned to the face.
+     */
+    MU_TEST(lighting_test_point)
+    {
+        MeshLighting lighting(*lighting_test_quad, 3);
+        mu_assert(lighting_test_quad->Attributes[0].Gouraud == 0xe003, "Face does not use its gouraud entry");
+
+        // Light 10 units above first corner, it gets half of light color
+        MeshLighting::Light light(Vector3D(0.0, -10.0, 0.0), 20.0, Types::HighColor::FromRGB555(8, 8, 8));
+        mu_assert(lighting.Update(&light, 1, Vector3D()) == 1, "Light was culled");
+
+        Types::HighColor color = lighting.GetVertexColor(0);
+        snprintf(buffer, buffer_size, "Lit corner %d", color.Red);
+        mu_assert(color.Red == 20 && color.Green == 20 && color.Blue == 20, buffer);
+
+        // Neighbour corners are farther and lit at an angle
+        color = lighting.GetVertexColor(1);
+        snprintf(buffer, buffer_size, "Near corner %d", color.Red);
+        mu_assert(color.Red == 17, buffer);
+
+        // Opposite corner gets less than one step
+        mu_assert(lighting.GetVertexColor(2).Red == 16, "Far corner is lit");
+    }
+
+    /**
+     * @brief Test light culling
+     *
+     * Verifies culling by mesh bounding sphere, mesh position and cap on number of lights.
+     */
+    MU_TEST(lighting_test_culling)
+    {
+        MeshLighting lighting(*lighting_test_quad, 0);
+        MeshLighting::Light lights[SRL_MAX_MESH_LIGHTS + 2];
+
+        lights[0] = MeshLighting::Light(Vector3D(100.0, -10.0, 0.0), 20.0, Types::HighColor::FromRGB555(8, 8, 8));
+        mu_assert(lighting.Update(lights, 1, Vector3D()) == 0, "Distant light was not culled");
+        mu_assert(lighting.GetVertexColor(0).Red == 16, "Culled light affects the mesh");
+
+        // Same light reaches the mesh once it is moved under it
+        mu_assert(lighting.Update(lights, 1, Vector3D(100.0, 0.0, 0.0)) == 1, "Light over moved mesh was culled");
+        mu_assert(lighting.GetVertexColor(0).Red == 20, "Light over moved mesh has wrong intensity");
+
+        for (size_t index = 0; index < SRL_MAX_MESH_LIGHTS + 2; index++)
+        {
+            lights[index] = MeshLighting::Light(Vector3D(5.0, -10.0, 5.0), 30.0, Types::HighColor::FromRGB555(1, 1, 1));
+        }
+
+        const size_t count = lighting.Update(lights, SRL_MAX_MESH_LIGHTS + 2, Vector3D());
+        snprintf(buffer, buffer_size, "Light cap %d", static_cast<int>(count));
+        mu_assert(count == SRL_MAX_MESH_LIGHTS && lighting.GetLightCount() == count, buffer);
+    }
+
+    /**
+     * @brief Test spot light cone
+     *
+     * Verifies that spot light lights only what is inside of its cone.
+     */
+    MU_TEST(lighting_test_spot)
+    {
+        MeshLighting lighting(*lighting_test_quad, 0);
+
+        // Pointing down at the first corner, cone of 60 degrees from its axis
+        MeshLighting::Light spot(Vector3D(0.0, -10.0, 0.0), Vector3D(0.0, 1.0, 0.0), 20.0, 0.5, Types::HighColor::FromRGB555(8, 8, 8));
+        mu_assert(lighting.Update(&spot, 1, Vector3D()) == 1, "Spot light was culled");
+        mu_assert(lighting.GetVertexColor(0).Red == 20, "Spot light axis has wrong intensity");
+        mu_assert(lighting.GetVertexColor(2).Red == 16, "Corner outside of cone is lit");
+
+        // Pointing up, whole mesh is behind the light
+        spot.Direction = Vector3D(0.0, -1.0, 0.0);
+        mu_assert(lighting.Update(&spot, 1, Vector3D()) == 0, "Spot light pointing away was not culled");
+        mu_assert(lighting.GetVertexColor(0).Red == 16, "Spot light pointing away lights the mesh");
+    }
+
+    /**
+     * @brief Test baked lighting
+     *
+     * Verifies that baked faces use consecutive gouraud entries and that baked table is copied to VDP1.
+     */
+    MU_TEST(lighting_test_baked)
+    {
+        const uint16_t entry = BakedLighting::MaxEntries - 1;
+        BakedLighting::Apply(*lighting_test_quad, entry);
+        mu_assert(lighting_test_quad->Attributes[0].Gouraud == 0xe000 + entry, "Face does not use its gouraud entry");
+        mu_assert((lighting_test_quad->Attributes[0].Display & 0x7) == CL_Gouraud, "Face does not use gouraud shading");
+
+        const Types::HighColor table[4] = {
+            Types::HighColor::FromRGB555(1, 2, 3),
+            Types::HighColor::FromRGB555(16, 16, 16),
+            Types::HighColor::FromRGB555(31, 0, 0),
+            Types::HighColor::FromRGB555(0, 0, 31)
+        };
+
+        BakedLighting::Load(table, 1, entry);
+        const Types::HighColor* loaded = VDP1::GetGouraudTable() + (entry << 2);
+
+        for (size_t corner = 0; corner < 4; corner++)
+        {
+            snprintf(buffer, buffer_size, "Corner %d was not copied to gouraud table", static_cast<int>(corner));
+            mu_assert(loaded[corner].Red == table[corner].Red &&
+                loaded[corner].Green == table[corner].Green &&
+                loaded[corner].Blue == table[corner].Blue, buffer);
+        }
+    }
+
+    /**
+     * @brief Lighting test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(lighting_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&lighting_test_setup,
+                                       &lighting_test_teardown,
+                                       &lighting_test_output_header);
+
+        MU_RUN_TEST(lighting_test_point);
+        MU_RUN_TEST(lighting_test_culling);
+        MU_RUN_TEST(lighting_test_spot);
+        MU_RUN_TEST(lighting_test_baked);
+    }
+}
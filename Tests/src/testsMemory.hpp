@@ -289,6 +289,91 @@ extern "C"
         delete[] srcPtr;
     }
 
+    /**
+     * @brief Over-aligned type used to test aligned @c new
+     */
+    struct alignas(32) MemoryTestAligned
+    {
+        /** @brief Payload
+         */
+        int32_t Values[3];
+    };
+
+    /**
+     * @brief Test aligned memory allocation
+     *
+     * Verifies that aligned blocks start at requested alignment in each zone and that their space is returned when freed.
+     */
+    MU_TEST(memory_test_malloc_aligned)
+    {
+        const SRL::Memory::Zone zones[2] = { SRL::Memory::Zone::HWRam, SRL::Memory::Zone::LWRam };
+        const size_t alignments[4] = { 4, 16, 256, 4096 };
+
+        for (const SRL::Memory::Zone zone : zones)
+        {
+            for (const size_t alignment : alignments)
+            {
+                // Unaligned block in front makes sure the aligned one is not at the start of free space by chance
+                void* padding = SRL::Memory::Malloc(20, zone);
+                void* ptr = SRL::Memory::MallocAligned(100, alignment, zone);
+
+                snprintf(buffer, buffer_size, "Block %p is not aligned to %d", ptr, alignment);
+                mu_assert(ptr != nullptr && (reinterpret_cast<uint32_t>(ptr) & (alignment - 1)) == 0, buffer);
+
+                SRL::Memory::MemSet(ptr, 0xaa, 100);
+                const size_t freeAllocated = SRL::Memory::GetFreeSpace(zone);
+                SRL::Memory::Free(ptr);
+
+                snprintf(buffer, buffer_size, "Free space %d after aligned free, expected at least %d", SRL::Memory::GetFreeSpace(zone), freeAllocated + 100);
+                mu_assert(SRL::Memory::GetFreeSpace(zone) >= freeAllocated + 100, buffer);
+
+                SRL::Memory::Free(padding);
+            }
+        }
+
+        mu_assert(SRL::Memory::MallocAligned(100, 24) == nullptr, "Alignment that is not power of two was accepted");
+    }
+
+    /**
+     * @brief Test cache-through aligned allocation
+     *
+     * Verifies that cache-through flag returns uncached alias of the block and that the alias can be freed.
+     */
+    MU_TEST(memory_test_malloc_aligned_cache_through)
+    {
+        const size_t freeBefore = SRL::Memory::GetFreeSpace(SRL::Memory::Zone::HWRam);
+        uint32_t* ptr = reinterpret_cast<uint32_t*>(SRL::Memory::MallocAligned(64, 16, SRL::Memory::Zone::HWRam, true));
+
+        mu_assert(ptr != nullptr, "Cache-through allocation failed");
+        mu_assert((reinterpret_cast<uint32_t>(ptr) & 0xf0000000) == 0x20000000, "Block is not cache-through");
+
+        // Written value is visible through the cached address
+        ptr[0] = 0x12345678;
+        mu_assert(*reinterpret_cast<uint32_t*>(reinterpret_cast<uint32_t>(ptr) & 0x0fffffff) == 0x12345678, "Cached address does not see written value");
+
+        SRL::Memory::Free(ptr);
+        mu_assert(SRL::Memory::GetFreeSpace(SRL::Memory::Zone::HWRam) >= freeBefore, "Cache-through block was not freed");
+    }
+
+    /**
+     * @brief Test aligned @c new
+     *
+     * Verifies that @c new of over-aligned type respects its alignment in default and specified zone.
+     */
+    MU_TEST(memory_test_new_aligned)
+    {
+        MemoryTestAligned* first = new MemoryTestAligned();
+        MemoryTestAligned* second = new (SRL::Memory::Zone::LWRam) MemoryTestAligned[3];
+
+        mu_assert(first != nullptr && (reinterpret_cast<uint32_t>(first) & 31) == 0, "Aligned new is not aligned");
+        mu_assert(SRL::Memory::HighWorkRam::InRange(first), "Aligned new is not in HWRam");
+        mu_assert(second != nullptr && (reinterpret_cast<uint32_t>(second) & 31) == 0, "Aligned new[] is not aligned");
+        mu_assert(SRL::Memory::LowWorkRam::InRange(second), "Aligned new[] is not in LWRam");
+
+        delete first;
+        delete[] second;
+    }
+
     /**
      * @brief Memory test suite configuration and test case registration
      *
@@ -314,5 +399,8 @@ extern "C"
         MU_RUN_TEST(memory_test_move_memory_blocks_various_sizes); // Register the new test case
         MU_RUN_TEST(memory_test_move_memory_blocks_edge_cases); // Register the new test case
         MU_RUN_TEST(memory_test_move_memory_blocks_invalid_pointers); // Register the new test case
+        MU_RUN_TEST(memory_test_malloc_aligned);
+        MU_RUN_TEST(memory_test_malloc_aligned_cache_through);
+        MU_RUN_TEST(memory_test_new_aligned);
     }
 }
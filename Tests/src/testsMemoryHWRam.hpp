@@ -428,6 +428,30 @@ extern "C"
         delete[] ptr;
     }
 
+    /**
+     * @brief Test allocation into free block of exactly the requested size
+     *
+     * Verifies that block which fits exactly is returned instead of being marked as used and lost.
+     */
+    MU_TEST(memory_HWRam_test_exact_fit)
+    {
+        void* first = Memory::Malloc(64, Memory::Zone::HWRam);
+        void* hole = Memory::Malloc(64, Memory::Zone::HWRam);
+        void* last = Memory::Malloc(64, Memory::Zone::HWRam);
+        Memory::Free(hole);
+
+        const size_t freeBefore = Memory::GetFreeSpace(Memory::Zone::HWRam);
+        void* ptr = Memory::Malloc(64, Memory::Zone::HWRam);
+        mu_assert(ptr != nullptr, "Exact fit allocation failed");
+        Memory::Free(ptr);
+
+        snprintf(buffer, buffer_size, "Free space %d after exact fit, expected %d", Memory::GetFreeSpace(Memory::Zone::HWRam), freeBefore);
+        mu_assert(Memory::GetFreeSpace(Memory::Zone::HWRam) >= freeBefore, buffer);
+
+        Memory::Free(first);
+        Memory::Free(last);
+    }
+
     /**
      * @brief Test for memory leaks
      *
@@ -672,6 +696,7 @@ extern "C"
         MU_RUN_TEST(memory_HWRam_test_large_block);
         MU_RUN_TEST(memory_HWRam_test_fragmentation);
         MU_RUN_TEST(memory_HWRam_test_boundary_conditions);
+        MU_RUN_TEST(memory_HWRam_test_exact_fit);
         MU_RUN_TEST(memory_HWRam_test_deplete_highworkram);
 
         // 5. Stress and Performance Tests
@@ -301,6 +301,54 @@ extern "C"
         delete[] ptr;
     }
 
+    /** @brief Table linked to LWRam
+     */
+    SRL_LWRAM_DATA static const int32_t memory_LWRam_test_table[4] = { 10, 20, 30, 40 };
+
+    /** @brief Rarely called function linked to LWRam
+     * @param index Table index
+     * @return Table value
+     */
+    SRL_COLD static int32_t memory_LWRam_test_cold(size_t index)
+    {
+        return memory_LWRam_test_table[index];
+    }
+
+    /** @brief Frequently called function linked to HWRam
+     * @param value Value to double
+     * @return Doubled value
+     */
+    SRL_HOT static int32_t memory_LWRam_test_hot(int32_t value)
+    {
+        return value << 1;
+    }
+
+    /**
+     * @brief Test code and data linked to LowWorkRam
+     *
+     * Verifies that cold code and data were copied into LowWorkRam, hot code stays in HighWorkRam and heap does not overlap them.
+     */
+    MU_TEST(memory_LWRam_test_linked)
+    {
+        const uint32_t cold = reinterpret_cast<uint32_t>(&memory_LWRam_test_cold);
+        const uint32_t table = reinterpret_cast<uint32_t>(&memory_LWRam_test_table);
+
+        mu_assert(cold >= 0x00200000 && cold < 0x00300000, "Cold function is not linked to LowWorkRam");
+        mu_assert(table >= 0x00200000 && table < 0x00300000, "Table is not linked to LowWorkRam");
+        mu_assert(Memory::HighWorkRam::InRange(reinterpret_cast<uint32_t>(&memory_LWRam_test_hot)), "Hot function is not linked to HighWorkRam");
+
+        snprintf(buffer, buffer_size, "Expected linked value 30, got %d", memory_LWRam_test_cold(2));
+        mu_assert(memory_LWRam_test_cold(2) == 30, buffer);
+        mu_assert(memory_LWRam_test_hot(memory_LWRam_test_table[3]) == 80, "Hot function returned wrong result");
+
+        mu_assert(Memory::LowWorkRam::GetLinkedSize() > 0, "Linked size was not reported");
+        mu_assert(Memory::LowWorkRam::GetSize() + Memory::LowWorkRam::GetLinkedSize() == 0x100000, "Heap overlaps linked code and data");
+
+        void* ptr = Memory::Malloc(16, Memory::Zone::LWRam);
+        mu_assert(reinterpret_cast<uint32_t>(ptr) >= 0x00200000 + Memory::LowWorkRam::GetLinkedSize(), "Heap block overlaps linked code and data");
+        Memory::Free(ptr);
+    }
+
     /**
      * @brief Test InRange function for LowWorkRam
      *
@@ -660,6 +708,7 @@ extern "C"
         MU_RUN_TEST(memory_LWRam_test_lowworkram_get_used_space);
         MU_RUN_TEST(memory_LWRam_test_lowworkram_get_size);
         MU_RUN_TEST(memory_LWRam_test_inrange_lowworkram);
+        MU_RUN_TEST(memory_LWRam_test_linked);
 
         // 3. Edge Cases and Error Handling
         MU_RUN_TEST(memory_LWRam_test_malloc_zero);
@@ -0,0 +1,194 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include "srl_memory.hpp"
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /**
+     * @brief Task allocating and freeing memory on slave
+     */
+    class MemorySlaveTestTask : public Types::ITask
+    {
+    public:
+        /** @brief Blocks to free on slave
+         */
+        void* ToFree[2] = { nullptr, nullptr };
+
+        /** @brief Blocks allocated on slave
+         */
+        void* Allocated[2] = { nullptr, nullptr };
+
+        /** @brief Free space of the slave heap after the task finished
+         */
+        size_t FreeSpace = 0;
+
+    protected:
+        /** @brief Free requested blocks, then allocate new ones
+         */
+        void Do() override
+        {
+            slCashPurge();
+
+            for (size_t block = 0; block < 2; block++)
+            {
+                Memory::Free(this->ToFree[block]);
+            }
+
+            this->Allocated[0] = new int32_t[4];
+            this->Allocated[1] = Memory::Malloc(256, Memory::Zone::LWRam);
+            this->FreeSpace = Memory::SlaveRam::GetFreeSpace();
+        }
+    };
+
+    /**
+     * @brief Run task on slave and wait for it
+     * @param task Task to run
+     */
+    static void memory_slave_test_run(MemorySlaveTestTask& task)
+    {
+        slCashPurge();
+        Slave::ExecuteOnSlave(task);
+        while (!task.IsDone());
+        slCashPurge();
+    }
+
+    /**
+     * @brief Set up routine for slave memory unit tests
+     *
+     * Slave heap cannot be destroyed, it is created once and shared by all tests.
+     */
+    void memory_slave_test_setup(void)
+    {
+        if (!Memory::SlaveRam::IsInitialized())
+        {
+            Memory::SlaveRam::Initialize(0x4000, Memory::Zone::HWRam);
+        }
+    }
+
+    /**
+     * @brief Tear down routine for slave memory unit tests
+     */
+    void memory_slave_test_teardown(void)
+    {
+        Memory::ProcessFreeQueue();
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void memory_slave_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_MEMORY_SLAVE****");
+            }
+            else
+            {
+                LogInfo("****UT_MEMORY_SLAVE_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test slave heap creation
+     *
+     * Verifies that slave heap exists, is taken from the requested zone and cannot be created twice.
+     */
+    MU_TEST(memory_slave_test_initialize)
+    {
+        mu_assert(Memory::SlaveRam::IsInitialized(), "Slave heap was not created");
+        mu_assert(Memory::SlaveRam::GetSize() == 0x4000, "Slave heap has wrong size");
+        mu_assert(!Memory::SlaveRam::Initialize(0x4000), "Slave heap was created twice");
+
+        // Master keeps allocating from its own zones
+        void* ptr = new int32_t[4];
+        mu_assert(ptr != nullptr && !Memory::SlaveRam::InRange(ptr), "Master allocated from slave heap");
+        delete[] reinterpret_cast<int32_t*>(ptr);
+    }
+
+    /**
+     * @brief Test allocation on slave
+     *
+     * Verifies that @c new and zone allocations made on slave are served by the slave heap.
+     */
+    MU_TEST(memory_slave_test_allocate)
+    {
+        MemorySlaveTestTask task;
+        memory_slave_test_run(task);
+
+        mu_assert(task.Allocated[0] != nullptr && task.Allocated[1] != nullptr, "Slave allocation failed");
+        mu_assert(Memory::SlaveRam::InRange(task.Allocated[0]), "new on slave did not use slave heap");
+        mu_assert(Memory::SlaveRam::InRange(task.Allocated[1]), "Zone allocation on slave did not use slave heap");
+
+        // Blocks are handed back to slave
+        MemorySlaveTestTask cleanup;
+        cleanup.ToFree[0] = task.Allocated[0];
+        cleanup.ToFree[1] = task.Allocated[1];
+        memory_slave_test_run(cleanup);
+        Memory::Free(cleanup.Allocated[0]);
+        Memory::Free(cleanup.Allocated[1]);
+    }
+
+    /**
+     * @brief Test cross CPU free
+     *
+     * Verifies that blocks freed by the CPU that does not own them are released by their owner.
+     */
+    MU_TEST(memory_slave_test_cross_free)
+    {
+        MemorySlaveTestTask task;
+        memory_slave_test_run(task);
+        const size_t allocatedSpace = task.FreeSpace;
+
+        // Slave blocks freed on master are released on next slave allocation, last queued block stays in the queue
+        Memory::Free(task.Allocated[1]);
+        Memory::Free(task.Allocated[0]);
+
+        MemorySlaveTestTask next;
+        memory_slave_test_run(next);
+        snprintf(buffer, buffer_size, "Slave heap free space %d, expected more than %d", next.FreeSpace, allocatedSpace - 64);
+        mu_assert(next.FreeSpace + 64 > allocatedSpace, buffer);
+
+        // Master blocks freed on slave are released on next master allocation
+        void* first = Memory::Malloc(1024, Memory::Zone::HWRam);
+        void* second = Memory::Malloc(1024, Memory::Zone::HWRam);
+        const size_t freeBefore = Memory::GetFreeSpace(Memory::Zone::HWRam);
+
+        MemorySlaveTestTask cleanup;
+        cleanup.ToFree[0] = first;
+        cleanup.ToFree[1] = second;
+        memory_slave_test_run(cleanup);
+        Memory::ProcessFreeQueue();
+
+        mu_assert(Memory::GetFreeSpace(Memory::Zone::HWRam) >= freeBefore + 1024, "Master block freed on slave was not released");
+
+        Memory::Free(next.Allocated[0]);
+        Memory::Free(next.Allocated[1]);
+        Memory::Free(cleanup.Allocated[0]);
+        Memory::Free(cleanup.Allocated[1]);
+    }
+
+    /**
+     * @brief Slave memory test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(memory_slave_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&memory_slave_test_setup,
+                                       &memory_slave_test_teardown,
+                                       &memory_slave_test_output_header);
+
+        MU_RUN_TEST(memory_slave_test_initialize);
+        MU_RUN_TEST(memory_slave_test_allocate);
+        MU_RUN_TEST(memory_slave_test_cross_free);
+    }
+}
@@ -0,0 +1,237 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_particles.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Number of particles used by update split tests
+     */
+    static constexpr size_t particles_test_count = 200;
+
+    /**
+     * @brief Set up routine for particle unit tests
+     */
+    void particles_test_setup(void)
+    {
+        // Nothing to set up
+    }
+
+    /**
+     * @brief Tear down routine for particle unit tests
+     */
+    void particles_test_teardown(void)
+    {
+        // Nothing to tear down
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void particles_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_PARTICLES****");
+            }
+            else
+            {
+                LogInfo("****UT_PARTICLES_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Spawn particles for update split tests
+     * @param system Particle system
+     */
+    void particles_test_fill(ParticleSystem& system)
+    {
+        system.SetGravity(Vector3D(0.0, 0.125, 0.0));
+
+        for (size_t particle = 0; particle < particles_test_count; particle++)
+        {
+            system.Spawn(
+                Vector3D(Fxp::BuildRaw(static_cast<int32_t>(particle) << 16), 0.0, Fxp::BuildRaw(-(static_cast<int32_t>(particle) << 12))),
+                Vector3D(Fxp::BuildRaw(static_cast<int32_t>(particle & 7) << 14), -1.0, 0.5),
+                (particle % 5) + 1);
+        }
+    }
+
+    /**
+     * @brief Test spawning single particles
+     *
+     * Verifies stored position, rejection of particles with no life and of particles over the pool capacity.
+     */
+    MU_TEST(particles_test_spawn)
+    {
+        ParticleSystem system(4);
+
+        mu_assert(system.Spawn(Vector3D(1.0, 2.0, 3.0), Vector3D(), 10), "Particle was not spawned");
+        mu_assert(!system.Spawn(Vector3D(), Vector3D(), 0), "Particle without life was spawned");
+        mu_assert(system.GetCount() == 1, "Particle count is wrong");
+
+        const Vector3D position = system.GetPosition(0);
+        mu_assert(position.X == Fxp(1.0) && position.Y == Fxp(2.0) && position.Z == Fxp(3.0), "Particle position is wrong");
+
+        mu_assert(system.Spawn(Vector3D(), Vector3D(), 10), "Second particle was not spawned");
+        mu_assert(system.Spawn(Vector3D(), Vector3D(), 10), "Third particle was not spawned");
+        mu_assert(system.Spawn(Vector3D(), Vector3D(), 10), "Fourth particle was not spawned");
+        mu_assert(!system.Spawn(Vector3D(), Vector3D(), 10), "Particle was spawned into full pool");
+        mu_assert(system.GetCount() == system.GetCapacity(), "Full pool count is wrong");
+
+        system.Clear();
+        mu_assert(system.GetCount() == 0, "Clear did not remove particles");
+    }
+
+    /**
+     * @brief Test emitter rate accumulation
+     *
+     * Verifies that fractional rates carry over between frames and that bursts stop at pool capacity.
+     */
+    MU_TEST(particles_test_emitter_rate)
+    {
+        ParticleSystem system(16);
+        ParticleSystem::Emitter emitter;
+        emitter.Rate = 0.25;
+
+        for (uint8_t frame = 0; frame < 3; frame++)
+        {
+            snprintf(buffer, buffer_size, "Frame %d spawned particle at rate 0.25", frame);
+            mu_assert(system.Emit(emitter) == 0, buffer);
+        }
+
+        mu_assert(system.Emit(emitter) == 1, "Accumulated rate did not spawn particle on fourth frame");
+        mu_assert(system.GetCount() == 1, "Accumulated rate spawned wrong number of particles");
+
+        emitter.Rate = 2.5;
+        const size_t expected[4] = { 2, 3, 2, 3 };
+
+        for (uint8_t frame = 0; frame < 4; frame++)
+        {
+            const size_t spawned = system.Emit(emitter);
+            snprintf(buffer, buffer_size, "Frame %d spawned %d particles instead of %d", frame, spawned, expected[frame]);
+            mu_assert(spawned == expected[frame], buffer);
+        }
+
+        mu_assert(system.GetCount() == 11, "Particle count is wrong");
+        mu_assert(system.Burst(emitter, 10) == 5, "Burst did not stop at pool capacity");
+        mu_assert(system.GetCount() == system.GetCapacity(), "Pool is not full");
+    }
+
+    /**
+     * @brief Test removal of dead particles
+     *
+     * Verifies that particles whose life or scale ran out are removed and live ones are kept with their data.
+     */
+    MU_TEST(particles_test_compact)
+    {
+        ParticleSystem system(10);
+        int32_t expectedSum = 0;
+
+        // Even particles live one frame, odd ones three frames
+        for (size_t particle = 0; particle < 10; particle++)
+        {
+            system.Spawn(Vector3D(Fxp::BuildRaw(static_cast<int32_t>(particle) << 16), 0.0, 0.0), Vector3D(), (particle & 1) != 0 ? 3 : 1);
+            expectedSum += (particle & 1) != 0 ? particle : 0;
+        }
+
+        system.Update();
+        snprintf(buffer, buffer_size, "%d particles left instead of 5", system.GetCount());
+        mu_assert(system.GetCount() == 5, buffer);
+
+        int32_t sum = 0;
+
+        for (size_t particle = 0; particle < system.GetCount(); particle++)
+        {
+            sum += system.GetPosition(particle).X.RawValue() >> 16;
+        }
+
+        snprintf(buffer, buffer_size, "Live particles are wrong, sum %d != %d", sum, expectedSum);
+        mu_assert(sum == expectedSum, buffer);
+
+        system.Update();
+        system.Update();
+        mu_assert(system.GetCount() == 0, "Particles outlived their life");
+
+        // Particle shrinking to zero dies before its life runs out
+        system.Spawn(Vector3D(), Vector3D(), 100, 1.0, -0.5);
+        system.Update();
+        mu_assert(system.GetCount() == 1, "Shrinking particle died too early");
+        system.Update();
+        mu_assert(system.GetCount() == 0, "Particle with zero scale was not removed");
+    }
+
+    /**
+     * @brief Test splitting update between CPUs
+     *
+     * Verifies that any slave share, including the whole pool, moves and removes particles same as master alone.
+     */
+    MU_TEST(particles_test_update_split)
+    {
+        const uint16_t shares[3] = { 64, 128, 256 };
+        ParticleSystem master(particles_test_count);
+        particles_test_fill(master);
+
+        for (uint8_t frame = 0; frame < 3; frame++)
+        {
+            master.Update();
+        }
+
+        for (uint16_t share : shares)
+        {
+            ParticleSystem split(particles_test_count);
+            particles_test_fill(split);
+
+            for (uint8_t frame = 0; frame < 3; frame++)
+            {
+                split.Update(share);
+            }
+
+            snprintf(buffer, buffer_size, "Share %d left %d particles instead of %d", share, split.GetCount(), master.GetCount());
+            mu_assert(split.GetCount() == master.GetCount(), buffer);
+
+            for (size_t particle = 0; particle < master.GetCount(); particle++)
+            {
+                const Vector3D expected = master.GetPosition(particle);
+                const Vector3D position = split.GetPosition(particle);
+                snprintf(buffer, buffer_size, "Share %d particle %d position differs", share, particle);
+                mu_assert(position.X == expected.X && position.Y == expected.Y && position.Z == expected.Z, buffer);
+            }
+        }
+
+        // Particles integrated on slave move by velocity and gravity
+        ParticleSystem single(1);
+        single.SetGravity(Vector3D(0.0, 0.5, 0.0));
+        single.Spawn(Vector3D(), Vector3D(1.0, -1.0, 2.0), 10);
+        single.Update(256);
+
+        const Vector3D position = single.GetPosition(0);
+        mu_assert(position.X == Fxp(1.0) && position.Y == Fxp(-0.5) && position.Z == Fxp(2.0), "Slave integration result is wrong");
+    }
+
+    /**
+     * @brief Particle system test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(particles_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&particles_test_setup,
+                                       &particles_test_teardown,
+                                       &particles_test_output_header);
+
+        MU_RUN_TEST(particles_test_spawn);
+        MU_RUN_TEST(particles_test_emitter_rate);
+        MU_RUN_TEST(particles_test_compact);
+        MU_RUN_TEST(particles_test_update_split);
+    }
+}
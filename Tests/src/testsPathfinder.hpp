@@ -0,0 +1,203 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_pathfinder.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Tilemap;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Grid size used by path finder tests
+     */
+    static constexpr uint16_t pathfinder_test_size = 32;
+
+    /** @brief Path buffer used by path finder tests
+     */
+    static Coord pathfinder_test_path[pathfinder_test_size * pathfinder_test_size];
+
+    /**
+     * @brief Set up routine for path finder unit tests
+     */
+    void pathfinder_test_setup(void)
+    {
+        // Nothing to set up
+    }
+
+    /**
+     * @brief Tear down routine for path finder unit tests
+     */
+    void pathfinder_test_teardown(void)
+    {
+        // Nothing to tear down
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void pathfinder_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_PATHFINDER****");
+            }
+            else
+            {
+                LogInfo("****UT_PATHFINDER_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Check that path is continuous and walkable
+     * @param finder Path finder
+     * @param length Path length
+     * @return True if path is valid
+     */
+    bool pathfinder_test_is_valid(PathFinder& finder, const size_t length)
+    {
+        for (size_t step = 0; step < length; step++)
+        {
+            if (!finder.IsPassable(pathfinder_test_path[step]))
+            {
+                return false;
+            }
+
+            if (step > 0)
+            {
+                const int32_t dx = Math::Abs(static_cast<int32_t>(pathfinder_test_path[step].X) - pathfinder_test_path[step - 1].X);
+                const int32_t dy = Math::Abs(static_cast<int32_t>(pathfinder_test_path[step].Y) - pathfinder_test_path[step - 1].Y);
+
+                if (dx > 1 || dy > 1 || dx + dy == 0)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Test path on an open grid
+     *
+     * Verifies path length with and without diagonal moves.
+     */
+    MU_TEST(pathfinder_test_open)
+    {
+        PathFinder finder(pathfinder_test_size, pathfinder_test_size);
+
+        mu_assert(finder.Find(Coord(0, 0), Coord(10, 5)) == PathFinder::Status::Found, "Path not found");
+        size_t length = finder.GetPath(pathfinder_test_path, pathfinder_test_size * pathfinder_test_size);
+        snprintf(buffer, buffer_size, "Straight path length %d != 16", length);
+        mu_assert(length == 16, buffer);
+        mu_assert(pathfinder_test_is_valid(finder, length), "Straight path is not valid");
+        mu_assert(pathfinder_test_path[0].X == 0 && pathfinder_test_path[0].Y == 0, "Path does not begin at start");
+        mu_assert(pathfinder_test_path[15].X == 10 && pathfinder_test_path[15].Y == 5, "Path does not end at goal");
+
+        finder.SetDiagonal(true);
+        mu_assert(finder.Find(Coord(0, 0), Coord(10, 5)) == PathFinder::Status::Found, "Diagonal path not found");
+        length = finder.GetPath(pathfinder_test_path, pathfinder_test_size * pathfinder_test_size);
+        snprintf(buffer, buffer_size, "Diagonal path length %d != 11", length);
+        mu_assert(length == 11, buffer);
+        mu_assert(pathfinder_test_is_valid(finder, length), "Diagonal path is not valid");
+    }
+
+    /**
+     * @brief Test path around walls
+     *
+     * Verifies that path goes through a gap in a wall, and that closed wall has no path.
+     */
+    MU_TEST(pathfinder_test_wall)
+    {
+        PathFinder finder(pathfinder_test_size, pathfinder_test_size);
+
+        for (uint16_t y = 0; y < pathfinder_test_size; y++)
+        {
+            finder.SetPassable(Coord(16, y), y == 30);
+        }
+
+        mu_assert(finder.Find(Coord(2, 2), Coord(28, 2)) == PathFinder::Status::Found, "Path through gap not found");
+        const size_t length = finder.GetPath(pathfinder_test_path, pathfinder_test_size * pathfinder_test_size);
+        mu_assert(pathfinder_test_is_valid(finder, length), "Path through gap is not valid");
+
+        bool throughGap = false;
+
+        for (size_t step = 0; step < length; step++)
+        {
+            throughGap |= pathfinder_test_path[step].X == 16 && pathfinder_test_path[step].Y == 30;
+        }
+
+        mu_assert(throughGap, "Path does not go through the gap");
+
+        finder.SetPassable(Coord(16, 30), false);
+        mu_assert(finder.Find(Coord(2, 2), Coord(28, 2)) == PathFinder::Status::NotFound, "Path through closed wall found");
+    }
+
+    /**
+     * @brief Test search spread over several steps
+     *
+     * Verifies iteration budget, and that repeated search is answered from remembered paths.
+     */
+    MU_TEST(pathfinder_test_budget)
+    {
+        PathFinder finder(pathfinder_test_size, pathfinder_test_size);
+
+        mu_assert(finder.Start(Coord(0, 0), Coord(31, 31)) == PathFinder::Status::Searching, "Search did not start");
+
+        while (finder.Step(8) == PathFinder::Status::Searching);
+
+        snprintf(buffer, buffer_size, "Search took %d steps", finder.GetStatistics().Steps);
+        mu_assert(finder.GetStatus() == PathFinder::Status::Found && finder.GetStatistics().Steps > 1, buffer);
+
+        const size_t length = finder.GetPath(pathfinder_test_path, pathfinder_test_size * pathfinder_test_size);
+        mu_assert(finder.Start(Coord(0, 0), Coord(31, 31)) == PathFinder::Status::Found, "Repeated search was not remembered");
+        mu_assert(finder.GetStatistics().CacheHits == 1, "Cache hit was not counted");
+        mu_assert(finder.GetPath(pathfinder_test_path, pathfinder_test_size * pathfinder_test_size) == length, "Remembered path has different length");
+    }
+
+    /**
+     * @brief Test hierarchical search
+     *
+     * Verifies that search limited to cluster route finds a valid path around walls.
+     */
+    MU_TEST(pathfinder_test_hierarchy)
+    {
+        PathFinder finder(pathfinder_test_size, pathfinder_test_size);
+        finder.SetHierarchy(8);
+
+        // Two walls forming a zig-zag corridor
+        for (uint16_t y = 0; y < pathfinder_test_size; y++)
+        {
+            finder.SetPassable(Coord(10, y), y > 28);
+            finder.SetPassable(Coord(21, y), y < 3);
+        }
+
+        mu_assert(finder.Find(Coord(1, 1), Coord(30, 30)) == PathFinder::Status::Found, "Hierarchical path not found");
+        const size_t length = finder.GetPath(pathfinder_test_path, pathfinder_test_size * pathfinder_test_size);
+        mu_assert(pathfinder_test_is_valid(finder, length), "Hierarchical path is not valid");
+        mu_assert(pathfinder_test_path[length - 1].X == 30 && pathfinder_test_path[length - 1].Y == 30, "Hierarchical path does not end at goal");
+    }
+
+    /**
+     * @brief Path finder test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(pathfinder_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&pathfinder_test_setup,
+                                       &pathfinder_test_teardown,
+                                       &pathfinder_test_output_header);
+
+        MU_RUN_TEST(pathfinder_test_open);
+        MU_RUN_TEST(pathfinder_test_wall);
+        MU_RUN_TEST(pathfinder_test_budget);
+        MU_RUN_TEST(pathfinder_test_hierarchy);
+    }
+}
@@ -0,0 +1,277 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_renderer.hpp>
+#include <srl_split_screen.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Two 20x20 quads facing camera, first one at Z = 20, second one at Z = 100
+     */
+    static Types::Mesh* renderer_test_mesh = nullptr;
+
+    /** @brief Number of textures loaded before renderer tests, renderer command tables are allocated after them
+     */
+    static uint16_t renderer_test_textures = 0;
+
+    /**
+     * @brief Set up routine for renderer unit tests
+     */
+    void renderer_test_setup(void)
+    {
+        renderer_test_textures = VDP1::GetTextureCount();
+        renderer_test_mesh = new Types::Mesh(8, 2);
+
+        for (size_t quad = 0; quad < 2; quad++)
+        {
+            const Fxp depth = quad == 0 ? 20.0 : 100.0;
+            renderer_test_mesh->Vertices[(quad * 4) + 0] = Vector3D(-10.0, -10.0, depth);
+            renderer_test_mesh->Vertices[(quad * 4) + 1] = Vector3D(10.0, -10.0, depth);
+            renderer_test_mesh->Vertices[(quad * 4) + 2] = Vector3D(10.0, 10.0, depth);
+            renderer_test_mesh->Vertices[(quad * 4) + 3] = Vector3D(-10.0, 10.0, depth);
+
+            const uint16_t vertices[4] = {
+                static_cast<uint16_t>(quad * 4),
+                static_cast<uint16_t>((quad * 4) + 1),
+                static_cast<uint16_t>((quad * 4) + 2),
+                static_cast<uint16_t>((quad * 4) + 3) };
+
+            renderer_test_mesh->Faces[quad] = Types::Polygon(Vector3D(0.0, 0.0, -1.0), vertices);
+            renderer_test_mesh->Attributes[quad] = Types::Attribute(
+                Types::Attribute::FaceVisibility::SingleSided,
+                Types::Attribute::SortMode::Center,
+                No_Texture,
+                Types::HighColor::FromRGB555(quad == 0 ? 31 : 0, 0, quad == 0 ? 0 : 31),
+                0,
+                CL32KRGB,
+                sprPolygon,
+                No_Option);
+        }
+
+        Scene3D::LoadIdentity();
+    }
+
+    /**
+     * @brief Tear down routine for renderer unit tests
+     */
+    void renderer_test_teardown(void)
+    {
+        delete renderer_test_mesh;
+        renderer_test_mesh = nullptr;
+        VDP1::ResetTextureHeap(renderer_test_textures);
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void renderer_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_RENDERER****");
+            }
+            else
+            {
+                LogInfo("****UT_RENDERER_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test drawing order
+     *
+     * Verifies that commands are written back to front regardless of the order faces were drawn in.
+     */
+    MU_TEST(renderer_test_order)
+    {
+        Renderer3D renderer(8, 8);
+        renderer.Begin();
+        mu_assert(renderer.Draw(*renderer_test_mesh), "Mesh was not drawn");
+        mu_assert(renderer.End(), "Command table was not submitted");
+
+        const Renderer3D::Statistics& statistics = renderer.GetStatistics();
+        snprintf(buffer, buffer_size, "Expected 2 commands, got %d", statistics.Commands);
+        mu_assert(statistics.Commands == 2, buffer);
+
+        const SPRITE* table = renderer.GetCommandTable();
+        mu_assert(table[0].COLR == renderer_test_mesh->Attributes[1].ColorMode, "Far quad is not drawn first");
+        mu_assert(table[1].COLR == renderer_test_mesh->Attributes[0].ColorMode, "Near quad is not drawn last");
+        mu_assert(table[0].XB - table[0].XA < table[1].XB - table[1].XA, "Far quad is not smaller on screen");
+        mu_assert((table[2].CTRL & 0x7000) == 0x7000, "Command table does not return to SGL list");
+    }
+
+    /**
+     * @brief Test culling
+     *
+     * Verifies that faces facing away and faces behind camera produce no commands.
+     */
+    MU_TEST(renderer_test_culling)
+    {
+        Renderer3D renderer(8, 8);
+
+        // Near quad faces away from camera
+        renderer_test_mesh->Faces[0].Normal = Vector3D(0.0, 0.0, 1.0);
+        renderer.Begin();
+        renderer.Draw(*renderer_test_mesh);
+        renderer.End();
+        mu_assert(renderer.GetStatistics().Commands == 1, "Back face was drawn");
+        mu_assert(renderer.GetStatistics().Culled == 1, "Back face was not counted as culled");
+
+        // Whole mesh behind camera
+        Scene3D::Translate(0.0, 0.0, -200.0);
+        renderer.Begin();
+        renderer.Draw(*renderer_test_mesh);
+        renderer.End();
+        mu_assert(renderer.GetStatistics().Commands == 0, "Mesh behind camera was drawn");
+    }
+
+    /**
+     * @brief Test near plane clipping
+     *
+     * Verifies that quad crossing the near plane is clipped into a pentagon drawn as two commands,
+     * and that textured quad keeps one command.
+     */
+    MU_TEST(renderer_test_clipping)
+    {
+        Renderer3D renderer(8, 8);
+
+        // Floor quad with one corner behind camera
+        renderer_test_mesh->Vertices[0] = Vector3D(-10.0, 10.0, -10.0);
+        renderer_test_mesh->Vertices[1] = Vector3D(10.0, 10.0, 10.0);
+        renderer_test_mesh->Vertices[2] = Vector3D(10.0, 10.0, 30.0);
+        renderer_test_mesh->Vertices[3] = Vector3D(-10.0, 10.0, 30.0);
+        renderer_test_mesh->Faces[0].Normal = Vector3D(0.0, -1.0, 0.0);
+        renderer_test_mesh->FaceCount = 1;
+
+        renderer.Begin();
+        renderer.Draw(*renderer_test_mesh);
+        renderer.End();
+        mu_assert(renderer.GetStatistics().Clipped == 1, "Quad was not clipped");
+        snprintf(buffer, buffer_size, "Clipped quad should be 2 commands, got %d", renderer.GetStatistics().Commands);
+        mu_assert(renderer.GetStatistics().Commands == 2, buffer);
+
+        // Corners of textured quad are moved onto the near plane instead
+        renderer_test_mesh->Attributes[0].Sort |= UseTexture;
+        renderer_test_mesh->Attributes[0].Direction = FUNC_Texture;
+        renderer.Begin();
+        renderer.Draw(*renderer_test_mesh);
+        renderer.End();
+        mu_assert(renderer.GetStatistics().Commands == 1, "Clipped textured quad was split");
+    }
+
+    /**
+     * @brief Test runtime limits
+     *
+     * Verifies that commands over the limit are dropped and meshes with too many vertices are refused.
+     */
+    MU_TEST(renderer_test_limits)
+    {
+        Renderer3D renderer(8, 1);
+        renderer.Begin();
+        renderer.Draw(*renderer_test_mesh);
+        renderer.End();
+        mu_assert(renderer.GetStatistics().Commands == 1, "Command limit was exceeded");
+        mu_assert(renderer.GetStatistics().Dropped == 1, "Dropped face was not counted");
+
+        renderer_test_mesh->VertexCount = 4;
+        Renderer3D tiny(2, 1);
+        tiny.Begin();
+        mu_assert(!tiny.Draw(*renderer_test_mesh), "Mesh over vertex limit was drawn");
+        tiny.End();
+    }
+
+    /**
+     * @brief Test viewport
+     *
+     * Verifies that projection is centered in the viewport and that the table sets and restores user clipping around the commands.
+     */
+    MU_TEST(renderer_test_viewport)
+    {
+        Renderer3D renderer(8, 8);
+        renderer.SetViewport(0, 0, (TV::Width >> 1) - 1, TV::Height - 1);
+        renderer_test_mesh->FaceCount = 1;
+        renderer.Begin();
+        renderer.Draw(*renderer_test_mesh);
+        renderer.End();
+        mu_assert(renderer.GetStatistics().Commands == 1, "Quad was not drawn");
+
+        const SPRITE* table = renderer.GetCommandTable();
+        mu_assert(table[0].CTRL == 0x0008 && table[0].XC == (TV::Width >> 1) - 1, "Table does not start with user clipping of the viewport");
+        mu_assert((table[1].PMOD & 0x0400) != 0, "Command does not use user clipping");
+
+        const int32_t middle = (table[1].XA + table[1].XB) >> 1;
+        snprintf(buffer, buffer_size, "Quad should be centered at %d, got %d", -(TV::Width >> 2), middle);
+        mu_assert(middle >= -(TV::Width >> 2) - 1 && middle <= -(TV::Width >> 2), buffer);
+        mu_assert(table[2].CTRL == 0x0008 && table[2].XC == TV::Width - 1, "User clipping is not restored");
+        mu_assert((table[3].CTRL & 0x7000) == 0x7000, "Command table does not return to SGL list");
+    }
+
+    /**
+     * @brief Test split screen
+     *
+     * Verifies that objects are culled per viewport and visible ones are drawn in every viewport.
+     */
+    MU_TEST(renderer_test_split_screen)
+    {
+        SplitScreen screen(2, 4, 8, 8);
+        screen.SetCamera(0, Vector3D(0.0, 0.0, 0.0), Vector3D(0.0, 0.0, 1.0), Angle::FromDegrees(0.0));
+        screen.SetCamera(1, Vector3D(0.0, 0.0, -100.0), Vector3D(0.0, 0.0, 1.0), Angle::FromDegrees(0.0));
+        renderer_test_mesh->FaceCount = 1;
+
+        for (size_t vertex = 0; vertex < 4; vertex++)
+        {
+            renderer_test_mesh->Vertices[vertex].Z = 0.0;
+        }
+
+        screen.Begin();
+        Scene3D::LoadIdentity();
+        Scene3D::Translate(0.0, 0.0, 50.0);
+        mu_assert(screen.Add(*renderer_test_mesh, 15.0), "Object was not added");
+
+        // Far to the side of both cameras
+        Scene3D::LoadIdentity();
+        Scene3D::Translate(1000.0, 0.0, 50.0);
+        screen.Add(*renderer_test_mesh, 15.0);
+        screen.End();
+
+        for (uint8_t viewport = 0; viewport < 2; viewport++)
+        {
+            snprintf(buffer, buffer_size, "Viewport %d culled %d objects, expected 1", viewport, screen.GetCulledObjects(viewport));
+            mu_assert(screen.GetCulledObjects(viewport) == 1, buffer);
+            snprintf(buffer, buffer_size, "Viewport %d drew %d commands, expected 1", viewport, screen.GetRenderer(viewport).GetStatistics().Commands);
+            mu_assert(screen.GetRenderer(viewport).GetStatistics().Commands == 1, buffer);
+        }
+
+        // Second camera is further away
+        const SPRITE* near = screen.GetRenderer(0).GetCommandTable();
+        const SPRITE* far = screen.GetRenderer(1).GetCommandTable();
+        mu_assert(far[1].XB - far[1].XA < near[1].XB - near[1].XA, "Viewports do not use their own cameras");
+    }
+
+    /**
+     * @brief Renderer test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(renderer_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&renderer_test_setup,
+                                       &renderer_test_teardown,
+                                       &renderer_test_output_header);
+
+        MU_RUN_TEST(renderer_test_order);
+        MU_RUN_TEST(renderer_test_culling);
+        MU_RUN_TEST(renderer_test_clipping);
+        MU_RUN_TEST(renderer_test_limits);
+        MU_RUN_TEST(renderer_test_viewport);
+        MU_RUN_TEST(renderer_test_split_screen);
+    }
+}
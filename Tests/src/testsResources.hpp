@@ -0,0 +1,224 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_resources.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /**
+     * @brief Set up routine for resource cache unit tests
+     */
+    void resources_test_setup(void)
+    {
+        // Test files are in the ROOT directory
+        SRL::Cd::ChangeDir("ROOT");
+    }
+
+    /**
+     * @brief Tear down routine for resource cache unit tests
+     */
+    void resources_test_teardown(void)
+    {
+        // Leave cache empty and without budget for the next test
+        Resources::SetBudget(Memory::Zone::HWRam, 0);
+        Resources::Flush();
+        SRL::Cd::ChangeDir(static_cast<const char*>(nullptr));
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void resources_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_RESOURCES****");
+            }
+            else
+            {
+                LogInfo("****UT_RESOURCES_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test acquiring same file twice
+     *
+     * Verifies that both acquires share one resource, data is loaded only on first access and only once,
+     * and that acquiring the file for another zone gives a separate resource.
+     */
+    MU_TEST(resources_test_acquire_dedup)
+    {
+        const Resources::Statistics before = Resources::GetStatistics();
+        Resources::Handle first = Resources::Acquire("FILE1.TXT");
+        Resources::Handle second = Resources::Acquire("FILE1.TXT");
+
+        mu_assert(first.IsValid(), "Acquire of existing file failed");
+        mu_assert(first.Slot == second.Slot && first.Generation == second.Generation, "Same file got two resources");
+        mu_assert(Resources::GetReferences(first) == 2, "Second acquire did not add reference");
+        mu_assert(Resources::GetState(first) == Resources::State::Unloaded, "Resource was loaded before first access");
+        mu_assert(Resources::GetStatistics().Misses == before.Misses + 1 && Resources::GetStatistics().Hits == before.Hits + 1, "Acquire statistics are wrong");
+
+        const char* data = Resources::Get<char>(first);
+        mu_assert(data != nullptr, "Resource could not be loaded");
+        snprintf(buffer, buffer_size, "Resource contents are wrong: %.14s", data);
+        mu_assert(strncmp(data, "File 1 Content", 14) == 0, buffer);
+        mu_assert(Resources::GetSize(first) == 14, "Resource size is wrong");
+
+        mu_assert(Resources::Get<char>(second) == data, "Second handle returned different data");
+        mu_assert(Resources::GetStatistics().Loads == before.Loads + 1, "Resource was loaded more than once");
+
+        mu_assert(!Resources::Acquire("MISSING.TXT").IsValid(), "Acquire of missing file returned valid handle");
+
+        // Same file in another zone is a separate resource
+        Resources::Handle other = Resources::Acquire("FILE1.TXT", Memory::Zone::LWRam);
+        mu_assert(other.IsValid() && other.Slot != first.Slot, "Same file in another zone shares resource");
+        mu_assert(Resources::GetReferences(first) == 2, "Acquire for another zone added reference");
+        Resources::Release(other);
+
+        Resources::Release(first);
+        Resources::Release(second);
+    }
+
+    /**
+     * @brief Test releasing references
+     *
+     * Verifies that released resource stays cached while unreferenced and that never loaded resource is dropped right away.
+     */
+    MU_TEST(resources_test_release)
+    {
+        Resources::Handle handle = Resources::Acquire("FILE1.TXT");
+        Resources::AddReference(handle);
+        const void* data = Resources::Get(handle);
+
+        Resources::Release(handle);
+        mu_assert(Resources::GetReferences(handle) == 1, "Release did not drop reference");
+        mu_assert(Resources::GetState(handle) == Resources::State::Loaded, "Referenced resource was unloaded");
+
+        Resources::Release(handle);
+        mu_assert(Resources::GetReferences(handle) == 0, "Last release did not drop reference");
+        mu_assert(Resources::GetState(handle) == Resources::State::Loaded, "Released resource was not kept cached");
+        mu_assert(Resources::GetUsage(Memory::Zone::HWRam) == 14, "Cached resource is not counted in zone usage");
+
+        // Acquiring cached resource again does not load it again
+        const uint32_t loads = Resources::GetStatistics().Loads;
+        Resources::Handle again = Resources::Acquire("FILE1.TXT");
+        mu_assert(Resources::Get(again) == data && Resources::GetStatistics().Loads == loads, "Cached resource was loaded again");
+        Resources::Release(again);
+
+        // Nothing to keep cached for resource that was never loaded
+        Resources::Handle unused = Resources::Acquire("FILE2.TXT");
+        Resources::Release(unused);
+        mu_assert(Resources::GetState(unused) == Resources::State::Failed, "Unloaded resource kept its slot after release");
+    }
+
+    /**
+     * @brief Test eviction under budget
+     *
+     * Verifies that least recently used unreferenced resources are evicted first when loading would exceed the budget.
+     */
+    MU_TEST(resources_test_eviction_order)
+    {
+        Resources::SetBudget(Memory::Zone::HWRam, 30);
+
+        // FILE1.TXT and FILE2.TXT are 14 bytes each, FILE1.TXT is used last
+        Resources::Handle file2 = Resources::Acquire("FILE2.TXT");
+        Resources::Handle file1 = Resources::Acquire("FILE1.TXT");
+        Resources::Get(file2);
+        Resources::Get(file1);
+        Resources::Release(file2);
+        Resources::Release(file1);
+        mu_assert(Resources::GetUsage(Memory::Zone::HWRam) == 28, "Zone usage is wrong");
+
+        // FILE.TXT is 16 bytes, one resource has to go
+        const uint32_t evictions = Resources::GetStatistics().Evictions;
+        Resources::Handle file = Resources::Acquire("FILE.TXT");
+        mu_assert(Resources::Get(file) != nullptr, "Resource could not be loaded within budget");
+
+        snprintf(buffer, buffer_size, "Zone usage %d is over budget", Resources::GetUsage(Memory::Zone::HWRam));
+        mu_assert(Resources::GetUsage(Memory::Zone::HWRam) <= 30, buffer);
+        mu_assert(Resources::GetStatistics().Evictions == evictions + 1, "More than one resource was evicted");
+        mu_assert(Resources::GetState(file2) != Resources::State::Loaded, "Least recently used resource was not evicted");
+        mu_assert(Resources::GetState(file1) == Resources::State::Loaded, "Recently used resource was evicted");
+
+        Resources::Release(file);
+    }
+
+    /**
+     * @brief Test referenced resource under budget
+     *
+     * Verifies that resource still referenced is never evicted, even when the zone stays over its budget.
+     */
+    MU_TEST(resources_test_pinned)
+    {
+        Resources::Handle pinned = Resources::Acquire("FILE1.TXT");
+        Resources::Handle other = Resources::Acquire("FILE2.TXT");
+        const void* data = Resources::Get(pinned);
+        Resources::Get(other);
+        Resources::Release(other);
+
+        Resources::SetBudget(Memory::Zone::HWRam, 1);
+        mu_assert(Resources::GetState(other) != Resources::State::Loaded, "Unreferenced resource over budget was not evicted");
+        mu_assert(Resources::GetState(pinned) == Resources::State::Loaded, "Referenced resource was evicted by budget");
+
+        Resources::Flush();
+        mu_assert(Resources::GetState(pinned) == Resources::State::Loaded, "Referenced resource was evicted by flush");
+        mu_assert(Resources::Get(pinned) == data, "Referenced resource data moved");
+        mu_assert(Resources::GetUsage(Memory::Zone::HWRam) == 14, "Zone usage is wrong");
+
+        Resources::Release(pinned);
+    }
+
+    /**
+     * @brief Test handle of evicted resource
+     *
+     * Verifies that handle of a resource evicted after release is stale, even once its slot is reused.
+     */
+    MU_TEST(resources_test_stale_handle)
+    {
+        Resources::Handle handle = Resources::Acquire("FILE1.TXT");
+        Resources::Get(handle);
+        Resources::Release(handle);
+        Resources::Flush();
+
+        mu_assert(Resources::GetState(handle) == Resources::State::Failed, "Evicted resource handle is not stale");
+        mu_assert(Resources::Get(handle) == nullptr, "Stale handle returned data");
+        mu_assert(Resources::GetReferences(handle) == 0 && Resources::GetSize(handle) == 0, "Stale handle reports resource");
+
+        // Slot is reused by the next acquire, old handle must not see the new resource
+        Resources::Handle reused = Resources::Acquire("FILE2.TXT");
+        mu_assert(reused.Slot != handle.Slot || reused.Generation != handle.Generation, "New resource got the stale handle");
+        mu_assert(Resources::Get(handle) == nullptr, "Stale handle returned data of reused slot");
+
+        // Releasing stale handle does not touch the new resource
+        Resources::Release(handle);
+        mu_assert(Resources::GetReferences(reused) == 1, "Stale handle released reference of reused slot");
+
+        Resources::Release(reused);
+    }
+
+    /**
+     * @brief Resource cache test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(resources_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&resources_test_setup,
+                                       &resources_test_teardown,
+                                       &resources_test_output_header);
+
+        MU_RUN_TEST(resources_test_acquire_dedup);
+        MU_RUN_TEST(resources_test_release);
+        MU_RUN_TEST(resources_test_eviction_order);
+        MU_RUN_TEST(resources_test_pinned);
+        MU_RUN_TEST(resources_test_stale_handle);
+    }
+}
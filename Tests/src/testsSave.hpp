@@ -0,0 +1,216 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_save.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Save data used by slot tests (spans several chunks)
+     */
+    struct save_test_data
+    {
+        uint32_t Score;
+        uint8_t Flags[600];
+        uint32_t Checksum;
+    };
+
+    /**
+     * @brief Set up routine for save unit tests
+     */
+    void save_test_setup(void)
+    {
+        Save::Initialize();
+    }
+
+    /**
+     * @brief Tear down routine for save unit tests
+     *
+     * Removes test slot from internal backup memory.
+     */
+    void save_test_teardown(void)
+    {
+        Save::Slot<save_test_data> slot("SRLTEST");
+        slot.Delete();
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void save_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_SAVE****");
+            }
+            else
+            {
+                LogInfo("****UT_SAVE_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Fill save data with test pattern
+     * @param data Data to fill
+     */
+    static void save_test_fill(save_test_data& data)
+    {
+        data.Score = 123456;
+
+        for (size_t index = 0; index < sizeof(data.Flags); index++)
+        {
+            data.Flags[index] = index < 300 ? 0 : static_cast<uint8_t>(index * 7);
+        }
+
+        data.Checksum = 0xdeadbeef;
+    }
+
+    /**
+     * @brief Test CRC32 calculation
+     *
+     * Verifies standard check value and calculation in parts.
+     */
+    MU_TEST(save_test_crc)
+    {
+        const char* text = "123456789";
+        uint32_t crc = Save::Crc32(text, 9);
+
+        snprintf(buffer, buffer_size, "CRC32: %x != cbf43926", crc);
+        mu_assert(crc == 0xcbf43926, buffer);
+
+        crc = Save::Crc32(text + 4, 5, Save::Crc32(text, 4));
+        snprintf(buffer, buffer_size, "CRC32 in parts: %x != cbf43926", crc);
+        mu_assert(crc == 0xcbf43926, buffer);
+    }
+
+    /**
+     * @brief Test compression round trip
+     *
+     * Verifies that runs are compressed and data is restored unchanged.
+     */
+    MU_TEST(save_test_compression)
+    {
+        uint8_t source[200];
+        uint8_t compressed[200];
+        uint8_t restored[200];
+
+        for (size_t index = 0; index < sizeof(source); index++)
+        {
+            source[index] = index < 150 ? 0x55 : static_cast<uint8_t>(index);
+        }
+
+        size_t size = Save::Compress(source, sizeof(source), compressed, sizeof(compressed));
+        snprintf(buffer, buffer_size, "Compressed size: %d", size);
+        mu_assert(size > 0 && size < sizeof(source), buffer);
+
+        size_t restoredSize = Save::Decompress(compressed, size, restored, sizeof(restored));
+        snprintf(buffer, buffer_size, "Decompressed size: %d != %d", restoredSize, sizeof(source));
+        mu_assert(restoredSize == sizeof(source), buffer);
+
+        for (size_t index = 0; index < sizeof(source); index++)
+        {
+            snprintf(buffer, buffer_size, "Byte %d: %x != %x", index, restored[index], source[index]);
+            mu_assert(restored[index] == source[index], buffer);
+        }
+    }
+
+    /**
+     * @brief Test slot write and read
+     *
+     * Verifies that data written into slot is read back unchanged.
+     */
+    MU_TEST(save_test_slot_write_read)
+    {
+        if (!Save::IsConnected(Save::Device::Internal))
+        {
+            LogWarning("Internal backup memory is not available, skipping");
+            return;
+        }
+
+        Save::Slot<save_test_data> slot("SRLTEST");
+        save_test_data data;
+        save_test_data loaded = { };
+        save_test_fill(data);
+
+        Save::Result result = slot.Write(data);
+        snprintf(buffer, buffer_size, "Write result: %d", static_cast<int32_t>(result));
+        mu_assert(result == Save::Result::Ok, buffer);
+
+        Save::Slot<save_test_data> other("SRLTEST");
+        result = other.Read(loaded);
+        snprintf(buffer, buffer_size, "Read result: %d", static_cast<int32_t>(result));
+        mu_assert(result == Save::Result::Ok, buffer);
+
+        snprintf(buffer, buffer_size, "Score: %d != %d", loaded.Score, data.Score);
+        mu_assert(loaded.Score == data.Score, buffer);
+        snprintf(buffer, buffer_size, "Checksum: %x != %x", loaded.Checksum, data.Checksum);
+        mu_assert(loaded.Checksum == data.Checksum, buffer);
+
+        for (size_t index = 0; index < sizeof(data.Flags); index++)
+        {
+            snprintf(buffer, buffer_size, "Flag %d: %x != %x", index, loaded.Flags[index], data.Flags[index]);
+            mu_assert(loaded.Flags[index] == data.Flags[index], buffer);
+        }
+    }
+
+    /**
+     * @brief Test delta writes
+     *
+     * Verifies that unchanged chunks are skipped and only modified chunk is rewritten.
+     */
+    MU_TEST(save_test_slot_delta)
+    {
+        if (!Save::IsConnected(Save::Device::Internal))
+        {
+            LogWarning("Internal backup memory is not available, skipping");
+            return;
+        }
+
+        Save::Slot<save_test_data> slot("SRLTEST");
+        save_test_data data;
+        save_test_fill(data);
+
+        mu_assert(slot.Write(data) == Save::Result::Ok, "First write failed");
+
+        mu_assert(slot.Write(data) == Save::Result::Ok, "Second write failed");
+        snprintf(buffer, buffer_size, "Unchanged write transferred %d chunks", slot.GetTiming().ChunksTransferred);
+        mu_assert(slot.GetTiming().ChunksTransferred == 0, buffer);
+
+        data.Score++;
+        mu_assert(slot.Write(data) == Save::Result::Ok, "Third write failed");
+        snprintf(buffer, buffer_size, "Modified write transferred %d chunks", slot.GetTiming().ChunksTransferred);
+        mu_assert(slot.GetTiming().ChunksTransferred == 1, buffer);
+        snprintf(buffer, buffer_size, "Modified write skipped %d chunks", slot.GetTiming().ChunksSkipped);
+        mu_assert(slot.GetTiming().ChunksSkipped == 2, buffer);
+
+        save_test_data loaded = { };
+        Save::Slot<save_test_data> other("SRLTEST");
+        mu_assert(other.Read(loaded) == Save::Result::Ok, "Read after delta write failed");
+        snprintf(buffer, buffer_size, "Score: %d != %d", loaded.Score, data.Score);
+        mu_assert(loaded.Score == data.Score, buffer);
+    }
+
+    /**
+     * @brief Save test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(save_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&save_test_setup,
+                                       &save_test_teardown,
+                                       &save_test_output_header);
+
+        MU_RUN_TEST(save_test_crc);
+        MU_RUN_TEST(save_test_compression);
+        MU_RUN_TEST(save_test_slot_write_read);
+        MU_RUN_TEST(save_test_slot_delta);
+    }
+}
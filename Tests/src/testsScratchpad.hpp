@@ -0,0 +1,126 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_scratchpad.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Value linked to the scratchpad
+     */
+    SRL_SCRATCHPAD_DATA static int32_t scratchpad_test_value = 1234;
+
+    /** @brief Function linked to the scratchpad
+     * @param values Values to sum
+     * @param count Number of values
+     * @return Sum of values
+     */
+    SRL_SCRATCHPAD_CODE static int32_t scratchpad_test_sum(const int32_t* values, size_t count)
+    {
+        int32_t sum = 0;
+
+        for (size_t index = 0; index < count; index++)
+        {
+            sum += values[index];
+        }
+
+        return sum;
+    }
+
+    /**
+     * @brief Set up routine for scratchpad unit tests
+     */
+    void scratchpad_test_setup(void)
+    {
+        Scratchpad::Enable();
+    }
+
+    /**
+     * @brief Tear down routine for scratchpad unit tests
+     */
+    void scratchpad_test_teardown(void)
+    {
+        Scratchpad::Disable();
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void scratchpad_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_SCRATCHPAD****");
+            }
+            else
+            {
+                LogInfo("****UT_SCRATCHPAD_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test code and data linked to the scratchpad
+     *
+     * Verifies that linked value is copied into the scratchpad and linked function can be called there.
+     */
+    MU_TEST(scratchpad_test_linked)
+    {
+        mu_assert(Scratchpad::IsEnabled(), "Scratchpad was not enabled");
+        mu_assert(reinterpret_cast<uint32_t>(&scratchpad_test_value) >= 0xc0000000 &&
+            reinterpret_cast<uint32_t>(&scratchpad_test_value) < 0xc0000000 + Scratchpad::Size, "Value is not linked to the scratchpad");
+
+        snprintf(buffer, buffer_size, "Expected linked value 1234, got %d", scratchpad_test_value);
+        mu_assert(scratchpad_test_value == 1234, buffer);
+
+        const int32_t values[4] = { 1, 2, 3, 4 };
+        mu_assert(scratchpad_test_sum(values, 4) == 10, "Function in scratchpad returned wrong result");
+        mu_assert(Scratchpad::GetUsed() == Scratchpad::GetLinkedSize(), "Linked code and data are not reserved");
+    }
+
+    /**
+     * @brief Test runtime allocations
+     *
+     * Verifies that copied data is readable from the scratchpad and that allocations stop at its end.
+     */
+    MU_TEST(scratchpad_test_allocate)
+    {
+        const int32_t values[3] = { 10, 20, 30 };
+        const int32_t* copy = reinterpret_cast<const int32_t*>(Scratchpad::Copy(values, sizeof(values)));
+        mu_assert(copy != nullptr, "Copy failed");
+        mu_assert(copy[0] == 10 && copy[1] == 20 && copy[2] == 30, "Copied data differs");
+        mu_assert(scratchpad_test_sum(copy, 3) == 60, "Function in scratchpad failed on data in scratchpad");
+
+        mu_assert(Scratchpad::Allocate(Scratchpad::Size) == nullptr, "Allocation larger than free space succeeded");
+        mu_assert(Scratchpad::Allocate(Scratchpad::Size - Scratchpad::GetUsed()) != nullptr, "Allocation of free space failed");
+        mu_assert(Scratchpad::Allocate(1) == nullptr, "Allocation in full scratchpad succeeded");
+
+        Scratchpad::Release();
+        mu_assert(Scratchpad::GetUsed() == Scratchpad::GetLinkedSize(), "Release did not free allocations");
+
+        Scratchpad::Disable();
+        mu_assert(!Scratchpad::IsEnabled(), "Scratchpad was not disabled");
+        mu_assert(Scratchpad::Allocate(4) == nullptr, "Allocation in disabled scratchpad succeeded");
+    }
+
+    /**
+     * @brief Scratchpad test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(scratchpad_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&scratchpad_test_setup,
+                                       &scratchpad_test_teardown,
+                                       &scratchpad_test_output_header);
+
+        MU_RUN_TEST(scratchpad_test_linked);
+        MU_RUN_TEST(scratchpad_test_allocate);
+    }
+}
@@ -0,0 +1,215 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_scudsp.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Number of points used by transform tests (more than single DSP batch)
+     */
+    static constexpr size_t scudsp_test_point_count = 50;
+
+    /** @brief Test transformation matrix in SGL layout (rotation rows followed by translation)
+     */
+    static FIXED scudsp_test_matrix[4][3] = {
+        { 0x0000ddb3, 0x00000000, -0x00008000 },
+        { 0x00000000, 0x00010000, 0x00000000 },
+        { 0x00008000, 0x00000000, 0x0000ddb3 },
+        { 0x00018000, -0x00020000, 0x00280000 }
+    };
+
+    /**
+     * @brief Set up routine for SCU DSP unit tests
+     */
+    void scudsp_test_setup(void)
+    {
+        // Nothing to set up
+    }
+
+    /**
+     * @brief Tear down routine for SCU DSP unit tests
+     *
+     * Stops any program left running by a failed test.
+     */
+    void scudsp_test_teardown(void)
+    {
+        ScuDsp::Stop();
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void scudsp_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_SCUDSP****");
+            }
+            else
+            {
+                LogInfo("****UT_SCUDSP_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Fill points used by transform tests
+     * @param points Points to fill
+     */
+    static void scudsp_test_fill_points(Vector3D* points)
+    {
+        for (size_t point = 0; point < scudsp_test_point_count; point++)
+        {
+            int32_t value = static_cast<int32_t>(point) - 25;
+            points[point] = Vector3D(
+                Fxp::BuildRaw(value << 16),
+                Fxp::BuildRaw((value * 3) << 14),
+                Fxp::BuildRaw(-(value << 15)));
+        }
+    }
+
+    /**
+     * @brief Test data RAM write and read back
+     *
+     * Verifies that words written to every data RAM bank can be read back unchanged.
+     */
+    MU_TEST(scudsp_test_data_ram)
+    {
+        uint32_t written[8] = { 1, 2, 3, 0xffffffff, 0x80000000, 0x12345678, 0, 42 };
+        uint32_t read[8] = { };
+
+        for (uint8_t bank = 0; bank < 4; bank++)
+        {
+            ScuDsp::WriteData(static_cast<ScuDsp::DataBank>(bank), 10, written, 8);
+            ScuDsp::ReadData(static_cast<ScuDsp::DataBank>(bank), 10, read, 8);
+
+            for (size_t word = 0; word < 8; word++)
+            {
+                snprintf(buffer, buffer_size, "Bank %d word %d: %x != %x", bank, word, read[word], written[word]);
+                mu_assert(read[word] == written[word], buffer);
+            }
+        }
+    }
+
+    /**
+     * @brief Test DSP point transform kernel
+     *
+     * Verifies that points transformed by the DSP match points transformed on the CPU.
+     */
+    MU_TEST(scudsp_test_point_transform)
+    {
+        Vector3D* points = new Vector3D[scudsp_test_point_count];
+        Vector3D* expected = new Vector3D[scudsp_test_point_count];
+        Vector3D* result = new Vector3D[scudsp_test_point_count];
+        scudsp_test_fill_points(points);
+
+        ScuDsp::PointTransform::TransformOnCpu(scudsp_test_matrix, points, expected, scudsp_test_point_count);
+        ScuDsp::PointTransform::Load(scudsp_test_matrix);
+        ScuDsp::PointTransform::Transform(points, result, scudsp_test_point_count);
+
+        for (size_t point = 0; point < scudsp_test_point_count; point++)
+        {
+            snprintf(buffer, buffer_size, "Point %d X: %x != %x", point, result[point].X.RawValue(), expected[point].X.RawValue());
+            mu_assert(SRL::Math::Abs(result[point].X.RawValue() - expected[point].X.RawValue()) <= 1, buffer);
+            snprintf(buffer, buffer_size, "Point %d Y: %x != %x", point, result[point].Y.RawValue(), expected[point].Y.RawValue());
+            mu_assert(SRL::Math::Abs(result[point].Y.RawValue() - expected[point].Y.RawValue()) <= 1, buffer);
+            snprintf(buffer, buffer_size, "Point %d Z: %x != %x", point, result[point].Z.RawValue(), expected[point].Z.RawValue());
+            mu_assert(SRL::Math::Abs(result[point].Z.RawValue() - expected[point].Z.RawValue()) <= 1, buffer);
+        }
+
+        delete[] points;
+        delete[] expected;
+        delete[] result;
+    }
+
+    /**
+     * @brief Test DSP point transform kernel against SGL
+     *
+     * Verifies that points transformed by the DSP match points transformed by slCalcPoint with the same matrix.
+     */
+    MU_TEST(scudsp_test_point_transform_sgl)
+    {
+        Vector3D* points = new Vector3D[scudsp_test_point_count];
+        Vector3D* result = new Vector3D[scudsp_test_point_count];
+        scudsp_test_fill_points(points);
+
+        ScuDsp::PointTransform::Load(scudsp_test_matrix);
+        ScuDsp::PointTransform::Transform(points, result, scudsp_test_point_count);
+
+        slPushMatrix();
+        slLoadMatrix(scudsp_test_matrix);
+
+        for (size_t point = 0; point < scudsp_test_point_count; point++)
+        {
+            FIXED expected[XYZ];
+            slCalcPoint(points[point].X.RawValue(), points[point].Y.RawValue(), points[point].Z.RawValue(), expected);
+
+            snprintf(buffer, buffer_size, "Point %d X: %x != slCalcPoint %x", point, result[point].X.RawValue(), expected[X]);
+            mu_assert(SRL::Math::Abs(result[point].X.RawValue() - expected[X]) <= 1, buffer);
+            snprintf(buffer, buffer_size, "Point %d Y: %x != slCalcPoint %x", point, result[point].Y.RawValue(), expected[Y]);
+            mu_assert(SRL::Math::Abs(result[point].Y.RawValue() - expected[Y]) <= 1, buffer);
+            snprintf(buffer, buffer_size, "Point %d Z: %x != slCalcPoint %x", point, result[point].Z.RawValue(), expected[Z]);
+            mu_assert(SRL::Math::Abs(result[point].Z.RawValue() - expected[Z]) <= 1, buffer);
+        }
+
+        slPopMatrix();
+
+        delete[] points;
+        delete[] result;
+    }
+
+    /**
+     * @brief Test parallel point transform
+     *
+     * Verifies that points split between DSP, slave and master match points transformed on the CPU.
+     */
+    MU_TEST(scudsp_test_point_transform_parallel)
+    {
+        Vector3D* points = new Vector3D[scudsp_test_point_count];
+        Vector3D* expected = new Vector3D[scudsp_test_point_count];
+        Vector3D* result = new Vector3D[scudsp_test_point_count];
+        scudsp_test_fill_points(points);
+
+        ScuDsp::PointTransform::TransformOnCpu(scudsp_test_matrix, points, expected, scudsp_test_point_count);
+        ScuDsp::PointTransform::TransformParallel(scudsp_test_matrix, points, result, scudsp_test_point_count);
+
+        for (size_t point = 0; point < scudsp_test_point_count; point++)
+        {
+            snprintf(buffer, buffer_size, "Point %d X: %x != %x", point, result[point].X.RawValue(), expected[point].X.RawValue());
+            mu_assert(SRL::Math::Abs(result[point].X.RawValue() - expected[point].X.RawValue()) <= 1, buffer);
+            snprintf(buffer, buffer_size, "Point %d Y: %x != %x", point, result[point].Y.RawValue(), expected[point].Y.RawValue());
+            mu_assert(SRL::Math::Abs(result[point].Y.RawValue() - expected[point].Y.RawValue()) <= 1, buffer);
+            snprintf(buffer, buffer_size, "Point %d Z: %x != %x", point, result[point].Z.RawValue(), expected[point].Z.RawValue());
+            mu_assert(SRL::Math::Abs(result[point].Z.RawValue() - expected[point].Z.RawValue()) <= 1, buffer);
+        }
+
+        delete[] points;
+        delete[] expected;
+        delete[] result;
+    }
+
+    /**
+     * @brief SCU DSP test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(scudsp_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&scudsp_test_setup,
+                                       &scudsp_test_teardown,
+                                       &scudsp_test_output_header);
+
+        MU_RUN_TEST(scudsp_test_data_ram);
+        MU_RUN_TEST(scudsp_test_point_transform);
+        MU_RUN_TEST(scudsp_test_point_transform_sgl);
+        MU_RUN_TEST(scudsp_test_point_transform_parallel);
+    }
+}
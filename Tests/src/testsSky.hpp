@@ -0,0 +1,130 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_sky.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /**
+     * @brief Set up routine for sky unit tests
+     */
+    void sky_test_setup(void)
+    {
+        // Nothing to set up
+    }
+
+    /**
+     * @brief Tear down routine for sky unit tests
+     */
+    void sky_test_teardown(void)
+    {
+        // Nothing to tear down
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void sky_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_SKY****");
+            }
+            else
+            {
+                LogInfo("****UT_SKY_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Check that two angles are close to each other
+     * @param angle Computed angle
+     * @param expected Expected raw angle
+     * @return True if angles differ by less than 0.1 degree
+     */
+    static bool sky_test_angle_near(const Angle& angle, const uint16_t expected)
+    {
+        const int16_t difference = static_cast<int16_t>(angle.RawValue() - expected);
+        return difference > -19 && difference < 19;
+    }
+
+    /**
+     * @brief Test camera orientation
+     *
+     * Verifies yaw and pitch computed from camera and target points.
+     */
+    MU_TEST(sky_test_orientation)
+    {
+        const Vector3D camera(10.0, -5.0, 20.0);
+
+        Sky::Orientation orientation = Sky::Orientation::FromLookAt(camera, Vector3D(10.0, -5.0, 120.0));
+        snprintf(buffer, buffer_size, "Forward yaw %d pitch %d", orientation.Yaw.RawValue(), orientation.Pitch.RawValue());
+        mu_assert(sky_test_angle_near(orientation.Yaw, 0) && sky_test_angle_near(orientation.Pitch, 0), buffer);
+
+        orientation = Sky::Orientation::FromLookAt(camera, Vector3D(60.0, -5.0, 20.0));
+        snprintf(buffer, buffer_size, "Right yaw %d", orientation.Yaw.RawValue());
+        mu_assert(sky_test_angle_near(orientation.Yaw, 0x4000), buffer);
+
+        orientation = Sky::Orientation::FromLookAt(camera, Vector3D(-40.0, -5.0, -30.0));
+        snprintf(buffer, buffer_size, "Back left yaw %d", orientation.Yaw.RawValue());
+        mu_assert(sky_test_angle_near(orientation.Yaw, 0xa000), buffer);
+
+        // Negative Y is up
+        orientation = Sky::Orientation::FromLookAt(camera, Vector3D(10.0, -35.0, 50.0));
+        snprintf(buffer, buffer_size, "Up pitch %d", orientation.Pitch.RawValue());
+        mu_assert(sky_test_angle_near(orientation.Pitch, 0x2000), buffer);
+    }
+
+    /**
+     * @brief Test panorama scrolling
+     *
+     * Verifies that yaw scrolls the panorama by its width per turn and pitch moves the horizon.
+     */
+    MU_TEST(sky_test_panorama)
+    {
+        Sky::Panorama<VDP2::NBG0> sky(512, 200);
+
+        // Half turn scrolls by half of width, middle of the screen stays on the turned column
+        Vector2D position = sky.GetPosition(Sky::Orientation(Angle::BuildRaw(0x8000), Angle::Zero()));
+        snprintf(buffer, buffer_size, "Half turn X %d", position.X.RawValue());
+        mu_assert(position.X == Fxp(256 - (TV::Width >> 1)), buffer);
+
+        // Looking forward wraps around to the end of the panorama
+        position = sky.GetPosition(Sky::Orientation());
+        snprintf(buffer, buffer_size, "Wrapped X %d", position.X.RawValue());
+        mu_assert(position.X == Fxp(512 - (TV::Width >> 1)), buffer);
+
+        // Level camera keeps horizon row in the middle of the screen
+        const Vector2D level = sky.GetPosition(Sky::Orientation());
+        mu_assert(level.Y == Fxp(200 - (TV::Height >> 1)), "Horizon is not centered");
+
+        // Looking up moves horizon down the screen, so panorama scrolls up
+        const Vector2D up = sky.GetPosition(Sky::Orientation(Angle::Zero(), Angle::BuildRaw(0x1000)));
+        const Vector2D steep = sky.GetPosition(Sky::Orientation(Angle::Zero(), Angle::BuildRaw(0x3fff)));
+        mu_assert(up.Y < level.Y && steep.Y < up.Y, "Horizon does not follow pitch");
+    }
+
+    /**
+     * @brief Sky test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(sky_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&sky_test_setup,
+                                       &sky_test_teardown,
+                                       &sky_test_output_header);
+
+        MU_RUN_TEST(sky_test_orientation);
+        MU_RUN_TEST(sky_test_panorama);
+    }
+}
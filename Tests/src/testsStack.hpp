@@ -0,0 +1,136 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_stack.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /**
+     * @brief Use some stack
+     * @param depth Recursion depth
+     * @return Sum of buffer values, keeps the buffer from being optimized away
+     */
+    __attribute__((noinline)) static uint32_t stack_test_recurse(uint8_t depth)
+    {
+        volatile uint8_t data[64];
+
+        for (uint8_t index = 0; index < 64; index++)
+        {
+            data[index] = depth;
+        }
+
+        return data[depth & 63] + (depth > 0 ? stack_test_recurse(depth - 1) : 0);
+    }
+
+    /**
+     * @brief Task using some stack on slave
+     */
+    class StackTestTask : public Types::ITask
+    {
+    public:
+        /** @brief Recursion depth
+         */
+        uint8_t Depth = 0;
+
+    protected:
+        /** @brief Recurse on slave
+         */
+        void Do() override
+        {
+            stack_test_recurse(this->Depth);
+        }
+    };
+
+    /**
+     * @brief Set up routine for stack unit tests
+     */
+    void stack_test_setup(void)
+    {
+        Stack::Paint();
+    }
+
+    /**
+     * @brief Tear down routine for stack unit tests
+     */
+    void stack_test_teardown(void)
+    {
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void stack_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_STACK****");
+            }
+            else
+            {
+                LogInfo("****UT_STACK_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test master stack report
+     *
+     * Verifies that deeper calls raise the high-water mark and that the guard stays intact.
+     */
+    MU_TEST(stack_test_master)
+    {
+        const Stack::Report before = Stack::GetReport(Stack::Cpu::Master);
+        mu_assert(before.Size == SRL_MASTER_STACK_SIZE, "Wrong master stack size");
+        mu_assert(before.HighWater > 0 && before.HighWater < before.Size, "Master stack was not painted");
+        mu_assert(before.HighWater + before.Free == before.Size, "Report does not add up");
+
+        stack_test_recurse(16);
+        const Stack::Report after = Stack::GetReport(Stack::Cpu::Master);
+        snprintf(buffer, buffer_size, "High-water %d did not grow from %d", after.HighWater, before.HighWater);
+        mu_assert(after.HighWater >= before.HighWater + (8 * 64), buffer);
+        mu_assert(!after.Overflow && Stack::Check(Stack::Cpu::Master), "Master stack guard reports overflow");
+    }
+
+    /**
+     * @brief Test slave stack report
+     *
+     * Verifies that stack used by slave task is measured from master.
+     */
+    MU_TEST(stack_test_slave)
+    {
+        const Stack::Report before = Stack::GetReport(Stack::Cpu::Slave);
+        mu_assert(before.Size == SRL_SLAVE_STACK_SIZE, "Wrong slave stack size");
+
+        StackTestTask task;
+        task.Depth = 8;
+        Slave::ExecuteOnSlave(task);
+        while (!task.IsDone());
+
+        const Stack::Report after = Stack::GetReport(Stack::Cpu::Slave);
+        snprintf(buffer, buffer_size, "High-water %d did not grow from %d", after.HighWater, before.HighWater);
+        mu_assert(after.HighWater >= before.HighWater + (4 * 64), buffer);
+        mu_assert(!after.Overflow && Stack::Check(Stack::Cpu::Slave), "Slave stack guard reports overflow");
+    }
+
+    /**
+     * @brief Stack test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(stack_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&stack_test_setup,
+                                       &stack_test_teardown,
+                                       &stack_test_output_header);
+
+        MU_RUN_TEST(stack_test_master);
+        MU_RUN_TEST(stack_test_slave);
+    }
+}
@@ -0,0 +1,135 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_terrain.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /** @brief Heightmap width used by terrain tests (4 blocks)
+     */
+    static constexpr uint16_t terrain_test_width = 256;
+
+    /** @brief Heightmap height used by terrain tests (2 blocks)
+     */
+    static constexpr uint16_t terrain_test_height = 128;
+
+    /** @brief Heightmap used by terrain tests
+     */
+    static uint8_t* terrain_test_map = nullptr;
+
+    /**
+     * @brief Set up routine for terrain unit tests
+     */
+    void terrain_test_setup(void)
+    {
+        // Ramp going up along X, repeating every 128 samples
+        terrain_test_map = reinterpret_cast<uint8_t*>(Memory::Malloc(terrain_test_width * terrain_test_height, Memory::Zone::LWRam));
+
+        for (size_t y = 0; y < terrain_test_height; y++)
+        {
+            for (size_t x = 0; x < terrain_test_width; x++)
+            {
+                terrain_test_map[(y * terrain_test_width) + x] = (x & 127) << 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Tear down routine for terrain unit tests
+     */
+    void terrain_test_teardown(void)
+    {
+        Memory::Free(terrain_test_map);
+        terrain_test_map = nullptr;
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void terrain_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_TERRAIN****");
+            }
+            else
+            {
+                LogInfo("****UT_TERRAIN_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test terrain height query
+     *
+     * Verifies height on samples, between samples, and outside of loaded window.
+     */
+    MU_TEST(terrain_test_height)
+    {
+        Terrain terrain(terrain_test_map, terrain_test_width, terrain_test_height, 2, 4.0, 0.5);
+        mu_assert(terrain.Update(Vector3D(8.0, 0.0, 8.0), 4), "Window was not loaded");
+
+        // Sample 10 has value 20, scaled by 0.5 and pointing up
+        Fxp height = terrain.GetHeight(40.0, 12.0);
+        snprintf(buffer, buffer_size, "Height on sample %d", height.RawValue());
+        mu_assert(height == Fxp(-10.0), buffer);
+
+        // Half way between samples 10 and 11
+        height = terrain.GetHeight(42.0, 12.0);
+        snprintf(buffer, buffer_size, "Height between samples %d", height.RawValue());
+        mu_assert(height == Fxp(-10.5), buffer);
+
+        // Block 3 is outside of the window
+        mu_assert(terrain.GetHeight(800.0, 12.0) == Fxp(0.0), "Height outside of window is not zero");
+    }
+
+    /**
+     * @brief Test streaming of blocks
+     *
+     * Verifies that moving the camera loads blocks of new window one by one, nearest first.
+     */
+    MU_TEST(terrain_test_stream)
+    {
+        Terrain terrain(terrain_test_map, terrain_test_width, terrain_test_height, 2, 4.0, 0.5);
+
+        mu_assert(!terrain.Update(Vector3D(8.0, 0.0, 8.0), 3), "Window was loaded over the limit");
+        mu_assert(terrain.GetStatistics().Loaded == 3 && terrain.GetStatistics().Pending == 1, "Wrong number of loaded blocks");
+        mu_assert(terrain.Update(Vector3D(8.0, 0.0, 8.0)), "Window was not loaded");
+
+        // Move to the last block column, window shifts by two blocks
+        const Vector3D camera(1000.0, 0.0, 8.0);
+        mu_assert(!terrain.Update(camera), "Moved window was loaded at once");
+        snprintf(buffer, buffer_size, "Pending blocks %d", terrain.GetStatistics().Pending);
+        mu_assert(terrain.GetStatistics().Loaded == 1 && terrain.GetStatistics().Pending == 3, buffer);
+
+        // Block under the camera is loaded first
+        mu_assert(terrain.GetHeight(1000.0, 8.0) == Fxp(-(((250 & 127) << 1) * 0.5)), "Block under camera was not loaded first");
+
+        while (!terrain.Update(camera));
+
+        mu_assert(terrain.GetHeight(600.0, 500.0) != Fxp(0.0), "Moved window was not loaded");
+    }
+
+    /**
+     * @brief Terrain test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(terrain_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&terrain_test_setup,
+                                       &terrain_test_teardown,
+                                       &terrain_test_output_header);
+
+        MU_RUN_TEST(terrain_test_height);
+        MU_RUN_TEST(terrain_test_stream);
+    }
+}
@@ -0,0 +1,228 @@
+#include <srl.hpp>
+#include <srl_log.hpp>
+#include <srl_texture_lod.hpp>
+
+// https://github.com/siu/minunit
+#include "minunit.h"
+
+using namespace SRL;
+using namespace SRL::Math::Types;
+
+extern "C"
+{
+    extern const uint8_t buffer_size;
+    extern char buffer[];
+
+    /**
+     * @brief 32x32 RGB555 bitmap with columns alternating between two colors
+     */
+    class TextureLodTestBitmap : public SRL::Bitmap::IBitmap
+    {
+    public:
+        uint16_t data[32 * 32];
+
+        TextureLodTestBitmap()
+        {
+            for (size_t pixel = 0; pixel < 32 * 32; pixel++)
+            {
+                data[pixel] = (pixel & 1) != 0 ? 0x801f : 0x8001;
+            }
+        }
+
+        uint8_t* GetData() override
+        {
+            return reinterpret_cast<uint8_t*>(data);
+        }
+
+        SRL::Bitmap::BitmapInfo GetInfo() override
+        {
+            return SRL::Bitmap::BitmapInfo(32, 32);
+        }
+    };
+
+    /** @brief Single 20x20 quad facing camera
+     */
+    static Types::Mesh* texture_lod_test_mesh = nullptr;
+
+    /** @brief Test texture
+     */
+    static TextureLodTestBitmap* texture_lod_test_bitmap = nullptr;
+
+    /** @brief Number of textures loaded before texture LOD tests
+     */
+    static uint16_t texture_lod_test_textures = 0;
+
+    /** @brief Move test quad
+     * @param depth Distance from camera
+     */
+    static void texture_lod_test_place(const Fxp& depth)
+    {
+        texture_lod_test_mesh->Vertices[0] = Vector3D(-10.0, -10.0, depth);
+        texture_lod_test_mesh->Vertices[1] = Vector3D(10.0, -10.0, depth);
+        texture_lod_test_mesh->Vertices[2] = Vector3D(10.0, 10.0, depth);
+        texture_lod_test_mesh->Vertices[3] = Vector3D(-10.0, 10.0, depth);
+    }
+
+    /**
+     * @brief Set up routine for texture LOD unit tests
+     */
+    void texture_lod_test_setup(void)
+    {
+        texture_lod_test_textures = VDP1::GetTextureCount();
+        texture_lod_test_bitmap = new TextureLodTestBitmap();
+        texture_lod_test_mesh = new Types::Mesh(4, 1);
+        texture_lod_test_place(20.0);
+
+        const uint16_t vertices[4] = { 0, 1, 2, 3 };
+        texture_lod_test_mesh->Faces[0] = Types::Polygon(Vector3D(0.0, 0.0, -1.0), vertices);
+        texture_lod_test_mesh->Attributes[0] = Types::Attribute(
+            Types::Attribute::FaceVisibility::SingleSided,
+            Types::Attribute::SortMode::Center,
+            0,
+            No_Palet,
+            No_Gouraud,
+            CL32KRGB,
+            sprNoflip,
+            No_Option);
+
+        Scene3D::LoadIdentity();
+    }
+
+    /**
+     * @brief Tear down routine for texture LOD unit tests
+     */
+    void texture_lod_test_teardown(void)
+    {
+        delete texture_lod_test_mesh;
+        texture_lod_test_mesh = nullptr;
+        delete texture_lod_test_bitmap;
+        texture_lod_test_bitmap = nullptr;
+        VDP1::ResetTextureHeap(texture_lod_test_textures);
+    }
+
+    /**
+     * @brief Output header for test suite error reporting
+     */
+    void texture_lod_test_output_header(void)
+    {
+        if (!suite_error_counter++)
+        {
+            if (Log::GetLogLevel() == Logger::LogLevels::TESTING)
+            {
+                LogDebug("****UT_TEXTURE_LOD****");
+            }
+            else
+            {
+                LogInfo("****UT_TEXTURE_LOD_ERROR(S)****");
+            }
+        }
+    }
+
+    /**
+     * @brief Test building of LOD chain
+     *
+     * Verifies that texture is halved down to 8 pixels wide level, which is the only one in VDP1 memory at first.
+     */
+    MU_TEST(texture_lod_test_chain)
+    {
+        TextureLod lod(4096, 1);
+        const int32_t texture = lod.Add(texture_lod_test_bitmap);
+        mu_assert(texture >= 0, "Texture was not added");
+
+        snprintf(buffer, buffer_size, "Expected 3 levels, got %d", lod.GetLevelCount(texture));
+        mu_assert(lod.GetLevelCount(texture) == 3, buffer);
+        mu_assert(lod.GetLevel(texture) == 2, "Smallest level is not drawn at first");
+        mu_assert(VDP1::Textures[texture].Width == 8 && VDP1::Textures[texture].Height == 8, "Texture entry does not point at smallest level");
+
+        // Neighboring columns are averaged
+        const uint16_t* level = reinterpret_cast<const uint16_t*>(lod.GetLevelData(texture, 1));
+        snprintf(buffer, buffer_size, "Expected averaged pixel 0x8010, got 0x%x", level[0]);
+        mu_assert(level[0] == 0x8010, buffer);
+    }
+
+    /**
+     * @brief Test level selection
+     *
+     * Verifies that near face loads the full size level and far face goes back to the smallest one.
+     */
+    MU_TEST(texture_lod_test_selection)
+    {
+        TextureLod lod(4096, 1);
+        const int32_t texture = lod.Add(texture_lod_test_bitmap);
+        texture_lod_test_mesh->Attributes[0].Texture = texture;
+
+        lod.Request(*texture_lod_test_mesh);
+        lod.Update();
+        mu_assert(lod.GetStatistics().Loads == 1, "Full size level was not loaded");
+        mu_assert(lod.GetLevel(texture) == 2, "Level was drawn before it was copied");
+
+        lod.Flush();
+        lod.Request(*texture_lod_test_mesh);
+        lod.Update();
+        snprintf(buffer, buffer_size, "Near face should use level 0, got %d", lod.GetLevel(texture));
+        mu_assert(lod.GetLevel(texture) == 0, buffer);
+        mu_assert(VDP1::Textures[texture].Width == 32, "Texture entry does not point at full size level");
+        mu_assert(memcmp(VDP1::Textures[texture].GetData(), texture_lod_test_bitmap->data, 32 * 32 * 2) == 0, "Level data in VDP1 memory differs");
+
+        texture_lod_test_place(2000.0);
+        lod.Request(*texture_lod_test_mesh);
+        lod.Update();
+        snprintf(buffer, buffer_size, "Far face should use level 2, got %d", lod.GetLevel(texture));
+        mu_assert(lod.GetLevel(texture) == 2, buffer);
+    }
+
+    /**
+     * @brief Test eviction
+     *
+     * Verifies that level of texture no longer drawn is evicted to make room once it is safe to do so.
+     */
+    MU_TEST(texture_lod_test_eviction)
+    {
+        // Room for smallest levels of both textures and one full size level
+        TextureLod lod(2048 + 512 + 256, 2);
+        const int32_t first = lod.Add(texture_lod_test_bitmap);
+        const int32_t second = lod.Add(texture_lod_test_bitmap);
+
+        texture_lod_test_mesh->Attributes[0].Texture = first;
+        lod.Request(*texture_lod_test_mesh);
+        lod.Update();
+        lod.Flush();
+        lod.Request(*texture_lod_test_mesh);
+        lod.Update();
+        mu_assert(lod.GetLevel(first) == 0, "First texture did not get full size level");
+
+        texture_lod_test_mesh->Attributes[0].Texture = second;
+        uint16_t evictions = 0;
+
+        for (uint8_t frame = 0; frame < 4; frame++)
+        {
+            lod.Request(*texture_lod_test_mesh);
+            lod.Update();
+            lod.Flush();
+            evictions += lod.GetStatistics().Evictions;
+
+            if (frame == 0)
+            {
+                mu_assert(evictions == 0, "Level still in use was evicted");
+            }
+        }
+
+        mu_assert(evictions == 1, "Unused level was not evicted");
+        mu_assert(lod.GetLevel(second) == 0, "Second texture did not get full size level");
+        mu_assert(lod.GetLevel(first) == 2, "Evicted texture does not fall back to smallest level");
+    }
+
+    /**
+     * @brief Texture LOD test suite configuration and test case registration
+     */
+    MU_TEST_SUITE(texture_lod_test_suite)
+    {
+        MU_SUITE_CONFIGURE_WITH_HEADER(&texture_lod_test_setup,
+                                       &texture_lod_test_teardown,
+                                       &texture_lod_test_output_header);
+
+        MU_RUN_TEST(texture_lod_test_chain);
+        MU_RUN_TEST(texture_lod_test_selection);
+        MU_RUN_TEST(texture_lod_test_eviction);
+    }
+}
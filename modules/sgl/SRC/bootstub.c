@@ -0,0 +1,160 @@
+#include <stdint.h>
+
+/*
+ * Boot stub for compressed main binary (SRL_COMPRESS_BINARY = 1)
+ *
+ * IP.BIN loads 0.bin to 0x06004000 and jumps to it. With compression enabled 0.bin consists of this stub
+ * followed by LZ4 block compressed main binary. Since the main binary must be decompressed to 0x06004000,
+ * the stub first copies itself together with the payload into LWRAM (where it is linked to), then decompresses
+ * the payload into place and jumps to PreLoader.
+ *
+ * Header fields are patched by tools/scripts/compress_binary.py after the stub is linked.
+ */
+
+/** @brief Header of the boot stub, placed right after the first branch
+ */
+typedef struct
+{
+    /** @brief Size of stub and payload in bytes (multiple of 4)
+     */
+    uint32_t ImageSize;
+
+    /** @brief Size of decompressed main binary in bytes
+     */
+    uint32_t UncompressedSize;
+
+    /** @brief Where to decompress main binary to and jump to afterwards
+     */
+    uint32_t Destination;
+} BootHeader_;
+
+/** @brief Header of the boot stub
+ * @note Defined within assembly below
+ */
+extern const BootHeader_ BootHeader;
+
+/** @brief Start of the compressed payload
+ * @note Defined within linker script
+ */
+extern const uint8_t boot_payload;
+
+/** @brief Cache control register
+ */
+#define CACHE_CONTROL (*(volatile uint8_t*)0xfffffe92)
+
+/** @brief Cache purge bit of cache control register
+ */
+#define CACHE_PURGE (0x10)
+
+void BootMain(void) __attribute__((used, noreturn));
+
+/*
+ * Entry point, runs from 0x06004000 where IP.BIN loaded it, but is linked to LWRAM.
+ * Only PC relative code is allowed until the jump to BootMain.
+ */
+__asm__(
+    "    .section BOOTSTART,\"ax\"\n"
+    "    .global _BootStart\n"
+    "_BootStart:\n"
+    "    bra     1f\n"
+    "    nop\n"
+    "    .global _BootHeader\n"
+    "_BootHeader:\n"
+    "    .long   0\n"                   /* ImageSize, patched */
+    "    .long   0\n"                   /* UncompressedSize, patched */
+    "    .long   0x06004000\n"          /* Destination */
+    "1:\n"
+    "    mov.l   2f, r1\n"              /* Where the image was loaded */
+    "    mov.l   3f, r2\n"              /* Where the image is linked to */
+    "    mov.l   @(4, r1), r3\n"        /* ImageSize */
+    "0:\n"
+    "    mov.l   @r1+, r0\n"
+    "    mov.l   r0, @r2\n"
+    "    add     #4, r2\n"
+    "    add     #-4, r3\n"
+    "    cmp/pl  r3\n"
+    "    bt      0b\n"
+    "    mov.l   4f, r0\n"
+    "    jmp     @r0\n"
+    "    nop\n"
+    "    .align  2\n"
+    "2:  .long   0x06004000\n"
+    "3:  .long   _BootStart\n"
+    "4:  .long   _BootMain\n"
+    "    .text\n");
+
+/** @brief Decompress LZ4 block
+ * @param source Compressed data
+ * @param destination Decompressed data
+ * @param size Size of decompressed data
+ */
+static void Decompress(const uint8_t* source, uint8_t* destination, const uint32_t size)
+{
+    uint8_t* end = destination + size;
+
+    while (destination < end)
+    {
+        const uint8_t token = *source++;
+        uint32_t length = token >> 4;
+
+        // Literals
+        if (length == 15)
+        {
+            uint8_t extra;
+
+            do
+            {
+                extra = *source++;
+                length += extra;
+            } while (extra == 255);
+        }
+
+        while (length-- > 0)
+        {
+            *destination++ = *source++;
+        }
+
+        // Last sequence has no match
+        if (destination >= end)
+        {
+            break;
+        }
+
+        // Match
+        const uint8_t* match = destination - (source[0] | (source[1] << 8));
+        source += 2;
+        length = token & 0x0f;
+
+        if (length == 15)
+        {
+            uint8_t extra;
+
+            do
+            {
+                extra = *source++;
+                length += extra;
+            } while (extra == 255);
+        }
+
+        length += 4;
+
+        while (length-- > 0)
+        {
+            *destination++ = *match++;
+        }
+    }
+}
+
+/** @brief Decompress main binary and start it
+ */
+void BootMain(void)
+{
+    Decompress(&boot_payload, (uint8_t*)BootHeader.Destination, BootHeader.UncompressedSize);
+
+    // Stub code that was at destination might still be in instruction cache
+    CACHE_CONTROL |= CACHE_PURGE;
+
+    ((void (*)(void))BootHeader.Destination)();
+
+    while (1);
+}
@@ -12,6 +12,18 @@ extern "C" {
      */
     extern uint32_t _bend;
 
+    /** @brief Start of code and data linked to LWRam
+     */
+    extern uint32_t _lwram_start;
+
+    /** @brief End of code and data linked to LWRam
+     */
+    extern uint32_t _lwram_end;
+
+    /** @brief Image of code and data linked to LWRam, loaded with the binary into HWRam
+     */
+    extern uint32_t _lwram_load;
+
     /** @brief Start address of constructor array
      */
     extern void(*__ctors)();
@@ -33,6 +45,14 @@ extern "C" {
      */
     void PreLoader()
     {
+        // Copy cold code and data into LWRam, must be done first since .bss overlaps the image
+        uint32_t* lwramImage = &_lwram_load;
+
+        for (uint32_t* lwramBlock = &_lwram_start; lwramBlock < &_lwram_end; lwramBlock++)
+        {
+            *lwramBlock = *lwramImage++;
+        }
+
         // Zero stuff inside .bss section
         for (uint32_t* bssBlock = &_bstart; bssBlock < &_bend; bssBlock++)
         {
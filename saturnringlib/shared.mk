@@ -42,17 +42,20 @@ ifdef OS
    CXX = sh2eb-elf-g++.exe
    LD = sh2eb-elf-gcc.exe
    OBJCOPY = sh2eb-elf-objcopy.exe
+   NM = sh2eb-elf-nm.exe
 else
 	ifneq (, $(shell which sh2eb-elf-gcc))
 		CC = sh2eb-elf-gcc
 		CXX = sh2eb-elf-g++
 		LD = sh2eb-elf-gcc
 		OBJCOPY = sh2eb-elf-objcopy
+		NM = sh2eb-elf-nm
 	else
 		CC = sh-elf-gcc
 		CXX = sh-elf-g++
 		LD = sh-elf-gcc
 		OBJCOPY = sh-elf-objcopy
+		NM = sh-elf-nm
   endif
 endif
 
@@ -108,6 +111,14 @@ ifneq ($(strip ${SRL_MODE}),PAL)
 	endif
 endif
 
+ifeq ($(strip ${SRL_COMPRESS_BINARY}),)
+	SRL_COMPRESS_BINARY = 0
+endif
+
+ifeq ($(strip ${SRL_MAP_REPORT}),)
+	SRL_MAP_REPORT = 0
+endif
+
 ifeq ($(strip ${SRL_DEBUG_MAX_PRINT_LENGTH}),)
 	SRL_DEBUG_MAX_PRINT_LENGTH = 45
 endif
@@ -128,6 +139,46 @@ CCFLAGS += -DSRL_MODE_$(strip ${SRL_MODE}) \
 ASSETS_DIR = ./cd/data
 MUSIC_DIR = ./cd/music
 
+# Asset pipeline, converts files from SRL_ASSETS_DIR into the CD staging folder
+# Rules are selected by directory first (SRL_ASSET_DIRS), then by file extension, files without rule are copied
+#   SRL_ASSETS_DIR = ./assets
+#   SRL_ASSET_RULE_tga = python3 tools/tga2spr.py $< $@     # Command, $< is input file and $@ output file
+#   SRL_ASSET_EXT_tga = SPR                                  # Optional output extension
+#   SRL_ASSET_DIRS = tiles                                   # Directories (relative to SRL_ASSETS_DIR) with own rule
+#   SRL_ASSET_RULE_DIR_tiles = ...
+#   SRL_ASSET_EXT_DIR_tiles = BIN
+# Only inputs newer than their output are converted again
+SRL_ASSET_COPY = cp $< $@
+
+ifneq ($(strip ${SRL_ASSETS_DIR}),)
+	ASSET_SOURCES = $(patsubst ./%,%,$(shell find $(strip ${SRL_ASSETS_DIR}) -type f))
+endif
+
+# Get directory rule matching asset (first listed directory wins)
+asset_dir = $(firstword $(foreach dir,$(strip ${SRL_ASSET_DIRS}),$(if $(filter $(patsubst ./%,%,$(strip ${SRL_ASSETS_DIR}))/$(dir)/%,$(1)),$(dir))))
+
+# Get extension of asset without the dot
+asset_ext = $(patsubst .%,%,$(suffix $(1)))
+
+# Get conversion command variable name of asset
+asset_rule = $(if $(call asset_dir,$(1)),SRL_ASSET_RULE_DIR_$(call asset_dir,$(1)),$(if $(SRL_ASSET_RULE_$(call asset_ext,$(1))),SRL_ASSET_RULE_$(call asset_ext,$(1)),SRL_ASSET_COPY))
+
+# Get output extension of asset
+asset_out_ext = $(or $(if $(call asset_dir,$(1)),$(SRL_ASSET_EXT_DIR_$(call asset_dir,$(1))),$(SRL_ASSET_EXT_$(call asset_ext,$(1)))),$(call asset_ext,$(1)))
+
+# Get output path of asset inside of CD staging folder
+asset_output = $(ASSETS_DIR)/$(basename $(patsubst $(patsubst ./%,%,$(strip ${SRL_ASSETS_DIR}))/%,%,$(1)))$(if $(call asset_out_ext,$(1)),.$(call asset_out_ext,$(1)))
+
+define asset_build_rule
+$(call asset_output,$(1)) : $(1)
+	mkdir -p $$(dir $$@)
+	$$($(call asset_rule,$(1)))
+endef
+
+$(foreach asset,$(ASSET_SOURCES),$(eval $(call asset_build_rule,$(asset))))
+
+ASSET_OUTPUTS = $(foreach asset,$(ASSET_SOURCES),$(call asset_output,$(asset)))
+
 # Handle work area
 ifneq ($(strip ${SGL_MAX_VERTICES}),)
 	SYSFLAGS += -DSGL_MAX_VERTICES=$(strip ${SGL_MAX_VERTICES})
@@ -164,6 +215,41 @@ BUILD_BIN = $(BUILD_ELF:.elf=.bin)
 BUILD_CUE = $(BUILD_ELF:.elf=.cue)
 BUILD_MAP = $(BUILD_ELF:.elf=.map)
 
+# Report of code and data placement in HWRam and LWRam (see SRL_HOT, SRL_COLD and SRL_LWRAM_DATA), generated from the map file when SRL_MAP_REPORT = 1
+BUILD_PLACEMENT = $(BUILD_ELF:.elf=.placement.txt)
+
+# Code overlays, each overlay is linked into the same shared region and written to CD as NAME.OVL
+OVERLAY_LDFILE = $(BUILD_DROP)/overlays.linker
+OVERLAY_OBJECTS = $(foreach ovl,$(strip ${SRL_OVERLAYS}),$(BUILD_DROP)/$(ovl).ovl.o)
+
+# Overlay sections are prefixed so they are not picked up by the main sections of the linker script
+# Section groups of inline functions and templates are dissolved and their weak symbols made local,
+# so every overlay keeps its own copy instead of the linker merging them into another overlay or the main program
+define overlay_rules
+SRL_OVERLAY_$(1)_OBJECTS = $$(patsubst %.cxx,%.o,$$(SRL_OVERLAY_$(1)_SOURCES:.c=.o))
+
+$(BUILD_DROP)/$(1).ovl.o : $$(SRL_OVERLAY_$(1)_OBJECTS)
+	mkdir -p $(BUILD_DROP)
+	$$(LD) -m2 -r -nostdlib -Wl,-d -Wl,--force-group-allocation $$^ -o $$@
+	$$(NM) -g --defined-only $$@ | awk '$$$$2 !~ /[VvWw]/ { print $$$$3 }' > $$@.globals
+	$$(OBJCOPY) --keep-global-symbols=$$@.globals --prefix-alloc-sections=.ovl.$(1) $$@
+endef
+
+$(foreach ovl,$(strip ${SRL_OVERLAYS}),$(eval $(call overlay_rules,$(ovl))))
+
+# Compressed main binary, boot stub decompresses it to 0x06004000 and jumps to PreLoader
+BOOTSTUB_SOURCE = $(SGLDIR)/SRC/bootstub.c
+BOOTSTUB_LDFILE = $(SGLDIR)/bootstub.linker
+BOOTSTUB_ELF = $(BUILD_DROP)/bootstub.elf
+BOOTSTUB_BIN = $(BUILD_DROP)/bootstub.bin
+UNCOMPRESSED_BIN = $(BUILD_DROP)/uncompressed.bin
+
+ifdef OS
+	PYTHON ?= python
+else
+	PYTHON ?= python3
+endif
+
 TLSFDIR = $(MODDIR)/tlsf
 DUMMYIDIR = $(MODDIR)/dummy
 SATURNMATHPPDIR = $(MODDIR)/SaturnMathPP
@@ -182,7 +268,7 @@ SYSOBJECTS = $(SYSSOURCES:.c=.o)
 # General compilation flags
 CCFLAGS += $(SYSFLAGS) -W -m2 -c -O2 -Wno-strict-aliasing \
 					-I$(DUMMYIDIR) -I$(SATURNMATHPPDIR) -I$(SGLIDIR) -I$(STDDIR) -I$(TLSFDIR) -I$(SDK_ROOT) $(MODULE_EXTRA_INC)
-LDFLAGS = -m2 -L$(SGLLDIR) -Xlinker -T$(LDFILE) -Xlinker -Map \
+LDFLAGS = -m2 -L$(SGLLDIR) -L$(BUILD_DROP) -Xlinker -T$(LDFILE) -Xlinker -Map \
 					-Xlinker $(BUILD_MAP) -Xlinker -e -Xlinker ___Start -nostartfiles
 
 ifeq "$(GCCMAJORVERSION)" "14"
@@ -217,7 +303,19 @@ endif
 %.o : %.cxx
 	$(CXX) $< $(CCFLAGS) -std=c++23 -fpermissive -fno-exceptions -fno-rtti -fno-unwind-tables -fno-asynchronous-unwind-tables -fno-threadsafe-statics -fno-use-cxa-atexit -o $@
 
-compile_objects : $(OBJECTS) $(SYSOBJECTS)
+# Generate overlay part of the linker script (empty region when there are no overlays)
+# Each overlay starts with address of its .bss start and end, so SRL::Overlay::Load() can clear it
+overlay_linker :
+	mkdir -p $(BUILD_DROP)
+	echo '__overlay_start = ALIGN(0x20);' > $(OVERLAY_LDFILE)
+ifneq ($(strip ${SRL_OVERLAYS}),)
+	echo 'OVERLAY __overlay_start : NOCROSSREFS {' >> $(OVERLAY_LDFILE)
+	$(foreach ovl,$(strip ${SRL_OVERLAYS}),echo '    OVL_$(ovl) { LONG(__ovl_$(ovl)_bss_start) LONG(__ovl_$(ovl)_bss_end) *(.ovl.$(ovl).[!b]*) . = ALIGN(0x4); __ovl_$(ovl)_bss_start = .; *(.ovl.$(ovl).bss .ovl.$(ovl).bss.*) . = ALIGN(0x4); __ovl_$(ovl)_bss_end = .; }' >> $(OVERLAY_LDFILE);)
+	echo '}' >> $(OVERLAY_LDFILE)
+endif
+	echo '__overlay_end = ALIGN(0x10);' >> $(OVERLAY_LDFILE)
+
+compile_objects : $(OBJECTS) $(SYSOBJECTS) $(OVERLAY_OBJECTS) overlay_linker
 	$(info ****** Info ******)
 	$(info Maximum textures : ${SRL_MAX_TEXTURES})
 	$(info Maximum vertices : ${SGL_MAX_VERTICES})
@@ -226,6 +324,9 @@ compile_objects : $(OBJECTS) $(SYSOBJECTS)
 	$(info Maximum work : ${SGL_MAX_WORKS})
 	$(info Log level selected : $(if $(strip ${SRL_LOG_LEVEL}),${SRL_LOG_LEVEL},NONE))
 	$(info Maximum Log length : $(if $(strip ${SRL_DEBUG_MAX_LOG_LENGTH}),${SRL_DEBUG_MAX_LOG_LENGTH},0))
+	$(info Compressed binary : $(if $(filter 1,$(strip ${SRL_COMPRESS_BINARY})),YES,NO))
+	$(info Placement report : $(if $(filter 1,$(strip ${SRL_MAP_REPORT})),YES,NO))
+	$(info Overlays : $(if $(strip ${SRL_OVERLAYS}),${SRL_OVERLAYS},NONE))
 	$(info ******************)
 	mkdir -p $(MUSIC_DIR)
 	mkdir -p $(ASSETS_DIR)
@@ -233,12 +334,30 @@ compile_objects : $(OBJECTS) $(SYSOBJECTS)
 	test -f $(ASSETS_DIR)/ABS.TXT || echo "NOT Abstracted by SEGA" >> $(ASSETS_DIR)/ABS.TXT
 	test -f $(ASSETS_DIR)/BIB.TXT || echo "NOT Bibliographiced by SEGA" >> $(ASSETS_DIR)/BIB.TXT
 	test -f $(ASSETS_DIR)/CPY.TXT || touch $(ASSETS_DIR)/CPY.TXT
-	$(CC) $(LDFLAGS) $(SYSOBJECTS) $(OBJECTS) $(LIBS) -o $(BUILD_ELF)
+	$(CC) $(LDFLAGS) $(SYSOBJECTS) $(OBJECTS) $(OVERLAY_OBJECTS) $(LIBS) -o $(BUILD_ELF)
+ifeq ($(strip ${SRL_MAP_REPORT}), 1)
+	$(PYTHON) $(SDK_ROOT)/../tools/scripts/map_report.py $(BUILD_MAP) $(BUILD_PLACEMENT)
+endif
 
 convert_binary : compile_objects
-	$(OBJCOPY) -O binary $(BUILD_ELF) ./cd/data/0.bin
+	$(OBJCOPY) -O binary $(foreach ovl,$(strip ${SRL_OVERLAYS}),-R OVL_$(ovl)) $(BUILD_ELF) ./cd/data/0.bin
+	$(foreach ovl,$(strip ${SRL_OVERLAYS}),$(OBJCOPY) -O binary -j OVL_$(ovl) $(BUILD_ELF) $(ASSETS_DIR)/$(ovl).OVL;)
+ifeq ($(strip ${SRL_COMPRESS_BINARY}), 1)
+	$(CC) $(BOOTSTUB_SOURCE) -m2 -Os -ffreestanding -fno-tree-loop-distribute-patterns -nostdlib -nostartfiles \
+		-Xlinker -T$(BOOTSTUB_LDFILE) -Xlinker -e -Xlinker _BootStart -o $(BOOTSTUB_ELF)
+	$(OBJCOPY) -O binary $(BOOTSTUB_ELF) $(BOOTSTUB_BIN)
+	mv ./cd/data/0.bin $(UNCOMPRESSED_BIN)
+	$(PYTHON) $(SDK_ROOT)/../tools/scripts/compress_binary.py $(BOOTSTUB_BIN) $(UNCOMPRESSED_BIN) ./cd/data/0.bin
+endif
+
+# Convert changed assets
+assets : $(ASSET_OUTPUTS)
+	$(info ****** Assets : $(words $(ASSET_OUTPUTS)) file(s) up to date ******)
+
+clean_assets :
+	rm -f $(ASSET_OUTPUTS)
 
-create_iso : convert_binary
+create_iso : convert_binary assets
 ifeq ($(strip ${SRL_USE_SGL_SOUND_DRIVER}),1)
 	cp -r $(SGLDIR)/DRV/. ./cd/data/
 ifeq ($(strip ${SRL_ENABLE_FREQ_ANALYSIS}), 1)
@@ -431,6 +550,8 @@ build_bin_cue: create_bin_cue add_audio_to_bin_cue
 clean:
 	rm -f $(SGLLDIR)/../SRC/*.o
 	rm -f $(OBJECTS) $(BUILD_ELF) $(BUILD_ISO) $(BUILD_MAP) $(ASSETS_DIR)/0.bin
+	rm -f $(foreach ovl,$(strip ${SRL_OVERLAYS}),$(SRL_OVERLAY_$(ovl)_OBJECTS) $(ASSETS_DIR)/$(ovl).OVL)
+	rm -f $(OVERLAY_OBJECTS) $(OVERLAY_OBJECTS:=.globals) $(OVERLAY_LDFILE)
 	rm -f $(AUDIO_FILES_RAW)
 ifeq ($(strip ${SRL_USE_SGL_SOUND_DRIVER}),1)
 	rm -f $(ASSETS_DIR)/SDDRVS.DAT $(ASSETS_DIR)/SDDRVS.TSK $(ASSETS_DIR)/BOOTSND.MAP
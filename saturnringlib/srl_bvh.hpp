@@ -0,0 +1,869 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_mesh.hpp"
+
+namespace SRL
+{
+    /** @brief Bounding volume hierarchy over mesh polygons
+     * @details Hierarchy is built once when level is loaded and references vertex and face arrays of the mesh, mesh must outlive it.
+     * Nodes are stored depth first in 16 bytes each, so left child always follows its parent and only right child offset is stored.
+     * Node bounds are kept in whole units rounded outwards, queries against them stay conservative.
+     *
+     * Quads are expected to be planar and convex, triangles repeat their third vertex as fourth one.
+     * Sphere query relies on face normals being set.
+     * @code {.cpp}
+     * SRL::MeshBvh level(levelMesh);
+     * SRL::MeshBvh::Hit hit;
+     *
+     * // Find ground under the player (Y axis points down)
+     * if (level.Segment(position, position + Vector3D(0.0, 100.0, 0.0), &hit))
+     * {
+     *     groundHeight = hit.Point.Y;
+     * }
+     * @endcode
+     */
+    class MeshBvh
+    {
+    public:
+
+        /** @brief Hierarchy node
+         */
+        struct Node
+        {
+            /** @brief Minimal corner of node bounds in whole units
+             */
+            int16_t Min[3];
+
+            /** @brief Maximal corner of node bounds in whole units
+             */
+            int16_t Max[3];
+
+            /** @brief First entry in face order for leaves, index of right child for inner nodes
+             */
+            uint16_t Offset;
+
+            /** @brief Number of faces in a leaf, zero for inner nodes
+             */
+            uint8_t Count;
+
+            /** @brief Axis inner node was split on
+             */
+            uint8_t Axis;
+        };
+
+        /** @brief Query hit
+         */
+        struct Hit
+        {
+            /** @brief Index of the face that was hit
+             */
+            size_t Face;
+
+            /** @brief Position of the hit along the segment (0-1)
+             */
+            Math::Types::Fxp Fraction;
+
+            /** @brief Hit point
+             */
+            Math::Types::Vector3D Point;
+
+            /** @brief Normal of the face that was hit
+             */
+            Math::Types::Vector3D Normal;
+        };
+
+        /** @brief Maximal number of faces in a leaf
+         */
+        static constexpr size_t LeafSize = 4;
+
+    private:
+
+        /** @brief Maximal depth of the hierarchy
+         */
+        static constexpr size_t MaxDepth = 32;
+
+        /** @brief Coordinates used by queries keep 8 bits of fraction, so their products fit into 64 bits
+         */
+        static constexpr int32_t FineShift = 8;
+
+        /** @brief Point in query coordinates
+         */
+        struct Point
+        {
+            /** @brief X coordinate
+             */
+            int32_t X;
+
+            /** @brief Y coordinate
+             */
+            int32_t Y;
+
+            /** @brief Z coordinate
+             */
+            int32_t Z;
+        };
+
+        /** @brief Mesh vertices
+         */
+        const Math::Types::Vector3D* vertices;
+
+        /** @brief Mesh faces
+         */
+        const Types::Polygon* faces;
+
+        /** @brief Number of faces
+         */
+        size_t faceCount;
+
+        /** @brief Hierarchy nodes
+         */
+        Node* nodes;
+
+        /** @brief Number of nodes
+         */
+        size_t nodeCount;
+
+        /** @brief Face indices ordered by leaves
+         */
+        uint16_t* order;
+
+        /** @brief Node and face arrays are owned by the hierarchy
+         */
+        bool owned;
+
+        /** @brief Number of nodes visited by last query
+         */
+        size_t visited;
+
+        /** @brief Convert vector to query coordinates
+         * @param vector Vector
+         * @return Point
+         */
+        static Point ToPoint(const Math::Types::Vector3D& vector)
+        {
+            return Point { vector.X.RawValue() >> MeshBvh::FineShift, vector.Y.RawValue() >> MeshBvh::FineShift, vector.Z.RawValue() >> MeshBvh::FineShift };
+        }
+
+        /** @brief Subtract points
+         * @param a First point
+         * @param b Second point
+         * @return Difference
+         */
+        static Point Subtract(const Point& a, const Point& b)
+        {
+            return Point { a.X - b.X, a.Y - b.Y, a.Z - b.Z };
+        }
+
+        /** @brief Dot product
+         * @param a First vector
+         * @param b Second vector
+         * @return Dot product
+         */
+        static int64_t Dot(const Point& a, const Point& b)
+        {
+            return (static_cast<int64_t>(a.X) * b.X) + (static_cast<int64_t>(a.Y) * b.Y) + (static_cast<int64_t>(a.Z) * b.Z);
+        }
+
+        /** @brief Absolute value
+         * @param value Value
+         * @return Absolute value
+         */
+        static int64_t Abs(const int64_t value)
+        {
+            return value < 0 ? -value : value;
+        }
+
+        /** @brief Get number of nodes needed for given number of faces
+         * @param count Number of faces
+         * @return Number of nodes
+         */
+        static size_t CountNodes(const size_t count)
+        {
+            if (count <= MeshBvh::LeafSize)
+            {
+                return 1;
+            }
+
+            return 1 + MeshBvh::CountNodes(count >> 1) + MeshBvh::CountNodes(count - (count >> 1));
+        }
+
+        /** @brief Get face centroid along an axis (times four)
+         * @param face Face index
+         * @param axis Axis
+         * @return Sum of face vertex coordinates
+         */
+        int32_t GetCentroid(const uint16_t face, const uint8_t axis) const
+        {
+            int32_t sum = 0;
+
+            for (size_t vertex = 0; vertex < 4; vertex++)
+            {
+                const Math::Types::Vector3D& point = this->vertices[this->faces[face].Vertices[vertex]];
+                const Math::Types::Fxp& coordinate = axis == 0 ? point.X : (axis == 1 ? point.Y : point.Z);
+                sum += coordinate.RawValue() >> 2;
+            }
+
+            return sum;
+        }
+
+        /** @brief Move faces so the one at given position has median centroid
+         * @param start First face in order
+         * @param count Number of faces
+         * @param median Position of the median relative to start
+         * @param axis Axis to sort along
+         */
+        void SelectMedian(const size_t start, const size_t count, const size_t median, const uint8_t axis)
+        {
+            const int32_t target = start + median;
+            int32_t first = start;
+            int32_t last = start + count - 1;
+
+            while (first < last)
+            {
+                const int32_t pivot = this->GetCentroid(this->order[(first + last) >> 1], axis);
+                int32_t left = first;
+                int32_t right = last;
+
+                while (left <= right)
+                {
+                    while (this->GetCentroid(this->order[left], axis) < pivot)
+                    {
+                        left++;
+                    }
+
+                    while (this->GetCentroid(this->order[right], axis) > pivot)
+                    {
+                        right--;
+                    }
+
+                    if (left <= right)
+                    {
+                        const uint16_t swap = this->order[left];
+                        this->order[left++] = this->order[right];
+                        this->order[right--] = swap;
+                    }
+                }
+
+                // Continue in the part holding the target, values between parts equal the pivot
+                if (target <= right)
+                {
+                    last = right;
+                }
+                else if (target >= left)
+                {
+                    first = left;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        /** @brief Build node and its children
+         * @param node Node index
+         * @param start First face in order
+         * @param count Number of faces
+         * @return Index after the last node of the subtree
+         */
+        size_t BuildNode(const size_t node, const size_t start, const size_t count)
+        {
+            int32_t min[3] = { INT32_MAX, INT32_MAX, INT32_MAX };
+            int32_t max[3] = { INT32_MIN, INT32_MIN, INT32_MIN };
+            int32_t centroidMin[3] = { INT32_MAX, INT32_MAX, INT32_MAX };
+            int32_t centroidMax[3] = { INT32_MIN, INT32_MIN, INT32_MIN };
+
+            for (size_t face = start; face < start + count; face++)
+            {
+                for (uint8_t axis = 0; axis < 3; axis++)
+                {
+                    for (size_t vertex = 0; vertex < 4; vertex++)
+                    {
+                        const Math::Types::Vector3D& point = this->vertices[this->faces[this->order[face]].Vertices[vertex]];
+                        const int32_t coordinate = (axis == 0 ? point.X : (axis == 1 ? point.Y : point.Z)).RawValue();
+                        min[axis] = Math::Min<int32_t>(min[axis], coordinate);
+                        max[axis] = Math::Max<int32_t>(max[axis], coordinate);
+                    }
+
+                    const int32_t centroid = this->GetCentroid(this->order[face], axis);
+                    centroidMin[axis] = Math::Min<int32_t>(centroidMin[axis], centroid);
+                    centroidMax[axis] = Math::Max<int32_t>(centroidMax[axis], centroid);
+                }
+            }
+
+            Node& current = this->nodes[node];
+
+            for (uint8_t axis = 0; axis < 3; axis++)
+            {
+                // Round outwards so node always contains its faces
+                current.Min[axis] = static_cast<int16_t>(Math::Max<int32_t>(INT16_MIN, min[axis] >> 16));
+                current.Max[axis] = static_cast<int16_t>(Math::Min<int32_t>(INT16_MAX, (max[axis] >> 16) + ((max[axis] & 0xffff) != 0 ? 1 : 0)));
+            }
+
+            if (count <= MeshBvh::LeafSize)
+            {
+                current.Offset = start;
+                current.Count = count;
+                current.Axis = 0;
+                return node + 1;
+            }
+
+            // Split at median centroid of the longest axis
+            uint8_t axis = 0;
+
+            for (uint8_t other = 1; other < 3; other++)
+            {
+                if (centroidMax[other] - centroidMin[other] > centroidMax[axis] - centroidMin[axis])
+                {
+                    axis = other;
+                }
+            }
+
+            const size_t half = count >> 1;
+            this->SelectMedian(start, count, half, axis);
+
+            const size_t right = this->BuildNode(node + 1, start, half);
+            current.Offset = right;
+            current.Count = 0;
+            current.Axis = axis;
+            return this->BuildNode(right, start + half, count - half);
+        }
+
+        /** @brief Test segment against node bounds
+         * @param node Node
+         * @param center Segment center
+         * @param half Half of the segment
+         * @return True if segment touches the node
+         */
+        static bool SegmentOverlapsNode(const Node& node, const Point& center, const Point& half)
+        {
+            // Separating axis test, box axes first then cross products of segment with box axes
+            const Point extent = {
+                (static_cast<int32_t>(node.Max[0]) - node.Min[0]) << (15 - MeshBvh::FineShift),
+                (static_cast<int32_t>(node.Max[1]) - node.Min[1]) << (15 - MeshBvh::FineShift),
+                (static_cast<int32_t>(node.Max[2]) - node.Min[2]) << (15 - MeshBvh::FineShift) };
+            const Point offset = {
+                center.X - (((static_cast<int32_t>(node.Max[0]) + node.Min[0]) << (16 - MeshBvh::FineShift)) >> 1),
+                center.Y - (((static_cast<int32_t>(node.Max[1]) + node.Min[1]) << (16 - MeshBvh::FineShift)) >> 1),
+                center.Z - (((static_cast<int32_t>(node.Max[2]) + node.Min[2]) << (16 - MeshBvh::FineShift)) >> 1) };
+            const int64_t absoluteX = MeshBvh::Abs(half.X) + 1;
+            const int64_t absoluteY = MeshBvh::Abs(half.Y) + 1;
+            const int64_t absoluteZ = MeshBvh::Abs(half.Z) + 1;
+
+            if (MeshBvh::Abs(offset.X) > extent.X + absoluteX ||
+                MeshBvh::Abs(offset.Y) > extent.Y + absoluteY ||
+                MeshBvh::Abs(offset.Z) > extent.Z + absoluteZ)
+            {
+                return false;
+            }
+
+            return
+                MeshBvh::Abs((static_cast<int64_t>(offset.Y) * half.Z) - (static_cast<int64_t>(offset.Z) * half.Y)) <= (extent.Y * absoluteZ) + (extent.Z * absoluteY) &&
+                MeshBvh::Abs((static_cast<int64_t>(offset.Z) * half.X) - (static_cast<int64_t>(offset.X) * half.Z)) <= (extent.X * absoluteZ) + (extent.Z * absoluteX) &&
+                MeshBvh::Abs((static_cast<int64_t>(offset.X) * half.Y) - (static_cast<int64_t>(offset.Y) * half.X)) <= (extent.X * absoluteY) + (extent.Y * absoluteX);
+        }
+
+        /** @brief Test segment against triangle
+         * @param start Segment start
+         * @param delta Segment direction and length
+         * @param a First triangle vertex
+         * @param b Second triangle vertex
+         * @param c Third triangle vertex
+         * @param fraction Fixed point position of the hit along the segment
+         * @return True if segment crosses the triangle
+         */
+        static bool SegmentTriangle(const Point& start, const Point& delta, const Point& a, const Point& b, const Point& c, int32_t& fraction)
+        {
+            const Point ab = MeshBvh::Subtract(b, a);
+            const Point ac = MeshBvh::Subtract(c, a);
+            const Point reverse = { -delta.X, -delta.Y, -delta.Z };
+            const Point fromA = MeshBvh::Subtract(start, a);
+
+            // Triangle normal, not normalized
+            const int64_t normalX = (static_cast<int64_t>(ab.Y) * ac.Z) - (static_cast<int64_t>(ab.Z) * ac.Y);
+            const int64_t normalY = (static_cast<int64_t>(ab.Z) * ac.X) - (static_cast<int64_t>(ab.X) * ac.Z);
+            const int64_t normalZ = (static_cast<int64_t>(ab.X) * ac.Y) - (static_cast<int64_t>(ab.Y) * ac.X);
+
+            int64_t denominator = (reverse.X * normalX) + (reverse.Y * normalY) + (reverse.Z * normalZ);
+            int64_t distance = (fromA.X * normalX) + (fromA.Y * normalY) + (fromA.Z * normalZ);
+
+            // Faces are hit from both sides
+            const int64_t sign = denominator < 0 ? -1 : 1;
+            denominator *= sign;
+            distance *= sign;
+
+            if (denominator == 0 || distance < 0 || distance > denominator)
+            {
+                return false;
+            }
+
+            // Barycentric coordinates scaled by denominator, computed in 64 bits
+            const int64_t edgeX = (static_cast<int64_t>(reverse.Y) * fromA.Z) - (static_cast<int64_t>(reverse.Z) * fromA.Y);
+            const int64_t edgeY = (static_cast<int64_t>(reverse.Z) * fromA.X) - (static_cast<int64_t>(reverse.X) * fromA.Z);
+            const int64_t edgeZ = (static_cast<int64_t>(reverse.X) * fromA.Y) - (static_cast<int64_t>(reverse.Y) * fromA.X);
+            const int64_t v = ((ac.X * edgeX) + (ac.Y * edgeY) + (ac.Z * edgeZ)) * sign;
+            const int64_t w = -((ab.X * edgeX) + (ab.Y * edgeY) + (ab.Z * edgeZ)) * sign;
+
+            if (v < 0 || w < 0 || v + w > denominator)
+            {
+                return false;
+            }
+
+            fraction = MeshBvh::Fraction(distance, denominator);
+            return true;
+        }
+
+        /** @brief Get ratio clamped to 0-1 range
+         * @param numerator Numerator
+         * @param denominator Denominator (positive)
+         * @return Fixed point ratio
+         */
+        static int32_t Fraction(int64_t numerator, int64_t denominator)
+        {
+            if (numerator <= 0 || denominator <= 0)
+            {
+                return 0;
+            }
+            else if (numerator >= denominator)
+            {
+                return 0x10000;
+            }
+
+            // Keep shifted numerator within 64 bits
+            while (denominator >= (static_cast<int64_t>(1) << 46))
+            {
+                numerator >>= 16;
+                denominator >>= 16;
+            }
+
+            return denominator > 0 ? static_cast<int32_t>((numerator << 16) / denominator) : 0;
+        }
+
+        /** @brief Get squared distance from point to segment
+         * @param point Point
+         * @param a Segment start
+         * @param b Segment end
+         * @return Squared distance
+         */
+        static int64_t DistanceToEdge(const Point& point, const Point& a, const Point& b)
+        {
+            const Point edge = MeshBvh::Subtract(b, a);
+            const int32_t fraction = MeshBvh::Fraction(MeshBvh::Dot(MeshBvh::Subtract(point, a), edge), MeshBvh::Dot(edge, edge));
+            const Point closest = {
+                a.X + static_cast<int32_t>((static_cast<int64_t>(edge.X) * fraction) >> 16),
+                a.Y + static_cast<int32_t>((static_cast<int64_t>(edge.Y) * fraction) >> 16),
+                a.Z + static_cast<int32_t>((static_cast<int64_t>(edge.Z) * fraction) >> 16) };
+            const Point offset = MeshBvh::Subtract(point, closest);
+            return MeshBvh::Dot(offset, offset);
+        }
+
+        /** @brief Test sphere against triangle
+         * @param center Sphere center
+         * @param radiusSquared Squared sphere radius
+         * @param normal Triangle normal
+         * @param a First triangle vertex
+         * @param b Second triangle vertex
+         * @param c Third triangle vertex
+         * @return True if sphere touches the triangle
+         */
+        static bool SphereTriangle(const Point& center, const int64_t radiusSquared, const Math::Types::Vector3D& normal, const Point& a, const Point& b, const Point& c)
+        {
+            const Point unit = { normal.X.RawValue(), normal.Y.RawValue(), normal.Z.RawValue() };
+            const int64_t distance = MeshBvh::Dot(unit, MeshBvh::Subtract(center, a)) >> 16;
+
+            if (distance * distance > radiusSquared)
+            {
+                return false;
+            }
+
+            // Point projected onto the plane lies inside when it is on the same side of all edges
+            const Point projected = {
+                center.X - static_cast<int32_t>((unit.X * distance) >> 16),
+                center.Y - static_cast<int32_t>((unit.Y * distance) >> 16),
+                center.Z - static_cast<int32_t>((unit.Z * distance) >> 16) };
+            const Point* corners[4] = { &a, &b, &c, &a };
+            bool inside = true;
+
+            for (size_t corner = 0; corner < 3 && inside; corner++)
+            {
+                const Point edge = MeshBvh::Subtract(*corners[corner + 1], *corners[corner]);
+                const Point toPoint = MeshBvh::Subtract(projected, *corners[corner]);
+                const int64_t crossX = (static_cast<int64_t>(edge.Y) * toPoint.Z) - (static_cast<int64_t>(edge.Z) * toPoint.Y);
+                const int64_t crossY = (static_cast<int64_t>(edge.Z) * toPoint.X) - (static_cast<int64_t>(edge.X) * toPoint.Z);
+                const int64_t crossZ = (static_cast<int64_t>(edge.X) * toPoint.Y) - (static_cast<int64_t>(edge.Y) * toPoint.X);
+                const int64_t side = ((crossX >> 8) * unit.X) + ((crossY >> 8) * unit.Y) + ((crossZ >> 8) * unit.Z);
+                inside = side >= 0;
+            }
+
+            if (!inside)
+            {
+                // Try the opposite winding, normals may point either way
+                inside = true;
+
+                for (size_t corner = 0; corner < 3 && inside; corner++)
+                {
+                    const Point edge = MeshBvh::Subtract(*corners[corner + 1], *corners[corner]);
+                    const Point toPoint = MeshBvh::Subtract(projected, *corners[corner]);
+                    const int64_t crossX = (static_cast<int64_t>(edge.Y) * toPoint.Z) - (static_cast<int64_t>(edge.Z) * toPoint.Y);
+                    const int64_t crossY = (static_cast<int64_t>(edge.Z) * toPoint.X) - (static_cast<int64_t>(edge.X) * toPoint.Z);
+                    const int64_t crossZ = (static_cast<int64_t>(edge.X) * toPoint.Y) - (static_cast<int64_t>(edge.Y) * toPoint.X);
+                    const int64_t side = ((crossX >> 8) * unit.X) + ((crossY >> 8) * unit.Y) + ((crossZ >> 8) * unit.Z);
+                    inside = side <= 0;
+                }
+            }
+
+            if (inside)
+            {
+                return true;
+            }
+
+            return MeshBvh::DistanceToEdge(center, a, b) <= radiusSquared ||
+                MeshBvh::DistanceToEdge(center, b, c) <= radiusSquared ||
+                MeshBvh::DistanceToEdge(center, c, a) <= radiusSquared;
+        }
+
+        /** @brief Get face vertex in query coordinates
+         * @param face Face index
+         * @param vertex Vertex of the face
+         * @return Point
+         */
+        Point GetVertex(const size_t face, const size_t vertex) const
+        {
+            return MeshBvh::ToPoint(this->vertices[this->faces[face].Vertices[vertex]]);
+        }
+
+        /** @brief Initialize hierarchy from mesh arrays
+         * @param vertices Mesh vertices
+         * @param faces Mesh faces
+         * @param faceCount Number of faces
+         * @param zone Memory zone to allocate hierarchy in
+         */
+        void Build(const Math::Types::Vector3D* vertices, const Types::Polygon* faces, const size_t faceCount, const Memory::Zone zone)
+        {
+            this->vertices = vertices;
+            this->faces = faces;
+            this->faceCount = faceCount;
+            this->owned = true;
+            this->visited = 0;
+
+            if (faceCount > 0xffff)
+            {
+                SRL::Debug::Assert("Mesh has too many faces for BVH (%d)", faceCount);
+            }
+
+            this->nodeCount = faceCount > 0 ? MeshBvh::CountNodes(faceCount) : 0;
+            this->nodes = reinterpret_cast<Node*>(Memory::Malloc(sizeof(Node) * Math::Max<size_t>(this->nodeCount, 1), zone));
+            this->order = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * Math::Max<size_t>(faceCount, 1), zone));
+
+            if (this->nodes == nullptr || this->order == nullptr)
+            {
+                SRL::Debug::Assert("Not enough memory for BVH of %d faces", faceCount);
+            }
+
+            for (size_t face = 0; face < faceCount; face++)
+            {
+                this->order[face] = face;
+            }
+
+            if (faceCount > 0)
+            {
+                this->BuildNode(0, 0, faceCount);
+            }
+        }
+
+    public:
+
+        /** @brief Build hierarchy over mesh
+         * @param mesh Mesh
+         * @param zone Memory zone to allocate hierarchy in
+         */
+        MeshBvh(const Types::Mesh& mesh, const Memory::Zone zone = Memory::Zone::HWRam)
+        {
+            this->Build(mesh.Vertices, mesh.Faces, mesh.FaceCount, zone);
+        }
+
+        /** @brief Build hierarchy over smooth mesh
+         * @param mesh Mesh
+         * @param zone Memory zone to allocate hierarchy in
+         */
+        MeshBvh(const Types::SmoothMesh& mesh, const Memory::Zone zone = Memory::Zone::HWRam)
+        {
+            this->Build(mesh.Vertices, mesh.Faces, mesh.FaceCount, zone);
+        }
+
+        /** @brief Use hierarchy built offline
+         * @details Node and face order arrays are the ones returned by SRL::MeshBvh::GetNodes() and SRL::MeshBvh::GetFaceOrder(), they are not copied
+         * @param vertices Mesh vertices
+         * @param faces Mesh faces
+         * @param faceCount Number of faces
+         * @param nodes Hierarchy nodes
+         * @param nodeCount Number of nodes
+         * @param order Face order
+         */
+        MeshBvh(
+            const Math::Types::Vector3D* vertices,
+            const Types::Polygon* faces,
+            const size_t faceCount,
+            Node* nodes,
+            const size_t nodeCount,
+            uint16_t* order) :
+            vertices(vertices), faces(faces), faceCount(faceCount), nodes(nodes), nodeCount(nodeCount), order(order), owned(false), visited(0)
+        {
+        }
+
+        /** @brief Disable copying
+         */
+        MeshBvh(const MeshBvh&) = delete;
+
+        /** @brief Disable copying
+         */
+        MeshBvh& operator=(const MeshBvh&) = delete;
+
+        /** @brief Destroy hierarchy
+         */
+        ~MeshBvh()
+        {
+            if (this->owned)
+            {
+                Memory::Free(this->nodes);
+                Memory::Free(this->order);
+            }
+        }
+
+        /** @brief Find first face crossed by a segment
+         * @param start Segment start
+         * @param end Segment end
+         * @param hit Closest hit, can be nullptr
+         * @return True if any face was hit
+         */
+        bool Segment(const Math::Types::Vector3D& start, const Math::Types::Vector3D& end, Hit* hit = nullptr)
+        {
+            this->visited = 0;
+
+            if (this->nodeCount == 0)
+            {
+                return false;
+            }
+
+            const Point origin = MeshBvh::ToPoint(start);
+            const Point delta = MeshBvh::Subtract(MeshBvh::ToPoint(end), origin);
+            int32_t best = 0x10000;
+            size_t bestFace = 0;
+            bool found = false;
+
+            // Segment is shortened to the closest hit found so far
+            Point half = { delta.X >> 1, delta.Y >> 1, delta.Z >> 1 };
+            Point center = { origin.X + half.X, origin.Y + half.Y, origin.Z + half.Z };
+
+            uint16_t stack[MeshBvh::MaxDepth * 2];
+            size_t top = 0;
+            stack[top++] = 0;
+
+            while (top > 0)
+            {
+                const uint16_t index = stack[--top];
+                const Node& node = this->nodes[index];
+                this->visited++;
+
+                if (!MeshBvh::SegmentOverlapsNode(node, center, half))
+                {
+                    continue;
+                }
+
+                if (node.Count == 0)
+                {
+                    const uint16_t left = index + 1;
+                    const int32_t direction = node.Axis == 0 ? delta.X : (node.Axis == 1 ? delta.Y : delta.Z);
+
+                    // Visit nearer child first, right child holds faces further along the split axis
+                    if (direction < 0)
+                    {
+                        stack[top++] = left;
+                        stack[top++] = node.Offset;
+                    }
+                    else
+                    {
+                        stack[top++] = node.Offset;
+                        stack[top++] = left;
+                    }
+
+                    continue;
+                }
+
+                for (size_t entry = node.Offset; entry < static_cast<size_t>(node.Offset + node.Count); entry++)
+                {
+                    const size_t face = this->order[entry];
+                    const Point a = this->GetVertex(face, 0);
+                    const Point b = this->GetVertex(face, 1);
+                    const Point c = this->GetVertex(face, 2);
+                    int32_t fraction;
+                    bool crossed = MeshBvh::SegmentTriangle(origin, delta, a, b, c, fraction);
+
+                    if (!crossed && this->faces[face].Vertices[3] != this->faces[face].Vertices[2])
+                    {
+                        crossed = MeshBvh::SegmentTriangle(origin, delta, a, c, this->GetVertex(face, 3), fraction);
+                    }
+
+                    if (crossed && fraction < best)
+                    {
+                        best = fraction;
+                        bestFace = face;
+                        found = true;
+                        half = Point {
+                            static_cast<int32_t>((static_cast<int64_t>(delta.X) * best) >> 17),
+                            static_cast<int32_t>((static_cast<int64_t>(delta.Y) * best) >> 17),
+                            static_cast<int32_t>((static_cast<int64_t>(delta.Z) * best) >> 17) };
+                        center = Point { origin.X + half.X, origin.Y + half.Y, origin.Z + half.Z };
+                    }
+                }
+            }
+
+            if (found && hit != nullptr)
+            {
+                const Math::Types::Fxp fraction = Math::Types::Fxp::BuildRaw(best);
+                hit->Face = bestFace;
+                hit->Fraction = fraction;
+                hit->Point = Math::Types::Vector3D(
+                    start.X + ((end.X - start.X) * fraction),
+                    start.Y + ((end.Y - start.Y) * fraction),
+                    start.Z + ((end.Z - start.Z) * fraction));
+                hit->Normal = this->faces[bestFace].Normal;
+            }
+
+            return found;
+        }
+
+        /** @brief Find first face crossed by a ray
+         * @param origin Ray origin
+         * @param direction Ray direction (unit vector)
+         * @param length Maximal distance
+         * @param hit Closest hit, fraction is relative to the length, can be nullptr
+         * @return True if any face was hit
+         */
+        bool Ray(const Math::Types::Vector3D& origin, const Math::Types::Vector3D& direction, const Math::Types::Fxp& length, Hit* hit = nullptr)
+        {
+            return this->Segment(
+                origin,
+                Math::Types::Vector3D(origin.X + (direction.X * length), origin.Y + (direction.Y * length), origin.Z + (direction.Z * length)),
+                hit);
+        }
+
+        /** @brief Find faces touching a sphere
+         * @param center Sphere center
+         * @param radius Sphere radius
+         * @param result Indices of faces touching the sphere
+         * @param capacity Size of the result array
+         * @return Number of faces found (can be more than capacity)
+         */
+        size_t Sphere(const Math::Types::Vector3D& center, const Math::Types::Fxp& radius, uint16_t* result, const size_t capacity)
+        {
+            this->visited = 0;
+
+            if (this->nodeCount == 0)
+            {
+                return 0;
+            }
+
+            const Point point = MeshBvh::ToPoint(center);
+            const int64_t fineRadius = radius.RawValue() >> MeshBvh::FineShift;
+            const int64_t radiusSquared = fineRadius * fineRadius;
+            size_t found = 0;
+
+            uint16_t stack[MeshBvh::MaxDepth * 2];
+            size_t top = 0;
+            stack[top++] = 0;
+
+            while (top > 0)
+            {
+                const uint16_t index = stack[--top];
+                const Node& node = this->nodes[index];
+                this->visited++;
+
+                // Squared distance from sphere center to node bounds
+                const int32_t coordinates[3] = { point.X, point.Y, point.Z };
+                int64_t distance = 0;
+
+                for (size_t axis = 0; axis < 3; axis++)
+                {
+                    const int32_t min = static_cast<int32_t>(node.Min[axis]) << (16 - MeshBvh::FineShift);
+                    const int32_t max = static_cast<int32_t>(node.Max[axis]) << (16 - MeshBvh::FineShift);
+                    const int64_t outside = coordinates[axis] < min ? min - coordinates[axis] : (coordinates[axis] > max ? coordinates[axis] - max : 0);
+                    distance += outside * outside;
+                }
+
+                if (distance > radiusSquared)
+                {
+                    continue;
+                }
+
+                if (node.Count == 0)
+                {
+                    stack[top++] = node.Offset;
+                    stack[top++] = index + 1;
+                    continue;
+                }
+
+                for (size_t entry = node.Offset; entry < static_cast<size_t>(node.Offset + node.Count); entry++)
+                {
+                    const size_t face = this->order[entry];
+                    const Point a = this->GetVertex(face, 0);
+                    const Point b = this->GetVertex(face, 1);
+                    const Point c = this->GetVertex(face, 2);
+                    bool touching = MeshBvh::SphereTriangle(point, radiusSquared, this->faces[face].Normal, a, b, c);
+
+                    if (!touching && this->faces[face].Vertices[3] != this->faces[face].Vertices[2])
+                    {
+                        touching = MeshBvh::SphereTriangle(point, radiusSquared, this->faces[face].Normal, a, c, this->GetVertex(face, 3));
+                    }
+
+                    if (touching)
+                    {
+                        if (found < capacity)
+                        {
+                            result[found] = face;
+                        }
+
+                        found++;
+                    }
+                }
+            }
+
+            return found;
+        }
+
+        /** @brief Get number of nodes visited by last query
+         * @return Number of nodes
+         */
+        size_t GetVisitedNodes() const
+        {
+            return this->visited;
+        }
+
+        /** @brief Get hierarchy nodes
+         * @return Nodes stored depth first
+         */
+        const Node* GetNodes() const
+        {
+            return this->nodes;
+        }
+
+        /** @brief Get number of hierarchy nodes
+         * @return Number of nodes
+         */
+        size_t GetNodeCount() const
+        {
+            return this->nodeCount;
+        }
+
+        /** @brief Get face indices in leaf order
+         * @return Face order
+         */
+        const uint16_t* GetFaceOrder() const
+        {
+            return this->order;
+        }
+    };
+}
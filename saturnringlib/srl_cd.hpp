@@ -3,6 +3,12 @@
 #include "srl_base.hpp"
 #include "srl_debug.hpp"
 
+#ifndef SRL_MAX_CD_CACHE_FILES
+/** @brief Maximal number of files that can be held by SRL::Cd::Cache
+ */
+#define SRL_MAX_CD_CACHE_FILES 32
+#endif
+
 namespace SRL
 {
     /** @brief File and CD access wrapper
@@ -199,6 +205,476 @@ namespace SRL
             }
         };
 
+        /** @brief Preload cache for frequently used files
+         * @details Files listed in a manifest are loaded once (e.g. during title screen) into cartridge RAM.
+         * Any later SRL::Cd::File read of a cached file (including resources loaded through SRL::Resources) is served
+         * from memory instead of the disc. When RAM cartridge is not inserted nothing is cached and files are read from disc as usual.
+         *
+         * Manifest is a plain text file with one file path per line, relative to the current directory.
+         * Directories are separated by '/', empty lines and lines starting with '#' are skipped.
+         * @code {.cpp}
+         * // HOT.TXT:
+         * // SPRITES.TGA
+         * // SOUND/BANK0.PCM
+         * // UI/FONT.BIN
+         *
+         * SRL::Cd::Cache::LoadManifest("HOT.TXT");
+         *
+         * while (!SRL::Cd::Cache::LoadNext())
+         * {
+         *     DrawProgressBar(SRL::Cd::Cache::GetProgress());
+         *     SRL::Core::Synchronize();
+         * }
+         *
+         * SRL::Cd::File file("SPRITES.TGA"); // Served from cartridge RAM
+         * @endcode
+         * @note Files are identified by their location on disc, so cache works regardless of which directory file was opened from
+         */
+        class Cache
+        {
+        public:
+
+            /** @brief Cached file
+             */
+            struct Entry
+            {
+                /** @brief Location of the file on disc (frame address)
+                 */
+                int32_t Address;
+
+                /** @brief Size of the file in bytes
+                 */
+                int32_t Size;
+
+                /** @brief Size of the sector
+                 */
+                int32_t SectorSize;
+
+                /** @brief File contents
+                 */
+                uint8_t* Data;
+            };
+
+            /** @brief Cache statistics
+             */
+            struct Statistics
+            {
+                /** @brief Number of cached files
+                 */
+                uint16_t Files;
+
+                /** @brief Number of bytes used by cached files
+                 */
+                size_t Bytes;
+
+                /** @brief Number of reads served from cache
+                 */
+                uint32_t Hits;
+
+                /** @brief Number of files that could not be cached
+                 */
+                uint16_t Failed;
+            };
+
+        private:
+
+            /** @brief Cached files
+             */
+            inline static Entry entries[SRL_MAX_CD_CACHE_FILES];
+
+            /** @brief Number of cached files
+             */
+            inline static uint16_t count = 0;
+
+            /** @brief Memory zone files are cached in
+             */
+            inline static Memory::Zone zone = Memory::Zone::CartRam;
+
+            /** @brief Cache statistics
+             */
+            inline static Statistics statistics = { 0, 0, 0, 0 };
+
+            /** @brief Loaded manifest text
+             */
+            inline static char* manifest = nullptr;
+
+            /** @brief Next manifest line to load
+             */
+            inline static char* nextLine = nullptr;
+
+            /** @brief Number of files in manifest
+             */
+            inline static uint16_t manifestFiles = 0;
+
+            /** @brief Number of processed files from manifest
+             */
+            inline static uint16_t manifestProcessed = 0;
+
+            /** @brief Get location of a file on disc
+             * @param fileId File identifier
+             * @return Frame address or -1 if file does not exist
+             */
+            static int32_t GetFileAddress(const int32_t fileId)
+            {
+                GfsDirId info;
+
+                if (fileId >= 0 && GFS_GetDirInfo(fileId, &info) >= 0)
+                {
+                    return info.dirrec.fad;
+                }
+
+                return -1;
+            }
+
+            /** @brief Skip to next non-empty manifest line
+             * @param line Current position in manifest
+             * @return Start of the next file path or nullptr if there are none
+             */
+            static char* SkipToPath(char* line)
+            {
+                while (line != nullptr && *line != '\0')
+                {
+                    if (*line == '\n' || *line == '\r' || *line == ' ' || *line == '\t')
+                    {
+                        line++;
+                    }
+                    else if (*line == '#')
+                    {
+                        while (*line != '\0' && *line != '\n')
+                        {
+                            line++;
+                        }
+                    }
+                    else
+                    {
+                        return line;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            /** @brief Disable constructor
+             */
+            Cache() = delete;
+
+            /** @brief Disable destructor
+             */
+            ~Cache() = delete;
+
+        public:
+
+            /** @brief Check whether files can be cached
+             * @return True if memory zone used by the cache is available (RAM cartridge is inserted)
+             */
+            static bool IsAvailable()
+            {
+                return Cache::zone != Memory::Zone::CartRam || Memory::CartRam::IsAvailable();
+            }
+
+            /** @brief Set memory zone files are cached in
+             * @note Only affects files cached after the call
+             * @param zone Memory zone (cartridge RAM by default)
+             */
+            static void SetZone(const Memory::Zone zone)
+            {
+                Cache::zone = zone;
+            }
+
+            /** @brief Find cached file
+             * @param fileId File identifier
+             * @return Cached file or nullptr if file is not cached
+             */
+            static const Entry* Find(const int32_t fileId)
+            {
+                if (Cache::count > 0)
+                {
+                    const int32_t address = Cache::GetFileAddress(fileId);
+
+                    for (uint16_t index = 0; index < Cache::count; index++)
+                    {
+                        if (Cache::entries[index].Address == address)
+                        {
+                            return &Cache::entries[index];
+                        }
+                    }
+                }
+
+                return nullptr;
+            }
+
+            /** @brief Copy part of cached file
+             * @param entry Cached file
+             * @param offset Byte offset in the file
+             * @param size Number of bytes to copy
+             * @param destination Destination buffer
+             * @return Number of bytes copied
+             */
+            static int32_t Read(const Entry* entry, const int32_t offset, const int32_t size, void* destination)
+            {
+                if (offset < 0 || offset >= entry->Size || size <= 0)
+                {
+                    return 0;
+                }
+
+                const int32_t length = Math::Min<int32_t>(size, entry->Size - offset);
+                const uint8_t* source = entry->Data + offset;
+                uint8_t* target = reinterpret_cast<uint8_t*>(destination);
+                int32_t copied = 0;
+
+                // Cartridge RAM sits on the slow A-bus, copy by words when possible
+                if (((reinterpret_cast<uint32_t>(source) | reinterpret_cast<uint32_t>(target)) & 3) == 0)
+                {
+                    for (; copied + 4 <= length; copied += 4)
+                    {
+                        *reinterpret_cast<uint32_t*>(target + copied) = *reinterpret_cast<const uint32_t*>(source + copied);
+                    }
+                }
+
+                for (; copied < length; copied++)
+                {
+                    target[copied] = source[copied];
+                }
+
+                Cache::statistics.Hits++;
+                return length;
+            }
+
+            /** @brief Load file into cache
+             * @param fileId File identifier
+             * @return True if file is cached
+             */
+            static bool Add(const int32_t fileId)
+            {
+                const int32_t address = Cache::GetFileAddress(fileId);
+
+                if (address < 0)
+                {
+                    Cache::statistics.Failed++;
+                    return false;
+                }
+
+                for (uint16_t index = 0; index < Cache::count; index++)
+                {
+                    if (Cache::entries[index].Address == address)
+                    {
+                        return true;
+                    }
+                }
+
+                if (Cache::count >= SRL_MAX_CD_CACHE_FILES || !Cache::IsAvailable())
+                {
+                    Cache::statistics.Failed++;
+                    return false;
+                }
+
+                const GfsHn handle = GFS_Open(fileId);
+
+                if (handle == nullptr)
+                {
+                    Cache::statistics.Failed++;
+                    return false;
+                }
+
+                Cd::File file(handle, fileId);
+
+                if (!file.IsOpen() || file.Size.Bytes <= 0)
+                {
+                    Cache::statistics.Failed++;
+                    return false;
+                }
+
+                // Whole sectors are allocated, so the last one can be transferred as is
+                const int32_t allocated = file.Size.Sectors * file.Size.SectorSize;
+                uint8_t* data = reinterpret_cast<uint8_t*>(Memory::Malloc(allocated, Cache::zone));
+
+                if (data == nullptr)
+                {
+                    Cache::statistics.Failed++;
+                    return false;
+                }
+
+                if (file.LoadBytes(0, file.Size.Bytes, data) != file.Size.Bytes)
+                {
+                    Memory::Free(data);
+                    Cache::statistics.Failed++;
+                    return false;
+                }
+
+                Cache::entries[Cache::count++] = Entry { address, file.Size.Bytes, file.Size.SectorSize, data };
+                Cache::statistics.Files++;
+                Cache::statistics.Bytes += allocated;
+                return true;
+            }
+
+            /** @brief Load file into cache
+             * @param path File path relative to current directory, directories are separated by '/'
+             * @return True if file is cached
+             */
+            static bool Add(const char* path)
+            {
+                char segment[16];
+                size_t length = 0;
+                uint8_t depth = 0;
+                bool result = false;
+
+                for (const char* character = path;; character++)
+                {
+                    if (*character == '/' || *character == '\0' || *character == '\n' || *character == '\r')
+                    {
+                        segment[length] = '\0';
+                        length = 0;
+
+                        if (*character != '/')
+                        {
+                            result = Cache::Add(GFS_NameToId(reinterpret_cast<int8_t*>(segment)));
+                            break;
+                        }
+                        else if (Cd::ChangeDir(segment) < ErrorCode::ErrorOk)
+                        {
+                            Cache::statistics.Failed++;
+                            break;
+                        }
+
+                        depth++;
+                    }
+                    else if (length < sizeof(segment) - 1)
+                    {
+                        segment[length++] = *character;
+                    }
+                }
+
+                // Return to the directory we started in
+                while (depth-- > 0)
+                {
+                    Cd::ChangeDir("..");
+                }
+
+                return result;
+            }
+
+            /** @brief Load manifest listing files to cache
+             * @note Files are not loaded yet, use SRL::Cd::Cache::LoadNext() or SRL::Cd::Cache::LoadAll()
+             * @param name Manifest file name
+             * @return Number of files listed in the manifest, 0 if manifest could not be read or cache is not available
+             */
+            static uint16_t LoadManifest(const char* name)
+            {
+                Cache::CloseManifest();
+
+                if (!Cache::IsAvailable())
+                {
+                    return 0;
+                }
+
+                Cd::File file(name);
+
+                if (!file.Exists() || file.Size.Bytes <= 0)
+                {
+                    return 0;
+                }
+
+                Cache::manifest = new char[(file.Size.Sectors * file.Size.SectorSize) + 1];
+
+                if (file.LoadBytes(0, file.Size.Bytes, Cache::manifest) != file.Size.Bytes)
+                {
+                    Cache::CloseManifest();
+                    return 0;
+                }
+
+                Cache::manifest[file.Size.Bytes] = '\0';
+                Cache::nextLine = Cache::SkipToPath(Cache::manifest);
+
+                for (char* line = Cache::nextLine; line != nullptr; Cache::manifestFiles++)
+                {
+                    while (*line != '\0' && *line != '\n')
+                    {
+                        line++;
+                    }
+
+                    line = Cache::SkipToPath(line);
+                }
+
+                return Cache::manifestFiles;
+            }
+
+            /** @brief Load next file from manifest
+             * @return True if all files from manifest were processed
+             */
+            static bool LoadNext()
+            {
+                if (Cache::nextLine == nullptr)
+                {
+                    Cache::CloseManifest();
+                    return true;
+                }
+
+                Cache::Add(Cache::nextLine);
+                Cache::manifestProcessed++;
+
+                while (*Cache::nextLine != '\0' && *Cache::nextLine != '\n')
+                {
+                    Cache::nextLine++;
+                }
+
+                Cache::nextLine = Cache::SkipToPath(Cache::nextLine);
+                return false;
+            }
+
+            /** @brief Load all remaining files from manifest
+             */
+            static void LoadAll()
+            {
+                while (!Cache::LoadNext());
+            }
+
+            /** @brief Get manifest loading progress
+             * @return Progress in percent
+             */
+            static uint8_t GetProgress()
+            {
+                return Cache::manifestFiles > 0 ? static_cast<uint8_t>((Cache::manifestProcessed * 100) / Cache::manifestFiles) : 100;
+            }
+
+            /** @brief Release manifest text, files that were not loaded yet are skipped
+             */
+            static void CloseManifest()
+            {
+                if (Cache::manifest != nullptr)
+                {
+                    delete[] Cache::manifest;
+                }
+
+                Cache::manifest = nullptr;
+                Cache::nextLine = nullptr;
+                Cache::manifestFiles = 0;
+                Cache::manifestProcessed = 0;
+            }
+
+            /** @brief Remove all files from cache
+             * @warning Files opened while they were cached must be closed first
+             */
+            static void Clear()
+            {
+                for (uint16_t index = 0; index < Cache::count; index++)
+                {
+                    Memory::Free(Cache::entries[index].Data);
+                }
+
+                Cache::count = 0;
+                Cache::statistics.Files = 0;
+                Cache::statistics.Bytes = 0;
+            }
+
+            /** @brief Get cache statistics
+             * @return Cache statistics
+             */
+            static const Statistics& GetStatistics()
+            {
+                return Cache::statistics;
+            }
+        };
+
         /** @brief Disk file
          */
         struct File
@@ -220,6 +696,10 @@ namespace SRL
              */
             uint8_t *workBuffer;
 
+            /** @brief Cached file contents, nullptr if file is read from disc
+             */
+            const Cache::Entry* cached;
+
             /** @brief Get the byte offset inside current work buffer
              * @param absolute Absolute position
              * @param workBufferSize Size of a work buffer
@@ -257,7 +737,8 @@ namespace SRL
                                                                    Size(getSize ? FileSize(handle) : FileSize()),
                                                                    identifier(fid),
                                                                    workBuffer(nullptr),
-                                                                   readBytes(0)
+                                                                   readBytes(0),
+                                                                   cached(Cache::Find(fid))
             {
                 #if defined(SRL_MAX_CD_FILES) && (SRL_MAX_CD_FILES < 1)
                     static_assert(false, "SRL_MAX_CD_FILES is not set properly to instantiate this class");
@@ -271,7 +752,8 @@ namespace SRL
                                      Size(0),
                                      identifier(-1),
                                      workBuffer(nullptr),
-                                     readBytes(0)
+                                     readBytes(0),
+                                     cached(nullptr)
             {
                 #if defined(SRL_MAX_CD_FILES) && (SRL_MAX_CD_FILES < 1)
                     static_assert(false, "SRL_MAX_CD_FILES is not set properly to instantiate this class");
@@ -287,6 +769,7 @@ namespace SRL
                     if (id >= 0)
                     {
                         this->identifier = id;
+                        this->cached = Cache::Find(id);
 
                         if (this->Open())
                         {
@@ -377,9 +860,22 @@ namespace SRL
              */
             constexpr bool IsEOF()
             {
+                if (this->cached != nullptr)
+                {
+                    return this->readBytes >= this->Size.Bytes;
+                }
+
                 return (GFS_IsEof(Handle) == TRUE);
             }
 
+            /** @brief File contents are served from SRL::Cd::Cache
+             * @return True if file is cached
+             */
+            constexpr bool IsCached()
+            {
+                return this->cached != nullptr;
+            }
+
             /**
              * @}
              */
@@ -401,6 +897,11 @@ namespace SRL
                 bool wasOpen = false;
                 int32_t result = 0;
 
+                if (this->cached != nullptr)
+                {
+                    return Cache::Read(this->cached, sectorOffset * this->cached->SectorSize, size, destination);
+                }
+
                 if (this->identifier >= 0)
                 {
                     if (this->IsOpen())
@@ -431,6 +932,13 @@ namespace SRL
             {
                 int32_t workBufferSize = this->Size.SectorSize * File::SectorsToReadAtOnce;
 
+                if (this->cached != nullptr && this->IsOpen() && size > 0)
+                {
+                    const int32_t read = Cache::Read(this->cached, this->readBytes, size, destination);
+                    this->readBytes += read;
+                    return read;
+                }
+
                 if (this->IsOpen() && size > 0 && this->Size.Bytes > 0)
                 {
                     int32_t currentlyRead = 0;
@@ -508,6 +1016,15 @@ namespace SRL
              */
             int32_t ReadSectors(const int32_t sectorCount, void* destination)
             {
+                if (this->cached != nullptr && this->IsOpen() && !this->IsEOF() && sectorCount > 0)
+                {
+                    const int32_t currentSector = this->readBytes / this->Size.SectorSize;
+                    const int32_t offset = currentSector * this->Size.SectorSize;
+                    const int32_t read = Cache::Read(this->cached, offset, sectorCount * this->Size.SectorSize, destination);
+                    this->readBytes = offset + read;
+                    return read;
+                }
+
                 if (this->IsOpen() && !this->IsEOF() && sectorCount > 0)
                 {
                     // Number of the current sector offset
@@ -540,6 +1057,17 @@ namespace SRL
                 int32_t result = -1;
                 int32_t workBufferSize = this->Size.SectorSize * File::SectorsToReadAtOnce;
 
+                if (this->cached != nullptr)
+                {
+                    if (this->IsOpen() && offset >= 0 && offset < this->Size.Bytes)
+                    {
+                        this->readBytes = offset;
+                        return offset;
+                    }
+
+                    return result;
+                }
+
                 if (this->IsOpen() && offset >= 0 && offset < this->Size.Bytes)
                 {
                     // Initialize read buffer if does not exist yet
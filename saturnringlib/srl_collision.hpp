@@ -0,0 +1,1246 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_slave.hpp"
+
+namespace SRL
+{
+    /** @brief Fixed point collision world
+     * @details Bodies are boxes, spheres or capsules. Broadphase uses sweep and prune along the X axis, body order is kept
+     * from the previous frame, so sorting is nearly linear when bodies move a little each frame.
+     * Pairs passing broadphase and layer filtering are tested exactly and reported as contacts.
+     * Contacts are remembered between frames, so each one is reported as entering, staying or exiting.
+     *
+     * For 2D games keep Z coordinate and Z size of all bodies at zero.
+     * @code {.cpp}
+     * SRL::CollisionWorld world(256, 512);
+     *
+     * int32_t player = world.Add(SRL::CollisionWorld::Body::Capsule(Vector3D(0.0, 0.0, 0.0), Vector3D(0.0, 8.0, 0.0), 4.0, PlayerLayer, EnemyLayer | WallLayer));
+     * int32_t enemy = world.Add(SRL::CollisionWorld::Body::Sphere(Vector3D(20.0, 0.0, 0.0), 6.0, EnemyLayer, PlayerLayer));
+     *
+     * // Each frame
+     * world.Get(player)->Position = playerPosition;
+     * world.Update();
+     *
+     * for (size_t index = 0; index < world.GetContactCount(); index++)
+     * {
+     *     const SRL::CollisionWorld::Contact& contact = world.GetContacts()[index];
+     *
+     *     if (contact.State == SRL::CollisionWorld::ContactState::Enter)
+     *     {
+     *         // Bodies contact.A and contact.B started touching
+     *     }
+     * }
+     * @endcode
+     */
+    class CollisionWorld
+    {
+    public:
+
+        /** @brief Body shape
+         */
+        enum class Shape : uint8_t
+        {
+            /** @brief Axis aligned box, size is half of the box extents
+             */
+            Box = 0,
+
+            /** @brief Sphere (circle in 2D)
+             */
+            Sphere = 1,
+
+            /** @brief Capsule, size is half of the segment between its end spheres
+             */
+            Capsule = 2
+        };
+
+        /** @brief Contact state
+         */
+        enum class ContactState : uint8_t
+        {
+            /** @brief Bodies started touching this frame
+             */
+            Enter = 0,
+
+            /** @brief Bodies were already touching in previous frame
+             */
+            Stay = 1,
+
+            /** @brief Bodies stopped touching this frame
+             */
+            Exit = 2
+        };
+
+        /** @brief Collision body
+         */
+        struct Body
+        {
+            /** @brief Body shape
+             */
+            Shape Type;
+
+            /** @brief Layers the body belongs to
+             */
+            uint16_t Layer;
+
+            /** @brief Layers the body collides with
+             */
+            uint16_t Mask;
+
+            /** @brief Body center
+             */
+            Math::Types::Vector3D Position;
+
+            /** @brief Half extents of a box or half segment of a capsule
+             */
+            Math::Types::Vector3D Size;
+
+            /** @brief Radius of a sphere or capsule
+             */
+            Math::Types::Fxp Radius;
+
+            /** @brief User data
+             */
+            void* UserData;
+
+            /** @brief Create box body
+             * @param position Box center
+             * @param halfSize Half of the box extents
+             * @param layer Layers the body belongs to
+             * @param mask Layers the body collides with
+             * @return Box body
+             */
+            static Body Box(
+                const Math::Types::Vector3D& position,
+                const Math::Types::Vector3D& halfSize,
+                const uint16_t layer = 1,
+                const uint16_t mask = 0xffff)
+            {
+                return Body { Shape::Box, layer, mask, position, halfSize, 0.0, nullptr };
+            }
+
+            /** @brief Create sphere body
+             * @param position Sphere center
+             * @param radius Sphere radius
+             * @param layer Layers the body belongs to
+             * @param mask Layers the body collides with
+             * @return Sphere body
+             */
+            static Body Sphere(
+                const Math::Types::Vector3D& position,
+                const Math::Types::Fxp& radius,
+                const uint16_t layer = 1,
+                const uint16_t mask = 0xffff)
+            {
+                return Body { Shape::Sphere, layer, mask, position, Math::Types::Vector3D(), radius, nullptr };
+            }
+
+            /** @brief Create capsule body
+             * @param position Capsule center
+             * @param halfAxis Vector from capsule center to center of one of its end spheres
+             * @param radius Capsule radius
+             * @param layer Layers the body belongs to
+             * @param mask Layers the body collides with
+             * @return Capsule body
+             */
+            static Body Capsule(
+                const Math::Types::Vector3D& position,
+                const Math::Types::Vector3D& halfAxis,
+                const Math::Types::Fxp& radius,
+                const uint16_t layer = 1,
+                const uint16_t mask = 0xffff)
+            {
+                return Body { Shape::Capsule, layer, mask, position, halfAxis, radius, nullptr };
+            }
+        };
+
+        /** @brief Contact between two bodies
+         */
+        struct Contact
+        {
+            /** @brief First body (lower identifier)
+             */
+            uint16_t A;
+
+            /** @brief Second body (higher identifier)
+             */
+            uint16_t B;
+
+            /** @brief Contact state
+             */
+            ContactState State;
+
+            /** @brief Contact normal pointing from body A to body B (zero for exiting contacts)
+             */
+            Math::Types::Vector3D Normal;
+
+            /** @brief Penetration depth along the normal (zero for exiting contacts)
+             */
+            Math::Types::Fxp Depth;
+        };
+
+        /** @brief Statistics of last update
+         */
+        struct Statistics
+        {
+            /** @brief Number of bodies
+             */
+            uint16_t Bodies;
+
+            /** @brief Number of pairs that passed broadphase and layer filtering
+             */
+            uint16_t Candidates;
+
+            /** @brief Number of touching pairs
+             */
+            uint16_t Contacts;
+
+            /** @brief Number of contacts that did not fit into contact buffer, exits included
+             * @note Dropped exit is not reported again, game has to recheck pairs it tracks when this is not zero
+             */
+            uint16_t Dropped;
+        };
+
+    private:
+
+        /** @brief Point in raw fixed point coordinates
+         */
+        struct Point
+        {
+            /** @brief X coordinate
+             */
+            int32_t X;
+
+            /** @brief Y coordinate
+             */
+            int32_t Y;
+
+            /** @brief Z coordinate
+             */
+            int32_t Z;
+        };
+
+        /** @brief Bounding box of a body in raw fixed point coordinates
+         */
+        struct Bounds
+        {
+            /** @brief Minimal corner
+             */
+            Point Min;
+
+            /** @brief Maximal corner
+             */
+            Point Max;
+        };
+
+        /** @brief Part of the sweep done on slave CPU
+         */
+        class SweepTask : public Types::ITask
+        {
+        public:
+
+            /** @brief World to sweep
+             */
+            CollisionWorld* World;
+
+            /** @brief First position in sorted body list
+             */
+            size_t Start;
+
+            /** @brief Position after the last one
+             */
+            size_t End;
+
+            /** @brief Number of contacts found
+             */
+            size_t Found;
+
+            /** @brief Number of candidate pairs
+             */
+            size_t Candidates;
+
+        protected:
+
+            /** @brief Sweep on slave
+             */
+            void Do() override
+            {
+                // Master updated body positions since slave last looked at them
+                slCashPurge();
+                this->Found = this->World->Sweep(this->Start, this->End, this->World->slaveContacts, this->World->maxContacts, &this->Candidates);
+            }
+        };
+
+        /** @brief Fixed point one
+         */
+        static constexpr int32_t One = 0x10000;
+
+        /** @brief Bodies
+         */
+        Body* bodies;
+
+        /** @brief Body bounds
+         */
+        Bounds* bounds;
+
+        /** @brief Body slot is used
+         */
+        uint8_t* used;
+
+        /** @brief Bodies sorted by minimal X coordinate
+         */
+        uint16_t* order;
+
+        /** @brief Contacts of current frame
+         */
+        Contact* contacts;
+
+        /** @brief Contacts found by slave CPU
+         */
+        Contact* slaveContacts;
+
+        /** @brief Sorted pair keys touching in previous frame
+         */
+        uint32_t* previous;
+
+        /** @brief Sorted pair keys touching in current frame
+         */
+        uint32_t* current;
+
+        /** @brief Maximal number of bodies
+         */
+        size_t maxBodies;
+
+        /** @brief Maximal number of contacts
+         */
+        size_t maxContacts;
+
+        /** @brief Number of bodies
+         */
+        size_t bodyCount;
+
+        /** @brief Number of contacts
+         */
+        size_t contactCount;
+
+        /** @brief Number of pairs in previous frame
+         */
+        size_t previousCount;
+
+        /** @brief Statistics of last update
+         */
+        Statistics statistics;
+
+        /** @brief Get pair key
+         * @param contact Contact
+         * @return Key ordered by body identifiers
+         */
+        static constexpr uint32_t GetKey(const Contact& contact)
+        {
+            return (static_cast<uint32_t>(contact.A) << 16) | contact.B;
+        }
+
+        /** @brief Convert vector to point
+         * @param vector Vector
+         * @return Raw point
+         */
+        static Point ToPoint(const Math::Types::Vector3D& vector)
+        {
+            return Point { vector.X.RawValue(), vector.Y.RawValue(), vector.Z.RawValue() };
+        }
+
+        /** @brief Multiply two fixed point numbers
+         * @param a First number
+         * @param b Second number
+         * @return Product
+         */
+        static int32_t Multiply(const int32_t a, const int32_t b)
+        {
+            return static_cast<int32_t>((static_cast<int64_t>(a) * b) >> 16);
+        }
+
+        /** @brief Dot product with 32.32 precision
+         * @param a First vector
+         * @param b Second vector
+         * @return Dot product
+         */
+        static int64_t Dot(const Point& a, const Point& b)
+        {
+            return (static_cast<int64_t>(a.X) * b.X) + (static_cast<int64_t>(a.Y) * b.Y) + (static_cast<int64_t>(a.Z) * b.Z);
+        }
+
+        /** @brief Subtract points
+         * @param a First point
+         * @param b Second point
+         * @return Difference
+         */
+        static Point Subtract(const Point& a, const Point& b)
+        {
+            return Point { a.X - b.X, a.Y - b.Y, a.Z - b.Z };
+        }
+
+        /** @brief Integer square root
+         * @param value Value
+         * @return Square root
+         */
+        static uint32_t SquareRoot(uint64_t value)
+        {
+            uint64_t result = 0;
+            uint64_t bit = static_cast<uint64_t>(1) << 62;
+
+            while (bit > value)
+            {
+                bit >>= 2;
+            }
+
+            while (bit != 0)
+            {
+                if (value >= result + bit)
+                {
+                    value -= result + bit;
+                    result = (result >> 1) + bit;
+                }
+                else
+                {
+                    result >>= 1;
+                }
+
+                bit >>= 2;
+            }
+
+            return static_cast<uint32_t>(result);
+        }
+
+        /** @brief Get ratio clamped to 0-1 range
+         * @param numerator Numerator
+         * @param denominator Denominator (positive)
+         * @return Fixed point ratio
+         */
+        static int32_t Fraction(int64_t numerator, int64_t denominator)
+        {
+            if (numerator <= 0 || denominator <= 0)
+            {
+                return 0;
+            }
+            else if (numerator >= denominator)
+            {
+                return CollisionWorld::One;
+            }
+
+            // Keep shifted numerator within 64 bits
+            while (denominator >= (static_cast<int64_t>(1) << 46))
+            {
+                numerator >>= 16;
+                denominator >>= 16;
+            }
+
+            return denominator > 0 ? static_cast<int32_t>((numerator << 16) / denominator) : 0;
+        }
+
+        /** @brief Get point on segment
+         * @param start Segment start
+         * @param direction Segment direction
+         * @param fraction Position on segment (0-1)
+         * @return Point on segment
+         */
+        static Point PointOnSegment(const Point& start, const Point& direction, const int32_t fraction)
+        {
+            return Point {
+                start.X + CollisionWorld::Multiply(direction.X, fraction),
+                start.Y + CollisionWorld::Multiply(direction.Y, fraction),
+                start.Z + CollisionWorld::Multiply(direction.Z, fraction) };
+        }
+
+        /** @brief Get closest point on segment
+         * @param start Segment start
+         * @param direction Segment direction
+         * @param point Point to find closest point to
+         * @return Closest point on segment
+         */
+        static Point ClosestOnSegment(const Point& start, const Point& direction, const Point& point)
+        {
+            const int32_t fraction = CollisionWorld::Fraction(
+                CollisionWorld::Dot(CollisionWorld::Subtract(point, start), direction),
+                CollisionWorld::Dot(direction, direction));
+
+            return CollisionWorld::PointOnSegment(start, direction, fraction);
+        }
+
+        /** @brief Get closest points between two segments
+         * @param startA First segment start
+         * @param directionA First segment direction
+         * @param startB Second segment start
+         * @param directionB Second segment direction
+         * @param closestA Closest point on first segment
+         * @param closestB Closest point on second segment
+         */
+        static void ClosestBetweenSegments(
+            const Point& startA,
+            const Point& directionA,
+            const Point& startB,
+            const Point& directionB,
+            Point& closestA,
+            Point& closestB)
+        {
+            // Products are kept in 16.16 so their products still fit into 64 bits
+            const Point offset = CollisionWorld::Subtract(startA, startB);
+            const int64_t a = CollisionWorld::Dot(directionA, directionA) >> 16;
+            const int64_t e = CollisionWorld::Dot(directionB, directionB) >> 16;
+            const int64_t f = CollisionWorld::Dot(directionB, offset) >> 16;
+            int32_t s = 0;
+            int32_t t = 0;
+
+            if (a == 0 && e == 0)
+            {
+                s = 0;
+                t = 0;
+            }
+            else if (a == 0)
+            {
+                t = CollisionWorld::Fraction(f, e);
+            }
+            else
+            {
+                const int64_t c = CollisionWorld::Dot(directionA, offset) >> 16;
+
+                if (e == 0)
+                {
+                    s = CollisionWorld::Fraction(-c, a);
+                }
+                else
+                {
+                    const int64_t b = CollisionWorld::Dot(directionA, directionB) >> 16;
+                    const int64_t denominator = (a * e) - (b * b);
+
+                    // Parallel segments have no unique closest point, any s works
+                    s = denominator > 0 ? CollisionWorld::Fraction((b * f) - (c * e), denominator) : 0;
+
+                    // Point on second segment closest to the chosen point on first one
+                    const int64_t tNumerator = ((b * s) >> 16) + f;
+
+                    if (tNumerator <= 0)
+                    {
+                        t = 0;
+                        s = CollisionWorld::Fraction(-c, a);
+                    }
+                    else if (tNumerator >= e)
+                    {
+                        t = CollisionWorld::One;
+                        s = CollisionWorld::Fraction(b - c, a);
+                    }
+                    else
+                    {
+                        t = CollisionWorld::Fraction(tNumerator, e);
+                    }
+                }
+            }
+
+            closestA = CollisionWorld::PointOnSegment(startA, directionA, s);
+            closestB = CollisionWorld::PointOnSegment(startB, directionB, t);
+        }
+
+        /** @brief Test two spheres
+         * @param centerA First sphere center
+         * @param radiusA First sphere radius
+         * @param centerB Second sphere center
+         * @param radiusB Second sphere radius
+         * @param contact Contact normal and depth, can be nullptr
+         * @return True if spheres touch
+         */
+        static bool TestSpheres(const Point& centerA, const int32_t radiusA, const Point& centerB, const int32_t radiusB, Contact* contact)
+        {
+            const Point difference = CollisionWorld::Subtract(centerB, centerA);
+            const int64_t distanceSquared = CollisionWorld::Dot(difference, difference);
+            const int64_t radius = static_cast<int64_t>(radiusA) + radiusB;
+
+            if (distanceSquared >= radius * radius)
+            {
+                return false;
+            }
+
+            if (contact != nullptr)
+            {
+                const int32_t distance = CollisionWorld::SquareRoot(distanceSquared);
+                contact->Depth = Math::Types::Fxp::BuildRaw(radius - distance);
+
+                if (distance > 0)
+                {
+                    contact->Normal = Math::Types::Vector3D(
+                        Math::Types::Fxp::BuildRaw((static_cast<int64_t>(difference.X) << 16) / distance),
+                        Math::Types::Fxp::BuildRaw((static_cast<int64_t>(difference.Y) << 16) / distance),
+                        Math::Types::Fxp::BuildRaw((static_cast<int64_t>(difference.Z) << 16) / distance));
+                }
+                else
+                {
+                    contact->Normal = Math::Types::Vector3D(1.0, 0.0, 0.0);
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief Test box against sphere
+         * @param box Box body
+         * @param center Sphere center
+         * @param radius Sphere radius
+         * @param contact Contact normal (from box to sphere) and depth, can be nullptr
+         * @return True if shapes touch
+         */
+        static bool TestBoxSphere(const Body& box, const Point& center, const int32_t radius, Contact* contact)
+        {
+            const Point boxCenter = CollisionWorld::ToPoint(box.Position);
+            const Point half = CollisionWorld::ToPoint(box.Size);
+            const Point closest = {
+                Math::Max<int32_t>(boxCenter.X - half.X, Math::Min<int32_t>(center.X, boxCenter.X + half.X)),
+                Math::Max<int32_t>(boxCenter.Y - half.Y, Math::Min<int32_t>(center.Y, boxCenter.Y + half.Y)),
+                Math::Max<int32_t>(boxCenter.Z - half.Z, Math::Min<int32_t>(center.Z, boxCenter.Z + half.Z)) };
+
+            if (closest.X != center.X || closest.Y != center.Y || closest.Z != center.Z)
+            {
+                // Sphere center is outside of the box
+                return CollisionWorld::TestSpheres(closest, 0, center, radius, contact);
+            }
+
+            if (contact != nullptr)
+            {
+                // Sphere center is inside of the box, push it out through the nearest face
+                const Point offset = CollisionWorld::Subtract(center, boxCenter);
+                const int32_t faceX = half.X - Math::Abs(offset.X);
+                const int32_t faceY = half.Y - Math::Abs(offset.Y);
+                const int32_t faceZ = half.Z - Math::Abs(offset.Z);
+                contact->Normal = Math::Types::Vector3D();
+
+                if (faceX <= faceY && faceX <= faceZ)
+                {
+                    contact->Normal.X = offset.X < 0 ? -1.0 : 1.0;
+                    contact->Depth = Math::Types::Fxp::BuildRaw(radius + faceX);
+                }
+                else if (faceY <= faceZ)
+                {
+                    contact->Normal.Y = offset.Y < 0 ? -1.0 : 1.0;
+                    contact->Depth = Math::Types::Fxp::BuildRaw(radius + faceY);
+                }
+                else
+                {
+                    contact->Normal.Z = offset.Z < 0 ? -1.0 : 1.0;
+                    contact->Depth = Math::Types::Fxp::BuildRaw(radius + faceZ);
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief Test two boxes
+         * @param boxA First box
+         * @param boxB Second box
+         * @param contact Contact normal and depth, can be nullptr
+         * @return True if boxes touch
+         */
+        static bool TestBoxes(const Body& boxA, const Body& boxB, Contact* contact)
+        {
+            const Point offset = CollisionWorld::Subtract(CollisionWorld::ToPoint(boxB.Position), CollisionWorld::ToPoint(boxA.Position));
+            const int32_t overlapX = boxA.Size.X.RawValue() + boxB.Size.X.RawValue() - Math::Abs(offset.X);
+            const int32_t overlapY = boxA.Size.Y.RawValue() + boxB.Size.Y.RawValue() - Math::Abs(offset.Y);
+            const int32_t overlapZ = boxA.Size.Z.RawValue() + boxB.Size.Z.RawValue() - Math::Abs(offset.Z);
+
+            // Flat (2D) boxes touch on Z when both have zero depth
+            if (overlapX <= 0 || overlapY <= 0 || overlapZ < 0)
+            {
+                return false;
+            }
+
+            if (contact != nullptr)
+            {
+                contact->Normal = Math::Types::Vector3D();
+
+                if (overlapX <= overlapY && (overlapX <= overlapZ || overlapZ == 0))
+                {
+                    contact->Normal.X = offset.X < 0 ? -1.0 : 1.0;
+                    contact->Depth = Math::Types::Fxp::BuildRaw(overlapX);
+                }
+                else if (overlapY <= overlapZ || overlapZ == 0)
+                {
+                    contact->Normal.Y = offset.Y < 0 ? -1.0 : 1.0;
+                    contact->Depth = Math::Types::Fxp::BuildRaw(overlapY);
+                }
+                else
+                {
+                    contact->Normal.Z = offset.Z < 0 ? -1.0 : 1.0;
+                    contact->Depth = Math::Types::Fxp::BuildRaw(overlapZ);
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief Clamp point into box
+         * @param point Point to clamp
+         * @param min Box minimum corner
+         * @param max Box maximum corner
+         * @return Point of the box closest to given point
+         */
+        static Point ClampToBox(const Point& point, const Point& min, const Point& max)
+        {
+            return Point {
+                Math::Max<int32_t>(min.X, Math::Min<int32_t>(point.X, max.X)),
+                Math::Max<int32_t>(min.Y, Math::Min<int32_t>(point.Y, max.Y)),
+                Math::Max<int32_t>(min.Z, Math::Min<int32_t>(point.Z, max.Z)) };
+        }
+
+        /** @brief Get squared distance between point and box
+         * @param point Point
+         * @param min Box minimum corner
+         * @param max Box maximum corner
+         * @return Squared distance with 32.32 precision
+         */
+        static int64_t BoxDistanceSquared(const Point& point, const Point& min, const Point& max)
+        {
+            const Point offset = CollisionWorld::Subtract(point, CollisionWorld::ClampToBox(point, min, max));
+            return CollisionWorld::Dot(offset, offset);
+        }
+
+        /** @brief Get point on segment closest to a box
+         * @details Distance to a box is convex along the segment, so ternary search over segment position finds the closest point
+         * even when segment passes near a box edge or corner.
+         * @param box Box body
+         * @param start Segment start
+         * @param direction Segment direction
+         * @return Point on segment closest to the box
+         */
+        static Point ClosestOnSegmentToBox(const Body& box, const Point& start, const Point& direction)
+        {
+            const Point boxCenter = CollisionWorld::ToPoint(box.Position);
+            const Point half = CollisionWorld::ToPoint(box.Size);
+            const Point min = CollisionWorld::Subtract(boxCenter, half);
+            const Point max = Point { boxCenter.X + half.X, boxCenter.Y + half.Y, boxCenter.Z + half.Z };
+            int32_t low = 0;
+            int32_t high = CollisionWorld::One;
+
+            while (high - low > 2)
+            {
+                const int32_t third = (high - low) / 3;
+                const int32_t first = low + third;
+                const int32_t second = high - third;
+
+                if (CollisionWorld::BoxDistanceSquared(CollisionWorld::PointOnSegment(start, direction, first), min, max) <=
+                    CollisionWorld::BoxDistanceSquared(CollisionWorld::PointOnSegment(start, direction, second), min, max))
+                {
+                    high = second;
+                }
+                else
+                {
+                    low = first;
+                }
+            }
+
+            Point closest = CollisionWorld::PointOnSegment(start, direction, low);
+            int64_t closestDistance = CollisionWorld::BoxDistanceSquared(closest, min, max);
+
+            for (int32_t fraction = low + 1; fraction <= high; fraction++)
+            {
+                const Point point = CollisionWorld::PointOnSegment(start, direction, fraction);
+                const int64_t distance = CollisionWorld::BoxDistanceSquared(point, min, max);
+
+                if (distance < closestDistance)
+                {
+                    closest = point;
+                    closestDistance = distance;
+                }
+            }
+
+            return closest;
+        }
+
+        /** @brief Get capsule segment
+         * @param capsule Capsule body
+         * @param start Segment start
+         * @param direction Segment direction
+         */
+        static void GetSegment(const Body& capsule, Point& start, Point& direction)
+        {
+            const Point half = CollisionWorld::ToPoint(capsule.Size);
+            start = CollisionWorld::Subtract(CollisionWorld::ToPoint(capsule.Position), half);
+            direction = Point { half.X << 1, half.Y << 1, half.Z << 1 };
+        }
+
+        /** @brief Test bodies with shapes in ascending order
+         * @param a First body
+         * @param b Second body (shape is same or higher than shape of the first body)
+         * @param contact Contact normal and depth, can be nullptr
+         * @return True if bodies touch
+         */
+        static bool TestOrdered(const Body& a, const Body& b, Contact* contact)
+        {
+            Point startA;
+            Point directionA;
+            Point startB;
+            Point directionB;
+
+            switch (a.Type)
+            {
+            case Shape::Box:
+                switch (b.Type)
+                {
+                case Shape::Box:
+                    return CollisionWorld::TestBoxes(a, b, contact);
+
+                case Shape::Sphere:
+                    return CollisionWorld::TestBoxSphere(a, CollisionWorld::ToPoint(b.Position), b.Radius.RawValue(), contact);
+
+                default:
+                    CollisionWorld::GetSegment(b, startB, directionB);
+                    return CollisionWorld::TestBoxSphere(
+                        a,
+                        CollisionWorld::ClosestOnSegmentToBox(a, startB, directionB),
+                        b.Radius.RawValue(),
+                        contact);
+                }
+
+            case Shape::Sphere:
+                if (b.Type == Shape::Sphere)
+                {
+                    return CollisionWorld::TestSpheres(CollisionWorld::ToPoint(a.Position), a.Radius.RawValue(), CollisionWorld::ToPoint(b.Position), b.Radius.RawValue(), contact);
+                }
+
+                CollisionWorld::GetSegment(b, startB, directionB);
+                return CollisionWorld::TestSpheres(
+                    CollisionWorld::ToPoint(a.Position),
+                    a.Radius.RawValue(),
+                    CollisionWorld::ClosestOnSegment(startB, directionB, CollisionWorld::ToPoint(a.Position)),
+                    b.Radius.RawValue(),
+                    contact);
+
+            default:
+                CollisionWorld::GetSegment(a, startA, directionA);
+                CollisionWorld::GetSegment(b, startB, directionB);
+                CollisionWorld::ClosestBetweenSegments(startA, directionA, startB, directionB, startA, startB);
+                return CollisionWorld::TestSpheres(startA, a.Radius.RawValue(), startB, b.Radius.RawValue(), contact);
+            }
+        }
+
+        /** @brief Compute bounding box of a body
+         * @param body Body
+         * @param bounds Bounding box
+         */
+        static void ComputeBounds(const Body& body, Bounds& bounds)
+        {
+            const Point center = CollisionWorld::ToPoint(body.Position);
+            Point extent;
+
+            switch (body.Type)
+            {
+            case Shape::Box:
+                extent = CollisionWorld::ToPoint(body.Size);
+                break;
+
+            case Shape::Sphere:
+                extent = Point { body.Radius.RawValue(), body.Radius.RawValue(), body.Radius.RawValue() };
+                break;
+
+            default:
+                extent = Point {
+                    Math::Abs(body.Size.X.RawValue()) + body.Radius.RawValue(),
+                    Math::Abs(body.Size.Y.RawValue()) + body.Radius.RawValue(),
+                    Math::Abs(body.Size.Z.RawValue()) + body.Radius.RawValue() };
+                break;
+            }
+
+            bounds.Min = CollisionWorld::Subtract(center, extent);
+            bounds.Max = Point { center.X + extent.X, center.Y + extent.Y, center.Z + extent.Z };
+        }
+
+        /** @brief Find touching pairs for part of the sorted body list
+         * @param start First position in sorted list
+         * @param end Position after the last one
+         * @param output Contact buffer
+         * @param capacity Contact buffer size
+         * @param candidates Number of pairs that passed broadphase
+         * @return Number of contacts found (can be more than capacity)
+         */
+        size_t Sweep(const size_t start, const size_t end, Contact* output, const size_t capacity, size_t* candidates)
+        {
+            size_t found = 0;
+            *candidates = 0;
+
+            for (size_t first = start; first < end; first++)
+            {
+                const uint16_t idA = this->order[first];
+                const Bounds& boundsA = this->bounds[idA];
+                const Body& bodyA = this->bodies[idA];
+
+                for (size_t second = first + 1; second < this->bodyCount; second++)
+                {
+                    const uint16_t idB = this->order[second];
+                    const Bounds& boundsB = this->bounds[idB];
+
+                    // Bodies are sorted by minimal X, nothing further can overlap
+                    if (boundsB.Min.X > boundsA.Max.X)
+                    {
+                        break;
+                    }
+
+                    const Body& bodyB = this->bodies[idB];
+
+                    if (boundsB.Min.Y > boundsA.Max.Y || boundsB.Max.Y < boundsA.Min.Y ||
+                        boundsB.Min.Z > boundsA.Max.Z || boundsB.Max.Z < boundsA.Min.Z ||
+                        (bodyA.Layer & bodyB.Mask) == 0 || (bodyB.Layer & bodyA.Mask) == 0)
+                    {
+                        continue;
+                    }
+
+                    (*candidates)++;
+                    Contact contact;
+                    const bool swap = idB < idA;
+
+                    if (CollisionWorld::Test(swap ? bodyB : bodyA, swap ? bodyA : bodyB, &contact))
+                    {
+                        if (found < capacity)
+                        {
+                            contact.A = swap ? idB : idA;
+                            contact.B = swap ? idA : idB;
+                            contact.State = ContactState::Enter;
+                            output[found] = contact;
+                        }
+
+                        found++;
+                    }
+                }
+            }
+
+            return found;
+        }
+
+        /** @brief Sort contacts by pair key
+         * @param list Contacts to sort
+         * @param count Number of contacts
+         */
+        static void SortContacts(Contact* list, const size_t count)
+        {
+            // Shell sort, contacts come in nearly random order
+            for (size_t gap = count >> 1; gap > 0; gap >>= 1)
+            {
+                for (size_t index = gap; index < count; index++)
+                {
+                    const Contact contact = list[index];
+                    const uint32_t key = CollisionWorld::GetKey(contact);
+                    size_t position = index;
+
+                    while (position >= gap && CollisionWorld::GetKey(list[position - gap]) > key)
+                    {
+                        list[position] = list[position - gap];
+                        position -= gap;
+                    }
+
+                    list[position] = contact;
+                }
+            }
+        }
+
+    public:
+
+        /** @brief Construct collision world
+         * @param maxBodies Maximal number of bodies
+         * @param maxContacts Maximal number of contacts reported each frame
+         * @param zone Memory zone to allocate world data in
+         */
+        CollisionWorld(const size_t maxBodies, const size_t maxContacts, const Memory::Zone zone = Memory::Zone::HWRam) :
+            maxBodies(Math::Min<size_t>(maxBodies, 0xffff)), maxContacts(maxContacts), bodyCount(0), contactCount(0), previousCount(0), statistics({ 0, 0, 0, 0 })
+        {
+            this->bodies = reinterpret_cast<Body*>(Memory::Malloc(sizeof(Body) * this->maxBodies, zone));
+            this->bounds = reinterpret_cast<Bounds*>(Memory::Malloc(sizeof(Bounds) * this->maxBodies, zone));
+            this->used = reinterpret_cast<uint8_t*>(Memory::Malloc(this->maxBodies, zone));
+            this->order = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * this->maxBodies, zone));
+            this->contacts = reinterpret_cast<Contact*>(Memory::Malloc(sizeof(Contact) * this->maxContacts, zone));
+            this->slaveContacts = reinterpret_cast<Contact*>(Memory::Malloc(sizeof(Contact) * this->maxContacts, zone));
+            this->previous = reinterpret_cast<uint32_t*>(Memory::Malloc(sizeof(uint32_t) * this->maxContacts, zone));
+            this->current = reinterpret_cast<uint32_t*>(Memory::Malloc(sizeof(uint32_t) * this->maxContacts, zone));
+
+            if (this->bodies == nullptr || this->bounds == nullptr || this->used == nullptr || this->order == nullptr ||
+                this->contacts == nullptr || this->slaveContacts == nullptr || this->previous == nullptr || this->current == nullptr)
+            {
+                SRL::Debug::Assert("Not enough memory for %d bodies and %d contacts", this->maxBodies, this->maxContacts);
+            }
+
+            for (size_t body = 0; body < this->maxBodies; body++)
+            {
+                this->used[body] = 0;
+            }
+        }
+
+        /** @brief Disable copying
+         */
+        CollisionWorld(const CollisionWorld&) = delete;
+
+        /** @brief Disable copying
+         */
+        CollisionWorld& operator=(const CollisionWorld&) = delete;
+
+        /** @brief Destroy collision world
+         */
+        ~CollisionWorld()
+        {
+            Memory::Free(this->bodies);
+            Memory::Free(this->bounds);
+            Memory::Free(this->used);
+            Memory::Free(this->order);
+            Memory::Free(this->contacts);
+            Memory::Free(this->slaveContacts);
+            Memory::Free(this->previous);
+            Memory::Free(this->current);
+        }
+
+        /** @brief Test whether two bodies touch
+         * @note Layers are not checked
+         * @param a First body
+         * @param b Second body
+         * @param contact Contact normal (from first to second body) and depth, can be nullptr
+         * @return True if bodies touch
+         */
+        static bool Test(const Body& a, const Body& b, Contact* contact = nullptr)
+        {
+            if (a.Type <= b.Type)
+            {
+                return CollisionWorld::TestOrdered(a, b, contact);
+            }
+
+            if (CollisionWorld::TestOrdered(b, a, contact))
+            {
+                if (contact != nullptr)
+                {
+                    contact->Normal = Math::Types::Vector3D(-contact->Normal.X, -contact->Normal.Y, -contact->Normal.Z);
+                }
+
+                return true;
+            }
+
+            return false;
+        }
+
+        /** @brief Add body
+         * @param body Body
+         * @return Body identifier or -1 if world is full
+         */
+        int32_t Add(const Body& body)
+        {
+            for (size_t id = 0; id < this->maxBodies; id++)
+            {
+                if (this->used[id] == 0)
+                {
+                    this->used[id] = 1;
+                    this->bodies[id] = body;
+                    CollisionWorld::ComputeBounds(body, this->bounds[id]);
+                    this->order[this->bodyCount++] = id;
+                    return id;
+                }
+            }
+
+            return -1;
+        }
+
+        /** @brief Remove body
+         * @note Contacts of the body are not reported as exiting
+         * @param id Body identifier
+         */
+        void Remove(const int32_t id)
+        {
+            if (id < 0 || static_cast<size_t>(id) >= this->maxBodies || this->used[id] == 0)
+            {
+                return;
+            }
+
+            this->used[id] = 0;
+            size_t kept = 0;
+
+            for (size_t position = 0; position < this->bodyCount; position++)
+            {
+                if (this->order[position] != id)
+                {
+                    this->order[kept++] = this->order[position];
+                }
+            }
+
+            this->bodyCount = kept;
+            kept = 0;
+
+            // Forget pairs of the body, so its identifier can be reused
+            for (size_t pair = 0; pair < this->previousCount; pair++)
+            {
+                if ((this->previous[pair] >> 16) != static_cast<uint32_t>(id) && (this->previous[pair] & 0xffff) != static_cast<uint32_t>(id))
+                {
+                    this->previous[kept++] = this->previous[pair];
+                }
+            }
+
+            this->previousCount = kept;
+        }
+
+        /** @brief Get body
+         * @note Changes are picked up by next SRL::CollisionWorld::Update()
+         * @param id Body identifier
+         * @return Body or nullptr if identifier is not valid
+         */
+        Body* Get(const int32_t id)
+        {
+            if (id < 0 || static_cast<size_t>(id) >= this->maxBodies || this->used[id] == 0)
+            {
+                return nullptr;
+            }
+
+            return &this->bodies[id];
+        }
+
+        /** @brief Find contacts
+         * @param slaveShare Share of the broadphase sweep done by the slave CPU (0-256)
+         */
+        void Update(const uint16_t slaveShare = 0)
+        {
+            for (size_t position = 0; position < this->bodyCount; position++)
+            {
+                const uint16_t id = this->order[position];
+                CollisionWorld::ComputeBounds(this->bodies[id], this->bounds[id]);
+            }
+
+            // Insertion sort, order from last frame is usually almost sorted
+            for (size_t position = 1; position < this->bodyCount; position++)
+            {
+                const uint16_t id = this->order[position];
+                const int32_t minX = this->bounds[id].Min.X;
+                size_t target = position;
+
+                while (target > 0 && this->bounds[this->order[target - 1]].Min.X > minX)
+                {
+                    this->order[target] = this->order[target - 1];
+                    target--;
+                }
+
+                this->order[target] = id;
+            }
+
+            // Bodies at the start of the list tend to have more neighbors to check, slave takes those
+            const size_t slaveEnd = (this->bodyCount * slaveShare) >> 8;
+            SweepTask task;
+
+            if (slaveEnd > 0)
+            {
+                task.World = this;
+                task.Start = 0;
+                task.End = slaveEnd;
+                Slave::ExecuteOnSlave(task);
+            }
+
+            size_t candidates = 0;
+            size_t found = this->Sweep(slaveEnd, this->bodyCount, this->contacts, this->maxContacts, &candidates);
+
+            if (slaveEnd > 0)
+            {
+                while (!task.IsDone());
+
+                // Drop stale lines of contacts written by slave
+                slCashPurge();
+                candidates += task.Candidates;
+
+                for (size_t contact = 0; contact < Math::Min<size_t>(task.Found, this->maxContacts); contact++)
+                {
+                    if (found < this->maxContacts)
+                    {
+                        this->contacts[found] = this->slaveContacts[contact];
+                    }
+
+                    found++;
+                }
+            }
+
+            this->statistics.Bodies = this->bodyCount;
+            this->statistics.Candidates = candidates;
+            this->statistics.Contacts = found;
+            this->contactCount = Math::Min(found, this->maxContacts);
+            this->statistics.Dropped = found - this->contactCount;
+
+            // Classify contacts against previous frame
+            CollisionWorld::SortContacts(this->contacts, this->contactCount);
+            const size_t touching = this->contactCount;
+            size_t old = 0;
+
+            for (size_t contact = 0; contact < touching; contact++)
+            {
+                const uint32_t key = CollisionWorld::GetKey(this->contacts[contact]);
+
+                while (old < this->previousCount && this->previous[old] < key)
+                {
+                    // Pair is not touching anymore
+                    if (this->contactCount < this->maxContacts)
+                    {
+                        this->contacts[this->contactCount++] = Contact { static_cast<uint16_t>(this->previous[old] >> 16), static_cast<uint16_t>(this->previous[old] & 0xffff), ContactState::Exit, Math::Types::Vector3D(), 0.0 };
+                    }
+                    else
+                    {
+                        this->statistics.Dropped++;
+                    }
+
+                    old++;
+                }
+
+                if (old < this->previousCount && this->previous[old] == key)
+                {
+                    this->contacts[contact].State = ContactState::Stay;
+                    old++;
+                }
+
+                this->current[contact] = key;
+            }
+
+            for (; old < this->previousCount; old++)
+            {
+                if (this->contactCount < this->maxContacts)
+                {
+                    this->contacts[this->contactCount++] = Contact { static_cast<uint16_t>(this->previous[old] >> 16), static_cast<uint16_t>(this->previous[old] & 0xffff), ContactState::Exit, Math::Types::Vector3D(), 0.0 };
+                }
+                else
+                {
+                    this->statistics.Dropped++;
+                }
+            }
+
+            // Current frame becomes previous
+            uint32_t* swap = this->previous;
+            this->previous = this->current;
+            this->current = swap;
+            this->previousCount = touching;
+        }
+
+        /** @brief Get contacts found by last update
+         * @details Touching pairs are sorted by body identifiers, exiting pairs follow after them
+         * @return Contact list
+         */
+        const Contact* GetContacts() const
+        {
+            return this->contacts;
+        }
+
+        /** @brief Get number of contacts found by last update
+         * @return Number of contacts
+         */
+        size_t GetContactCount() const
+        {
+            return this->contactCount;
+        }
+
+        /** @brief Get number of bodies
+         * @return Number of bodies
+         */
+        size_t GetBodyCount() const
+        {
+            return this->bodyCount;
+        }
+
+        /** @brief Get statistics of last update
+         * @return Statistics
+         */
+        const Statistics& GetStatistics() const
+        {
+            return this->statistics;
+        }
+    };
+}
@@ -0,0 +1,448 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_slave.hpp"
+
+#include <type_traits>
+
+namespace SRL
+{
+    /** @brief Data oriented entity storage
+     * @details Each component type is stored in its own tightly packed array (structure of arrays), so systems iterating
+     * over a few components read memory sequentially instead of chasing pointers to individual objects.
+     * Live entities are always kept at the start of the arrays, destroying an entity moves the last one into its place.
+     * Handles stay valid when entities move and become invalid once the entity is destroyed.
+     *
+     * Every entity in a store has all of its components, use separate stores for different kinds of entities.
+     * @code {.cpp}
+     * struct Position { Vector3D Value; };
+     * struct Velocity { Vector3D Value; };
+     *
+     * SRL::EntityStore<Position, Velocity> bullets(1024, SRL::Memory::Zone::HWRam);
+     *
+     * auto bullet = bullets.Create();
+     * bullets.Get<Velocity>(bullet)->Value = Vector3D(0.0, 0.0, 2.0);
+     *
+     * // Update on both CPUs, slave takes half of the entities
+     * bullets.ForEachParallel<Position, Velocity>([](Position& position, Velocity& velocity)
+     * {
+     *     position.Value += velocity.Value;
+     * });
+     * @endcode
+     * @warning Entities must not be created or destroyed while iterating, collect handles and destroy them afterwards
+     * @tparam Components Component types (trivially destructible)
+     */
+    template <typename... Components>
+    class EntityStore
+    {
+        static_assert(sizeof...(Components) > 0, "Entity store needs at least one component");
+        static_assert((std::is_trivially_destructible_v<Components> && ...), "Components must be trivially destructible");
+
+    public:
+
+        /** @brief Entity handle
+         */
+        struct Handle
+        {
+            /** @brief Entity slot
+             */
+            uint16_t Slot;
+
+            /** @brief Slot generation the handle was created in
+             */
+            uint16_t Generation;
+
+            /** @brief Construct invalid handle
+             */
+            constexpr Handle() : Slot(EntityStore::InvalidSlot), Generation(0) {}
+
+            /** @brief Construct handle
+             * @param slot Entity slot
+             * @param generation Slot generation
+             */
+            constexpr Handle(const uint16_t slot, const uint16_t generation) : Slot(slot), Generation(generation) {}
+
+            /** @brief Check whether handle points to an entity
+             * @note Entity might have been destroyed already, use SRL::EntityStore::IsAlive() to check that
+             * @return True if handle is not empty
+             */
+            constexpr bool IsValid() const
+            {
+                return this->Slot != EntityStore::InvalidSlot;
+            }
+
+            /** @brief Compare handles
+             * @param other Other handle
+             * @return True if both handles point to the same entity
+             */
+            constexpr bool operator==(const Handle& other) const
+            {
+                return this->Slot == other.Slot && this->Generation == other.Generation;
+            }
+        };
+
+        /** @brief Maximal number of entities a store can hold
+         */
+        static constexpr size_t MaxCapacity = 0xfffe;
+
+    private:
+
+        /** @brief Slot value of an empty handle
+         */
+        static constexpr uint16_t InvalidSlot = 0xffff;
+
+        /** @brief Number of component types
+         */
+        static constexpr size_t ComponentCount = sizeof...(Components);
+
+        /** @brief Part of the entities processed on slave CPU
+         * @tparam Function Type of function to call
+         * @tparam Selected Selected component types
+         */
+        template <typename Function, typename... Selected>
+        class RangeTask : public Types::ITask
+        {
+        public:
+
+            /** @brief Store to iterate over
+             */
+            EntityStore* Store;
+
+            /** @brief Function to call for each entity
+             */
+            Function* Callback;
+
+            /** @brief First entity
+             */
+            size_t Start;
+
+            /** @brief Entity after the last one
+             */
+            size_t End;
+
+        protected:
+
+            /** @brief Iterate over entities on slave
+             */
+            void Do() override
+            {
+                // Master might have changed the data since slave last looked at it
+                slCashPurge();
+                this->Store->Iterate(this->Start, this->End, *this->Callback, this->Store->template GetArray<Selected>()...);
+            }
+        };
+
+        /** @brief Component arrays
+         */
+        void* pools[EntityStore::ComponentCount];
+
+        /** @brief Entity slot to array index, or next free slot for free slots
+         */
+        uint16_t* indices;
+
+        /** @brief Array index to entity slot
+         */
+        uint16_t* slots;
+
+        /** @brief Current generation of each slot
+         */
+        uint16_t* generations;
+
+        /** @brief First free slot
+         */
+        uint16_t freeSlot;
+
+        /** @brief Number of live entities
+         */
+        size_t count;
+
+        /** @brief Maximal number of entities
+         */
+        size_t capacity;
+
+        /** @brief Get position of component type in the store
+         * @tparam Component Component type
+         * @return Index of the component array
+         */
+        template <typename Component>
+        static constexpr size_t IndexOf()
+        {
+            size_t index = 0;
+            bool found = false;
+            ((found = found || std::is_same_v<Component, Components>, index += found ? 0 : 1), ...);
+            return index;
+        }
+
+        /** @brief Call function for range of entities
+         * @param start First entity
+         * @param end Entity after the last one
+         * @param function Function to call
+         * @param arrays Component arrays
+         */
+        template <typename Function, typename... Selected>
+        static void Iterate(const size_t start, const size_t end, Function& function, Selected*... arrays)
+        {
+            for (size_t index = start; index < end; index++)
+            {
+                function(arrays[index]...);
+            }
+        }
+
+        /** @brief Copy components of one entity over another one
+         * @param from Array index to copy from
+         * @param to Array index to copy to
+         */
+        void Move(const size_t from, const size_t to)
+        {
+            ((this->template GetArray<Components>()[to] = this->template GetArray<Components>()[from]), ...);
+        }
+
+    public:
+
+        /** @brief Construct entity store
+         * @param capacity Maximal number of entities (up to SRL::EntityStore::MaxCapacity)
+         * @param zone Memory zone to allocate component arrays in
+         */
+        EntityStore(const size_t capacity, const Memory::Zone zone = Memory::Zone::HWRam) :
+            freeSlot(0), count(0), capacity(Math::Min<size_t>(capacity, EntityStore::MaxCapacity))
+        {
+            size_t pool = 0;
+            ((this->pools[pool++] = Memory::Malloc(sizeof(Components) * this->capacity, zone)), ...);
+
+            this->indices = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * this->capacity, zone));
+            this->slots = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * this->capacity, zone));
+            this->generations = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * this->capacity, zone));
+
+            bool allocated = this->indices != nullptr && this->slots != nullptr && this->generations != nullptr;
+
+            for (pool = 0; pool < EntityStore::ComponentCount; pool++)
+            {
+                allocated = allocated && this->pools[pool] != nullptr;
+            }
+
+            if (!allocated)
+            {
+                SRL::Debug::Assert("Not enough memory for %d entities", this->capacity);
+            }
+
+            // Link all slots into free list
+            for (size_t slot = 0; slot < this->capacity; slot++)
+            {
+                this->indices[slot] = slot + 1;
+                this->generations[slot] = 0;
+            }
+        }
+
+        /** @brief Disable copying
+         */
+        EntityStore(const EntityStore&) = delete;
+
+        /** @brief Disable copying
+         */
+        EntityStore& operator=(const EntityStore&) = delete;
+
+        /** @brief Destroy entity store and free component arrays
+         */
+        ~EntityStore()
+        {
+            for (size_t pool = 0; pool < EntityStore::ComponentCount; pool++)
+            {
+                Memory::Free(this->pools[pool]);
+            }
+
+            Memory::Free(this->indices);
+            Memory::Free(this->slots);
+            Memory::Free(this->generations);
+        }
+
+        /** @brief Create new entity, components are default initialized
+         * @return Entity handle, invalid handle if store is full
+         */
+        Handle Create()
+        {
+            if (this->count >= this->capacity)
+            {
+                return Handle();
+            }
+
+            const uint16_t slot = this->freeSlot;
+            const size_t index = this->count++;
+
+            this->freeSlot = this->indices[slot];
+            this->indices[slot] = index;
+            this->slots[index] = slot;
+
+            ((this->template GetArray<Components>()[index] = Components()), ...);
+            return Handle(slot, this->generations[slot]);
+        }
+
+        /** @brief Destroy entity
+         * @note Last entity is moved into the freed place, so order of entities changes
+         * @param handle Entity handle
+         * @return True if entity was destroyed, false if it was not alive
+         */
+        bool Destroy(const Handle handle)
+        {
+            if (!this->IsAlive(handle))
+            {
+                return false;
+            }
+
+            const size_t index = this->indices[handle.Slot];
+            const size_t last = --this->count;
+
+            if (index != last)
+            {
+                this->Move(last, index);
+                this->slots[index] = this->slots[last];
+                this->indices[this->slots[index]] = index;
+            }
+
+            // Invalidate existing handles and put slot into free list
+            this->generations[handle.Slot]++;
+            this->indices[handle.Slot] = this->freeSlot;
+            this->freeSlot = handle.Slot;
+            return true;
+        }
+
+        /** @brief Destroy all entities
+         */
+        void Clear()
+        {
+            while (this->count > 0)
+            {
+                this->Destroy(this->GetHandle(this->count - 1));
+            }
+        }
+
+        /** @brief Check whether entity exists
+         * @param handle Entity handle
+         * @return True if entity was not destroyed yet
+         */
+        bool IsAlive(const Handle handle) const
+        {
+            return handle.Slot < this->capacity &&
+                this->generations[handle.Slot] == handle.Generation &&
+                this->indices[handle.Slot] < this->count &&
+                this->slots[this->indices[handle.Slot]] == handle.Slot;
+        }
+
+        /** @brief Get component of an entity
+         * @note Pointer is valid only until an entity is destroyed
+         * @tparam Component Component type
+         * @param handle Entity handle
+         * @return Component or nullptr if entity does not exist
+         */
+        template <typename Component>
+        Component* Get(const Handle handle)
+        {
+            if (!this->IsAlive(handle))
+            {
+                return nullptr;
+            }
+
+            return &this->template GetArray<Component>()[this->indices[handle.Slot]];
+        }
+
+        /** @brief Get whole component array
+         * @details Live entities occupy indexes from 0 to SRL::EntityStore::GetCount() - 1
+         * @tparam Component Component type
+         * @return Component array
+         */
+        template <typename Component>
+        Component* GetArray()
+        {
+            static_assert(EntityStore::IndexOf<Component>() < EntityStore::ComponentCount, "Component is not part of this store");
+            return reinterpret_cast<Component*>(this->pools[EntityStore::IndexOf<Component>()]);
+        }
+
+        /** @brief Get handle of entity at array index
+         * @param index Array index
+         * @return Entity handle
+         */
+        Handle GetHandle(const size_t index) const
+        {
+            if (index >= this->count)
+            {
+                return Handle();
+            }
+
+            const uint16_t slot = this->slots[index];
+            return Handle(slot, this->generations[slot]);
+        }
+
+        /** @brief Get number of live entities
+         * @return Number of entities
+         */
+        size_t GetCount() const
+        {
+            return this->count;
+        }
+
+        /** @brief Get maximal number of entities
+         * @return Store capacity
+         */
+        size_t GetCapacity() const
+        {
+            return this->capacity;
+        }
+
+        /** @brief Call function for every entity
+         * @tparam Selected Component types passed to the function
+         * @param function Function taking references to selected components
+         */
+        template <typename... Selected, typename Function>
+        void ForEach(Function&& function)
+        {
+            EntityStore::Iterate(0, this->count, function, this->template GetArray<Selected>()...);
+        }
+
+        /** @brief Call function for range of entities
+         * @tparam Selected Component types passed to the function
+         * @param start First entity
+         * @param end Entity after the last one
+         * @param function Function taking references to selected components
+         */
+        template <typename... Selected, typename Function>
+        void ForEach(const size_t start, const size_t end, Function&& function)
+        {
+            EntityStore::Iterate(start, Math::Min<size_t>(end, this->count), function, this->template GetArray<Selected>()...);
+        }
+
+        /** @brief Call function for every entity, entities are split between slave and master CPU
+         * @details Slave CPU takes the first part of the entities, master CPU the rest. Returns once both are done.
+         * @warning Function is called from both CPUs at the same time, it must not write to anything shared
+         * @tparam Selected Component types passed to the function
+         * @param function Function taking references to selected components
+         * @param slaveShare Share of entities processed by the slave CPU (0-256)
+         */
+        template <typename... Selected, typename Function>
+        void ForEachParallel(Function&& function, const uint16_t slaveShare = 128)
+        {
+            using Callback = std::remove_reference_t<Function>;
+            const size_t slaveCount = (this->count * slaveShare) >> 8;
+            RangeTask<Callback, Selected...> task;
+
+            if (slaveCount > 0)
+            {
+                task.Store = this;
+                task.Callback = &function;
+                task.Start = 0;
+                task.End = slaveCount;
+                Slave::ExecuteOnSlave(task);
+            }
+
+            EntityStore::Iterate(slaveCount, this->count, function, this->template GetArray<Selected>()...);
+
+            if (slaveCount > 0)
+            {
+                while (!task.IsDone());
+
+                // Drop stale lines of data written by slave
+                slCashPurge();
+            }
+        }
+    };
+}
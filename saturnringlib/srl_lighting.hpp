@@ -0,0 +1,769 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_cd.hpp"
+#include "srl_core.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_mesh.hpp"
+#include "srl_slave.hpp"
+#include "srl_vdp1.hpp"
+
+#ifndef SRL_MAX_MESH_LIGHTS
+/** @brief Maximal number of lights affecting one mesh
+ */
+#define SRL_MAX_MESH_LIGHTS 4
+#endif
+
+namespace SRL
+{
+    /** @brief Static lighting baked offline into gouraud table entries
+     * @details Lighting of static geometry (ambient occlusion and lights that never move) is computed on the host
+     * by tools/scripts/bake_lighting.py, one gouraud table entry per face. Table is copied to VDP1 once,
+     * mesh is then drawn with regular gouraud shading without any light calculation per frame.
+     *
+     * Faces get entries in the order they are stored, meshes of one model follow each other,
+     * same as gouraud entries assigned by ModelObject in the 3D samples.
+     * @code {.cpp}
+     * // Level was baked with: bake_lighting.py LEVEL.NYA LEVEL.GRD --light 0,-40,0,120,20,16,8
+     * ModelObject level("LEVEL.NYA", 0);
+     * SRL::BakedLighting::Load("LEVEL.GRD", 0);
+     * SRL::BakedLighting::Apply(*level.GetMesh<SRL::Types::SmoothMesh>(0), 0);
+     *
+     * // Each frame
+     * SRL::BakedLighting::Draw(*level.GetMesh<SRL::Types::SmoothMesh>(0));
+     * @endcode
+     */
+    class BakedLighting
+    {
+        /** @brief Make class purely static
+         */
+        BakedLighting() = delete;
+
+        /** @brief Make class purely static
+         */
+        ~BakedLighting() = delete;
+
+    public:
+
+        /** @brief Baked table file identifier ("BAKE")
+         */
+        static constexpr uint32_t Magic = 0x42414b45;
+
+        /** @brief Size of baked table file header (identifier and number of entries)
+         */
+        static constexpr size_t HeaderSize = 8;
+
+        /** @brief Number of gouraud table entries available in VDP1 memory (last 32 entries are used by SGL)
+         */
+        static constexpr size_t MaxEntries = 0x1fe0;
+
+        /** @brief Point faces to consecutive gouraud table entries and disable SGL light calculation on them
+         * @param attributes Face attributes
+         * @param count Number of faces
+         * @param firstEntry Gouraud table entry of the first face
+         */
+        static void Apply(Types::Attribute* attributes, const size_t count, const uint16_t firstEntry)
+        {
+            if (firstEntry + count > BakedLighting::MaxEntries)
+            {
+                SRL::Debug::Assert("%d faces do not fit gouraud table at entry %d", count, firstEntry);
+            }
+
+            for (size_t face = 0; face < count; face++)
+            {
+                Types::Attribute& attribute = attributes[face];
+                attribute.Gouraud = 0xe000 + firstEntry + face;
+                attribute.Display = (attribute.Display & ~0x7) | CL_Gouraud;
+                attribute.Sort &= ~(UseGouraud | UseLight);
+            }
+        }
+
+        /** @brief Point faces of the mesh to consecutive gouraud table entries
+         * @param mesh Baked mesh
+         * @param firstEntry Gouraud table entry of the first face
+         */
+        static void Apply(Types::Mesh& mesh, const uint16_t firstEntry)
+        {
+            BakedLighting::Apply(mesh.Attributes, mesh.FaceCount, firstEntry);
+        }
+
+        /** @brief Point faces of the mesh to consecutive gouraud table entries
+         * @param mesh Baked mesh
+         * @param firstEntry Gouraud table entry of the first face
+         */
+        static void Apply(Types::SmoothMesh& mesh, const uint16_t firstEntry)
+        {
+            BakedLighting::Apply(mesh.Attributes, mesh.FaceCount, firstEntry);
+        }
+
+        /** @brief Copy baked table to VDP1
+         * @note Call while VDP1 is not drawing baked meshes (during loading or in vblank)
+         * @param table Baked colors, four per entry
+         * @param count Number of entries
+         * @param firstEntry Gouraud table entry to copy table to
+         */
+        static void Load(const Types::HighColor* table, const size_t count, const uint16_t firstEntry)
+        {
+            if (firstEntry + count > BakedLighting::MaxEntries)
+            {
+                SRL::Debug::Assert("Baked table with %d entries does not fit gouraud table at entry %d", count, firstEntry);
+            }
+
+            slDMACopy(const_cast<Types::HighColor*>(table), VDP1::GetGouraudTable() + (firstEntry << 2), count * 4 * sizeof(Types::HighColor));
+            slDMAWait();
+        }
+
+        /** @brief Load baked table from file and copy it to VDP1
+         * @note Call while VDP1 is not drawing baked meshes (during loading or in vblank)
+         * @param fileName Baked table file
+         * @param firstEntry Gouraud table entry to copy table to
+         * @param zone Memory zone to use for temporary buffer
+         * @return Number of loaded entries
+         */
+        static size_t Load(const char* fileName, const uint16_t firstEntry, const Memory::Zone zone = Memory::Zone::LWRam)
+        {
+            Cd::File file(fileName);
+
+            if (!file.Exists() || file.Size.Bytes <= static_cast<int32_t>(BakedLighting::HeaderSize))
+            {
+                SRL::Debug::Assert("Baked table file '%s' is missing", fileName);
+                return 0;
+            }
+
+            uint8_t* buffer = reinterpret_cast<uint8_t*>(Memory::Malloc(file.Size.Bytes, zone));
+            const int32_t read = file.LoadBytes(0, file.Size.Bytes, buffer);
+            const uint32_t count = *reinterpret_cast<uint32_t*>(buffer + 4);
+
+            if (read != file.Size.Bytes ||
+                *reinterpret_cast<uint32_t*>(buffer) != BakedLighting::Magic ||
+                BakedLighting::HeaderSize + (count * 4 * sizeof(Types::HighColor)) > static_cast<size_t>(read))
+            {
+                SRL::Debug::Assert("Baked table file '%s' is not valid", fileName);
+                Memory::Free(buffer);
+                return 0;
+            }
+
+            BakedLighting::Load(reinterpret_cast<Types::HighColor*>(buffer + BakedLighting::HeaderSize), count, firstEntry);
+            Memory::Free(buffer);
+            return count;
+        }
+
+        /** @brief Draw mesh with baked lighting
+         * @param mesh Baked mesh
+         * @return True on success
+         */
+        static bool Draw(Types::SmoothMesh& mesh)
+        {
+            // Smooth mesh data starts with regular mesh data, vertex normals are not needed
+            return slPutPolygon(reinterpret_cast<PDATA*>(mesh.SglPtr()));
+        }
+
+        /** @brief Draw mesh with baked lighting
+         * @param mesh Baked mesh
+         * @return True on success
+         */
+        static bool Draw(Types::Mesh& mesh)
+        {
+            return slPutPolygon(mesh.SglPtr());
+        }
+    };
+
+    /** @brief Point and spot lights for smooth meshes
+     * @details SGL light functions support only one directional light. This class computes per vertex lighting
+     * from any number of point and spot lights into its own gouraud table entries, one entry per face of the mesh.
+     * Table is copied to VDP1 in vblank, mesh is then drawn with regular gouraud shading.
+     *
+     * Lights are culled by bounding sphere of the mesh, only the nearest SRL_MAX_MESH_LIGHTS lights are used.
+     * Light intensity falls off linearly with distance and reaches zero at light radius.
+     *
+     * Vertex color is ambient color plus light colors, gouraud value of 16 leaves face color unchanged,
+     * lower values darken it and higher values brighten it.
+     * Mesh is expected to be only translated, not rotated or scaled. For rotated mesh, pass lights transformed into mesh space.
+     * @note Attributes of the mesh are switched to gouraud shading with table entries owned by this object,
+     * entries must not overlap with SRL::Scene3D::LightInitGouraudTable() or other lit meshes.
+     * @code {.cpp}
+     * SRL::MeshLighting lighting(mesh, 0);
+     * lighting.SetAmbient(HighColor::FromRGB555(6, 6, 8));
+     *
+     * SRL::MeshLighting::Light lights[] = {
+     *     SRL::MeshLighting::Light(Vector3D(0.0, -20.0, 0.0), 60.0, HighColor::FromRGB555(20, 12, 4)),
+     *     SRL::MeshLighting::Light(lampPosition, Vector3D(0.0, 1.0, 0.0), 100.0, 0.8, HighColor::FromRGB555(16, 16, 16))
+     * };
+     *
+     * // Each frame
+     * lighting.BeginUpdate(lights, 2, meshPosition);     // Slave computes vertex colors
+     * // ... master runs game logic ...
+     * lighting.EndUpdate();
+     *
+     * SRL::Scene3D::PushMatrix();
+     * SRL::Scene3D::Translate(meshPosition);
+     * lighting.Draw();
+     * SRL::Scene3D::PopMatrix();
+     * @endcode
+     */
+    class MeshLighting
+    {
+    public:
+
+        /** @brief Dynamic light
+         */
+        struct Light
+        {
+            /** @brief Light shape
+             */
+            enum class Type : uint8_t
+            {
+                /** @brief Light shines in all directions
+                 */
+                Point = 0,
+
+                /** @brief Light shines in a cone
+                 */
+                Spot = 1
+            };
+
+            /** @brief Light shape
+             */
+            Type Kind;
+
+            /** @brief Light position
+             */
+            Math::Types::Vector3D Position;
+
+            /** @brief Direction of spot light cone (unit vector)
+             */
+            Math::Types::Vector3D Direction;
+
+            /** @brief Distance at which light intensity reaches zero
+             */
+            Math::Types::Fxp Radius;
+
+            /** @brief Cosine of half of the spot light cone angle
+             */
+            Math::Types::Fxp Cutoff;
+
+            /** @brief Light color added to ambient color at full intensity
+             */
+            Types::HighColor Color;
+
+            /** @brief Construct light with zero radius
+             */
+            Light() : Kind(Type::Point), Position(), Direction(), Radius(0.0), Cutoff(0.0), Color()
+            {
+                // Do nothing
+            }
+
+            /** @brief Construct point light
+             * @param position Light position
+             * @param radius Distance at which light intensity reaches zero
+             * @param color Light color added to ambient color at full intensity
+             */
+            Light(const Math::Types::Vector3D& position, const Math::Types::Fxp& radius, const Types::HighColor& color) :
+                Kind(Type::Point), Position(position), Direction(), Radius(radius), Cutoff(0.0), Color(color)
+            {
+                // Do nothing
+            }
+
+            /** @brief Construct spot light
+             * @param position Light position
+             * @param direction Direction of light cone (unit vector)
+             * @param radius Distance at which light intensity reaches zero
+             * @param cutoff Cosine of half of the cone angle, intensity fades from cone axis to its edge
+             * @param color Light color added to ambient color at full intensity
+             */
+            Light(
+                const Math::Types::Vector3D& position,
+                const Math::Types::Vector3D& direction,
+                const Math::Types::Fxp& radius,
+                const Math::Types::Fxp& cutoff,
+                const Types::HighColor& color) :
+                Kind(Type::Spot), Position(position), Direction(direction), Radius(radius), Cutoff(cutoff), Color(color)
+            {
+                // Do nothing
+            }
+        };
+
+    private:
+
+        /** @brief Light computation running on slave CPU
+         */
+        class LightingTask : public Types::ITask
+        {
+        public:
+
+            /** @brief Lighting to compute
+             */
+            MeshLighting* Lighting;
+
+        protected:
+
+            /** @brief Compute vertex colors on slave
+             */
+            void Do() override
+            {
+                // Master has selected lights since slave last looked at them
+                slCashPurge();
+                this->Lighting->Compute();
+            }
+        };
+
+        /** @brief Light selected for the mesh, in mesh space
+         */
+        struct ActiveLight
+        {
+            /** @brief Light position
+             */
+            int32_t X;
+
+            /** @brief Light position
+             */
+            int32_t Y;
+
+            /** @brief Light position
+             */
+            int32_t Z;
+
+            /** @brief Light radius
+             */
+            int32_t Radius;
+
+            /** @brief Light radius squared
+             */
+            int64_t RadiusSquared;
+
+            /** @brief Light source
+             */
+            const Light* Source;
+
+            /** @brief Distance to mesh relative to light radius, nearest lights are kept
+             */
+            int32_t Score;
+        };
+
+        /** @brief Lit mesh
+         */
+        Types::SmoothMesh& mesh;
+
+        /** @brief First gouraud table entry of the mesh
+         */
+        uint16_t firstEntry;
+
+        /** @brief Vertex colors
+         */
+        Types::HighColor* vertexColors;
+
+        /** @brief Gouraud table of the mesh, four colors per face
+         */
+        Types::HighColor* table;
+
+        /** @brief Center of bounding sphere in mesh space
+         */
+        Math::Types::Vector3D center;
+
+        /** @brief Radius of bounding sphere
+         */
+        int32_t boundingRadius;
+
+        /** @brief Color of unlit vertex
+         */
+        Types::HighColor ambient;
+
+        /** @brief Lights affecting the mesh
+         */
+        ActiveLight lights[SRL_MAX_MESH_LIGHTS];
+
+        /** @brief Number of lights affecting the mesh
+         */
+        size_t lightCount;
+
+        /** @brief Slave CPU task
+         */
+        LightingTask task;
+
+        /** @brief Slave CPU is computing vertex colors
+         */
+        bool isUpdating;
+
+        /** @brief Table is ready to be copied to VDP1
+         */
+        volatile bool isReady;
+
+        /** @brief Vblank handler copying the table
+         */
+        Types::MemberProxy<> copyProxy;
+
+        /** @brief Integer square root
+         * @param value Value
+         * @return Square root rounded down
+         */
+        static uint64_t SquareRoot(uint64_t value)
+        {
+            uint64_t result = 0;
+
+            for (uint64_t bit = static_cast<uint64_t>(1) << 62; bit != 0; bit >>= 2)
+            {
+                if (value >= result + bit)
+                {
+                    value -= result + bit;
+                    result = (result >> 1) + bit;
+                }
+                else
+                {
+                    result >>= 1;
+                }
+            }
+
+            return result;
+        }
+
+        /** @brief Get distance between two points
+         * @param x Difference on X axis
+         * @param y Difference on Y axis
+         * @param z Difference on Z axis
+         * @return Distance
+         */
+        static int32_t Distance(const int64_t x, const int64_t y, const int64_t z)
+        {
+            return static_cast<int32_t>(MeshLighting::SquareRoot(static_cast<uint64_t>((x * x) + (y * y) + (z * z))));
+        }
+
+        /** @brief Compute bounding sphere of the mesh
+         */
+        void ComputeBounds()
+        {
+            if (this->mesh.VertexCount == 0)
+            {
+                this->boundingRadius = 0;
+                return;
+            }
+
+            Math::Types::Vector3D minimum = this->mesh.Vertices[0];
+            Math::Types::Vector3D maximum = this->mesh.Vertices[0];
+
+            for (size_t vertex = 1; vertex < this->mesh.VertexCount; vertex++)
+            {
+                const Math::Types::Vector3D& point = this->mesh.Vertices[vertex];
+                minimum = Math::Types::Vector3D(Math::Min<Math::Types::Fxp>(minimum.X, point.X), Math::Min<Math::Types::Fxp>(minimum.Y, point.Y), Math::Min<Math::Types::Fxp>(minimum.Z, point.Z));
+                maximum = Math::Types::Vector3D(Math::Max<Math::Types::Fxp>(maximum.X, point.X), Math::Max<Math::Types::Fxp>(maximum.Y, point.Y), Math::Max<Math::Types::Fxp>(maximum.Z, point.Z));
+            }
+
+            this->center = Math::Types::Vector3D(
+                Math::Types::Fxp::BuildRaw((minimum.X.RawValue() >> 1) + (maximum.X.RawValue() >> 1)),
+                Math::Types::Fxp::BuildRaw((minimum.Y.RawValue() >> 1) + (maximum.Y.RawValue() >> 1)),
+                Math::Types::Fxp::BuildRaw((minimum.Z.RawValue() >> 1) + (maximum.Z.RawValue() >> 1)));
+
+            this->boundingRadius = 0;
+
+            for (size_t vertex = 0; vertex < this->mesh.VertexCount; vertex++)
+            {
+                const Math::Types::Vector3D& point = this->mesh.Vertices[vertex];
+                this->boundingRadius = Math::Max<int32_t>(
+                    this->boundingRadius,
+                    MeshLighting::Distance(
+                        static_cast<int64_t>(point.X.RawValue()) - this->center.X.RawValue(),
+                        static_cast<int64_t>(point.Y.RawValue()) - this->center.Y.RawValue(),
+                        static_cast<int64_t>(point.Z.RawValue()) - this->center.Z.RawValue()) + 1);
+            }
+        }
+
+        /** @brief Pick lights affecting the mesh
+         * @param lights Scene lights
+         * @param count Number of scene lights
+         * @param position Mesh position
+         */
+        void SelectLights(const Light* lights, const size_t count, const Math::Types::Vector3D& position)
+        {
+            this->lightCount = 0;
+
+            for (size_t index = 0; index < count; index++)
+            {
+                const Light& light = lights[index];
+                const int32_t radius = light.Radius.RawValue();
+
+                if (radius <= 0)
+                {
+                    continue;
+                }
+
+                // Light position in mesh space
+                const int32_t x = light.Position.X.RawValue() - position.X.RawValue();
+                const int32_t y = light.Position.Y.RawValue() - position.Y.RawValue();
+                const int32_t z = light.Position.Z.RawValue() - position.Z.RawValue();
+
+                const int64_t toCenterX = static_cast<int64_t>(this->center.X.RawValue()) - x;
+                const int64_t toCenterY = static_cast<int64_t>(this->center.Y.RawValue()) - y;
+                const int64_t toCenterZ = static_cast<int64_t>(this->center.Z.RawValue()) - z;
+                const int32_t distance = MeshLighting::Distance(toCenterX, toCenterY, toCenterZ);
+
+                if (distance >= radius + this->boundingRadius)
+                {
+                    continue;
+                }
+
+                // Whole mesh is behind spot light
+                if (light.Kind == Light::Type::Spot &&
+                    ((toCenterX * light.Direction.X.RawValue()) + (toCenterY * light.Direction.Y.RawValue()) + (toCenterZ * light.Direction.Z.RawValue())) >> 16 < -this->boundingRadius)
+                {
+                    continue;
+                }
+
+                const int32_t score = static_cast<int32_t>((static_cast<int64_t>(Math::Max<int32_t>(0, distance - this->boundingRadius)) << 16) / radius);
+
+                // Keep lights sorted from nearest, drop the farthest one when full
+                size_t slot = this->lightCount;
+
+                if (slot == SRL_MAX_MESH_LIGHTS)
+                {
+                    if (score >= this->lights[slot - 1].Score)
+                    {
+                        continue;
+                    }
+
+                    slot--;
+                }
+                else
+                {
+                    this->lightCount++;
+                }
+
+                while (slot > 0 && this->lights[slot - 1].Score > score)
+                {
+                    this->lights[slot] = this->lights[slot - 1];
+                    slot--;
+                }
+
+                this->lights[slot] = ActiveLight { x, y, z, radius, static_cast<int64_t>(radius) * radius, &light, score };
+            }
+        }
+
+        /** @brief Compute vertex colors and gouraud table
+         */
+        void Compute()
+        {
+            for (size_t vertex = 0; vertex < this->mesh.VertexCount; vertex++)
+            {
+                const Math::Types::Vector3D& point = this->mesh.Vertices[vertex];
+                const Math::Types::Vector3D& normal = this->mesh.Normals[vertex];
+                int32_t red = this->ambient.Red << 16;
+                int32_t green = this->ambient.Green << 16;
+                int32_t blue = this->ambient.Blue << 16;
+
+                for (size_t index = 0; index < this->lightCount; index++)
+                {
+                    const ActiveLight& light = this->lights[index];
+                    const int64_t x = static_cast<int64_t>(light.X) - point.X.RawValue();
+                    const int64_t y = static_cast<int64_t>(light.Y) - point.Y.RawValue();
+                    const int64_t z = static_cast<int64_t>(light.Z) - point.Z.RawValue();
+                    const int64_t distanceSquared = (x * x) + (y * y) + (z * z);
+
+                    if (distanceSquared >= light.RadiusSquared)
+                    {
+                        continue;
+                    }
+
+                    const int32_t distance = static_cast<int32_t>(MeshLighting::SquareRoot(static_cast<uint64_t>(distanceSquared)));
+                    int32_t intensity = 0x10000;
+
+                    if (distance > 0)
+                    {
+                        // Lambert term, cosine between normal and direction to the light
+                        const int64_t facing = (x * normal.X.RawValue()) + (y * normal.Y.RawValue()) + (z * normal.Z.RawValue());
+
+                        if (facing <= 0)
+                        {
+                            continue;
+                        }
+
+                        intensity = static_cast<int32_t>(facing / distance);
+
+                        if (light.Source->Kind == Light::Type::Spot)
+                        {
+                            // Cosine between cone axis and direction from the light, faded from cutoff to the axis
+                            const Math::Types::Vector3D& axis = light.Source->Direction;
+                            const int64_t along = -((x * axis.X.RawValue()) + (y * axis.Y.RawValue()) + (z * axis.Z.RawValue())) / distance;
+                            const int32_t cutoff = light.Source->Cutoff.RawValue();
+
+                            if (along <= cutoff)
+                            {
+                                continue;
+                            }
+
+                            const int32_t cone = Math::Min<int32_t>(0x10000, static_cast<int32_t>(((along - cutoff) << 16) / Math::Max<int32_t>(1, 0x10000 - cutoff)));
+                            intensity = static_cast<int32_t>((static_cast<int64_t>(intensity) * cone) >> 16);
+                        }
+                    }
+
+                    // Linear falloff reaching zero at light radius
+                    intensity = static_cast<int32_t>((static_cast<int64_t>(intensity) * (((static_cast<int64_t>(light.Radius) - distance) << 16) / light.Radius)) >> 16);
+                    red += light.Source->Color.Red * intensity;
+                    green += light.Source->Color.Green * intensity;
+                    blue += light.Source->Color.Blue * intensity;
+                }
+
+                this->vertexColors[vertex] = Types::HighColor::FromRGB555(
+                    Math::Min<int32_t>(31, red >> 16),
+                    Math::Min<int32_t>(31, green >> 16),
+                    Math::Min<int32_t>(31, blue >> 16));
+            }
+
+            // Each face corner takes color of its vertex
+            for (size_t face = 0; face < this->mesh.FaceCount; face++)
+            {
+                const uint16_t* vertices = this->mesh.Faces[face].Vertices;
+                Types::HighColor* entry = this->table + (face << 2);
+
+                for (size_t corner = 0; corner < 4; corner++)
+                {
+                    entry[corner] = this->vertexColors[vertices[corner]];
+                }
+            }
+        }
+
+        /** @brief Copy gouraud table to VDP1, called in vblank
+         */
+        void CopyTable()
+        {
+            if (this->isReady)
+            {
+                uint32_t* source = reinterpret_cast<uint32_t*>(this->table);
+                uint32_t* target = reinterpret_cast<uint32_t*>(VDP1::GetGouraudTable() + (this->firstEntry << 2));
+
+                for (size_t word = 0; word < this->mesh.FaceCount << 1; word++)
+                {
+                    target[word] = source[word];
+                }
+
+                this->isReady = false;
+            }
+        }
+
+    public:
+
+        /** @brief Prepare mesh for dynamic lighting
+         * @param mesh Mesh with vertex normals
+         * @param firstEntry First gouraud table entry used by the mesh, mesh uses one entry per face
+         * @param zone Memory zone to allocate vertex colors and gouraud table in
+         */
+        MeshLighting(Types::SmoothMesh& mesh, const uint16_t firstEntry, const Memory::Zone zone = Memory::Zone::HWRam) :
+            mesh(mesh),
+            firstEntry(firstEntry),
+            center(),
+            boundingRadius(0),
+            ambient(Types::HighColor::FromRGB555(16, 16, 16)),
+            lightCount(0),
+            isUpdating(false),
+            isReady(false),
+            copyProxy(this, &MeshLighting::CopyTable)
+        {
+            this->vertexColors = reinterpret_cast<Types::HighColor*>(Memory::Malloc(sizeof(Types::HighColor) * Math::Max<size_t>(1, mesh.VertexCount), zone));
+            this->table = reinterpret_cast<Types::HighColor*>(Memory::Malloc(sizeof(Types::HighColor) * Math::Max<size_t>(1, mesh.FaceCount << 2), zone));
+            this->task.Lighting = this;
+            this->ComputeBounds();
+
+            // Faces are shaded by our own table entries, SGL light calculation must not touch them
+            BakedLighting::Apply(mesh, firstEntry);
+
+            Core::OnVblank += &this->copyProxy;
+        }
+
+        /** @brief Disable copying
+         */
+        MeshLighting(const MeshLighting&) = delete;
+
+        /** @brief Disable copying
+         */
+        MeshLighting& operator=(const MeshLighting&) = delete;
+
+        /** @brief Destroy mesh lighting
+         */
+        ~MeshLighting()
+        {
+            this->EndUpdate();
+            Core::OnVblank -= &this->copyProxy;
+            Memory::Free(this->vertexColors);
+            Memory::Free(this->table);
+        }
+
+        /** @brief Set color of vertices not reached by any light
+         * @param color Ambient color, 16 on each channel leaves face color unchanged
+         */
+        void SetAmbient(const Types::HighColor& color)
+        {
+            this->ambient = color;
+        }
+
+        /** @brief Compute lighting of the mesh on master CPU
+         * @param lights Scene lights
+         * @param count Number of scene lights
+         * @param position Mesh position
+         * @return Number of lights affecting the mesh
+         */
+        size_t Update(const Light* lights, const size_t count, const Math::Types::Vector3D& position)
+        {
+            this->EndUpdate();
+            this->isReady = false;
+            this->SelectLights(lights, count, position);
+            this->Compute();
+            this->isReady = true;
+            return this->lightCount;
+        }
+
+        /** @brief Start computing lighting of the mesh on slave CPU
+         * @note Lights must not be changed and mesh must not be drawn until SRL::MeshLighting::EndUpdate() is called
+         * @param lights Scene lights
+         * @param count Number of scene lights
+         * @param position Mesh position
+         * @return Number of lights affecting the mesh
+         */
+        size_t BeginUpdate(const Light* lights, const size_t count, const Math::Types::Vector3D& position)
+        {
+            this->EndUpdate();
+            this->isReady = false;
+            this->SelectLights(lights, count, position);
+            Slave::ExecuteOnSlave(this->task);
+            this->isUpdating = true;
+            return this->lightCount;
+        }
+
+        /** @brief Wait for slave CPU to finish, table is copied to VDP1 in next vblank
+         */
+        void EndUpdate()
+        {
+            if (this->isUpdating)
+            {
+                while (!this->task.IsDone());
+
+                // Drop stale lines of data written by slave
+                slCashPurge();
+                this->isUpdating = false;
+                this->isReady = true;
+            }
+        }
+
+        /** @brief Draw the mesh with computed lighting
+         * @return True on success
+         */
+        bool Draw()
+        {
+            return BakedLighting::Draw(this->mesh);
+        }
+
+        /** @brief Get number of lights that affected the mesh in last update
+         * @return Number of lights
+         */
+        size_t GetLightCount() const
+        {
+            return this->lightCount;
+        }
+
+        /** @brief Get computed vertex color
+         * @param vertex Vertex index
+         * @return Gouraud color of the vertex
+         */
+        Types::HighColor GetVertexColor(const size_t vertex) const
+        {
+            return this->vertexColors[vertex];
+        }
+    };
+}
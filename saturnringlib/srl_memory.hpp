@@ -5,10 +5,47 @@
 extern "C" {
     extern char _heap_start;
     extern char _heap_end;
+
+    /** @brief Start of code and data linked to LWRam
+     * @note Defined within linker script
+     */
+    extern char _lwram_start;
+
+    /** @brief End of code and data linked to LWRam, LWRam heap starts here
+     * @note Defined within linker script
+     */
+    extern char _lwram_end;
 }
 
+/** @brief Place function with the rest of frequently called code at the start of HWRam code
+ * @details Hot functions are linked next to each other, so they share cache lines and do not evict each other
+ * @code {.cpp}
+ * SRL_HOT void UpdateParticles(Particle* particles, size_t count) { ... }
+ * @endcode
+ */
+#define SRL_HOT __attribute__((hot, section(".text.hot")))
+
+/** @brief Place rarely called function into LWRam
+ * @details Cold code is copied from the binary to LWRam before static constructors run, HWRam it was loaded to is then reused by .bss.
+ * Use for menus, loading and initialization code or error handlers. LWRam is slower than HWRam, so this should not be used on anything called every frame.
+ * @code {.cpp}
+ * SRL_COLD void LoadLevel(const char* name) { ... }
+ * @endcode
+ */
+#define SRL_COLD __attribute__((cold, noinline, section(".lwram.text")))
+
+/** @brief Place global variable or large table into LWRam
+ * @details Data is copied to LWRam together with cold code, see SRL_COLD
+ * @code {.cpp}
+ * SRL_LWRAM_DATA const uint8_t DialogText[0x8000] = { ... };
+ * @endcode
+ * @note Constant and writable variables cannot share this section within one source file, compiler reports section type conflict
+ */
+#define SRL_LWRAM_DATA __attribute__((section(".lwram.data")))
+
 #include <tlsf.h>
 #include <stdlib.h>
+#include <new>
 
 namespace SRL
 {
@@ -180,6 +217,7 @@ namespace SRL
                 if (header->Size == newBlock)
                 {
                     header->State = SimpleMalloc::BlockState::Used;
+                    return true;
                 }
                 else if (header->Size > newBlock)
                 {
@@ -279,8 +317,8 @@ namespace SRL
              */
             inline static void* Malloc(const MemoryZone& zone, size_t size)
             {
-                // Align to 4
-                size_t length = size;
+                // Align to 4, every block has room for at least one pointer so it can be queued when freed by the other CPU
+                size_t length = size > 0 ? size : 4;
                 size_t align = length & 3;
 
                 if (align != 0)
@@ -320,6 +358,68 @@ namespace SRL
                 return nullptr;
             }
 
+            /** @brief Allocate memory starting at aligned address
+             * @details Space in front of the aligned address is split off as a separate free block,
+             * so the allocated block has its header right before it and is freed the same way as any other block.
+             * @param zone Memory zone settings
+             * @param size Number of bytes to allocate
+             * @param alignment Alignment of the returned address, must be power of two
+             * @return Pointer to allocated space
+             */
+            inline static void* MallocAligned(const MemoryZone& zone, size_t size, size_t alignment)
+            {
+                // Align to 4, same as in Malloc()
+                size_t length = size > 0 ? size : 4;
+                size_t align = length & 3;
+
+                if (align != 0)
+                {
+                    length += 4 - align;
+                }
+
+                size_t location = 0;
+                size_t newBlock = length & 0x7fffffff;
+
+                while (location < zone.Size)
+                {
+                    SimpleMalloc::Header* header = ((SimpleMalloc::Header*)&((uint8_t*)zone.Address)[location]);
+
+                    if (header->State == SimpleMalloc::BlockState::Free)
+                    {
+                        SimpleMalloc::MergeFreeMemoryBlocks(zone, location);
+
+                        // Distance from start of the block data to the nearest aligned address,
+                        // data is always 4 byte aligned so the padding is either 0 or big enough to hold a header
+                        size_t data = reinterpret_cast<uint32_t>(zone.Address) + location + sizeof(SimpleMalloc::Header);
+                        size_t padding = (alignment - (data & (alignment - 1))) & (alignment - 1);
+
+                        if (header->Size >= padding + newBlock)
+                        {
+                            if (padding > 0)
+                            {
+                                // Leave padding as free block in front of the aligned one
+                                size_t oldBlockSize = header->Size;
+                                header->Size = padding - sizeof(SimpleMalloc::Header);
+                                location += padding;
+
+                                SimpleMalloc::Header* aligned = ((SimpleMalloc::Header*)&((uint8_t*)zone.Address)[location]);
+                                aligned->State = SimpleMalloc::BlockState::Free;
+                                aligned->Size = oldBlockSize - padding;
+                            }
+
+                            if (SimpleMalloc::SetBlockAllocation(zone, location, newBlock))
+                            {
+                                return (void*)&((uint8_t*)zone.Address)[location + sizeof(SimpleMalloc::Header)];
+                            }
+                        }
+                    }
+
+                    location = SimpleMalloc::GetNextBlockLocation(zone, location);
+                }
+
+                return nullptr;
+            }
+
             /** @brief Reallocate memory (can either shrink, enlarge or move)
              * @param zone Memory zone settings
              * @param ptr Allocated memory to resize
@@ -361,7 +461,217 @@ namespace SRL
                 return nullptr;
             }
         };
-        
+
+        /** @brief Address of cache-through mirror of the system RAM
+         */
+        static constexpr uint32_t CacheThrough = 0x20000000;
+
+        /** @brief Get cache-through address of an object
+         * @note Used for data written by one CPU and read by the other
+         * @tparam Type Object type
+         * @param ptr Object address
+         * @return Address of the same object that bypasses cache of the calling CPU
+         */
+        template<typename Type>
+        inline static Type* Uncached(Type* ptr)
+        {
+            return reinterpret_cast<Type*>(reinterpret_cast<uint32_t>(ptr) | Memory::CacheThrough);
+        }
+
+        /** @brief Purge cache lines of the calling CPU covering specified memory area
+         * @param address Start of the memory area
+         * @param size Size of the memory area in bytes
+         */
+        inline static void PurgeCache(const void* address, const size_t size)
+        {
+            uint32_t line = reinterpret_cast<uint32_t>(address) & 0x1ffffff0;
+            const uint32_t end = (reinterpret_cast<uint32_t>(address) & 0x1fffffff) + size;
+
+            for (; line < end; line += 16)
+            {
+                *reinterpret_cast<volatile uint32_t*>(0x40000000 | line) = 0;
+            }
+        }
+
+        /** @brief Get address of the block in system RAM from its cache-through alias
+         * @param ptr Block address, cached or cache-through
+         * @return Cached address for blocks in HWRam and LWRam, cart RAM addresses are returned unchanged
+         */
+        inline static void* Cached(void* ptr)
+        {
+            const uint32_t address = reinterpret_cast<uint32_t>(ptr) & ~Memory::CacheThrough;
+
+            if (HighWorkRam::InRange(address) || LowWorkRam::InRange(address))
+            {
+                return reinterpret_cast<void*>(address);
+            }
+
+            return ptr;
+        }
+
+        #if defined(USE_TLSF_ALLOCATOR)
+        /** @brief Add block of TLSF pool to the report
+         * @param ptr Block address
+         * @param size Block size
+         * @param used Non-zero if block is allocated
+         * @param user Report being filled
+         */
+        inline static void TlsfWalker(void* ptr, size_t size, int used, void* user)
+        {
+            Report* report = reinterpret_cast<Report*>(user);
+            report->AllocationHeaders += tlsf_alloc_overhead();
+
+            if (used)
+            {
+                report->UsedBlocks++;
+            }
+            else
+            {
+                report->FreeBlocks++;
+                report->FreeSize += size;
+            }
+        }
+
+        /** @brief Get report on the TLSF allocator in specified memory zone
+         * @param zone Memory zone
+         * @return State report
+         */
+        inline static const Report GetTlsfReport(const MemoryZone& zone)
+        {
+            Report report = Report { 0, 0, 0, zone.Size, 0 };
+            tlsf_walk_pool(tlsf_get_pool(zone.Address), Memory::TlsfWalker, &report);
+            return report;
+        }
+        #endif
+
+        /** @brief Queue of blocks freed by the CPU that does not own them
+         * @details Lock-free single producer single consumer queue linked through the freed blocks themselves.
+         * Only the other CPU pushes and only the owner pops, so it does not need any atomic instructions.
+         * Last pushed block stays in the queue until another one is pushed after it, since the producer still points at it.
+         */
+        class FreeQueue
+        {
+        private:
+
+            /** @brief Link stored in the first word of a freed block
+             */
+            struct Node
+            {
+                /** @brief Next freed block
+                 */
+                Node* volatile Next;
+            };
+
+            /** @brief Initial queue element, is never returned
+             */
+            Node stub;
+
+            /** @brief Oldest element, touched only by consumer
+             */
+            Node* volatile head;
+
+            /** @brief Newest element, touched only by producer
+             */
+            Node* volatile tail;
+
+        public:
+
+            /** @brief Empty the queue
+             * @note Must not be called while the other CPU uses the queue
+             */
+            void Reset()
+            {
+                FreeQueue* queue = Memory::Uncached(this);
+                Memory::Uncached(&this->stub)->Next = nullptr;
+                queue->head = &this->stub;
+                queue->tail = &this->stub;
+            }
+
+            /** @brief Add freed block to the queue
+             * @param ptr Freed block, must be at least 4 bytes long
+             */
+            void Push(void* ptr)
+            {
+                FreeQueue* queue = Memory::Uncached(this);
+                Node* node = reinterpret_cast<Node*>(ptr);
+                Memory::Uncached(node)->Next = nullptr;
+                Memory::Uncached(queue->tail)->Next = node;
+                queue->tail = node;
+            }
+
+            /** @brief Take oldest freed block from the queue
+             * @return Freed block or nullptr if there is nothing to free yet
+             */
+            void* Pop()
+            {
+                FreeQueue* queue = Memory::Uncached(this);
+                Node* next = Memory::Uncached(queue->head)->Next;
+
+                // Skip the stub, it is at the front only until the first pop
+                if (next != nullptr && queue->head == &this->stub)
+                {
+                    queue->head = next;
+                    next = Memory::Uncached(next)->Next;
+                }
+
+                if (next == nullptr)
+                {
+                    return nullptr;
+                }
+
+                Node* freed = queue->head;
+                queue->head = next;
+                return freed;
+            }
+        };
+
+        /** @brief Blocks owned by master that were freed on slave
+         */
+        inline static FreeQueue masterQueue;
+
+        /** @brief Blocks owned by slave that were freed on master
+         */
+        inline static FreeQueue slaveQueue;
+
+        /** @brief Free block owned by master in whichever zone it belongs to
+         * @param ptr Pointer to allocated memory
+         */
+        inline static void FreeInZone(void* ptr)
+        {
+            if (HighWorkRam::InRange(ptr))
+            {
+                HighWorkRam::Free(ptr);
+            }
+            else if (LowWorkRam::InRange(ptr))
+            {
+                LowWorkRam::Free(ptr);
+            }
+            else if (CartRam::InRange(ptr))
+            {
+                CartRam::Free(ptr);
+            }
+        }
+
+        /** @brief Check whether allocation must be served by the slave heap
+         * @note On master this also frees blocks that slave handed back
+         * @return True when running on slave and slave heap is initialized
+         */
+        inline static bool UseSlaveRam()
+        {
+            if (!SlaveRam::IsInitialized())
+            {
+                return false;
+            }
+
+            if (Memory::IsSlave())
+            {
+                return true;
+            }
+
+            Memory::ProcessFreeQueue();
+            return false;
+        }
+
     public:
 
         /** @brief Memory zone codes
@@ -448,7 +758,7 @@ namespace SRL
             static void Free(void* ptr)
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                tlsf_free(Memory::mainWorkRam.Address, ptr);
+                tlsf_free(HighWorkRam::zone.Address, ptr);
                 #else
                 Memory::SimpleMalloc::Free(HighWorkRam::zone, ptr);
                 #endif
@@ -461,12 +771,26 @@ namespace SRL
             static void* Malloc(size_t size)
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return tlsf_malloc(Memory::mainWorkRam.Address, size);
+                return tlsf_malloc(HighWorkRam::zone.Address, size);
                 #else
                 return Memory::SimpleMalloc::Malloc(HighWorkRam::zone, size);
                 #endif
             }
 
+            /** @brief Allocate some memory starting at aligned address
+             * @param size Number of bytes to allocate
+             * @param alignment Alignment of the returned address, must be power of two
+             * @return Pointer to the allocated space in memory
+             */
+            static void* MallocAligned(size_t size, size_t alignment)
+            {
+                #if defined(USE_TLSF_ALLOCATOR)
+                return tlsf_memalign(HighWorkRam::zone.Address, alignment, size);
+                #else
+                return Memory::SimpleMalloc::MallocAligned(HighWorkRam::zone, size, alignment);
+                #endif
+            }
+
             /** @brief Reallocate existing memory
              * @param ptr Pointer to the existing allocated memory
              * @param size New size in number of bytes that should be allocated
@@ -475,7 +799,7 @@ namespace SRL
             static void* Realloc(void* ptr, size_t size)
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return tlsf_realloc(Memory::mainWorkRam.Address, size);
+                return tlsf_realloc(HighWorkRam::zone.Address, ptr, size);
                 #else
                 return Memory::SimpleMalloc::Realloc(HighWorkRam::zone, ptr, size);
                 #endif
@@ -487,7 +811,7 @@ namespace SRL
             static size_t GetFreeSpace()
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return 0;
+                return Memory::GetTlsfReport(HighWorkRam::zone).FreeSize;
                 #else
                 return Memory::SimpleMalloc::GetReport(HighWorkRam::zone).FreeSize;
                 #endif
@@ -499,7 +823,7 @@ namespace SRL
             static const Report GetReport()
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return Report { 0, 0, 0, Memory::mainWorkRam.Size, 0};
+                return Memory::GetTlsfReport(HighWorkRam::zone);
                 #else
                 return Memory::SimpleMalloc::GetReport(HighWorkRam::zone);
                 #endif
@@ -519,7 +843,7 @@ namespace SRL
             static size_t GetUsedSpace()
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return 0;
+                return HighWorkRam::GetSize() - HighWorkRam::GetFreeSpace();
                 #else
                 auto report = Memory::SimpleMalloc::GetReport(HighWorkRam::zone);
                 return report.TotalSize - report.FreeSize;
@@ -542,15 +866,20 @@ namespace SRL
              */
             inline static Memory::MemoryZone zone;
 
+            /** @brief Full low system memory zone
+             */
+            inline static const MemoryZone fullZone = { (void*)0x00200000, 0x100000 };
+
             /** @brief Initialize memory zone
+             * @note Heap starts after code and data linked to LWRam
              */
             inline static void Initialize()
             {
-                const volatile void* address = (void*)0x00200000;
-                const uint32_t size = 0x100000;
+                const volatile void* address = (void*)&_lwram_end;
+                const uint32_t size = 0x00300000 - reinterpret_cast<uint32_t>(&_lwram_end);
 
                 #if defined(USE_TLSF_ALLOCATOR)
-                LowWorkRam::mainWorkRam = Memory::MemoryZone
+                LowWorkRam::zone = Memory::MemoryZone
                 {
                     tlsf_create_with_pool((void*)address, size),
                     size
@@ -572,7 +901,7 @@ namespace SRL
              */
             inline static bool InRange(void* ptr)
             {
-                return Memory::InZone(LowWorkRam::zone, ptr);
+                return Memory::InZone(LowWorkRam::fullZone, ptr);
             }
 
             /** @brief Check whether pointer is in range of the memory zone
@@ -581,7 +910,16 @@ namespace SRL
              */
             inline static bool InRange(uint32_t zoneAddress)
             {
-                return Memory::InZone(LowWorkRam::zone, (void*)zoneAddress);
+                return Memory::InZone(LowWorkRam::fullZone, (void*)zoneAddress);
+            }
+
+            /** @brief Gets size of code and data linked to LWRam
+             * @note See SRL_COLD and SRL_LWRAM_DATA
+             * @return Number of bytes taken from the start of LWRam before the heap
+             */
+            inline static size_t GetLinkedSize()
+            {
+                return reinterpret_cast<uint32_t>(&_lwram_end) - reinterpret_cast<uint32_t>(&_lwram_start);
             }
 
             /** @brief Free allocated memory
@@ -590,7 +928,7 @@ namespace SRL
             inline static void Free(void* ptr)
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                tlsf_free(LowWorkRam::Zone.Address, ptr);
+                tlsf_free(LowWorkRam::zone.Address, ptr);
                 #else
                 Memory::SimpleMalloc::Free(LowWorkRam::zone, ptr);
                 #endif
@@ -603,12 +941,26 @@ namespace SRL
             inline static void* Malloc(size_t size)
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return tlsf_malloc(LowWorkRam::Zone.Address, size);
+                return tlsf_malloc(LowWorkRam::zone.Address, size);
                 #else
                 return Memory::SimpleMalloc::Malloc(LowWorkRam::zone, size);
                 #endif
             }
 
+            /** @brief Allocate some memory starting at aligned address
+             * @param size Number of bytes to allocate
+             * @param alignment Alignment of the returned address, must be power of two
+             * @return Pointer to the allocated space in memory
+             */
+            inline static void* MallocAligned(size_t size, size_t alignment)
+            {
+                #if defined(USE_TLSF_ALLOCATOR)
+                return tlsf_memalign(LowWorkRam::zone.Address, alignment, size);
+                #else
+                return Memory::SimpleMalloc::MallocAligned(LowWorkRam::zone, size, alignment);
+                #endif
+            }
+
            /** @brief Reallocate existing memory
             * @param ptr Pointer to the existing allocated memory
             * @param size New size in number of bytes that should be allocated
@@ -617,7 +969,7 @@ namespace SRL
             inline static void* Realloc(void* ptr, size_t size)
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return tlsf_realloc(LowWorkRam::Zone.Address, ptr, size);
+                return tlsf_realloc(LowWorkRam::zone.Address, ptr, size);
                 #else
                 return Memory::SimpleMalloc::Realloc(LowWorkRam::zone, ptr, size);
                 #endif
@@ -629,7 +981,7 @@ namespace SRL
             static size_t GetFreeSpace()
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return 0;
+                return Memory::GetTlsfReport(LowWorkRam::zone).FreeSize;
                 #else
                 return Memory::SimpleMalloc::GetReport(LowWorkRam::zone).FreeSize;
                 #endif
@@ -641,7 +993,7 @@ namespace SRL
             static const Report GetReport()
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return Report { 0, 0, 0, LowWorkRam::Zone.Size, 0};
+                return Memory::GetTlsfReport(LowWorkRam::zone);
                 #else
                 return Memory::SimpleMalloc::GetReport(LowWorkRam::zone);
                 #endif
@@ -661,7 +1013,7 @@ namespace SRL
             static size_t GetUsedSpace()
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return 0;
+                return LowWorkRam::GetSize() - LowWorkRam::GetFreeSpace();
                 #else
                 auto report = Memory::SimpleMalloc::GetReport(LowWorkRam::zone);
                 return report.TotalSize - report.FreeSize;
@@ -670,6 +1022,7 @@ namespace SRL
         };
 
         /** @brief Malloc for expansion cart RAM
+         * @note Zone is empty (all allocations fail) when RAM cartridge is not inserted, use SRL::Memory::CartRam::IsAvailable() to check
          */
         class CartRam
         {
@@ -679,19 +1032,83 @@ namespace SRL
              */
             friend class Memory;
 
+            /** @brief Cartridge identifier of 1MB (8Mbit) RAM cartridge
+             */
+            static constexpr uint8_t Id1MB = 0x5a;
+
+            /** @brief Cartridge identifier of 4MB (32Mbit) RAM cartridge
+             */
+            static constexpr uint8_t Id4MB = 0x5c;
+
+            /** @brief Start of the cartridge RAM
+             */
+            static constexpr uint32_t Address = 0x22400000;
+
             /** @brief Memory zone
              */
-            inline static Memory::MemoryZone zone;
+            inline static Memory::MemoryZone zone = { nullptr, 0 };
 
             /** @brief Initialize memory zone
              */
             inline static void Initialize()
             {
-                // TODO: Implement
+                size_t size = 0;
+
+                switch (CartRam::GetCartridgeId())
+                {
+                case CartRam::Id4MB:
+                    size = 0x400000;
+                    break;
+
+                case CartRam::Id1MB:
+                    // 1MB cartridge is split into two 512KB banks (0x22400000 and 0x22600000), only first one is used
+                    size = 0x80000;
+                    break;
+
+                default:
+                    return;
+                }
+
+                // Set A-bus timing for cartridge RAM and enable writing
+                *reinterpret_cast<volatile uint32_t*>(0x25fe00b0) = 0x23301ff0;
+                *reinterpret_cast<volatile uint32_t*>(0x25fe00b8) = 0x00000013;
+                *reinterpret_cast<volatile uint16_t*>(0x257efffe) = 0x0001;
+
+                void* address = reinterpret_cast<void*>(CartRam::Address);
+
+                #if defined(USE_TLSF_ALLOCATOR)
+                CartRam::zone = Memory::MemoryZone
+                {
+                    tlsf_create_with_pool(address, size),
+                    size
+                };
+                #else
+                CartRam::zone = Memory::MemoryZone
+                {
+                    Memory::SimpleMalloc::InitializeZone(address, size),
+                    size
+                };
+                #endif
             }
             
         public:
 
+            /** @brief Get identifier of inserted cartridge
+             * @return Cartridge identifier (0x5a for 1MB RAM cartridge, 0x5c for 4MB RAM cartridge)
+             */
+            inline static uint8_t GetCartridgeId()
+            {
+                return *reinterpret_cast<volatile uint8_t*>(0x24ffffff);
+            }
+
+            /** @brief Check whether RAM cartridge is inserted
+             * @return true if cartridge RAM can be used
+             */
+            inline static bool IsAvailable()
+            {
+                return CartRam::zone.Size > 0;
+            }
+
             /** @brief Check whether pointer is in range of the memory zone
              * @param ptr Pointer to check
              * @return true if pointer belongs to the current memory zone
@@ -707,7 +1124,7 @@ namespace SRL
              */
             inline static bool InRange(uint32_t zoneAddress)
             {
-                return false;
+                return CartRam::IsAvailable() && Memory::InZone(CartRam::zone, (void*)zoneAddress);
             }
 
             /** @brief Free allocated memory
@@ -715,7 +1132,11 @@ namespace SRL
              */
             inline static void Free(void* ptr)
             {
-                // TODO implement
+                #if defined(USE_TLSF_ALLOCATOR)
+                tlsf_free(CartRam::zone.Address, ptr);
+                #else
+                Memory::SimpleMalloc::Free(CartRam::zone, ptr);
+                #endif
             }
 
             /** @brief Allocate some memory
@@ -724,7 +1145,35 @@ namespace SRL
              */
             inline static void* Malloc(size_t size)
             {
-                return nullptr;
+                if (!CartRam::IsAvailable())
+                {
+                    return nullptr;
+                }
+
+                #if defined(USE_TLSF_ALLOCATOR)
+                return tlsf_malloc(CartRam::zone.Address, size);
+                #else
+                return Memory::SimpleMalloc::Malloc(CartRam::zone, size);
+                #endif
+            }
+
+            /** @brief Allocate some memory starting at aligned address
+             * @param size Number of bytes to allocate
+             * @param alignment Alignment of the returned address, must be power of two
+             * @return Pointer to the allocated space in memory
+             */
+            inline static void* MallocAligned(size_t size, size_t alignment)
+            {
+                if (!CartRam::IsAvailable())
+                {
+                    return nullptr;
+                }
+
+                #if defined(USE_TLSF_ALLOCATOR)
+                return tlsf_memalign(CartRam::zone.Address, alignment, size);
+                #else
+                return Memory::SimpleMalloc::MallocAligned(CartRam::zone, size, alignment);
+                #endif
             }
 
             /** @brief Reallocate existing memory
@@ -734,7 +1183,16 @@ namespace SRL
              */
             inline static void* Realloc(void* ptr, size_t size)
             {
-                return nullptr;
+                if (!CartRam::IsAvailable())
+                {
+                    return nullptr;
+                }
+
+                #if defined(USE_TLSF_ALLOCATOR)
+                return tlsf_realloc(CartRam::zone.Address, ptr, size);
+                #else
+                return Memory::SimpleMalloc::Realloc(CartRam::zone, ptr, size);
+                #endif
             }
 
             /** @brief Gets total size of the free space in the memory zone
@@ -742,7 +1200,11 @@ namespace SRL
              */
             inline static size_t GetFreeSpace()
             {
-                return 0;
+                #if defined(USE_TLSF_ALLOCATOR)
+                return CartRam::IsAvailable() ? Memory::GetTlsfReport(CartRam::zone).FreeSize : 0;
+                #else
+                return CartRam::IsAvailable() ? Memory::SimpleMalloc::GetReport(CartRam::zone).FreeSize : 0;
+                #endif
             }
 
             /** @brief Gets report on the allocator state
@@ -751,9 +1213,9 @@ namespace SRL
             static const Report GetReport()
             {
                 #if defined(USE_TLSF_ALLOCATOR)
-                return Report { 0, 0, 0, 0, 0};
+                return CartRam::IsAvailable() ? Memory::GetTlsfReport(CartRam::zone) : Report { 0, 0, 0, 0, 0};
                 #else
-                return Report { 0, 0, 0, 0, 0};
+                return CartRam::IsAvailable() ? Memory::SimpleMalloc::GetReport(CartRam::zone) : Report { 0, 0, 0, 0, 0};
                 #endif
             }
 
@@ -762,7 +1224,7 @@ namespace SRL
              */
             inline static size_t GetSize()
             {
-                return 0;
+                return CartRam::zone.Size;
             }
             
             /** @brief Gets total size of the used space in the memory zone
@@ -770,10 +1232,320 @@ namespace SRL
              */
             inline static size_t GetUsedSpace()
             {
-                return 0;
+                #if defined(USE_TLSF_ALLOCATOR)
+                return CartRam::GetSize() - CartRam::GetFreeSpace();
+                #else
+                if (!CartRam::IsAvailable())
+                {
+                    return 0;
+                }
+
+                auto report = Memory::SimpleMalloc::GetReport(CartRam::zone);
+                return report.TotalSize - report.FreeSize;
+                #endif
+            }
+        };
+
+        /** @brief Malloc owned by slave CPU
+         * @details Allocators of the memory zones have no locking, so allocating on slave while master does the same corrupts them.
+         * Slave heap is a region taken from one of the zones, once it is initialized, all allocations made on slave
+         * (including @c new) are served from it. Blocks can be freed on either CPU, block freed by the CPU that does not own it
+         * is put into a lock-free queue and released later by its owner on its next allocation or free, or by SRL::Memory::ProcessFreeQueue().
+         * @code {.cpp}
+         * // On master, before any slave task allocates
+         * SRL::Memory::SlaveRam::Initialize(0x10000, SRL::Memory::Zone::HWRam);
+         *
+         * // Inside of ITask::Do(), node is allocated in the slave heap
+         * Node* node = new Node();
+         *
+         * // Later on master, block is queued and slave releases it on its next allocation
+         * delete node;
+         * @endcode
+         * @note Slave task must purge its cache with slCashPurge() before it reads memory written by master.
+         * Most recently queued block is released only after another block is queued behind it.
+         */
+        class SlaveRam
+        {
+        private:
+
+            /** @brief Memory class needs to be able to see private members to process free queues
+             */
+            friend class Memory;
+
+            /** @brief Memory zone
+             */
+            inline static Memory::MemoryZone zone = { nullptr, 0 };
+
+            /** @brief Slave cache was purged after the slave heap was created
+             * @note Only accessed by slave
+             */
+            inline static bool slavePurged = false;
+
+            /** @brief Get slave heap zone
+             * @details Zone is written by master in Initialize(), so it is read through cache-through address.
+             * On first use on slave the slave cache is purged, so no stale lines of the heap memory are left from before master handed it over.
+             * @return Memory zone
+             */
+            inline static Memory::MemoryZone GetZone()
+            {
+                const Memory::MemoryZone current = *Memory::Uncached(&SlaveRam::zone);
+
+                if (current.Size > 0 && !SlaveRam::slavePurged && Memory::IsSlave())
+                {
+                    slCashPurge();
+                    SlaveRam::slavePurged = true;
+                }
+
+                return current;
+            }
+
+            /** @brief Free block in the slave heap
+             * @note Must be called on slave
+             * @param ptr Pointer to allocated memory
+             */
+            inline static void Release(void* ptr)
+            {
+                #if defined(USE_TLSF_ALLOCATOR)
+                tlsf_free(SlaveRam::GetZone().Address, ptr);
+                #else
+                Memory::SimpleMalloc::Free(SlaveRam::GetZone(), ptr);
+                #endif
+            }
+
+        public:
+
+            /** @brief Create slave heap
+             * @note Must be called on master before slave allocates anything, slave heap cannot be destroyed
+             * @param size Size of the slave heap in bytes
+             * @param source Memory zone slave heap is taken from
+             * @return True on success, false if slave heap already exists or there is not enough memory
+             */
+            inline static bool Initialize(size_t size, const Zone source = Zone::HWRam)
+            {
+                if (SlaveRam::IsInitialized() || Memory::IsSlave())
+                {
+                    return false;
+                }
+
+                size &= ~3;
+                void* address = Memory::Malloc(size, source);
+
+                if (address == nullptr)
+                {
+                    return false;
+                }
+
+                Memory::masterQueue.Reset();
+                Memory::slaveQueue.Reset();
+
+                #if defined(USE_TLSF_ALLOCATOR)
+                SlaveRam::zone = Memory::MemoryZone
+                {
+                    tlsf_create_with_pool(address, size),
+                    size
+                };
+                #else
+                SlaveRam::zone = Memory::MemoryZone
+                {
+                    Memory::SimpleMalloc::InitializeZone(address, size),
+                    size
+                };
+                #endif
+
+                return true;
+            }
+
+            /** @brief Check whether slave heap was created
+             * @return true if slave allocates from its own heap
+             */
+            inline static bool IsInitialized()
+            {
+                return SlaveRam::GetZone().Size > 0;
+            }
+
+            /** @brief Check whether pointer is in range of the memory zone
+             * @param ptr Pointer to check
+             * @return true if pointer belongs to the slave heap
+             */
+            inline static bool InRange(void* ptr)
+            {
+                return SlaveRam::IsInitialized() && Memory::InZone(SlaveRam::GetZone(), ptr);
+            }
+
+            /** @brief Free allocated memory
+             * @note Can be called on either CPU, on master the block is queued for slave to release it
+             * @param ptr Pointer to allocated memory
+             */
+            inline static void Free(void* ptr)
+            {
+                if (ptr == nullptr || !SlaveRam::InRange(ptr))
+                {
+                    return;
+                }
+
+                if (Memory::IsSlave())
+                {
+                    Memory::ProcessFreeQueue();
+                    SlaveRam::Release(ptr);
+                }
+                else
+                {
+                    Memory::slaveQueue.Push(ptr);
+                }
+            }
+
+            /** @brief Allocate some memory
+             * @note Must be called on slave
+             * @param size Number of bytes to allocate
+             * @return Pointer to the allocated space in memory
+             */
+            inline static void* Malloc(size_t size)
+            {
+                if (!SlaveRam::IsInitialized())
+                {
+                    return nullptr;
+                }
+
+                Memory::ProcessFreeQueue();
+
+                #if defined(USE_TLSF_ALLOCATOR)
+                return tlsf_malloc(SlaveRam::GetZone().Address, size);
+                #else
+                return Memory::SimpleMalloc::Malloc(SlaveRam::GetZone(), size);
+                #endif
+            }
+
+            /** @brief Allocate some memory starting at aligned address
+             * @note Must be called on slave
+             * @param size Number of bytes to allocate
+             * @param alignment Alignment of the returned address, must be power of two
+             * @return Pointer to the allocated space in memory
+             */
+            inline static void* MallocAligned(size_t size, size_t alignment)
+            {
+                if (!SlaveRam::IsInitialized())
+                {
+                    return nullptr;
+                }
+
+                Memory::ProcessFreeQueue();
+
+                #if defined(USE_TLSF_ALLOCATOR)
+                return tlsf_memalign(SlaveRam::GetZone().Address, alignment, size);
+                #else
+                return Memory::SimpleMalloc::MallocAligned(SlaveRam::GetZone(), size, alignment);
+                #endif
+            }
+
+            /** @brief Reallocate existing memory
+             * @note Must be called on slave
+             * @param ptr Pointer to the existing allocated memory
+             * @param size New size in number of bytes that should be allocated
+             * @return Pointer to the allocated space in memory
+             */
+            inline static void* Realloc(void* ptr, size_t size)
+            {
+                if (!SlaveRam::IsInitialized())
+                {
+                    return nullptr;
+                }
+
+                Memory::ProcessFreeQueue();
+
+                #if defined(USE_TLSF_ALLOCATOR)
+                return tlsf_realloc(SlaveRam::GetZone().Address, ptr, size);
+                #else
+                return Memory::SimpleMalloc::Realloc(SlaveRam::GetZone(), ptr, size);
+                #endif
+            }
+
+            /** @brief Gets total size of the free space in the memory zone
+             * @note Blocks waiting in the free queue are not counted as free
+             * @return Number of bytes
+             */
+            inline static size_t GetFreeSpace()
+            {
+                #if defined(USE_TLSF_ALLOCATOR)
+                return SlaveRam::IsInitialized() ? Memory::GetTlsfReport(SlaveRam::GetZone()).FreeSize : 0;
+                #else
+                return SlaveRam::IsInitialized() ? Memory::SimpleMalloc::GetReport(SlaveRam::GetZone()).FreeSize : 0;
+                #endif
+            }
+
+            /** @brief Gets report on the allocator state
+             * @return Current state of the allocator
+             */
+            static const Report GetReport()
+            {
+                #if defined(USE_TLSF_ALLOCATOR)
+                return SlaveRam::IsInitialized() ? Memory::GetTlsfReport(SlaveRam::GetZone()) : Report { 0, 0, 0, 0, 0};
+                #else
+                return SlaveRam::IsInitialized() ? Memory::SimpleMalloc::GetReport(SlaveRam::GetZone()) : Report { 0, 0, 0, 0, 0};
+                #endif
+            }
+
+            /** @brief Gets total size of the memory zone
+             * @return Number of bytes
+             */
+            inline static size_t GetSize()
+            {
+                return SlaveRam::GetZone().Size;
+            }
+
+            /** @brief Gets total size of the used space in the memory zone
+             * @return Number of bytes
+             */
+            inline static size_t GetUsedSpace()
+            {
+                #if defined(USE_TLSF_ALLOCATOR)
+                return SlaveRam::GetSize() - SlaveRam::GetFreeSpace();
+                #else
+                if (!SlaveRam::IsInitialized())
+                {
+                    return 0;
+                }
+
+                auto report = Memory::SimpleMalloc::GetReport(SlaveRam::GetZone());
+                return report.TotalSize - report.FreeSize;
+                #endif
             }
         };
 
+        /** @brief Check whether code is running on slave CPU
+         * @return true when called from slave SH2
+         */
+        inline static bool IsSlave()
+        {
+            // Bus control register 1 has master/slave mode bit, each CPU reads its own
+            return (*reinterpret_cast<volatile uint32_t*>(0xffffffe0) & 0x8000) != 0;
+        }
+
+        /** @brief Release blocks of the calling CPU that were freed by the other CPU
+         * @note Called automatically on allocation and free, can be called periodically to return memory sooner
+         */
+        inline static void ProcessFreeQueue()
+        {
+            if (!SlaveRam::IsInitialized())
+            {
+                return;
+            }
+
+            if (Memory::IsSlave())
+            {
+                for (void* ptr = Memory::slaveQueue.Pop(); ptr != nullptr; ptr = Memory::slaveQueue.Pop())
+                {
+                    SlaveRam::Release(ptr);
+                }
+            }
+            else
+            {
+                for (void* ptr = Memory::masterQueue.Pop(); ptr != nullptr; ptr = Memory::masterQueue.Pop())
+                {
+                    Memory::FreeInZone(ptr);
+                }
+            }
+        }
+
         /** @brief Set memory to some value by 1 byte
          * @param destination Destination to set
          * @param value Value to set
@@ -868,31 +1640,47 @@ namespace SRL
         }
 
         /** @brief Free allocated memory from any memory zone
+         * @note Can be called on either CPU, see SRL::Memory::SlaveRam
          * @param ptr Pointer to allocated memory
          */
         inline static void Free(void* ptr)
         {
-            if (HighWorkRam::InRange(ptr))
-            {
-                HighWorkRam::Free(ptr);
-            }
-            else if (LowWorkRam::InRange(ptr))
-            {
-                LowWorkRam::Free(ptr);
-            }
-            else if (CartRam::InRange(ptr))
+            // Blocks allocated with cache-through flag are freed through their cached address
+            ptr = Memory::Cached(ptr);
+
+            if (ptr != nullptr && SlaveRam::IsInitialized())
             {
-                CartRam::Free(ptr);
+                // Block owned by the other CPU is handed back to it through its free queue
+                if (SlaveRam::InRange(ptr))
+                {
+                    SlaveRam::Free(ptr);
+                    return;
+                }
+                else if (Memory::IsSlave())
+                {
+                    Memory::masterQueue.Push(ptr);
+                    return;
+                }
+
+                Memory::ProcessFreeQueue();
             }
+
+            Memory::FreeInZone(ptr);
         }
 
         /** @brief Allocate some memory in specified zone
+         * @note On slave with initialized slave heap, memory is always allocated in the slave heap
          * @param size Number of bytes to allocate
          * @param zone Memory zone
          * @return Pointer to the allocated space in memory
          */
         inline static void* Malloc(size_t size, const SRL::Memory::Zone zone)
         {
+            if (Memory::UseSlaveRam())
+            {
+                return SlaveRam::Malloc(size);
+            }
+
             switch (zone)
             {
             case SRL::Memory::Zone::CartRam:
@@ -906,6 +1694,65 @@ namespace SRL
             }
         }
 
+        /** @brief Allocate some memory in specified zone starting at aligned address
+         * @details Use for buffers read by DMA, VDP tables or data that should start on a 16 byte cache line.
+         * Returned block is freed with SRL::Memory::Free() or @c delete as any other block.
+         * @code {.cpp}
+         * // 4KB aligned table that is written by CPU and read by DMA, CPU writes go straight to RAM
+         * uint16_t* table = (uint16_t*)SRL::Memory::MallocAligned(4096, 4096, SRL::Memory::Zone::HWRam, true);
+         * 
+         * // Freed block does not have to be converted back to cached address
+         * SRL::Memory::Free(table);
+         * @endcode
+         * @note On slave with initialized slave heap, memory is always allocated in the slave heap
+         * @param size Number of bytes to allocate
+         * @param alignment Alignment of the returned address, must be power of two
+         * @param zone Memory zone
+         * @param cacheThrough Return cache-through address of the block, so that data is shared with DMA or the other CPU without cache purges.
+         * Cache lines of the calling CPU covering the block are purged, cache of the other CPU is not touched.
+         * Cart RAM is never cached, so the flag has no effect there.
+         * @return Pointer to the allocated space in memory or nullptr if alignment is not power of two or there is not enough memory
+         */
+        inline static void* MallocAligned(size_t size, size_t alignment, const SRL::Memory::Zone zone = SRL::Memory::Zone::HWRam, const bool cacheThrough = false)
+        {
+            if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+            {
+                return nullptr;
+            }
+
+            void* ptr = nullptr;
+
+            if (Memory::UseSlaveRam())
+            {
+                ptr = SlaveRam::MallocAligned(size, alignment);
+            }
+            else
+            {
+                switch (zone)
+                {
+                case SRL::Memory::Zone::CartRam:
+                    ptr = SRL::Memory::CartRam::MallocAligned(size, alignment);
+                    break;
+
+                case SRL::Memory::Zone::LWRam:
+                    ptr = SRL::Memory::LowWorkRam::MallocAligned(size, alignment);
+                    break;
+
+                default:
+                    ptr = SRL::Memory::HighWorkRam::MallocAligned(size, alignment);
+                    break;
+                }
+            }
+
+            if (ptr != nullptr && cacheThrough && !CartRam::InRange(ptr))
+            {
+                Memory::PurgeCache(ptr, size);
+                return Memory::Uncached(ptr);
+            }
+
+            return ptr;
+        }
+
         /** @brief Allocate some memory in zone containing specified address
          * @param size Number of bytes to allocate
          * @param address Address in the memory where object should be allocated
@@ -913,6 +1760,11 @@ namespace SRL
          */
         inline static void* PlacementMalloc(size_t size, uint32_t address)
         {
+            if (Memory::UseSlaveRam())
+            {
+                return SlaveRam::Malloc(size);
+            }
+
             // Figure out what malloc we have to use
             if (SRL::Memory::HighWorkRam::InRange(address))
             {
@@ -937,6 +1789,11 @@ namespace SRL
          */
         inline static void* PlacementMalloc(size_t size, void* address)
         {
+            if (Memory::UseSlaveRam())
+            {
+                return SlaveRam::Malloc(size);
+            }
+
             // Figure out what malloc we have to use
             if (SRL::Memory::HighWorkRam::InRange(address))
             {
@@ -1053,12 +1910,13 @@ inline void* operator new[](size_t size, uint32_t zoneAddress)
 }
 
 /** @brief Allocate some memory
+ * @note Allocates in the slave heap when called on slave, see SRL::Memory::SlaveRam
  * @param size Number of bytes to allocate
  * @return Pointer to the allocated space in memory
  */
 inline void* operator new(size_t size)
 {
-    return SRL::Memory::HighWorkRam::Malloc(size);
+    return SRL::Memory::Malloc(size, SRL::Memory::Zone::HWRam);
 }
 
 /** @brief Allocate some memory
@@ -1068,17 +1926,7 @@ inline void* operator new(size_t size)
  */
 inline void* operator new(size_t size, const SRL::Memory::Zone zone)
 {
-    switch (zone)
-    {
-    case SRL::Memory::Zone::CartRam:
-        return SRL::Memory::CartRam::Malloc(size);
-
-    case SRL::Memory::Zone::LWRam:
-        return SRL::Memory::LowWorkRam::Malloc(size);
-
-    default:
-        return SRL::Memory::HighWorkRam::Malloc(size);
-    }
+    return SRL::Memory::Malloc(size, zone);
 }
 
 /** @brief Free allocated memory
@@ -1104,7 +1952,7 @@ inline void operator delete(void* ptr, size_t size)
  */
 inline void* operator new[](size_t size)
 {
-    return SRL::Memory::HighWorkRam::Malloc(size);
+    return SRL::Memory::Malloc(size, SRL::Memory::Zone::HWRam);
 }
 
 /** @brief Allocate some memory
@@ -1113,17 +1961,7 @@ inline void* operator new[](size_t size)
  */
 inline void* operator new[](size_t size, const SRL::Memory::Zone zone)
 {
-    switch (zone)
-    {
-    case SRL::Memory::Zone::CartRam:
-        return SRL::Memory::CartRam::Malloc(size);
-
-    case SRL::Memory::Zone::LWRam:
-        return SRL::Memory::LowWorkRam::Malloc(size);
-
-    default:
-        return SRL::Memory::HighWorkRam::Malloc(size);
-    }
+    return SRL::Memory::Malloc(size, zone);
 }
 
 /** @brief Free allocated array from memory
@@ -1141,4 +1979,85 @@ inline void operator delete[](void* ptr)
 inline void operator delete[](void* ptr, size_t size)
 {
     SRL::Memory::Free(ptr);
-}
\ No newline at end of file
+}
+
+/** @brief Allocate some memory for over-aligned type
+ * @note Used by @c new for types declared with @c alignas bigger than 4 bytes
+ * @param size Number of bytes to allocate
+ * @param alignment Alignment of the type
+ * @return Pointer to the allocated space in memory
+ */
+inline void* operator new(size_t size, std::align_val_t alignment)
+{
+    return SRL::Memory::MallocAligned(size, static_cast<size_t>(alignment), SRL::Memory::Zone::HWRam);
+}
+
+/** @brief Allocate some memory for over-aligned type
+ * @param size Number of bytes to allocate
+ * @param alignment Alignment of the type
+ * @param zone Memory zone
+ * @return Pointer to the allocated space in memory
+ */
+inline void* operator new(size_t size, std::align_val_t alignment, const SRL::Memory::Zone zone)
+{
+    return SRL::Memory::MallocAligned(size, static_cast<size_t>(alignment), zone);
+}
+
+/** @brief Allocate some memory from array of over-aligned type
+ * @param size Number of bytes to allocate
+ * @param alignment Alignment of the type
+ * @return Pointer to the allocated space in memory
+ */
+inline void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return SRL::Memory::MallocAligned(size, static_cast<size_t>(alignment), SRL::Memory::Zone::HWRam);
+}
+
+/** @brief Allocate some memory from array of over-aligned type
+ * @param size Number of bytes to allocate
+ * @param alignment Alignment of the type
+ * @param zone Memory zone
+ * @return Pointer to the allocated space in memory
+ */
+inline void* operator new[](size_t size, std::align_val_t alignment, const SRL::Memory::Zone zone)
+{
+    return SRL::Memory::MallocAligned(size, static_cast<size_t>(alignment), zone);
+}
+
+/** @brief Free allocated memory of over-aligned type
+ * @param ptr Pointer to allocated memory
+ * @param alignment Alignment of the type (Not used)
+ */
+inline void operator delete(void* ptr, std::align_val_t alignment)
+{
+    SRL::Memory::Free(ptr);
+}
+
+/** @brief Free allocated memory of over-aligned type
+ * @param ptr Pointer to allocated memory
+ * @param size Number of bytes to free (Not used)
+ * @param alignment Alignment of the type (Not used)
+ */
+inline void operator delete(void* ptr, size_t size, std::align_val_t alignment)
+{
+    SRL::Memory::Free(ptr);
+}
+
+/** @brief Free allocated array of over-aligned type from memory
+ * @param ptr Pointer to allocated memory
+ * @param alignment Alignment of the type (Not used)
+ */
+inline void operator delete[](void* ptr, std::align_val_t alignment)
+{
+    SRL::Memory::Free(ptr);
+}
+
+/** @brief Free allocated array of over-aligned type from memory
+ * @param ptr Pointer to allocated memory
+ * @param size Number of bytes to free (Not used)
+ * @param alignment Alignment of the type (Not used)
+ */
+inline void operator delete[](void* ptr, size_t size, std::align_val_t alignment)
+{
+    SRL::Memory::Free(ptr);
+}
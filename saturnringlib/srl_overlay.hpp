@@ -0,0 +1,269 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_cd.hpp"
+#include "srl_debug.hpp"
+
+extern "C"
+{
+    /** @brief Start of the shared overlay region
+     * @note Defined within linker script
+     */
+    extern uint8_t _overlay_start;
+
+    /** @brief End of the shared overlay region (end of the largest overlay)
+     * @note Defined within linker script
+     */
+    extern uint8_t _overlay_end;
+}
+
+namespace SRL
+{
+    /** @brief Code overlays loaded from CD on demand
+     * @details Overlays are groups of source files that are linked to the same shared region of HWRam.
+     * Only one overlay can be resident at a time, loading another one replaces the previous.
+     * Overlays are declared in the project makefile, each overlay is then written to the CD as a separate file named <tt>NAME.OVL</tt>.
+     * @code {.makefile}
+     * SRL_OVERLAYS = MENU BOSS1
+     * SRL_OVERLAY_MENU_SOURCES = overlays/menu.cxx
+     * SRL_OVERLAY_BOSS1_SOURCES = overlays/boss1.cxx overlays/boss1_ai.cxx
+     * @endcode
+     * Overlay sources must not be part of the <tt>SOURCES</tt> list.
+     * Code in one overlay cannot reference code or data of another overlay (checked by linker),
+     * and static constructors inside of overlays are not called, .bss of the overlay is cleared on every load.
+     * Inline functions and templates used by an overlay are linked into it as a private copy,
+     * so each overlay (and the main program) has its own instance of their static variables.
+     * @code {.cpp}
+     * if (SRL::Overlay::Load("BOSS1"))
+     * {
+     *     // Function is checked to be in the loaded overlay when compiled with DEBUG
+     *     SRL::Overlay::Call("BOSS1", BossUpdate, deltaTime);
+     * }
+     * @endcode
+     */
+    class Overlay
+    {
+    private:
+
+        /** @brief Header linked to the start of every overlay (see overlay_linker in shared.mk)
+         */
+        struct Header
+        {
+            /** @brief Start address of overlay .bss
+             */
+            uint32_t BssStart;
+
+            /** @brief End address of overlay .bss
+             */
+            uint32_t BssEnd;
+        };
+
+        /** @brief Name of the currently loaded overlay
+         */
+        inline static char loaded[9] = { '\0' };
+
+        /** @brief Size of the currently loaded overlay
+         */
+        inline static size_t loadedSize = 0;
+
+        /** @brief Compare overlay names
+         * @param left First name
+         * @param right Second name
+         * @return True if names are same
+         */
+        static bool IsSameName(const char* left, const char* right)
+        {
+            for (size_t index = 0; index < Overlay::MaxNameLength; index++)
+            {
+                if (left[index] != right[index])
+                {
+                    return false;
+                }
+                else if (left[index] == '\0')
+                {
+                    return true;
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief Disable constructor
+         */
+        Overlay() = delete;
+
+        /** @brief Disable destructor
+         */
+        ~Overlay() = delete;
+
+    public:
+
+        /** @brief Maximal length of overlay name
+         * @note Name is used as CD file name together with the <tt>.OVL</tt> extension
+         */
+        static constexpr size_t MaxNameLength = 8;
+
+        /** @brief Get start of the shared overlay region
+         * @return Pointer to the region
+         */
+        static void* GetRegionStart()
+        {
+            return &_overlay_start;
+        }
+
+        /** @brief Get size of the shared overlay region
+         * @return Size in bytes (size of the largest overlay)
+         */
+        static size_t GetRegionSize()
+        {
+            return &_overlay_end - &_overlay_start;
+        }
+
+        /** @brief Get name of the currently loaded overlay
+         * @return Overlay name or nullptr if none is loaded
+         */
+        static const char* GetLoaded()
+        {
+            return Overlay::loaded[0] != '\0' ? Overlay::loaded : nullptr;
+        }
+
+        /** @brief Get size of the currently loaded overlay
+         * @return Size in bytes, including .bss
+         */
+        static size_t GetLoadedSize()
+        {
+            return Overlay::loadedSize;
+        }
+
+        /** @brief Check whether overlay is loaded
+         * @param name Overlay name
+         * @return True if overlay is currently resident
+         */
+        static bool IsLoaded(const char* name)
+        {
+            return name != nullptr && Overlay::loaded[0] != '\0' && Overlay::IsSameName(name, Overlay::loaded);
+        }
+
+        /** @brief Load overlay from CD into the shared region
+         * @note Replaces currently loaded overlay, any pointers into the previous overlay become invalid.
+         * Only cache of the calling CPU is purged, slave must purge its own cache before executing overlay code.
+         * @param name Overlay name
+         * @return True on success
+         */
+        static bool Load(const char* name)
+        {
+            if (name == nullptr)
+            {
+                return false;
+            }
+
+            if (Overlay::IsLoaded(name))
+            {
+                return true;
+            }
+
+            char fileName[Overlay::MaxNameLength + 5];
+            size_t length = 0;
+
+            while (length < Overlay::MaxNameLength && name[length] != '\0')
+            {
+                fileName[length] = name[length];
+                length++;
+            }
+
+            fileName[length] = '.';
+            fileName[length + 1] = 'O';
+            fileName[length + 2] = 'V';
+            fileName[length + 3] = 'L';
+            fileName[length + 4] = '\0';
+
+            Cd::File file = Cd::File(fileName);
+
+            if (!file.Exists() || static_cast<size_t>(file.Size.Bytes) < sizeof(Overlay::Header) || static_cast<size_t>(file.Size.Bytes) > Overlay::GetRegionSize())
+            {
+                return false;
+            }
+
+            // Region is about to be overwritten
+            Overlay::Unload();
+
+            if (file.LoadBytes(0, file.Size.Bytes, Overlay::GetRegionStart()) != file.Size.Bytes)
+            {
+                return false;
+            }
+
+            // Make sure no stale instructions or data of previous overlay stay in cache
+            slCashPurge();
+
+            // Overlay .bss is not guaranteed to be zero in the file, clear it using addresses from overlay header
+            const Overlay::Header* header = static_cast<const Overlay::Header*>(Overlay::GetRegionStart());
+            uint8_t* bssStart = reinterpret_cast<uint8_t*>(header->BssStart);
+            uint8_t* bssEnd = reinterpret_cast<uint8_t*>(header->BssEnd);
+
+            if (bssStart < &_overlay_start || bssEnd < bssStart || bssEnd > &_overlay_end)
+            {
+                return false;
+            }
+
+            Memory::MemSet(bssStart, 0, bssEnd - bssStart);
+
+            for (size_t index = 0; index < length; index++)
+            {
+                Overlay::loaded[index] = name[index];
+            }
+
+            Overlay::loaded[length] = '\0';
+            Overlay::loadedSize = bssEnd - &_overlay_start;
+            return true;
+        }
+
+        /** @brief Mark overlay region as empty
+         */
+        static void Unload()
+        {
+            Overlay::loaded[0] = '\0';
+            Overlay::loadedSize = 0;
+        }
+
+        /** @brief Check that function or data is resident before accessing it
+         * @note Does nothing unless compiled with DEBUG
+         * @param name Overlay the address belongs to
+         * @param address Address of function or data inside the overlay
+         */
+        static void Check(const char* name, const void* address = nullptr)
+        {
+#ifdef DEBUG
+            if (!Overlay::IsLoaded(name))
+            {
+                SRL::Debug::Assert("Overlay '%s' is not loaded!\nLoaded overlay: %s", name, Overlay::GetLoaded() != nullptr ? Overlay::GetLoaded() : "none");
+            }
+            else if (address != nullptr)
+            {
+                const uint8_t* location = static_cast<const uint8_t*>(address);
+                const uint8_t* start = static_cast<const uint8_t*>(Overlay::GetRegionStart());
+
+                if (location < start || location >= start + Overlay::loadedSize)
+                {
+                    SRL::Debug::Assert("Address 0x%x is not inside of overlay '%s'", (uint32_t)address, name);
+                }
+            }
+#endif
+        }
+
+        /** @brief Call function that lives inside of an overlay
+         * @note When compiled with DEBUG, asserts that the overlay is loaded and the function is inside of it
+         * @tparam Function Function type
+         * @tparam Args Argument types
+         * @param name Overlay the function belongs to
+         * @param function Function to call
+         * @param args Function arguments
+         * @return Return value of the function
+         */
+        template <typename Function, typename ...Args>
+        static auto Call(const char* name, Function function, Args...args)
+        {
+            Overlay::Check(name, reinterpret_cast<const void*>(function));
+            return function(args...);
+        }
+    };
+}
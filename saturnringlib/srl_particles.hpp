@@ -0,0 +1,578 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_scene2d.hpp"
+#include "srl_slave.hpp"
+
+namespace SRL
+{
+    /** @brief Pooled particle system
+     * @details Particles are stored as structure of arrays in a single pool and integrated in fixed point.
+     * All particles share one texture, its sprite attribute is built once and reused for every sprite submitted to VDP1.
+     * Integration can be split between both CPUs, or run fully on the slave CPU while the master does something else.
+     *
+     * In screen mode particle positions are screen coordinates and particles are drawn as scaled sprites.
+     * In world mode particle positions are 3D coordinates, particles are drawn as billboards transformed by current matrix
+     * and scaled by distance.
+     * @code {.cpp}
+     * SRL::ParticleSystem sparks(2000, SRL::ParticleSystem::Mode::World);
+     * sparks.SetTexture(sparkTexture);
+     * sparks.SetGravity(Vector3D(0.0, 0.02, 0.0));
+     *
+     * SRL::ParticleSystem::Emitter fountain;
+     * fountain.Velocity = Vector3D(0.0, -1.5, 0.0);
+     * fountain.VelocitySpread = Vector3D(0.5, 0.3, 0.5);
+     * fountain.Life = 90;
+     * fountain.Rate = 20.0;
+     *
+     * // Each frame
+     * sparks.Emit(fountain);
+     * sparks.BeginUpdate();       // Slave integrates particles
+     * // ... master runs game logic ...
+     * sparks.EndUpdate();
+     * sparks.Draw();
+     * @endcode
+     */
+    class ParticleSystem
+    {
+    public:
+
+        /** @brief Particle drawing mode
+         */
+        enum class Mode : uint8_t
+        {
+            /** @brief Particles are in screen coordinates
+             */
+            Screen = 0,
+
+            /** @brief Particles are in 3D and drawn as projected billboards
+             */
+            World = 1
+        };
+
+        /** @brief Particle emitter definition
+         */
+        struct Emitter
+        {
+            /** @brief Where particles are spawned
+             */
+            Math::Types::Vector3D Position;
+
+            /** @brief Maximal random offset of spawn position on each axis
+             */
+            Math::Types::Vector3D PositionSpread;
+
+            /** @brief Initial velocity per frame
+             */
+            Math::Types::Vector3D Velocity;
+
+            /** @brief Maximal random change of initial velocity on each axis
+             */
+            Math::Types::Vector3D VelocitySpread;
+
+            /** @brief Particle lifetime in frames
+             */
+            uint16_t Life;
+
+            /** @brief Maximal random change of lifetime
+             */
+            uint16_t LifeSpread;
+
+            /** @brief Initial particle scale
+             */
+            Math::Types::Fxp Scale;
+
+            /** @brief Change of scale per frame, particle dies when its scale reaches zero
+             */
+            Math::Types::Fxp ScaleSpeed;
+
+            /** @brief Number of particles spawned per frame, can be fractional
+             */
+            Math::Types::Fxp Rate;
+
+            /** @brief Construct emitter with default values
+             */
+            Emitter() :
+                Position(), PositionSpread(), Velocity(), VelocitySpread(),
+                Life(60), LifeSpread(0), Scale(1.0), ScaleSpeed(0.0), Rate(1.0) {}
+        };
+
+    private:
+
+        /** @brief Part of the pool integrated on slave CPU
+         */
+        class UpdateTask : public Types::ITask
+        {
+        public:
+
+            /** @brief Particle system to update
+             */
+            ParticleSystem* System;
+
+            /** @brief First particle
+             */
+            size_t Start;
+
+            /** @brief Particle after the last one
+             */
+            size_t End;
+
+        protected:
+
+            /** @brief Integrate particles on slave
+             */
+            void Do() override
+            {
+                // Master might have spawned particles since slave last looked at the pool
+                slCashPurge();
+                this->System->Integrate(this->Start, this->End);
+            }
+        };
+
+        /** @brief Particle positions
+         */
+        int32_t* positionX;
+
+        /** @brief Particle positions
+         */
+        int32_t* positionY;
+
+        /** @brief Particle positions
+         */
+        int32_t* positionZ;
+
+        /** @brief Particle velocities
+         */
+        int32_t* velocityX;
+
+        /** @brief Particle velocities
+         */
+        int32_t* velocityY;
+
+        /** @brief Particle velocities
+         */
+        int32_t* velocityZ;
+
+        /** @brief Particle scales
+         */
+        int32_t* scale;
+
+        /** @brief Particle scale change per frame
+         */
+        int32_t* scaleSpeed;
+
+        /** @brief Remaining particle lifetime in frames
+         */
+        uint16_t* life;
+
+        /** @brief Number of live particles
+         */
+        size_t count;
+
+        /** @brief Maximal number of particles
+         */
+        size_t capacity;
+
+        /** @brief Drawing mode
+         */
+        Mode mode;
+
+        /** @brief Shared sprite attribute of all particles
+         */
+        SPR_ATTR attribute;
+
+        /** @brief Texture was set
+         */
+        bool hasTexture;
+
+        /** @brief Velocity change per frame
+         */
+        Math::Types::Vector3D gravity;
+
+        /** @brief Sort depth of screen mode particles
+         */
+        Math::Types::Fxp depth;
+
+        /** @brief Fraction of a particle carried over to next Emit()
+         */
+        Math::Types::Fxp accumulated;
+
+        /** @brief Random generator for emitter spread
+         */
+        Math::Random random;
+
+        /** @brief Slave CPU task
+         */
+        UpdateTask task;
+
+        /** @brief Slave CPU is integrating particles
+         */
+        bool isUpdating;
+
+        /** @brief Get random value within spread
+         * @param spread Maximal absolute value
+         * @return Random value
+         */
+        int32_t GetSpread(const Math::Types::Fxp& spread)
+        {
+            const int32_t range = spread.RawValue() >> 8;
+
+            if (range <= 0)
+            {
+                return 0;
+            }
+
+            return this->random.GetNumber(-range, range) << 8;
+        }
+
+        /** @brief Integrate range of particles
+         * @param start First particle
+         * @param end Particle after the last one
+         */
+        void Integrate(const size_t start, const size_t end)
+        {
+            const int32_t gravityX = this->gravity.X.RawValue();
+            const int32_t gravityY = this->gravity.Y.RawValue();
+            const int32_t gravityZ = this->gravity.Z.RawValue();
+
+            for (size_t particle = start; particle < end; particle++)
+            {
+                this->velocityX[particle] += gravityX;
+                this->velocityY[particle] += gravityY;
+                this->velocityZ[particle] += gravityZ;
+                this->positionX[particle] += this->velocityX[particle];
+                this->positionY[particle] += this->velocityY[particle];
+                this->positionZ[particle] += this->velocityZ[particle];
+                this->scale[particle] += this->scaleSpeed[particle];
+
+                if (this->life[particle] > 0)
+                {
+                    this->life[particle]--;
+                }
+            }
+        }
+
+        /** @brief Remove dead particles, last particle is moved into place of the removed one
+         */
+        void Compact()
+        {
+            size_t particle = 0;
+
+            while (particle < this->count)
+            {
+                if (this->life[particle] == 0 || this->scale[particle] <= 0)
+                {
+                    const size_t last = --this->count;
+                    this->positionX[particle] = this->positionX[last];
+                    this->positionY[particle] = this->positionY[last];
+                    this->positionZ[particle] = this->positionZ[last];
+                    this->velocityX[particle] = this->velocityX[last];
+                    this->velocityY[particle] = this->velocityY[last];
+                    this->velocityZ[particle] = this->velocityZ[last];
+                    this->scale[particle] = this->scale[last];
+                    this->scaleSpeed[particle] = this->scaleSpeed[last];
+                    this->life[particle] = this->life[last];
+                }
+                else
+                {
+                    particle++;
+                }
+            }
+        }
+
+    public:
+
+        /** @brief Construct particle system
+         * @param capacity Maximal number of live particles
+         * @param mode Drawing mode
+         * @param zone Memory zone to allocate particle pool in
+         */
+        ParticleSystem(const size_t capacity, const Mode mode = Mode::Screen, const Memory::Zone zone = Memory::Zone::HWRam) :
+            count(0), capacity(capacity), mode(mode), hasTexture(false), gravity(), depth(500.0), accumulated(0.0), random(1), isUpdating(false)
+        {
+            this->positionX = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * capacity, zone));
+            this->positionY = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * capacity, zone));
+            this->positionZ = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * capacity, zone));
+            this->velocityX = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * capacity, zone));
+            this->velocityY = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * capacity, zone));
+            this->velocityZ = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * capacity, zone));
+            this->scale = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * capacity, zone));
+            this->scaleSpeed = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * capacity, zone));
+            this->life = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * capacity, zone));
+
+            if (this->positionX == nullptr || this->positionY == nullptr || this->positionZ == nullptr ||
+                this->velocityX == nullptr || this->velocityY == nullptr || this->velocityZ == nullptr ||
+                this->scale == nullptr || this->scaleSpeed == nullptr || this->life == nullptr)
+            {
+                SRL::Debug::Assert("Not enough memory for %d particles", capacity);
+            }
+
+            this->task.System = this;
+        }
+
+        /** @brief Disable copying
+         */
+        ParticleSystem(const ParticleSystem&) = delete;
+
+        /** @brief Disable copying
+         */
+        ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+        /** @brief Destroy particle system
+         */
+        ~ParticleSystem()
+        {
+            this->EndUpdate();
+            Memory::Free(this->positionX);
+            Memory::Free(this->positionY);
+            Memory::Free(this->positionZ);
+            Memory::Free(this->velocityX);
+            Memory::Free(this->velocityY);
+            Memory::Free(this->velocityZ);
+            Memory::Free(this->scale);
+            Memory::Free(this->scaleSpeed);
+            Memory::Free(this->life);
+        }
+
+        /** @brief Set texture of all particles
+         * @note Current SRL::Scene2D effects (transparency, gouraud, ...) are captured as well
+         * @param texture Texture identifier
+         * @param palette Texture color palette override
+         */
+        void SetTexture(const uint16_t texture, SRL::CRAM::Palette* palette = nullptr)
+        {
+            this->attribute = Scene2D::GetSpriteAttribute(texture, palette);
+            this->hasTexture = true;
+        }
+
+        /** @brief Set velocity change applied to all particles each frame
+         * @param gravity Velocity change per frame
+         */
+        void SetGravity(const Math::Types::Vector3D& gravity)
+        {
+            this->gravity = gravity;
+        }
+
+        /** @brief Set sort depth of particles in screen mode
+         * @param depth Sort depth
+         */
+        void SetDepth(const Math::Types::Fxp& depth)
+        {
+            this->depth = depth;
+        }
+
+        /** @brief Spawn single particle
+         * @param position Particle position
+         * @param velocity Particle velocity per frame
+         * @param life Lifetime in frames
+         * @param scale Particle scale
+         * @param scaleSpeed Change of scale per frame
+         * @return True if particle was spawned, false if pool is full
+         */
+        bool Spawn(
+            const Math::Types::Vector3D& position,
+            const Math::Types::Vector3D& velocity,
+            const uint16_t life,
+            const Math::Types::Fxp& scale = 1.0,
+            const Math::Types::Fxp& scaleSpeed = 0.0)
+        {
+            if (this->count >= this->capacity || life == 0)
+            {
+                return false;
+            }
+
+            const size_t particle = this->count++;
+            this->positionX[particle] = position.X.RawValue();
+            this->positionY[particle] = position.Y.RawValue();
+            this->positionZ[particle] = position.Z.RawValue();
+            this->velocityX[particle] = velocity.X.RawValue();
+            this->velocityY[particle] = velocity.Y.RawValue();
+            this->velocityZ[particle] = velocity.Z.RawValue();
+            this->scale[particle] = scale.RawValue();
+            this->scaleSpeed[particle] = scaleSpeed.RawValue();
+            this->life[particle] = life;
+            return true;
+        }
+
+        /** @brief Spawn particles from emitter
+         * @param emitter Emitter definition
+         * @param amount Number of particles to spawn
+         * @return Number of spawned particles
+         */
+        size_t Burst(const Emitter& emitter, const size_t amount)
+        {
+            size_t spawned = 0;
+
+            for (; spawned < amount; spawned++)
+            {
+                const Math::Types::Vector3D position(
+                    Math::Types::Fxp::BuildRaw(emitter.Position.X.RawValue() + this->GetSpread(emitter.PositionSpread.X)),
+                    Math::Types::Fxp::BuildRaw(emitter.Position.Y.RawValue() + this->GetSpread(emitter.PositionSpread.Y)),
+                    Math::Types::Fxp::BuildRaw(emitter.Position.Z.RawValue() + this->GetSpread(emitter.PositionSpread.Z)));
+
+                const Math::Types::Vector3D velocity(
+                    Math::Types::Fxp::BuildRaw(emitter.Velocity.X.RawValue() + this->GetSpread(emitter.VelocitySpread.X)),
+                    Math::Types::Fxp::BuildRaw(emitter.Velocity.Y.RawValue() + this->GetSpread(emitter.VelocitySpread.Y)),
+                    Math::Types::Fxp::BuildRaw(emitter.Velocity.Z.RawValue() + this->GetSpread(emitter.VelocitySpread.Z)));
+
+                const uint16_t life = emitter.LifeSpread > 0 ?
+                    Math::Min<int32_t>(0xffff, Math::Max<int32_t>(1, emitter.Life + this->random.GetNumber(-emitter.LifeSpread, emitter.LifeSpread))) :
+                    emitter.Life;
+
+                if (!this->Spawn(position, velocity, life, emitter.Scale, emitter.ScaleSpeed))
+                {
+                    break;
+                }
+            }
+
+            return spawned;
+        }
+
+        /** @brief Spawn particles from emitter according to its rate, call once per frame
+         * @note Fraction of a particle left over is carried by the particle system, use one system per continuous emitter
+         * @param emitter Emitter definition
+         * @return Number of spawned particles
+         */
+        size_t Emit(const Emitter& emitter)
+        {
+            this->accumulated += emitter.Rate;
+            const size_t amount = this->accumulated.RawValue() > 0 ? this->accumulated.RawValue() >> 16 : 0;
+            this->accumulated = Math::Types::Fxp::BuildRaw(this->accumulated.RawValue() & 0xffff);
+            return this->Burst(emitter, amount);
+        }
+
+        /** @brief Move particles by one frame and remove dead ones
+         * @param slaveShare Share of particles integrated by the slave CPU (0-256)
+         */
+        void Update(const uint16_t slaveShare = 0)
+        {
+            this->EndUpdate();
+            const size_t slaveCount = (this->count * slaveShare) >> 8;
+
+            if (slaveCount > 0)
+            {
+                this->task.Start = 0;
+                this->task.End = slaveCount;
+                Slave::ExecuteOnSlave(this->task);
+                this->isUpdating = true;
+            }
+
+            this->Integrate(slaveCount, this->count);
+            this->EndUpdate();
+        }
+
+        /** @brief Start moving particles by one frame on the slave CPU
+         * @note Pool must not be touched until SRL::ParticleSystem::EndUpdate() is called
+         */
+        void BeginUpdate()
+        {
+            this->EndUpdate();
+
+            if (this->count > 0)
+            {
+                this->task.Start = 0;
+                this->task.End = this->count;
+                Slave::ExecuteOnSlave(this->task);
+                this->isUpdating = true;
+            }
+        }
+
+        /** @brief Wait for slave CPU to finish and remove dead particles
+         */
+        void EndUpdate()
+        {
+            if (this->isUpdating)
+            {
+                while (!this->task.IsDone());
+
+                // Drop stale lines of data written by slave
+                slCashPurge();
+                this->isUpdating = false;
+            }
+
+            this->Compact();
+        }
+
+        /** @brief Submit all particles to VDP1
+         * @return Number of particles drawn, can be lower than particle count if particles were culled or sprite limit was reached
+         */
+        size_t Draw()
+        {
+            if (!this->hasTexture)
+            {
+                return 0;
+            }
+
+            FIXED position[XYZS];
+            size_t drawn = 0;
+
+            if (this->mode == Mode::Screen)
+            {
+                position[Z] = this->depth.RawValue();
+
+                for (size_t particle = 0; particle < this->count; particle++)
+                {
+                    position[X] = this->positionX[particle];
+                    position[Y] = this->positionY[particle];
+                    position[S] = this->scale[particle];
+                    drawn += slDispSprite(position, &this->attribute, 0) ? 1 : 0;
+                }
+            }
+            else
+            {
+                for (size_t particle = 0; particle < this->count; particle++)
+                {
+                    position[X] = this->positionX[particle];
+                    position[Y] = this->positionY[particle];
+                    position[Z] = this->positionZ[particle];
+                    position[S] = this->scale[particle];
+
+                    // Particles behind camera or outside of the screen are rejected by SGL
+                    drawn += slPutSprite(position, &this->attribute, 0) ? 1 : 0;
+                }
+            }
+
+            return drawn;
+        }
+
+        /** @brief Remove all particles
+         */
+        void Clear()
+        {
+            this->EndUpdate();
+            this->count = 0;
+            this->accumulated = 0.0;
+        }
+
+        /** @brief Get number of live particles
+         * @return Number of particles
+         */
+        size_t GetCount() const
+        {
+            return this->count;
+        }
+
+        /** @brief Get particle position
+         * @note Particles are reordered when dead ones are removed, index is valid only until next update
+         * @param particle Particle index (less than SRL::ParticleSystem::GetCount())
+         * @return Particle position
+         */
+        Math::Types::Vector3D GetPosition(const size_t particle) const
+        {
+            return Math::Types::Vector3D(
+                Math::Types::Fxp::BuildRaw(this->positionX[particle]),
+                Math::Types::Fxp::BuildRaw(this->positionY[particle]),
+                Math::Types::Fxp::BuildRaw(this->positionZ[particle]));
+        }
+
+        /** @brief Get maximal number of particles
+         * @return Pool capacity
+         */
+        size_t GetCapacity() const
+        {
+            return this->capacity;
+        }
+    };
+}
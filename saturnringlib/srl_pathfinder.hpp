@@ -0,0 +1,1043 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_tilemap.hpp"
+
+#ifndef SRL_PATH_CACHE_SIZE
+/** @brief Number of recent paths remembered by path finder
+ */
+#define SRL_PATH_CACHE_SIZE 8
+#endif
+
+#ifndef SRL_PATH_CACHE_LENGTH
+/** @brief Maximal length of a path that can be remembered by path finder
+ */
+#define SRL_PATH_CACHE_LENGTH 64
+#endif
+
+namespace SRL::Tilemap
+{
+    /** @brief Incremental A* path finder over a tile grid
+     * @details Passability is stored as one bit per tile. All search data is allocated once when path finder is created,
+     * every tile needs 5 bytes for search state and 4 bytes for the open set, so grids are limited to 65535 tiles.
+     * Search is advanced by SRL::Tilemap::PathFinder::Step() with a limit on expanded tiles, so long searches can be spread over several frames.
+     *
+     * With hierarchy enabled, map is split into square clusters. Clusters connected through their borders are searched first,
+     * tile search is then limited to the clusters on that route. When the limited search fails, full search is done instead.
+     *
+     * Recently found paths are remembered, asking for the same path again returns it without searching.
+     * Changing passability of any tile forgets remembered paths.
+     * @code {.cpp}
+     * SRL::Tilemap::PathFinder finder(64, 64);
+     * finder.SetFromMap(level, [](uint32_t cell) { return (cell & 0x3ff) < 16; });
+     *
+     * finder.Start(SRL::Tilemap::Coord(1, 1), SRL::Tilemap::Coord(60, 40));
+     *
+     * // Each frame
+     * if (finder.Step(200) == SRL::Tilemap::PathFinder::Status::Found)
+     * {
+     *     size_t length = finder.GetPath(path, 256);
+     * }
+     * @endcode
+     */
+    class PathFinder
+    {
+    public:
+
+        /** @brief Search status
+         */
+        enum class Status : uint8_t
+        {
+            /** @brief No search was started
+             */
+            Idle = 0,
+
+            /** @brief Search is in progress
+             */
+            Searching = 1,
+
+            /** @brief Path was found
+             */
+            Found = 2,
+
+            /** @brief There is no path between tiles
+             */
+            NotFound = 3
+        };
+
+        /** @brief Search statistics
+         */
+        struct Statistics
+        {
+            /** @brief Number of tiles expanded by current search
+             */
+            uint32_t Expanded;
+
+            /** @brief Number of frames (steps) current search took
+             */
+            uint16_t Steps;
+
+            /** @brief Number of searches answered from remembered paths
+             */
+            uint16_t CacheHits;
+
+            /** @brief Number of searches that failed in limited area and were repeated over whole map
+             */
+            uint16_t Fallbacks;
+        };
+
+    private:
+
+        /** @brief Tile has no parent
+         */
+        static constexpr uint8_t NoParent = 0x7;
+
+        /** @brief Tile is not in open set
+         */
+        static constexpr uint16_t NotInHeap = 0xffff;
+
+        /** @brief Cost of a straight step
+         */
+        static constexpr uint16_t StraightCost = 2;
+
+        /** @brief Cost of a diagonal step
+         */
+        static constexpr uint16_t DiagonalCost = 3;
+
+        /** @brief Closed flag in tile info
+         */
+        static constexpr uint8_t ClosedFlag = 0x08;
+
+        /** @brief Neighbor offsets along X axis, straight directions first
+         */
+        inline static constexpr int8_t OffsetX[8] = { 1, 0, -1, 0, 1, -1, -1, 1 };
+
+        /** @brief Neighbor offsets along Y axis, straight directions first
+         */
+        inline static constexpr int8_t OffsetY[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+
+        /** @brief Open set entry
+         */
+        struct HeapEntry
+        {
+            /** @brief Tile index
+             */
+            uint16_t Tile;
+
+            /** @brief Estimated total cost
+             */
+            uint16_t Score;
+        };
+
+        /** @brief Remembered path
+         */
+        struct CacheEntry
+        {
+            /** @brief Start tile index
+             */
+            uint16_t Start;
+
+            /** @brief Goal tile index
+             */
+            uint16_t Goal;
+
+            /** @brief Number of tiles in the path, zero for unused entry
+             */
+            uint16_t Length;
+
+            /** @brief Path tile indices from start to goal
+             */
+            uint16_t Path[SRL_PATH_CACHE_LENGTH];
+        };
+
+        /** @brief Grid width
+         */
+        uint16_t width;
+
+        /** @brief Grid height
+         */
+        uint16_t height;
+
+        /** @brief Passability bits
+         */
+        uint8_t* passable;
+
+        /** @brief Cost from start to each tile
+         */
+        uint16_t* cost;
+
+        /** @brief Position of each tile in open set
+         */
+        uint16_t* heapIndex;
+
+        /** @brief Search stamp (upper 4 bits), closed flag and parent direction (lower 3 bits) of each tile
+         */
+        uint8_t* info;
+
+        /** @brief Open set
+         */
+        HeapEntry* heap;
+
+        /** @brief Number of entries in open set
+         */
+        size_t heapCount;
+
+        /** @brief Current search stamp
+         */
+        uint8_t stamp;
+
+        /** @brief Diagonal movement is allowed
+         */
+        bool diagonal;
+
+        /** @brief Cluster size of the hierarchy, zero when disabled
+         */
+        uint8_t clusterSize;
+
+        /** @brief Number of clusters along X axis
+         */
+        uint16_t clustersX;
+
+        /** @brief Number of clusters along Y axis
+         */
+        uint16_t clustersY;
+
+        /** @brief Cluster connections (bit 0 to the right, bit 1 down)
+         */
+        uint8_t* links;
+
+        /** @brief Clusters on the route of current search, also used as visited flags of cluster search
+         */
+        uint16_t* corridor;
+
+        /** @brief Queue and parents of cluster search
+         */
+        uint16_t* route;
+
+        /** @brief Cluster connections must be rebuilt
+         */
+        bool linksDirty;
+
+        /** @brief Tile search is limited to clusters on the route
+         */
+        bool useCorridor;
+
+        /** @brief Start tile of current search
+         */
+        uint16_t startTile;
+
+        /** @brief Goal tile of current search
+         */
+        uint16_t goalTile;
+
+        /** @brief Current search status
+         */
+        Status status;
+
+        /** @brief Cache entry holding result of current search or -1
+         */
+        int32_t cachedResult;
+
+        /** @brief Remembered paths
+         */
+        CacheEntry cache[SRL_PATH_CACHE_SIZE];
+
+        /** @brief Next cache entry to replace
+         */
+        size_t cacheNext;
+
+        /** @brief Search statistics
+         */
+        Statistics statistics;
+
+        /** @brief Get tile index
+         * @param coord Tile coordinates
+         * @return Tile index
+         */
+        uint16_t GetIndex(const Coord& coord) const
+        {
+            return (coord.Y * this->width) + coord.X;
+        }
+
+        /** @brief Check whether tile index is passable
+         * @param tile Tile index
+         * @return True if tile can be walked on
+         */
+        bool IsPassableIndex(const uint16_t tile) const
+        {
+            return (this->passable[tile >> 3] & (1 << (tile & 7))) != 0;
+        }
+
+        /** @brief Check whether tile can be entered by current search
+         * @param x X coordinate
+         * @param y Y coordinate
+         * @return True if tile is inside of the map, passable and in search area
+         */
+        bool CanEnter(const int32_t x, const int32_t y) const
+        {
+            if (x < 0 || y < 0 || x >= this->width || y >= this->height || !this->IsPassableIndex((y * this->width) + x))
+            {
+                return false;
+            }
+
+            return !this->useCorridor ||
+                this->corridor[((y / this->clusterSize) * this->clustersX) + (x / this->clusterSize)] == this->stamp;
+        }
+
+        /** @brief Estimate cost between tiles
+         * @param tile Tile index
+         * @return Cost estimate to the goal
+         */
+        uint16_t Estimate(const uint16_t tile) const
+        {
+            const int32_t dx = Math::Abs(static_cast<int32_t>(tile % this->width) - static_cast<int32_t>(this->goalTile % this->width));
+            const int32_t dy = Math::Abs(static_cast<int32_t>(tile / this->width) - static_cast<int32_t>(this->goalTile / this->width));
+
+            if (this->diagonal)
+            {
+                return Math::Min<int32_t>(0xffff, (PathFinder::StraightCost * (dx + dy)) - Math::Min<int32_t>(dx, dy));
+            }
+
+            return Math::Min<int32_t>(0xffff, PathFinder::StraightCost * (dx + dy));
+        }
+
+        /** @brief Get tile the search came from
+         * @param tile Tile index
+         * @return Parent tile index
+         */
+        uint16_t GetParent(const uint16_t tile) const
+        {
+            const uint8_t parent = this->info[tile] & 0x7;
+            return ((static_cast<int32_t>(tile / this->width) - PathFinder::OffsetY[parent]) * this->width) +
+                (static_cast<int32_t>(tile % this->width) - PathFinder::OffsetX[parent]);
+        }
+
+        /** @brief Check whether tile was reached by current search
+         * @param tile Tile index
+         * @return True if tile state belongs to current search
+         */
+        bool IsVisited(const uint16_t tile) const
+        {
+            return (this->info[tile] >> 4) == this->stamp;
+        }
+
+        /** @brief Move open set entry towards the root
+         * @param position Entry position
+         */
+        void SiftUp(size_t position)
+        {
+            const HeapEntry entry = this->heap[position];
+
+            while (position > 0)
+            {
+                const size_t parent = (position - 1) >> 1;
+
+                if (this->heap[parent].Score <= entry.Score)
+                {
+                    break;
+                }
+
+                this->heap[position] = this->heap[parent];
+                this->heapIndex[this->heap[position].Tile] = position;
+                position = parent;
+            }
+
+            this->heap[position] = entry;
+            this->heapIndex[entry.Tile] = position;
+        }
+
+        /** @brief Move open set entry towards the leaves
+         * @param position Entry position
+         */
+        void SiftDown(size_t position)
+        {
+            const HeapEntry entry = this->heap[position];
+
+            while (true)
+            {
+                size_t child = (position << 1) + 1;
+
+                if (child >= this->heapCount)
+                {
+                    break;
+                }
+
+                if (child + 1 < this->heapCount && this->heap[child + 1].Score < this->heap[child].Score)
+                {
+                    child++;
+                }
+
+                if (entry.Score <= this->heap[child].Score)
+                {
+                    break;
+                }
+
+                this->heap[position] = this->heap[child];
+                this->heapIndex[this->heap[position].Tile] = position;
+                position = child;
+            }
+
+            this->heap[position] = entry;
+            this->heapIndex[entry.Tile] = position;
+        }
+
+        /** @brief Add tile to open set or lower its cost
+         * @param tile Tile index
+         * @param tileCost Cost from start
+         * @param parent Direction to parent tile
+         */
+        void Open(const uint16_t tile, const uint16_t tileCost, const uint8_t parent)
+        {
+            const uint16_t score = Math::Min<int32_t>(0xffff, tileCost + this->Estimate(tile));
+
+            if (!this->IsVisited(tile))
+            {
+                this->info[tile] = (this->stamp << 4) | parent;
+                this->cost[tile] = tileCost;
+                this->heap[this->heapCount] = HeapEntry { tile, score };
+                this->SiftUp(this->heapCount++);
+            }
+            else if ((this->info[tile] & PathFinder::ClosedFlag) == 0 && tileCost < this->cost[tile])
+            {
+                this->info[tile] = (this->stamp << 4) | parent;
+                this->cost[tile] = tileCost;
+                this->heap[this->heapIndex[tile]].Score = score;
+                this->SiftUp(this->heapIndex[tile]);
+            }
+        }
+
+        /** @brief Begin new tile search
+         */
+        void Restart()
+        {
+            // Stamps avoid clearing search state for each search, clear it only when they wrap around
+            this->stamp++;
+
+            if (this->stamp > 15)
+            {
+                this->stamp = 1;
+                const size_t tiles = this->width * this->height;
+
+                for (size_t tile = 0; tile < tiles; tile++)
+                {
+                    this->info[tile] = 0;
+                }
+            }
+
+            this->heapCount = 0;
+            this->Open(this->startTile, 0, PathFinder::NoParent);
+        }
+
+        /** @brief Rebuild cluster connections
+         */
+        void BuildLinks()
+        {
+            for (uint16_t clusterY = 0; clusterY < this->clustersY; clusterY++)
+            {
+                for (uint16_t clusterX = 0; clusterX < this->clustersX; clusterX++)
+                {
+                    uint8_t link = 0;
+                    const int32_t left = clusterX * this->clusterSize;
+                    const int32_t top = clusterY * this->clusterSize;
+                    const int32_t right = Math::Min<int32_t>(left + this->clusterSize, this->width) - 1;
+                    const int32_t bottom = Math::Min<int32_t>(top + this->clusterSize, this->height) - 1;
+
+                    for (int32_t y = top; y <= bottom && right + 1 < this->width; y++)
+                    {
+                        if (this->IsPassableIndex((y * this->width) + right) && this->IsPassableIndex((y * this->width) + right + 1))
+                        {
+                            link |= 1;
+                            break;
+                        }
+                    }
+
+                    for (int32_t x = left; x <= right && bottom + 1 < this->height; x++)
+                    {
+                        if (this->IsPassableIndex((bottom * this->width) + x) && this->IsPassableIndex(((bottom + 1) * this->width) + x))
+                        {
+                            link |= 2;
+                            break;
+                        }
+                    }
+
+                    this->links[(clusterY * this->clustersX) + clusterX] = link;
+                }
+            }
+
+            this->linksDirty = false;
+        }
+
+        /** @brief Find route between clusters of start and goal tile and mark it as search area
+         * @return True if route was found
+         */
+        bool FindCorridor()
+        {
+            if (this->linksDirty)
+            {
+                this->BuildLinks();
+            }
+
+            const uint16_t clusters = this->clustersX * this->clustersY;
+            const uint16_t startCluster = (((this->startTile / this->width) / this->clusterSize) * this->clustersX) + ((this->startTile % this->width) / this->clusterSize);
+            const uint16_t goalCluster = (((this->goalTile / this->width) / this->clusterSize) * this->clustersX) + ((this->goalTile % this->width) / this->clusterSize);
+
+            // Breadth first search over clusters
+            uint16_t* queue = this->route;
+            uint16_t* from = this->route + clusters;
+            size_t head = 0;
+            size_t tail = 0;
+            const uint16_t visited = 0x8000 | this->stamp;
+
+            for (uint16_t cluster = 0; cluster < clusters; cluster++)
+            {
+                this->corridor[cluster] = 0;
+            }
+
+            queue[tail++] = startCluster;
+            this->corridor[startCluster] = visited;
+            from[startCluster] = startCluster;
+
+            while (head < tail && this->corridor[goalCluster] != visited)
+            {
+                const uint16_t cluster = queue[head++];
+                const uint16_t x = cluster % this->clustersX;
+                const uint16_t y = cluster / this->clustersX;
+                const uint16_t neighbors[4] = {
+                    static_cast<uint16_t>((this->links[cluster] & 1) != 0 ? cluster + 1 : clusters),
+                    static_cast<uint16_t>((this->links[cluster] & 2) != 0 ? cluster + this->clustersX : clusters),
+                    static_cast<uint16_t>(x > 0 && (this->links[cluster - 1] & 1) != 0 ? cluster - 1 : clusters),
+                    static_cast<uint16_t>(y > 0 && (this->links[cluster - this->clustersX] & 2) != 0 ? cluster - this->clustersX : clusters) };
+
+                for (size_t neighbor = 0; neighbor < 4; neighbor++)
+                {
+                    if (neighbors[neighbor] < clusters && this->corridor[neighbors[neighbor]] != visited)
+                    {
+                        this->corridor[neighbors[neighbor]] = visited;
+                        from[neighbors[neighbor]] = cluster;
+                        queue[tail++] = neighbors[neighbor];
+                    }
+                }
+            }
+
+            if (this->corridor[goalCluster] != visited)
+            {
+                return false;
+            }
+
+            // Keep only clusters on the route and their neighbors, so tile search can go around obstacles near cluster borders
+            for (uint16_t cluster = goalCluster; ; cluster = from[cluster])
+            {
+                const uint16_t x = cluster % this->clustersX;
+                const uint16_t y = cluster / this->clustersX;
+                this->corridor[cluster] = this->stamp;
+
+                if (x > 0)
+                {
+                    this->corridor[cluster - 1] = this->stamp;
+                }
+
+                if (x + 1 < this->clustersX)
+                {
+                    this->corridor[cluster + 1] = this->stamp;
+                }
+
+                if (y > 0)
+                {
+                    this->corridor[cluster - this->clustersX] = this->stamp;
+                }
+
+                if (y + 1 < this->clustersY)
+                {
+                    this->corridor[cluster + this->clustersX] = this->stamp;
+                }
+
+                if (cluster == startCluster)
+                {
+                    break;
+                }
+            }
+
+            for (uint16_t cluster = 0; cluster < clusters; cluster++)
+            {
+                if (this->corridor[cluster] == visited)
+                {
+                    this->corridor[cluster] = 0;
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief Remember path of current search
+         */
+        void Remember()
+        {
+            size_t length = 1;
+
+            for (uint16_t tile = this->goalTile; tile != this->startTile; length++)
+            {
+                tile = this->GetParent(tile);
+            }
+
+            if (length > SRL_PATH_CACHE_LENGTH)
+            {
+                return;
+            }
+
+            CacheEntry& entry = this->cache[this->cacheNext];
+            this->cacheNext = (this->cacheNext + 1) % SRL_PATH_CACHE_SIZE;
+            entry.Start = this->startTile;
+            entry.Goal = this->goalTile;
+            entry.Length = length;
+
+            uint16_t tile = this->goalTile;
+
+            for (size_t position = length; position > 0; position--)
+            {
+                entry.Path[position - 1] = tile;
+
+                tile = this->GetParent(tile);
+            }
+        }
+
+    public:
+
+        /** @brief Create path finder
+         * @param width Grid width in tiles
+         * @param height Grid height in tiles
+         * @param zone Memory zone to allocate search data in
+         */
+        PathFinder(const uint16_t width, const uint16_t height, const Memory::Zone zone = Memory::Zone::HWRam) :
+            width(width),
+            height(height),
+            heapCount(0),
+            stamp(0),
+            diagonal(false),
+            clusterSize(0),
+            clustersX(0),
+            clustersY(0),
+            links(nullptr),
+            corridor(nullptr),
+            route(nullptr),
+            linksDirty(false),
+            useCorridor(false),
+            startTile(0),
+            goalTile(0),
+            status(Status::Idle),
+            cachedResult(-1),
+            cacheNext(0),
+            statistics({ 0, 0, 0, 0 })
+        {
+            const size_t tiles = width * height;
+
+            if (tiles >= PathFinder::NotInHeap)
+            {
+                SRL::Debug::Assert("Path finder grid is too large (%dx%d)", width, height);
+            }
+
+            this->passable = reinterpret_cast<uint8_t*>(Memory::Malloc((tiles + 7) >> 3, zone));
+            this->cost = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * tiles, zone));
+            this->heapIndex = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * tiles, zone));
+            this->info = reinterpret_cast<uint8_t*>(Memory::Malloc(tiles, zone));
+            this->heap = reinterpret_cast<HeapEntry*>(Memory::Malloc(sizeof(HeapEntry) * tiles, zone));
+
+            if (this->passable == nullptr || this->cost == nullptr || this->heapIndex == nullptr || this->info == nullptr || this->heap == nullptr)
+            {
+                SRL::Debug::Assert("Not enough memory for path finder grid (%dx%d)", width, height);
+            }
+
+            for (size_t tile = 0; tile < tiles; tile++)
+            {
+                this->info[tile] = 0;
+            }
+
+            for (size_t byte = 0; byte < ((tiles + 7) >> 3); byte++)
+            {
+                this->passable[byte] = 0xff;
+            }
+
+            for (size_t entry = 0; entry < SRL_PATH_CACHE_SIZE; entry++)
+            {
+                this->cache[entry].Length = 0;
+            }
+        }
+
+        /** @brief Disable copying
+         */
+        PathFinder(const PathFinder&) = delete;
+
+        /** @brief Disable copying
+         */
+        PathFinder& operator=(const PathFinder&) = delete;
+
+        /** @brief Destroy path finder
+         */
+        ~PathFinder()
+        {
+            Memory::Free(this->passable);
+            Memory::Free(this->cost);
+            Memory::Free(this->heapIndex);
+            Memory::Free(this->info);
+            Memory::Free(this->heap);
+
+            if (this->links != nullptr)
+            {
+                Memory::Free(this->links);
+                Memory::Free(this->corridor);
+                Memory::Free(this->route);
+            }
+        }
+
+        /** @brief Set whether tile can be walked on
+         * @note Forgets remembered paths
+         * @param coord Tile coordinates
+         * @param isPassable True if tile can be walked on
+         */
+        void SetPassable(const Coord& coord, const bool isPassable)
+        {
+            if (coord.X >= this->width || coord.Y >= this->height)
+            {
+                return;
+            }
+
+            const uint16_t tile = this->GetIndex(coord);
+
+            if (isPassable)
+            {
+                this->passable[tile >> 3] |= 1 << (tile & 7);
+            }
+            else
+            {
+                this->passable[tile >> 3] &= ~(1 << (tile & 7));
+            }
+
+            this->linksDirty = true;
+            this->ClearCache();
+        }
+
+        /** @brief Check whether tile can be walked on
+         * @param coord Tile coordinates
+         * @return True if tile is inside of the grid and can be walked on
+         */
+        bool IsPassable(const Coord& coord) const
+        {
+            return coord.X < this->width && coord.Y < this->height && this->IsPassableIndex(this->GetIndex(coord));
+        }
+
+        /** @brief Set passability of all tiles from tilemap data
+         * @note Map data is expected to be stored row by row, grid size is clamped to the map size
+         * @tparam Predicate Callable taking pattern name data (uint32_t) and returning true for passable tiles
+         * @param map Tilemap
+         * @param isPassable Predicate
+         */
+        template <typename Predicate>
+        void SetFromMap(ITilemap& map, Predicate isPassable)
+        {
+            const TilemapInfo mapInfo = map.GetInfo();
+            const uint16_t* words = reinterpret_cast<const uint16_t*>(map.GetMapData());
+            const bool twoWords = mapInfo.MapMode == PNB_2WORD;
+
+            for (uint16_t y = 0; words != nullptr && y < Math::Min<uint16_t>(this->height, mapInfo.MapHeight); y++)
+            {
+                for (uint16_t x = 0; x < Math::Min<uint16_t>(this->width, mapInfo.MapWidth); x++)
+                {
+                    const size_t cell = (y * mapInfo.MapWidth) + x;
+                    const uint32_t data = twoWords ? ((static_cast<uint32_t>(words[cell << 1]) << 16) | words[(cell << 1) + 1]) : words[cell];
+                    const uint16_t tile = (y * this->width) + x;
+
+                    if (isPassable(data))
+                    {
+                        this->passable[tile >> 3] |= 1 << (tile & 7);
+                    }
+                    else
+                    {
+                        this->passable[tile >> 3] &= ~(1 << (tile & 7));
+                    }
+                }
+            }
+
+            this->linksDirty = true;
+            this->ClearCache();
+        }
+
+        /** @brief Set whether diagonal moves are allowed
+         * @note Diagonal moves never cut corners of impassable tiles
+         * @param allowed True to allow diagonal moves
+         */
+        void SetDiagonal(const bool allowed)
+        {
+            this->diagonal = allowed;
+            this->ClearCache();
+        }
+
+        /** @brief Enable search over clusters first
+         * @details Useful for large open maps, found paths might be slightly longer than the shortest ones
+         * @param size Cluster size in tiles, zero disables hierarchy
+         * @param zone Memory zone to allocate cluster data in
+         */
+        void SetHierarchy(const uint8_t size, const Memory::Zone zone = Memory::Zone::HWRam)
+        {
+            if (this->links != nullptr)
+            {
+                Memory::Free(this->links);
+                Memory::Free(this->corridor);
+                Memory::Free(this->route);
+                this->links = nullptr;
+                this->corridor = nullptr;
+                this->route = nullptr;
+            }
+
+            this->clusterSize = size;
+            this->ClearCache();
+
+            if (size == 0)
+            {
+                return;
+            }
+
+            this->clustersX = (this->width + size - 1) / size;
+            this->clustersY = (this->height + size - 1) / size;
+
+            const size_t clusters = this->clustersX * this->clustersY;
+            this->links = reinterpret_cast<uint8_t*>(Memory::Malloc(clusters, zone));
+            this->corridor = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * clusters, zone));
+            this->route = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * clusters * 2, zone));
+            this->linksDirty = true;
+
+            if (this->links == nullptr || this->corridor == nullptr || this->route == nullptr)
+            {
+                SRL::Debug::Assert("Not enough memory for %d path finder clusters", clusters);
+            }
+
+            for (size_t cluster = 0; cluster < clusters; cluster++)
+            {
+                this->corridor[cluster] = 0;
+            }
+        }
+
+        /** @brief Forget remembered paths
+         */
+        void ClearCache()
+        {
+            for (size_t entry = 0; entry < SRL_PATH_CACHE_SIZE; entry++)
+            {
+                this->cache[entry].Length = 0;
+            }
+
+            this->cachedResult = -1;
+        }
+
+        /** @brief Start new search
+         * @note Previous search is abandoned
+         * @param start Start tile
+         * @param goal Goal tile
+         * @return Search status, SRL::Tilemap::PathFinder::Status::Found when path was remembered
+         */
+        Status Start(const Coord& start, const Coord& goal)
+        {
+            this->statistics.Expanded = 0;
+            this->statistics.Steps = 0;
+            this->cachedResult = -1;
+
+            if (!this->IsPassable(start) || !this->IsPassable(goal))
+            {
+                this->status = Status::NotFound;
+                return this->status;
+            }
+
+            this->startTile = this->GetIndex(start);
+            this->goalTile = this->GetIndex(goal);
+
+            for (size_t entry = 0; entry < SRL_PATH_CACHE_SIZE; entry++)
+            {
+                if (this->cache[entry].Length > 0 && this->cache[entry].Start == this->startTile && this->cache[entry].Goal == this->goalTile)
+                {
+                    this->statistics.CacheHits++;
+                    this->cachedResult = entry;
+                    this->status = Status::Found;
+                    return this->status;
+                }
+            }
+
+            this->useCorridor = false;
+            this->Restart();
+
+            if (this->clusterSize > 0)
+            {
+                if (!this->FindCorridor())
+                {
+                    // Clusters are not connected, so neither are the tiles
+                    this->status = Status::NotFound;
+                    return this->status;
+                }
+
+                this->useCorridor = true;
+            }
+
+            this->status = Status::Searching;
+            return this->status;
+        }
+
+        /** @brief Continue search
+         * @param budget Maximal number of tiles to expand
+         * @return Search status
+         */
+        Status Step(const size_t budget = 256)
+        {
+            if (this->status != Status::Searching)
+            {
+                return this->status;
+            }
+
+            this->statistics.Steps++;
+            const uint8_t directions = this->diagonal ? 8 : 4;
+
+            for (size_t expanded = 0; expanded < budget; expanded++)
+            {
+                if (this->heapCount == 0)
+                {
+                    if (this->useCorridor)
+                    {
+                        // Route through clusters does not work inside of them, search whole map
+                        this->useCorridor = false;
+                        this->statistics.Fallbacks++;
+                        this->Restart();
+                        continue;
+                    }
+
+                    this->status = Status::NotFound;
+                    return this->status;
+                }
+
+                const uint16_t tile = this->heap[0].Tile;
+                this->heap[0] = this->heap[--this->heapCount];
+
+                if (this->heapCount > 0)
+                {
+                    this->SiftDown(0);
+                }
+
+                this->info[tile] |= PathFinder::ClosedFlag;
+                this->statistics.Expanded++;
+
+                if (tile == this->goalTile)
+                {
+                    this->status = Status::Found;
+                    this->Remember();
+                    return this->status;
+                }
+
+                const int32_t x = tile % this->width;
+                const int32_t y = tile / this->width;
+
+                for (uint8_t direction = 0; direction < directions; direction++)
+                {
+                    const int32_t nextX = x + PathFinder::OffsetX[direction];
+                    const int32_t nextY = y + PathFinder::OffsetY[direction];
+
+                    if (!this->CanEnter(nextX, nextY))
+                    {
+                        continue;
+                    }
+
+                    // Diagonal move needs both straight neighbors free
+                    if (direction >= 4 && (!this->CanEnter(nextX, y) || !this->CanEnter(x, nextY)))
+                    {
+                        continue;
+                    }
+
+                    const uint16_t next = (nextY * this->width) + nextX;
+                    const int32_t nextCost = this->cost[tile] + (direction >= 4 ? PathFinder::DiagonalCost : PathFinder::StraightCost);
+
+                    if (nextCost < 0xffff)
+                    {
+                        this->Open(next, nextCost, direction);
+                    }
+                }
+            }
+
+            return this->status;
+        }
+
+        /** @brief Run search until it finishes
+         * @param start Start tile
+         * @param goal Goal tile
+         * @return Search status
+         */
+        Status Find(const Coord& start, const Coord& goal)
+        {
+            this->Start(start, goal);
+
+            while (this->status == Status::Searching)
+            {
+                this->Step(this->width * this->height);
+            }
+
+            return this->status;
+        }
+
+        /** @brief Get current search status
+         * @return Search status
+         */
+        Status GetStatus() const
+        {
+            return this->status;
+        }
+
+        /** @brief Get found path
+         * @param path Path tiles from start to goal
+         * @param capacity Size of the path array
+         * @return Number of tiles in the path (can be more than capacity), zero if path was not found
+         */
+        size_t GetPath(Coord* path, const size_t capacity) const
+        {
+            if (this->status != Status::Found)
+            {
+                return 0;
+            }
+
+            if (this->cachedResult >= 0)
+            {
+                const CacheEntry& entry = this->cache[this->cachedResult];
+
+                for (size_t position = 0; position < Math::Min<size_t>(entry.Length, capacity); position++)
+                {
+                    path[position] = Coord(entry.Path[position] % this->width, entry.Path[position] / this->width);
+                }
+
+                return entry.Length;
+            }
+
+            size_t length = 1;
+
+            for (uint16_t tile = this->goalTile; tile != this->startTile; length++)
+            {
+                tile = this->GetParent(tile);
+            }
+
+            uint16_t tile = this->goalTile;
+
+            for (size_t position = length; position > 0; position--)
+            {
+                if (position <= capacity)
+                {
+                    path[position - 1] = Coord(tile % this->width, tile / this->width);
+                }
+
+                tile = this->GetParent(tile);
+            }
+
+            return length;
+        }
+
+        /** @brief Get search statistics
+         * @return Statistics
+         */
+        const Statistics& GetStatistics() const
+        {
+            return this->statistics;
+        }
+    };
+}
@@ -0,0 +1,1032 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_mesh.hpp"
+#include "srl_scudsp.hpp"
+#include "srl_slave.hpp"
+#include "srl_tv.hpp"
+#include "srl_vdp1.hpp"
+
+namespace SRL
+{
+    /** @brief 3D renderer that does not use SGL polygon pipeline
+     * @details Alternative to SRL::Scene3D::DrawMesh() with limits chosen at runtime. Vertices of each mesh are transformed by the current
+     * SRL::Scene3D matrix and projected on both CPUs, faces are culled, clipped against the near plane, and turned into VDP1 commands
+     * right away. At the end of the frame commands are sorted back to front with a radix sort over 16 bit depth keys (ordering table with
+     * 65536 slots) and written to one of two command tables allocated in VDP1 memory.
+     *
+     * SGL still owns the VDP1 command list, renderer submits a single command to it that calls the renderer's table.
+     * Whole scene drawn by the renderer therefore sits at one depth among polygons and sprites drawn through SGL.
+     *
+     * Perspective follows SRL::Scene3D::SetPerspective(). Flat light is computed by the renderer itself from faces with
+     * SRL::Types::Attribute::DisplayOption::EnableFlatLight, other SGL options (depth shading, SGL gouraud light) are ignored,
+     * gouraud table entries of faces are used as they are.
+     *
+     * Renderer can be limited to a viewport with its own projection center, which together with SRL::Renderer3D::Draw() overloads
+     * taking a matrix and SRL::Renderer3D::Finish() allows drawing split screen views on both CPUs, see SRL::SplitScreen.
+     * @code {.cpp}
+     * // Up to 2000 vertices per mesh and 3000 VDP1 commands per frame
+     * SRL::Renderer3D renderer(2000, 3000);
+     * renderer.SetDirectionalLight(Vector3D(0.0, 1.0, 0.0), 0);
+     *
+     * // Each frame
+     * renderer.Begin();
+     * SRL::Scene3D::LoadIdentity();
+     * SRL::Scene3D::LookAt(camera, target, 0);
+     * renderer.Draw(*teapot.GetMesh<SRL::Types::Mesh>(0));
+     * renderer.End();
+     * SRL::Core::Synchronize();
+     * @endcode
+     */
+    class Renderer3D
+    {
+    public:
+
+        /** @brief Rendering statistics of the last frame
+         */
+        struct Statistics
+        {
+            /** @brief Number of faces passed to the renderer
+             */
+            uint16_t Faces;
+
+            /** @brief Number of VDP1 commands written
+             */
+            uint16_t Commands;
+
+            /** @brief Number of faces culled (back facing, behind camera, past far plane or off screen)
+             */
+            uint16_t Culled;
+
+            /** @brief Number of faces clipped by the near plane
+             */
+            uint16_t Clipped;
+
+            /** @brief Number of faces dropped because command buffer was full
+             */
+            uint16_t Dropped;
+        };
+
+        /** @brief Largest screen coordinate written to VDP1 command, projected points further away are clamped
+         */
+        static constexpr int32_t CoordinateLimit = 2047;
+
+        /** @brief Number of gouraud table entries used by flat light
+         */
+        static constexpr uint16_t LightLevels = 32;
+
+    private:
+
+        /** @brief Projected vertex
+         */
+        struct ScreenPoint
+        {
+            /** @brief Screen X coordinate
+             */
+            int16_t X;
+
+            /** @brief Screen Y coordinate
+             */
+            int16_t Y;
+        };
+
+        /** @brief Part of mesh vertices transformed on slave CPU
+         */
+        class VertexTask : public Types::ITask
+        {
+        public:
+
+            /** @brief Renderer to transform vertices for
+             */
+            Renderer3D* Renderer;
+
+            /** @brief Mesh vertices
+             */
+            const Math::Types::Vector3D* Source;
+
+            /** @brief Number of vertices
+             */
+            size_t Count;
+
+        protected:
+
+            /** @brief Transform vertices on slave
+             */
+            void Do() override
+            {
+                // Matrix and mesh might have changed since slave last looked at them
+                slCashPurge();
+                this->Renderer->TransformVertices(this->Source, 0, this->Count);
+            }
+        };
+
+        /** @brief Vertices in view space
+         */
+        Math::Types::Vector3D* viewVertices;
+
+        /** @brief Projected vertices
+         */
+        ScreenPoint* screenVertices;
+
+        /** @brief Commands in the order they were drawn
+         */
+        SPRITE* commands;
+
+        /** @brief Depth key of each command (0 is the farthest)
+         */
+        uint16_t* keys;
+
+        /** @brief Command order
+         */
+        uint16_t* order;
+
+        /** @brief Command order during sorting
+         */
+        uint16_t* sortBuffer;
+
+        /** @brief Command tables in VDP1 memory, one is drawn while the other one is written
+         */
+        SPRITE* tables[2];
+
+        /** @brief Table written by next SRL::Renderer3D::End()
+         */
+        uint8_t currentTable;
+
+        /** @brief Maximal number of vertices per mesh
+         */
+        size_t maxVertices;
+
+        /** @brief Maximal number of commands per frame
+         */
+        size_t maxCommands;
+
+        /** @brief Number of commands drawn this frame
+         */
+        size_t commandCount;
+
+        /** @brief Transformation matrix of the current mesh
+         */
+        FIXED matrix[4][3];
+
+        /** @brief Near plane distance
+         */
+        Math::Types::Fxp nearPlane;
+
+        /** @brief Far plane distance
+         */
+        Math::Types::Fxp farPlane;
+
+        /** @brief Multiplier converting distance from near plane to depth key
+         */
+        uint32_t depthScale;
+
+        /** @brief Share of vertices transformed by slave CPU (0-256)
+         */
+        uint16_t slaveShare;
+
+        /** @brief Light direction in view space
+         */
+        Math::Types::Vector3D lightDirection;
+
+        /** @brief Gouraud table entry of the darkest light level
+         */
+        uint16_t lightEntry;
+
+        /** @brief Is flat light enabled
+         */
+        bool hasLight;
+
+        /** @brief Focal length in pixels as raw value, 0 follows SRL::Scene3D::SetPerspective()
+         */
+        int32_t focalLength;
+
+        /** @brief Screen area drawn to (left, top, right, bottom) relative to screen center
+         */
+        int16_t bounds[4];
+
+        /** @brief Projection center relative to screen center
+         */
+        ScreenPoint center;
+
+        /** @brief Is drawing limited to a viewport
+         */
+        bool hasViewport;
+
+        /** @brief Were commands of this frame already written to the command table
+         */
+        bool isFinished;
+
+        /** @brief Statistics of current frame
+         */
+        Renderer3D::Statistics statistics;
+
+        /** @brief Statistics of last finished frame
+         */
+        Renderer3D::Statistics lastStatistics;
+
+        /** @brief Vertex transformation running on slave CPU
+         */
+        Renderer3D::VertexTask task;
+
+        /** @brief Transform and project vertices
+         * @param source Mesh vertices
+         * @param start First vertex
+         * @param count Number of vertices
+         */
+        void TransformVertices(const Math::Types::Vector3D* source, const size_t start, const size_t count)
+        {
+            ScuDsp::PointTransform::TransformOnCpu(this->matrix, source + start, this->viewVertices + start, count);
+
+            for (size_t vertex = start; vertex < start + count; vertex++)
+            {
+                this->screenVertices[vertex] = this->Project(this->viewVertices[vertex]);
+            }
+        }
+
+        /** @brief Project point in view space onto the screen
+         * @param point Point in front of near plane
+         * @return Screen coordinates
+         */
+        ScreenPoint Project(const Math::Types::Vector3D& point) const
+        {
+            if (point.Z < this->nearPlane)
+            {
+                return ScreenPoint { 0, 0 };
+            }
+
+            const int64_t scale = (Math::Types::Fxp::BuildRaw(this->focalLength != 0 ? this->focalLength : MsScreenDist) / point.Z).RawValue();
+            const int32_t x = static_cast<int32_t>((point.X.RawValue() * scale) >> 32) + this->center.X;
+            const int32_t y = static_cast<int32_t>((point.Y.RawValue() * scale) >> 32) + this->center.Y;
+
+            return ScreenPoint {
+                static_cast<int16_t>(Math::Clamp<int32_t>(x, -Renderer3D::CoordinateLimit, Renderer3D::CoordinateLimit)),
+                static_cast<int16_t>(Math::Clamp<int32_t>(y, -Renderer3D::CoordinateLimit, Renderer3D::CoordinateLimit)) };
+        }
+
+        /** @brief Rotate vector by the current matrix
+         * @param vector Vector to rotate
+         * @return Rotated vector
+         */
+        Math::Types::Vector3D Rotate(const Math::Types::Vector3D& vector) const
+        {
+            const int64_t x = vector.X.RawValue();
+            const int64_t y = vector.Y.RawValue();
+            const int64_t z = vector.Z.RawValue();
+
+            return Math::Types::Vector3D(
+                Math::Types::Fxp::BuildRaw(static_cast<int32_t>(((x * this->matrix[0][0]) + (y * this->matrix[1][0]) + (z * this->matrix[2][0])) >> 16)),
+                Math::Types::Fxp::BuildRaw(static_cast<int32_t>(((x * this->matrix[0][1]) + (y * this->matrix[1][1]) + (z * this->matrix[2][1])) >> 16)),
+                Math::Types::Fxp::BuildRaw(static_cast<int32_t>(((x * this->matrix[0][2]) + (y * this->matrix[1][2]) + (z * this->matrix[2][2])) >> 16)));
+        }
+
+        /** @brief Dot product without overflow
+         * @param a First vector
+         * @param b Second vector
+         * @return Dot product as raw 32.32 value
+         */
+        static int64_t Dot(const Math::Types::Vector3D& a, const Math::Types::Vector3D& b)
+        {
+            return (static_cast<int64_t>(a.X.RawValue()) * b.X.RawValue()) +
+                (static_cast<int64_t>(a.Y.RawValue()) * b.Y.RawValue()) +
+                (static_cast<int64_t>(a.Z.RawValue()) * b.Z.RawValue());
+        }
+
+        /** @brief Get point where edge crosses the near plane
+         * @param a Point in front of near plane
+         * @param b Point behind near plane
+         * @return Point on near plane
+         */
+        Math::Types::Vector3D ClipEdge(const Math::Types::Vector3D& a, const Math::Types::Vector3D& b) const
+        {
+            const int64_t distance = a.Z.RawValue() - this->nearPlane.RawValue();
+            const int64_t length = a.Z.RawValue() - b.Z.RawValue();
+
+            return Math::Types::Vector3D(
+                Math::Types::Fxp::BuildRaw(a.X.RawValue() + static_cast<int32_t>(((b.X.RawValue() - static_cast<int64_t>(a.X.RawValue())) * distance) / length)),
+                Math::Types::Fxp::BuildRaw(a.Y.RawValue() + static_cast<int32_t>(((b.Y.RawValue() - static_cast<int64_t>(a.Y.RawValue())) * distance) / length)),
+                this->nearPlane);
+        }
+
+        /** @brief Convert depth to depth key
+         * @param depth Distance from camera
+         * @return Depth key, 0 is the farthest
+         */
+        uint16_t GetKey(const Math::Types::Fxp& depth) const
+        {
+            const int64_t distance = Math::Clamp<int32_t>(depth.RawValue(), this->nearPlane.RawValue(), this->farPlane.RawValue()) - this->nearPlane.RawValue();
+            return 0xffff - static_cast<uint16_t>(Math::Min<int64_t>(0xffff, (distance * this->depthScale) >> 32));
+        }
+
+        /** @brief Build VDP1 command template of the face
+         * @param attribute Face attribute
+         * @param normal Face normal in view space
+         * @return Command without coordinates
+         */
+        SPRITE GetCommand(const Types::Attribute& attribute, const Math::Types::Vector3D& normal) const
+        {
+            SPRITE command;
+            command.CTRL = attribute.Direction & 0x3f;
+            command.LINK = 0;
+            command.PMOD = attribute.Display;
+            command.COLR = attribute.ColorMode;
+            command.SRCA = 0;
+            command.SIZE = 0;
+            command.GRDA = attribute.Gouraud;
+
+            if (this->hasViewport)
+            {
+                // Enable user clipping, draw inside the clipping area
+                command.PMOD |= 0x0400;
+            }
+
+            if ((attribute.Sort & UseTexture) != 0)
+            {
+                const VDP1::Texture& texture = VDP1::Textures[attribute.Texture];
+                command.SRCA = texture.Address;
+                command.SIZE = texture.Size;
+            }
+
+            if ((attribute.Sort & UseLight) != 0 && this->hasLight)
+            {
+                // Light level from darkest facing away from the light to brightest facing the light
+                const int32_t intensity = -static_cast<int32_t>(Renderer3D::Dot(normal, this->lightDirection) >> 16);
+                const int32_t level = ((Math::Clamp<int32_t>(intensity, -65536, 65536) + 65536) * (Renderer3D::LightLevels - 1)) >> 17;
+                command.PMOD |= CL_Gouraud;
+                command.GRDA = 0xe000 + this->lightEntry + level;
+            }
+
+            return command;
+        }
+
+        /** @brief Add command to the frame
+         * @param command Command with coordinates
+         * @param key Depth key
+         */
+        void AddCommand(const SPRITE& command, const uint16_t key)
+        {
+            if (this->commandCount >= this->maxCommands)
+            {
+                this->statistics.Dropped++;
+                return;
+            }
+
+            this->commands[this->commandCount] = command;
+            this->keys[this->commandCount] = key;
+            this->commandCount++;
+            this->statistics.Commands++;
+        }
+
+        /** @brief Set corners of the command
+         * @param command Command to fill
+         * @param points Four projected corners
+         */
+        static void SetCorners(SPRITE& command, const ScreenPoint points[4])
+        {
+            command.XA = points[0].X;
+            command.YA = points[0].Y;
+            command.XB = points[1].X;
+            command.YB = points[1].Y;
+            command.XC = points[2].X;
+            command.YC = points[2].Y;
+            command.XD = points[3].X;
+            command.YD = points[3].Y;
+        }
+
+        /** @brief Draw face crossing the near plane
+         * @param command Command template
+         * @param corners Face corners in view space
+         * @param cornerCount Number of corners (3 or 4)
+         * @param exact Clip exactly, otherwise corners behind the plane are moved onto it to keep texture and gouraud mapping
+         * @param key Depth key
+         */
+        void DrawClipped(SPRITE& command, const Math::Types::Vector3D* corners, const size_t cornerCount, const bool exact, const uint16_t key)
+        {
+            ScreenPoint points[5];
+
+            if (exact)
+            {
+                // Sutherland-Hodgman against near plane, quad can become pentagon
+                size_t count = 0;
+
+                for (size_t corner = 0; corner < cornerCount; corner++)
+                {
+                    const Math::Types::Vector3D& current = corners[corner];
+                    const Math::Types::Vector3D& next = corners[(corner + 1) % cornerCount];
+                    const bool isFront = current.Z >= this->nearPlane;
+
+                    if (isFront)
+                    {
+                        points[count++] = this->Project(current);
+                    }
+
+                    if (isFront != (next.Z >= this->nearPlane))
+                    {
+                        points[count++] = this->Project(isFront ? this->ClipEdge(current, next) : this->ClipEdge(next, current));
+                    }
+                }
+
+                const ScreenPoint first[4] = { points[0], points[1], points[2], points[count > 3 ? 3 : 2] };
+                Renderer3D::SetCorners(command, first);
+                this->AddCommand(command, key);
+
+                if (count > 4)
+                {
+                    const ScreenPoint second[4] = { points[0], points[3], points[4], points[4] };
+                    Renderer3D::SetCorners(command, second);
+                    this->AddCommand(command, key);
+                }
+
+                return;
+            }
+
+            // Slide each corner behind the plane along an edge towards a corner in front of it
+            for (size_t corner = 0; corner < cornerCount; corner++)
+            {
+                const Math::Types::Vector3D& current = corners[corner];
+
+                if (current.Z >= this->nearPlane)
+                {
+                    points[corner] = this->Project(current);
+                    continue;
+                }
+
+                const Math::Types::Vector3D& previous = corners[(corner + cornerCount - 1) % cornerCount];
+                const Math::Types::Vector3D& next = corners[(corner + 1) % cornerCount];
+                const Math::Types::Vector3D& opposite = corners[(corner + 2) % cornerCount];
+                const Math::Types::Vector3D& target = previous.Z >= this->nearPlane ? previous : (next.Z >= this->nearPlane ? next : opposite);
+                points[corner] = this->Project(this->ClipEdge(target, current));
+            }
+
+            if (cornerCount == 3)
+            {
+                points[3] = points[2];
+            }
+
+            Renderer3D::SetCorners(command, points);
+            this->AddCommand(command, key);
+        }
+
+        /** @brief Draw faces of transformed mesh
+         * @param faces Mesh faces
+         * @param attributes Face attributes
+         * @param faceCount Number of faces
+         */
+        void DrawFaces(const Types::Polygon* faces, const Types::Attribute* attributes, const size_t faceCount)
+        {
+            uint16_t lastKey = 0;
+
+            for (size_t face = 0; face < faceCount; face++)
+            {
+                const Types::Polygon& polygon = faces[face];
+                const Types::Attribute& attribute = attributes[face];
+                const size_t cornerCount = polygon.Vertices[3] == polygon.Vertices[2] ? 3 : 4;
+                Math::Types::Vector3D corners[4];
+                int32_t nearest = INT32_MAX;
+                int32_t farthest = INT32_MIN;
+                int64_t sum = 0;
+
+                this->statistics.Faces++;
+
+                for (size_t corner = 0; corner < 4; corner++)
+                {
+                    corners[corner] = this->viewVertices[polygon.Vertices[corner]];
+                }
+
+                for (size_t corner = 0; corner < cornerCount; corner++)
+                {
+                    const int32_t depth = corners[corner].Z.RawValue();
+                    nearest = Math::Min<int32_t>(nearest, depth);
+                    farthest = Math::Max<int32_t>(farthest, depth);
+                    sum += depth;
+                }
+
+                if (farthest < this->nearPlane.RawValue() || nearest > this->farPlane.RawValue())
+                {
+                    this->statistics.Culled++;
+                    continue;
+                }
+
+                const Math::Types::Vector3D normal = this->Rotate(polygon.Normal);
+
+                // Face normal must point towards camera at the origin of view space
+                if (attribute.Visibility == Types::Attribute::FaceVisibility::SingleSided && Renderer3D::Dot(normal, corners[0]) >= 0)
+                {
+                    this->statistics.Culled++;
+                    continue;
+                }
+
+                uint16_t key;
+
+                switch (attribute.Sort & 0x3)
+                {
+                case SORT_MIN:
+                    key = this->GetKey(Math::Types::Fxp::BuildRaw(nearest));
+                    break;
+
+                case SORT_MAX:
+                    key = this->GetKey(Math::Types::Fxp::BuildRaw(farthest));
+                    break;
+
+                case SORT_CEN:
+                    key = this->GetKey(Math::Types::Fxp::BuildRaw(static_cast<int32_t>(sum / static_cast<int32_t>(cornerCount))));
+                    break;
+
+                default:
+                    // Draw just before the previous face
+                    key = lastKey > 0 ? lastKey - 1 : 0;
+                    break;
+                }
+
+                lastKey = key;
+                SPRITE command = this->GetCommand(attribute, normal);
+
+                if (nearest < this->nearPlane.RawValue())
+                {
+                    // Exact clipping changes number of corners, which only untextured faces without gouraud table can afford
+                    const bool exact = (attribute.Sort & UseTexture) == 0 && (command.PMOD & CL_Gouraud) == 0;
+                    this->statistics.Clipped++;
+                    this->DrawClipped(command, corners, cornerCount, exact, key);
+                    continue;
+                }
+
+                const ScreenPoint points[4] = {
+                    this->screenVertices[polygon.Vertices[0]],
+                    this->screenVertices[polygon.Vertices[1]],
+                    this->screenVertices[polygon.Vertices[2]],
+                    this->screenVertices[polygon.Vertices[3]] };
+
+                int32_t left = INT32_MAX;
+                int32_t right = INT32_MIN;
+                int32_t top = INT32_MAX;
+                int32_t bottom = INT32_MIN;
+
+                for (size_t corner = 0; corner < 4; corner++)
+                {
+                    left = Math::Min<int32_t>(left, points[corner].X);
+                    right = Math::Max<int32_t>(right, points[corner].X);
+                    top = Math::Min<int32_t>(top, points[corner].Y);
+                    bottom = Math::Max<int32_t>(bottom, points[corner].Y);
+                }
+
+                if (right < this->bounds[0] || left > this->bounds[2] || bottom < this->bounds[1] || top > this->bounds[3])
+                {
+                    this->statistics.Culled++;
+                    continue;
+                }
+
+                Renderer3D::SetCorners(command, points);
+                this->AddCommand(command, key);
+            }
+        }
+
+        /** @brief Sort commands back to front
+         * @details Least significant digit radix sort with 8 bit digits, it is stable so commands with same key stay in the order they were drawn
+         */
+        void Sort()
+        {
+            uint16_t* source = this->order;
+            uint16_t* destination = this->sortBuffer;
+
+            for (size_t command = 0; command < this->commandCount; command++)
+            {
+                source[command] = command;
+            }
+
+            for (uint8_t shift = 0; shift < 16; shift += 8)
+            {
+                uint16_t buckets[256] = { 0 };
+
+                for (size_t command = 0; command < this->commandCount; command++)
+                {
+                    buckets[(this->keys[command] >> shift) & 0xff]++;
+                }
+
+                uint16_t offset = 0;
+
+                for (size_t bucket = 0; bucket < 256; bucket++)
+                {
+                    const uint16_t count = buckets[bucket];
+                    buckets[bucket] = offset;
+                    offset += count;
+                }
+
+                for (size_t command = 0; command < this->commandCount; command++)
+                {
+                    const uint16_t index = source[command];
+                    destination[buckets[(this->keys[index] >> shift) & 0xff]++] = index;
+                }
+
+                uint16_t* swap = source;
+                source = destination;
+                destination = swap;
+            }
+
+            // Even number of passes, result ends in order buffer
+        }
+
+    public:
+
+        /** @brief Construct renderer
+         * @param maxVertices Maximal number of vertices of a single mesh
+         * @param maxCommands Maximal number of VDP1 commands per frame (two command tables of this size are allocated in VDP1 memory)
+         * @param zone Memory zone to allocate work buffers in
+         */
+        Renderer3D(const size_t maxVertices, const size_t maxCommands, const Memory::Zone zone = Memory::Zone::HWRam) :
+            tables { nullptr, nullptr },
+            currentTable(0),
+            maxVertices(maxVertices),
+            maxCommands(Math::Min<size_t>(maxCommands, 0xfffc)),
+            commandCount(0),
+            nearPlane(1.0),
+            farPlane(4000.0),
+            depthScale(0),
+            slaveShare(128),
+            lightDirection(),
+            lightEntry(0),
+            hasLight(false),
+            focalLength(0),
+            bounds { static_cast<int16_t>(-(TV::Width >> 1)), static_cast<int16_t>(-(TV::Height >> 1)), static_cast<int16_t>(TV::Width >> 1), static_cast<int16_t>(TV::Height >> 1) },
+            center { 0, 0 },
+            hasViewport(false),
+            isFinished(false),
+            statistics { 0, 0, 0, 0, 0 },
+            lastStatistics { 0, 0, 0, 0, 0 }
+        {
+            this->viewVertices = reinterpret_cast<Math::Types::Vector3D*>(Memory::Malloc(sizeof(Math::Types::Vector3D) * Math::Max<size_t>(1, maxVertices), zone));
+            this->screenVertices = reinterpret_cast<ScreenPoint*>(Memory::Malloc(sizeof(ScreenPoint) * Math::Max<size_t>(1, maxVertices), zone));
+            this->commands = reinterpret_cast<SPRITE*>(Memory::Malloc(sizeof(SPRITE) * Math::Max<size_t>(1, this->maxCommands), zone));
+            this->keys = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * Math::Max<size_t>(1, this->maxCommands), zone));
+            this->order = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * Math::Max<size_t>(1, this->maxCommands), zone));
+            this->sortBuffer = reinterpret_cast<uint16_t*>(Memory::Malloc(sizeof(uint16_t) * Math::Max<size_t>(1, this->maxCommands), zone));
+            this->task.Renderer = this;
+            this->SetDepthRange(this->nearPlane, this->farPlane);
+
+            // Command tables are allocated as 16 pixel wide RGB555 textures, one 32 byte command per row,
+            // two rows set and restore user clipping of a viewport, last row ends the table
+            for (size_t table = 0; table < 2; table++)
+            {
+                const int32_t texture = VDP1::TryAllocateTexture(16, static_cast<uint16_t>(this->maxCommands + 3), CRAM::TextureColorMode::RGB555, 0);
+
+                if (texture < 0)
+                {
+                    SRL::Debug::Assert("Not enough VDP1 memory for %d commands", this->maxCommands);
+                    this->maxCommands = 0;
+                    break;
+                }
+
+                this->tables[table] = reinterpret_cast<SPRITE*>(VDP1::Textures[texture].GetData());
+            }
+        }
+
+        /** @brief Disable copying
+         */
+        Renderer3D(const Renderer3D&) = delete;
+
+        /** @brief Disable copying
+         */
+        Renderer3D& operator=(const Renderer3D&) = delete;
+
+        /** @brief Destroy renderer
+         * @note Command tables stay allocated in VDP1 memory until texture heap is reset
+         */
+        ~Renderer3D()
+        {
+            Memory::Free(this->viewVertices);
+            Memory::Free(this->screenVertices);
+            Memory::Free(this->commands);
+            Memory::Free(this->keys);
+            Memory::Free(this->order);
+            Memory::Free(this->sortBuffer);
+        }
+
+        /** @brief Set distance of near and far planes
+         * @details Faces crossing the near plane are clipped, faces past far plane are culled.
+         * Depth keys are spread over the range, keeping it tight improves sorting precision.
+         * @param nearPlane Near plane distance (must be greater than 0)
+         * @param farPlane Far plane distance
+         */
+        void SetDepthRange(const Math::Types::Fxp& nearPlane, const Math::Types::Fxp& farPlane)
+        {
+            this->nearPlane = Math::Max<Math::Types::Fxp>(nearPlane, Math::Types::Fxp::BuildRaw(1));
+            this->farPlane = Math::Max<Math::Types::Fxp>(farPlane, this->nearPlane + Math::Types::Fxp::BuildRaw(1));
+            this->depthScale = static_cast<uint32_t>((static_cast<uint64_t>(0xffff) << 32) / static_cast<uint32_t>(this->farPlane.RawValue() - this->nearPlane.RawValue()));
+        }
+
+        /** @brief Set how vertices are split between CPUs
+         * @param slaveShare Share of vertices transformed by the slave CPU (0-256)
+         */
+        void SetSlaveShare(const uint16_t slaveShare)
+        {
+            this->slaveShare = Math::Min<uint16_t>(slaveShare, 256);
+        }
+
+        /** @brief Limit drawing to part of the screen
+         * @details Projection is centered in the viewport and VDP1 user clipping keeps commands inside of it.
+         * Command table then starts with user clipping command, and user clipping is set back to the whole screen at its end.
+         * @param left Left edge in screen pixels
+         * @param top Top edge in screen pixels
+         * @param right Right edge in screen pixels (inclusive)
+         * @param bottom Bottom edge in screen pixels (inclusive)
+         */
+        void SetViewport(const int16_t left, const int16_t top, const int16_t right, const int16_t bottom)
+        {
+            const int16_t halfWidth = TV::Width >> 1;
+            const int16_t halfHeight = TV::Height >> 1;
+            this->bounds[0] = left - halfWidth;
+            this->bounds[1] = top - halfHeight;
+            this->bounds[2] = right - halfWidth;
+            this->bounds[3] = bottom - halfHeight;
+            this->center = ScreenPoint {
+                static_cast<int16_t>(((left + right + 1) >> 1) - halfWidth),
+                static_cast<int16_t>(((top + bottom + 1) >> 1) - halfHeight) };
+            this->hasViewport = true;
+        }
+
+        /** @brief Draw to the whole screen again
+         */
+        void ResetViewport()
+        {
+            this->bounds[0] = -(TV::Width >> 1);
+            this->bounds[1] = -(TV::Height >> 1);
+            this->bounds[2] = TV::Width >> 1;
+            this->bounds[3] = TV::Height >> 1;
+            this->center = ScreenPoint { 0, 0 };
+            this->hasViewport = false;
+        }
+
+        /** @brief Set distance of the projection plane
+         * @details Viewport narrower than the screen needs shorter focal length to keep the same field of view
+         * @param focalLength Focal length in pixels, 0 follows SRL::Scene3D::SetPerspective()
+         */
+        void SetFocalLength(const Math::Types::Fxp& focalLength)
+        {
+            this->focalLength = focalLength.RawValue();
+        }
+
+        /** @brief Enable flat light on faces with SRL::Types::Attribute::DisplayOption::EnableFlatLight
+         * @details Direction is transformed by the current matrix, same as SRL::Scene3D::SetDirectionalLight().
+         * Light levels are written to gouraud table, darkest face uses the first entry.
+         * @param direction Direction the light travels in (unit vector)
+         * @param firstEntry First of SRL::Renderer3D::LightLevels gouraud table entries used by light levels
+         */
+        void SetDirectionalLight(const Math::Types::Vector3D& direction, const uint16_t firstEntry)
+        {
+            FIXED current[4][3];
+            slGetMatrix(current);
+            this->SetDirectionalLight(direction, firstEntry, current);
+        }
+
+        /** @brief Enable flat light on faces with SRL::Types::Attribute::DisplayOption::EnableFlatLight
+         * @details Light levels are written to gouraud table, darkest face uses the first entry.
+         * @param direction Direction the light travels in (unit vector)
+         * @param firstEntry First of SRL::Renderer3D::LightLevels gouraud table entries used by light levels
+         * @param matrix Matrix transforming the direction into view space
+         */
+        void SetDirectionalLight(const Math::Types::Vector3D& direction, const uint16_t firstEntry, const FIXED matrix[4][3])
+        {
+            memcpy(this->matrix, matrix, sizeof(this->matrix));
+            this->lightDirection = this->Rotate(direction);
+            this->lightEntry = firstEntry;
+            this->hasLight = true;
+
+            Types::HighColor* table = VDP1::GetGouraudTable() + (firstEntry << 2);
+
+            for (uint16_t level = 0; level < Renderer3D::LightLevels; level++)
+            {
+                for (size_t corner = 0; corner < 4; corner++)
+                {
+                    table[(level << 2) + corner] = Types::HighColor::FromRGB555(level, level, level);
+                }
+            }
+        }
+
+        /** @brief Disable flat light
+         */
+        void DisableLight()
+        {
+            this->hasLight = false;
+        }
+
+        /** @brief Start new frame
+         */
+        void Begin()
+        {
+            this->commandCount = 0;
+            this->isFinished = false;
+            this->statistics = Renderer3D::Statistics { 0, 0, 0, 0, 0 };
+        }
+
+        /** @brief Draw mesh with current transformation matrix
+         * @param mesh Mesh to draw
+         * @return True on success, false if mesh has too many vertices
+         */
+        bool Draw(const Types::Mesh& mesh)
+        {
+            if (!this->TransformMesh(mesh.Vertices, mesh.VertexCount))
+            {
+                return false;
+            }
+
+            this->DrawFaces(mesh.Faces, mesh.Attributes, mesh.FaceCount);
+            return true;
+        }
+
+        /** @brief Draw mesh with given transformation matrix
+         * @note Does not touch SGL matrix stack, can be called from slave CPU
+         * @param mesh Mesh to draw
+         * @param matrix Matrix transforming mesh into view space
+         * @return True on success, false if mesh has too many vertices
+         */
+        bool Draw(const Types::Mesh& mesh, const FIXED matrix[4][3])
+        {
+            if (!this->TransformMesh(mesh.Vertices, mesh.VertexCount, matrix))
+            {
+                return false;
+            }
+
+            this->DrawFaces(mesh.Faces, mesh.Attributes, mesh.FaceCount);
+            return true;
+        }
+
+        /** @brief Draw mesh with current transformation matrix
+         * @note Vertex normals are not used, faces are shaded by their gouraud table entries
+         * @param mesh Mesh to draw
+         * @return True on success, false if mesh has too many vertices
+         */
+        bool Draw(const Types::SmoothMesh& mesh)
+        {
+            if (!this->TransformMesh(mesh.Vertices, mesh.VertexCount))
+            {
+                return false;
+            }
+
+            this->DrawFaces(mesh.Faces, mesh.Attributes, mesh.FaceCount);
+            return true;
+        }
+
+        /** @brief Draw mesh with given transformation matrix
+         * @note Vertex normals are not used, faces are shaded by their gouraud table entries.
+         * Does not touch SGL matrix stack, can be called from slave CPU
+         * @param mesh Mesh to draw
+         * @param matrix Matrix transforming mesh into view space
+         * @return True on success, false if mesh has too many vertices
+         */
+        bool Draw(const Types::SmoothMesh& mesh, const FIXED matrix[4][3])
+        {
+            if (!this->TransformMesh(mesh.Vertices, mesh.VertexCount, matrix))
+            {
+                return false;
+            }
+
+            this->DrawFaces(mesh.Faces, mesh.Attributes, mesh.FaceCount);
+            return true;
+        }
+
+        /** @brief Transform vertices by current matrix on both CPUs
+         * @param vertices Mesh vertices
+         * @param count Number of vertices
+         * @return True on success, false if there are too many vertices
+         */
+        bool TransformMesh(const Math::Types::Vector3D* vertices, const size_t count)
+        {
+            FIXED current[4][3];
+            slGetMatrix(current);
+            return this->TransformMesh(vertices, count, current);
+        }
+
+        /** @brief Transform vertices by given matrix
+         * @details Slave CPU takes its share of vertices unless it is set to 0 by SRL::Renderer3D::SetSlaveShare()
+         * @param vertices Mesh vertices
+         * @param count Number of vertices
+         * @param matrix Matrix transforming vertices into view space
+         * @return True on success, false if there are too many vertices
+         */
+        bool TransformMesh(const Math::Types::Vector3D* vertices, const size_t count, const FIXED matrix[4][3])
+        {
+            if (count > this->maxVertices)
+            {
+                return false;
+            }
+
+            memcpy(this->matrix, matrix, sizeof(this->matrix));
+            const size_t slaveCount = (count * this->slaveShare) >> 8;
+
+            if (slaveCount > 0)
+            {
+                this->task.Source = vertices;
+                this->task.Count = slaveCount;
+                Slave::ExecuteOnSlave(this->task);
+            }
+
+            this->TransformVertices(vertices, slaveCount, count - slaveCount);
+
+            if (slaveCount > 0)
+            {
+                while (!this->task.IsDone());
+
+                // Drop stale lines of data written by slave
+                slCashPurge();
+            }
+
+            return true;
+        }
+
+        /** @brief Sort commands of this frame and write them to the command table
+         * @details Called by SRL::Renderer3D::End() if it was not called before.
+         * Does not call SGL, so the work can be done on slave CPU while master CPU submits the table later.
+         */
+        void Finish()
+        {
+            if (this->isFinished || this->maxCommands == 0)
+            {
+                return;
+            }
+
+            this->isFinished = true;
+            this->lastStatistics = this->statistics;
+            SPRITE* table = this->tables[this->currentTable];
+            this->currentTable ^= 1;
+            this->Sort();
+
+            if (this->hasViewport)
+            {
+                // User clipping area is in absolute coordinates
+                const int16_t halfWidth = TV::Width >> 1;
+                const int16_t halfHeight = TV::Height >> 1;
+                table->CTRL = 0x0008;
+                table->XA = this->bounds[0] + halfWidth;
+                table->YA = this->bounds[1] + halfHeight;
+                table->XC = this->bounds[2] + halfWidth;
+                table->YC = this->bounds[3] + halfHeight;
+                table++;
+            }
+
+            // Commands are written to VDP1 memory with 32 bit writes
+            uint32_t* destination = reinterpret_cast<uint32_t*>(table);
+
+            for (size_t command = 0; command < this->commandCount; command++)
+            {
+                const uint32_t* source = reinterpret_cast<const uint32_t*>(&this->commands[this->order[command]]);
+
+                for (size_t word = 0; word < sizeof(SPRITE) / sizeof(uint32_t); word++)
+                {
+                    *destination++ = source[word];
+                }
+            }
+
+            if (this->hasViewport)
+            {
+                // Whole screen for commands that follow in SGL command list
+                table[this->commandCount].CTRL = 0x0008;
+                table[this->commandCount].XA = 0;
+                table[this->commandCount].YA = 0;
+                table[this->commandCount].XC = TV::Width - 1;
+                table[this->commandCount].YC = TV::Height - 1;
+                table++;
+            }
+
+            // Skip and return to SGL command list
+            table[this->commandCount].CTRL = 0x7000;
+        }
+
+        /** @brief Sort commands of this frame and submit them to VDP1
+         * @note Must be called on master CPU
+         * @param sort Z order of the whole scene among sprites and polygons drawn by SGL
+         * @return True on success
+         */
+        bool End(const Math::Types::Fxp& sort = 1000.0)
+        {
+            if (this->maxCommands == 0)
+            {
+                this->lastStatistics = this->statistics;
+                return false;
+            }
+
+            this->Finish();
+
+            // Skip and call renderer table
+            SPRITE call;
+            call.CTRL = 0x6000;
+            call.LINK = (reinterpret_cast<uint32_t>(this->tables[this->currentTable ^ 1]) - SpriteVRAM) >> 3;
+            return slSetSprite(&call, sort.RawValue()) != 0;
+        }
+
+        /** @brief Get statistics of the last frame
+         * @return Statistics from the last SRL::Renderer3D::End()
+         */
+        const Renderer3D::Statistics& GetStatistics() const
+        {
+            return this->lastStatistics;
+        }
+
+        /** @brief Get command table written by the last SRL::Renderer3D::End()
+         * @return Commands in drawing order, preceded by user clipping command when viewport is set
+         */
+        const SPRITE* GetCommandTable() const
+        {
+            return this->tables[this->currentTable ^ 1];
+        }
+    };
+}
@@ -0,0 +1,742 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_cd.hpp"
+#include "srl_memory.hpp"
+
+#ifndef SRL_MAX_RESOURCES
+/** @brief Maximal number of resources that can be tracked at once
+ */
+#define SRL_MAX_RESOURCES 64
+#endif
+
+namespace SRL
+{
+    /** @brief Resource cache with reference counting, lazy loading and memory budgets
+     * @details Resources are keyed by CD file, memory zone and loader, acquiring same file twice returns same handle and data is loaded only once.
+     * Same file acquired for another zone or with another loader is a separate resource.
+     * Data is loaded on first access, not when acquired. Released resources stay cached until their memory is needed,
+     * least recently used unreferenced resources are evicted first when a zone goes over its budget or runs out of memory.
+     * @code {.cpp}
+     * SRL::Resources::SetBudget(SRL::Memory::Zone::LWRam, 256 * 1024);
+     *
+     * SRL::Resources::Handle level = SRL::Resources::Acquire("LEVEL1.BIN", SRL::Memory::Zone::LWRam);
+     * uint8_t* data = SRL::Resources::Get<uint8_t>(level);  // Loads file here
+     *
+     * // Data stays cached after release, it is freed only when space is needed
+     * SRL::Resources::Release(level);
+     * @endcode
+     * @note Loading is synchronous. File identifiers are relative to the directory that was current when resource was acquired,
+     * that directory must be current again when the resource is first accessed.
+     */
+    class Resources
+    {
+    public:
+
+        /** @brief Creates resource data from file
+         * @param file File to load from
+         * @param zone Memory zone to load into
+         * @param size Number of bytes used by loaded data
+         * @return Loaded data or nullptr on failure
+         */
+        using Loader = void* (*)(Cd::File* file, Memory::Zone zone, size_t* size);
+
+        /** @brief Destroys resource data created by a loader
+         * @param data Loaded data
+         */
+        using Unloader = void (*)(void* data);
+
+        /** @brief Handle to a resource
+         */
+        struct Handle
+        {
+            /** @brief Resource table slot
+             */
+            uint16_t Slot;
+
+            /** @brief Slot generation, used to detect stale handles
+             */
+            uint16_t Generation;
+
+            /** @brief Construct invalid handle
+             */
+            Handle() : Slot(0xffff), Generation(0) { }
+
+            /** @brief Construct handle
+             * @param slot Resource table slot
+             * @param generation Slot generation
+             */
+            Handle(const uint16_t slot, const uint16_t generation) : Slot(slot), Generation(generation) { }
+
+            /** @brief Check whether handle points to a resource table slot
+             * @return True if handle was returned by successful acquire
+             */
+            constexpr bool IsValid() const
+            {
+                return this->Slot != 0xffff;
+            }
+        };
+
+        /** @brief Resource state
+         */
+        enum class State : uint8_t
+        {
+            /** @brief Resource is not loaded yet (or was evicted)
+             */
+            Unloaded = 0,
+
+            /** @brief Resource data is available
+             */
+            Loaded = 1,
+
+            /** @brief Last attempt to load resource failed
+             */
+            Failed = 2
+        };
+
+        /** @brief Cache statistics
+         */
+        struct Statistics
+        {
+            /** @brief Number of acquires served by already known resource
+             */
+            uint32_t Hits;
+
+            /** @brief Number of acquires that created new resource entry
+             */
+            uint32_t Misses;
+
+            /** @brief Number of loads from CD
+             */
+            uint32_t Loads;
+
+            /** @brief Number of evicted resources
+             */
+            uint32_t Evictions;
+        };
+
+    private:
+
+        /** @brief Number of memory zones
+         */
+        static constexpr size_t ZoneCount = 3;
+
+        /** @brief Resource table entry
+         */
+        struct Entry
+        {
+            /** @brief Loaded data
+             */
+            void* Data;
+
+            /** @brief Size of the loaded data
+             */
+            size_t Size;
+
+            /** @brief Loader used to create data
+             */
+            Resources::Loader Load;
+
+            /** @brief Unloader used to destroy data
+             */
+            Resources::Unloader Unload;
+
+            /** @brief Last time resource was accessed
+             */
+            uint32_t LastUse;
+
+            /** @brief File address on disc, unique key across directories
+             */
+            int32_t Fad;
+
+            /** @brief File identifier in directory it was acquired from
+             */
+            int32_t FileId;
+
+            /** @brief Number of references
+             */
+            uint16_t References;
+
+            /** @brief Slot generation
+             */
+            uint16_t Generation;
+
+            /** @brief Memory zone data is loaded into
+             */
+            Memory::Zone Zone;
+
+            /** @brief Resource state
+             */
+            Resources::State Status;
+
+            /** @brief Slot is in use
+             */
+            bool InUse;
+        };
+
+        /** @brief Resource table
+         */
+        inline static Entry entries[SRL_MAX_RESOURCES] = { };
+
+        /** @brief Memory budget of each zone (0 means no budget)
+         */
+        inline static size_t budgets[Resources::ZoneCount] = { 0, 0, 0 };
+
+        /** @brief Bytes used by loaded resources in each zone
+         */
+        inline static size_t usage[Resources::ZoneCount] = { 0, 0, 0 };
+
+        /** @brief Access counter used for LRU
+         */
+        inline static uint32_t clock = 0;
+
+        /** @brief Cache statistics
+         */
+        inline static Statistics statistics = { 0, 0, 0, 0 };
+
+        /** @brief Default loader, loads whole file as raw bytes
+         * @param file File to load from
+         * @param zone Memory zone to load into
+         * @param size Number of bytes used by loaded data
+         * @return Loaded data or nullptr on failure
+         */
+        static void* LoadRaw(Cd::File* file, Memory::Zone zone, size_t* size)
+        {
+            void* data = Memory::Malloc(file->Size.Bytes, zone);
+
+            if (data != nullptr)
+            {
+                if (file->LoadBytes(0, file->Size.Bytes, data) != file->Size.Bytes)
+                {
+                    Memory::Free(data);
+                    return nullptr;
+                }
+
+                *size = file->Size.Bytes;
+            }
+
+            return data;
+        }
+
+        /** @brief Default unloader, frees raw bytes
+         * @param data Loaded data
+         */
+        static void UnloadRaw(void* data)
+        {
+            Memory::Free(data);
+        }
+
+        /** @brief Get entry pointed to by handle
+         * @param handle Resource handle
+         * @return Entry or nullptr if handle is stale
+         */
+        static Entry* GetEntry(const Handle& handle)
+        {
+            if (handle.Slot < SRL_MAX_RESOURCES)
+            {
+                Entry* entry = &Resources::entries[handle.Slot];
+
+                if (entry->InUse && entry->Generation == handle.Generation)
+                {
+                    return entry;
+                }
+            }
+
+            return nullptr;
+        }
+
+        /** @brief Destroy loaded data of an entry
+         * @param entry Resource entry
+         */
+        static void UnloadEntry(Entry* entry)
+        {
+            if (entry->Status == State::Loaded)
+            {
+                entry->Unload(entry->Data);
+                Resources::usage[static_cast<size_t>(entry->Zone)] -= entry->Size;
+                Resources::statistics.Evictions++;
+            }
+
+            entry->Data = nullptr;
+            entry->Size = 0;
+            entry->Status = State::Unloaded;
+
+            // Nobody holds this entry anymore, slot can be reused
+            if (entry->References == 0)
+            {
+                entry->InUse = false;
+                entry->Generation++;
+            }
+        }
+
+        /** @brief Evict least recently used unreferenced resource from zone
+         * @param zone Memory zone
+         * @return True if anything was evicted
+         */
+        static bool EvictOne(const Memory::Zone zone)
+        {
+            Entry* oldest = nullptr;
+
+            for (Entry& entry : Resources::entries)
+            {
+                if (entry.InUse &&
+                    entry.References == 0 &&
+                    entry.Status == State::Loaded &&
+                    entry.Zone == zone &&
+                    (oldest == nullptr || entry.LastUse < oldest->LastUse))
+                {
+                    oldest = &entry;
+                }
+            }
+
+            if (oldest != nullptr)
+            {
+                Resources::UnloadEntry(oldest);
+                return true;
+            }
+
+            return false;
+        }
+
+        /** @brief Load entry data
+         * @param entry Resource entry
+         * @return True on success
+         */
+        static bool LoadEntry(Entry* entry)
+        {
+            GfsHn handle = GFS_Open(entry->FileId);
+
+            if (handle == nullptr)
+            {
+                entry->Status = State::Failed;
+                return false;
+            }
+
+            Cd::File file(handle, entry->FileId);
+
+            // Make room within budget, size of the file is used as estimate
+            const size_t zone = static_cast<size_t>(entry->Zone);
+
+            while (Resources::budgets[zone] != 0 &&
+                   Resources::usage[zone] + file.Size.Bytes > Resources::budgets[zone] &&
+                   Resources::EvictOne(entry->Zone));
+
+            size_t size = 0;
+            void* data = entry->Load(&file, entry->Zone, &size);
+
+            // Out of memory, evict unreferenced resources and try again
+            while (data == nullptr && Resources::EvictOne(entry->Zone))
+            {
+                data = entry->Load(&file, entry->Zone, &size);
+            }
+
+            if (data == nullptr)
+            {
+                entry->Status = State::Failed;
+                return false;
+            }
+
+            entry->Data = data;
+            entry->Size = size;
+            entry->Status = State::Loaded;
+            Resources::usage[zone] += size;
+            Resources::statistics.Loads++;
+            return true;
+        }
+
+        /** @brief Get address of a file on disc
+         * @param fileId File identifier
+         * @return File address or -1 if file does not exist
+         */
+        static int32_t GetFileAddress(const int32_t fileId)
+        {
+            GfsDirId info;
+
+            if (fileId >= 0 && GFS_GetDirInfo(fileId, &info) >= 0)
+            {
+                return info.dirrec.fad;
+            }
+
+            return -1;
+        }
+
+        /** @brief Disable constructor
+         */
+        Resources() = delete;
+
+        /** @brief Disable destructor
+         */
+        ~Resources() = delete;
+
+    public:
+
+        /** @brief Acquire resource by file identifier
+         * @note File identifier is relative to the current directory, same file acquired from different directories is still one resource
+         * @param fileId File identifier in current directory
+         * @param zone Memory zone to load resource into
+         * @param loader Loader to use (raw file bytes by default)
+         * @param unloader Unloader matching the loader
+         * @return Resource handle, invalid if file does not exist or resource table is full
+         */
+        static Handle Acquire(const int32_t fileId,
+            const Memory::Zone zone = Memory::Zone::HWRam,
+            const Resources::Loader loader = Resources::LoadRaw,
+            const Resources::Unloader unloader = Resources::UnloadRaw)
+        {
+            const int32_t fad = Resources::GetFileAddress(fileId);
+
+            if (fad < 0)
+            {
+                return Handle();
+            }
+
+            Entry* free = nullptr;
+
+            for (uint16_t slot = 0; slot < SRL_MAX_RESOURCES; slot++)
+            {
+                Entry* entry = &Resources::entries[slot];
+
+                if (entry->InUse && entry->Fad == fad && entry->Zone == zone && entry->Load == loader)
+                {
+                    entry->References++;
+                    entry->FileId = fileId;
+                    Resources::statistics.Hits++;
+                    return Handle(slot, entry->Generation);
+                }
+                else if (!entry->InUse && free == nullptr)
+                {
+                    free = entry;
+                }
+            }
+
+            // Table is full, make room by evicting least recently used unreferenced resource
+            if (free == nullptr)
+            {
+                Entry* oldest = nullptr;
+
+                for (Entry& entry : Resources::entries)
+                {
+                    if (entry.References == 0 && (oldest == nullptr || entry.LastUse < oldest->LastUse))
+                    {
+                        oldest = &entry;
+                    }
+                }
+
+                if (oldest != nullptr)
+                {
+                    Resources::UnloadEntry(oldest);
+                    free = oldest;
+                }
+            }
+
+            if (free == nullptr)
+            {
+                return Handle();
+            }
+
+            free->InUse = true;
+            free->Data = nullptr;
+            free->Size = 0;
+            free->Load = loader;
+            free->Unload = unloader;
+            free->LastUse = Resources::clock;
+            free->Fad = fad;
+            free->FileId = fileId;
+            free->References = 1;
+            free->Zone = zone;
+            free->Status = State::Unloaded;
+            Resources::statistics.Misses++;
+            return Handle(free - Resources::entries, free->Generation);
+        }
+
+        /** @brief Acquire resource by file name
+         * @param name File name in current directory
+         * @param zone Memory zone to load resource into
+         * @param loader Loader to use (raw file bytes by default)
+         * @param unloader Unloader matching the loader
+         * @return Resource handle, invalid if file does not exist or resource table is full
+         */
+        static Handle Acquire(const char* name,
+            const Memory::Zone zone = Memory::Zone::HWRam,
+            const Resources::Loader loader = Resources::LoadRaw,
+            const Resources::Unloader unloader = Resources::UnloadRaw)
+        {
+            return Resources::Acquire(GFS_NameToId((int8_t*)name), zone, loader, unloader);
+        }
+
+        /** @brief Add reference to already acquired resource
+         * @param handle Resource handle
+         * @return Same handle
+         */
+        static Handle AddReference(const Handle& handle)
+        {
+            Entry* entry = Resources::GetEntry(handle);
+
+            if (entry != nullptr)
+            {
+                entry->References++;
+            }
+
+            return handle;
+        }
+
+        /** @brief Release reference to a resource
+         * @note Data stays loaded until evicted
+         * @param handle Resource handle
+         */
+        static void Release(const Handle& handle)
+        {
+            Entry* entry = Resources::GetEntry(handle);
+
+            if (entry != nullptr && entry->References > 0)
+            {
+                entry->References--;
+
+                // Nothing to keep cached
+                if (entry->References == 0 && entry->Status != State::Loaded)
+                {
+                    Resources::UnloadEntry(entry);
+                }
+            }
+        }
+
+        /** @brief Get resource data, loads it on first access
+         * @param handle Resource handle
+         * @return Resource data or nullptr if it could not be loaded
+         */
+        static void* Get(const Handle& handle)
+        {
+            Entry* entry = Resources::GetEntry(handle);
+
+            if (entry == nullptr)
+            {
+                return nullptr;
+            }
+
+            entry->LastUse = ++Resources::clock;
+
+            if (entry->Status != State::Loaded && !Resources::LoadEntry(entry))
+            {
+                return nullptr;
+            }
+
+            return entry->Data;
+        }
+
+        /** @brief Get resource data, loads it on first access
+         * @tparam T Type of the data
+         * @param handle Resource handle
+         * @return Resource data or nullptr if it could not be loaded
+         */
+        template <typename T>
+        static T* Get(const Handle& handle)
+        {
+            return static_cast<T*>(Resources::Get(handle));
+        }
+
+        /** @brief Get resource state
+         * @param handle Resource handle
+         * @return Resource state
+         */
+        static State GetState(const Handle& handle)
+        {
+            Entry* entry = Resources::GetEntry(handle);
+            return entry != nullptr ? entry->Status : State::Failed;
+        }
+
+        /** @brief Get size of loaded resource
+         * @param handle Resource handle
+         * @return Number of bytes used by resource data
+         */
+        static size_t GetSize(const Handle& handle)
+        {
+            Entry* entry = Resources::GetEntry(handle);
+            return entry != nullptr ? entry->Size : 0;
+        }
+
+        /** @brief Get number of references to a resource
+         * @param handle Resource handle
+         * @return Reference count
+         */
+        static uint16_t GetReferences(const Handle& handle)
+        {
+            Entry* entry = Resources::GetEntry(handle);
+            return entry != nullptr ? entry->References : 0;
+        }
+
+        /** @brief Set memory budget of a zone
+         * @note Exceeding budget evicts unreferenced resources, referenced resources are never evicted
+         * @param zone Memory zone
+         * @param bytes Maximal number of bytes resources can use (0 means no budget)
+         */
+        static void SetBudget(const Memory::Zone zone, const size_t bytes)
+        {
+            Resources::budgets[static_cast<size_t>(zone)] = bytes;
+
+            while (bytes != 0 && Resources::usage[static_cast<size_t>(zone)] > bytes && Resources::EvictOne(zone));
+        }
+
+        /** @brief Get memory budget of a zone
+         * @param zone Memory zone
+         * @return Number of bytes (0 means no budget)
+         */
+        static size_t GetBudget(const Memory::Zone zone)
+        {
+            return Resources::budgets[static_cast<size_t>(zone)];
+        }
+
+        /** @brief Get memory used by resources in a zone
+         * @param zone Memory zone
+         * @return Number of bytes
+         */
+        static size_t GetUsage(const Memory::Zone zone)
+        {
+            return Resources::usage[static_cast<size_t>(zone)];
+        }
+
+        /** @brief Get cache statistics
+         * @return Statistics
+         */
+        static const Statistics& GetStatistics()
+        {
+            return Resources::statistics;
+        }
+
+        /** @brief Evict all unreferenced resources
+         * @param zone Memory zone to evict from
+         */
+        static void Flush(const Memory::Zone zone)
+        {
+            while (Resources::EvictOne(zone));
+        }
+
+        /** @brief Evict all unreferenced resources from all zones
+         */
+        static void Flush()
+        {
+            Resources::Flush(Memory::Zone::HWRam);
+            Resources::Flush(Memory::Zone::LWRam);
+            Resources::Flush(Memory::Zone::CartRam);
+        }
+
+        /** @brief List of resources to load ahead of time, intended for loading screens
+         * @details Resources in the list are referenced until the list is released or destroyed,
+         * after that they stay cached and are picked up by later acquires.
+         * @code {.cpp}
+         * SRL::Resources::PreloadList preload(3);
+         * preload.Add("LEVEL1.BIN");
+         * preload.Add("ENEMY.TGA");
+         * preload.Add("MUSIC.PCM", SRL::Memory::Zone::LWRam);
+         *
+         * while (!preload.LoadNext())
+         * {
+         *     DrawProgressBar(preload.GetProgress());
+         *     SRL::Core::Synchronize();
+         * }
+         * @endcode
+         */
+        class PreloadList
+        {
+        private:
+
+            /** @brief Resources in the list
+             */
+            Handle* handles;
+
+            /** @brief Capacity of the list
+             */
+            size_t capacity;
+
+            /** @brief Number of resources in the list
+             */
+            size_t count;
+
+            /** @brief Next resource to load
+             */
+            size_t next;
+
+        public:
+
+            /** @brief Construct preload list
+             * @param capacity Maximal number of resources
+             */
+            PreloadList(const size_t capacity) : handles(new Handle[capacity]), capacity(capacity), count(0), next(0) { }
+
+            /** @brief Destroy preload list and release its references
+             */
+            ~PreloadList()
+            {
+                this->Release();
+                delete[] this->handles;
+            }
+
+            /** @brief Add resource to the list
+             * @param name File name in current directory
+             * @param zone Memory zone to load resource into
+             * @param loader Loader to use (raw file bytes by default)
+             * @param unloader Unloader matching the loader
+             * @return Resource handle, invalid if resource could not be added
+             */
+            Handle Add(const char* name,
+                const Memory::Zone zone = Memory::Zone::HWRam,
+                const Resources::Loader loader = Resources::LoadRaw,
+                const Resources::Unloader unloader = Resources::UnloadRaw)
+            {
+                if (this->count >= this->capacity)
+                {
+                    return Handle();
+                }
+
+                Handle handle = Resources::Acquire(name, zone, loader, unloader);
+
+                if (handle.IsValid())
+                {
+                    this->handles[this->count++] = handle;
+                }
+
+                return handle;
+            }
+
+            /** @brief Load next resource in the list
+             * @return True when all resources were processed
+             */
+            bool LoadNext()
+            {
+                if (this->next < this->count)
+                {
+                    Resources::Get(this->handles[this->next++]);
+                }
+
+                return this->next >= this->count;
+            }
+
+            /** @brief Load all remaining resources
+             */
+            void LoadAll()
+            {
+                while (!this->LoadNext());
+            }
+
+            /** @brief Get loading progress
+             * @return Progress in percent
+             */
+            uint8_t GetProgress() const
+            {
+                return this->count > 0 ? static_cast<uint8_t>((this->next * 100) / this->count) : 100;
+            }
+
+            /** @brief Release references held by the list, loaded resources stay cached
+             */
+            void Release()
+            {
+                for (size_t index = 0; index < this->count; index++)
+                {
+                    Resources::Release(this->handles[index]);
+                }
+
+                this->count = 0;
+                this->next = 0;
+            }
+        };
+    };
+}
@@ -0,0 +1,819 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_datetime.hpp"
+#include "srl_timer.hpp"
+
+namespace SRL
+{
+    /** @brief Backup RAM save system
+     * @details Save slot data is split into chunks, each chunk is compressed and stored as a separate backup file
+     * next to a small slot header. Slot remembers the image it last read or wrote, so saving again rewrites only chunks
+     * that changed. Every chunk and the whole image are validated with CRC32 on load.
+     * @code {.cpp}
+     * struct GameProgress
+     * {
+     *     uint32_t Score;
+     *     uint8_t UnlockedLevels[64];
+     * };
+     *
+     * SRL::Save::Initialize();
+     * SRL::Save::Slot<GameProgress> slot("MYGAME");
+     * GameProgress progress;
+     *
+     * if (slot.Read(progress) != SRL::Save::Result::Ok)
+     * {
+     *     progress = GameProgress();
+     * }
+     *
+     * progress.Score += 100;
+     * slot.Write(progress);   // Only chunk containing Score is rewritten
+     * @endcode
+     */
+    class Save
+    {
+    public:
+
+        /** @brief Backup device
+         */
+        enum class Device : uint32_t
+        {
+            /** @brief Internal backup memory
+             */
+            Internal = 0,
+
+            /** @brief Backup memory cartridge
+             */
+            Cartridge = 1,
+
+            /** @brief External backup device (floppy drive)
+             */
+            External = 2
+        };
+
+        /** @brief Result of save operation
+         */
+        enum class Result : int32_t
+        {
+            /** @brief Operation succeeded
+             */
+            Ok = 0,
+
+            /** @brief Device is not connected
+             */
+            NotConnected = BUP_NON,
+
+            /** @brief Device is not formatted
+             */
+            Unformatted = BUP_UNFORMAT,
+
+            /** @brief Device is write protected
+             */
+            WriteProtected = BUP_WRITE_PROTECT,
+
+            /** @brief Not enough free space on device
+             */
+            NotEnoughMemory = BUP_NOT_ENOUGH_MEMORY,
+
+            /** @brief Save file was not found
+             */
+            NotFound = BUP_NOT_FOUND,
+
+            /** @brief Verification of written data failed
+             */
+            NoMatch = BUP_NO_MATCH,
+
+            /** @brief Backup memory is broken
+             */
+            Broken = BUP_BROKEN,
+
+            /** @brief Save data is corrupted (CRC mismatch)
+             */
+            CrcMismatch = 100,
+
+            /** @brief Save data does not belong to this slot type
+             */
+            InvalidData = 101,
+
+            /** @brief Backup library is not initialized
+             */
+            NotInitialized = 102
+        };
+
+        /** @brief Statistics of last save or load operation
+         */
+        struct Timing
+        {
+            /** @brief Duration of the operation
+             */
+            uint32_t Microseconds;
+
+            /** @brief Number of chunks written or read
+             */
+            uint16_t ChunksTransferred;
+
+            /** @brief Number of chunks skipped because they did not change
+             */
+            uint16_t ChunksSkipped;
+
+            /** @brief Number of bytes written or read from device
+             */
+            uint32_t Bytes;
+        };
+
+        /** @brief Number of uncompressed bytes stored in one chunk
+         */
+        static constexpr size_t ChunkSize = 256;
+
+        /** @brief Maximal length of slot name
+         * @note Two characters are left for chunk index, backup file names are up to 11 characters long
+         */
+        static constexpr size_t MaxNameLength = 8;
+
+    private:
+
+        /** @brief Slot header identifier ('SRLS')
+         */
+        static constexpr uint32_t Magic = 0x53524c53;
+
+        /** @brief Chunk is stored without compression
+         */
+        static constexpr uint16_t RawChunk = 0x8000;
+
+        /** @brief Size of the backup library area in 32bit words
+         */
+        static constexpr size_t LibrarySize = 4096;
+
+        /** @brief Size of the backup library work area in 32bit words
+         */
+        static constexpr size_t WorkSize = 2048;
+
+        /** @brief Slot header file
+         */
+        struct Header
+        {
+            /** @brief Header identifier
+             */
+            uint32_t Magic;
+
+            /** @brief Size of the slot data
+             */
+            uint32_t Size;
+
+            /** @brief CRC32 of the whole slot data
+             */
+            uint32_t Crc;
+
+            /** @brief Number of chunks
+             */
+            uint16_t Chunks;
+
+            /** @brief User data version
+             */
+            uint16_t Version;
+        };
+
+        /** @brief Chunk file header
+         */
+        struct ChunkHeader
+        {
+            /** @brief CRC32 of the uncompressed chunk
+             */
+            uint32_t Crc;
+
+            /** @brief Number of uncompressed bytes
+             */
+            uint16_t Size;
+
+            /** @brief Number of stored bytes, highest bit set if chunk is not compressed
+             */
+            uint16_t Stored;
+        };
+
+        /** @brief Backup library area
+         */
+        inline static uint32_t* library = nullptr;
+
+        /** @brief Backup library work area
+         */
+        inline static uint32_t* work = nullptr;
+
+        /** @brief Connected devices
+         */
+        inline static BupConfig config[3];
+
+        /** @brief Buffer used to transfer chunk to and from device
+         */
+        alignas(4) inline static uint8_t transfer[sizeof(Save::ChunkHeader) + Save::ChunkSize];
+
+        /** @brief CRC32 lookup table for 4bit nibbles
+         */
+        static constexpr uint32_t CrcTable[16] = {
+            0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+            0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+        };
+
+        /** @brief Compose backup file name
+         * @param name Slot name
+         * @param chunk Chunk index, or -1 for slot header
+         * @param fileName Output file name (12 bytes)
+         */
+        static void GetFileName(const char* name, const int16_t chunk, uint8_t* fileName)
+        {
+            static constexpr char Hex[] = "0123456789ABCDEF";
+            size_t length = 0;
+
+            while (length < Save::MaxNameLength && name[length] != '\0')
+            {
+                fileName[length] = name[length];
+                length++;
+            }
+
+            if (chunk >= 0)
+            {
+                fileName[length++] = '_';
+                fileName[length++] = Hex[(chunk >> 4) & 0x0f];
+                fileName[length++] = Hex[chunk & 0x0f];
+            }
+
+            while (length < 12)
+            {
+                fileName[length++] = '\0';
+            }
+        }
+
+        /** @brief Write backup file
+         * @param device Backup device
+         * @param fileName Backup file name
+         * @param comment File comment
+         * @param data Data to write
+         * @param size Data size
+         * @return Result of the operation
+         */
+        static Result WriteFile(const Device device, const uint8_t* fileName, const char* comment, const uint8_t* data, const size_t size)
+        {
+            BupDir dir;
+
+            for (size_t index = 0; index < sizeof(dir.filename); index++)
+            {
+                dir.filename[index] = fileName[index];
+            }
+
+            size_t length = 0;
+
+            while (length < sizeof(dir.comment) - 1 && comment != nullptr && comment[length] != '\0')
+            {
+                dir.comment[length] = comment[length];
+                length++;
+            }
+
+            while (length < sizeof(dir.comment))
+            {
+                dir.comment[length++] = '\0';
+            }
+
+            BupDate date = Types::DateTime::Now().ToBackupUnitDate();
+            dir.language = BUP_ENGLISH;
+            dir.date = BUP_SetDate(&date);
+            dir.datasize = size;
+            dir.blocksize = 0;
+
+            return static_cast<Result>(BUP_Write(static_cast<uint32_t>(device), &dir, const_cast<uint8_t*>(data), 0));
+        }
+
+        /** @brief Get size of backup file
+         * @param device Backup device
+         * @param fileName Backup file name
+         * @return File size, 0 if file does not exist
+         */
+        static size_t GetFileSize(const Device device, const uint8_t* fileName)
+        {
+            BupDir dir;
+
+            if (BUP_Dir(static_cast<uint32_t>(device), const_cast<uint8_t*>(fileName), 1, &dir) > 0)
+            {
+                return dir.datasize;
+            }
+
+            return 0;
+        }
+
+        /** @brief Disable constructor
+         */
+        Save() = delete;
+
+        /** @brief Disable destructor
+         */
+        ~Save() = delete;
+
+    public:
+
+        /** @brief Initialize backup library
+         * @note Allocates 24KB of memory for backup library
+         * @return True if at least internal backup memory is available
+         */
+        static bool Initialize()
+        {
+            if (Save::library == nullptr)
+            {
+                Save::library = new uint32_t[Save::LibrarySize];
+                Save::work = new uint32_t[Save::WorkSize];
+                BUP_Init(Save::library, Save::work, Save::config);
+            }
+
+            return Save::IsConnected(Device::Internal);
+        }
+
+        /** @brief Check whether backup library was initialized
+         * @return True if initialized
+         */
+        static bool IsInitialized()
+        {
+            return Save::library != nullptr;
+        }
+
+        /** @brief Check whether device is connected
+         * @param device Backup device
+         * @return True if connected
+         */
+        static bool IsConnected(const Device device)
+        {
+            return Save::IsInitialized() && Save::config[static_cast<size_t>(device)].unit_id != 0;
+        }
+
+        /** @brief Get free space on device
+         * @param device Backup device
+         * @return Number of free bytes
+         */
+        static size_t GetFreeSpace(const Device device)
+        {
+            BupStat stat;
+
+            if (Save::IsConnected(device) && BUP_Stat(static_cast<uint32_t>(device), 0, &stat) == 0)
+            {
+                return stat.freesize;
+            }
+
+            return 0;
+        }
+
+        /** @brief Calculate CRC32 (IEEE 802.3)
+         * @param data Data to calculate checksum of
+         * @param size Data size
+         * @param crc Previous CRC when calculating in parts
+         * @return Checksum
+         */
+        static uint32_t Crc32(const void* data, const size_t size, const uint32_t crc = 0)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            uint32_t value = ~crc;
+
+            for (size_t index = 0; index < size; index++)
+            {
+                value ^= bytes[index];
+                value = (value >> 4) ^ Save::CrcTable[value & 0x0f];
+                value = (value >> 4) ^ Save::CrcTable[value & 0x0f];
+            }
+
+            return ~value;
+        }
+
+        /** @brief Compress data with run length encoding (PackBits)
+         * @param source Data to compress
+         * @param size Data size
+         * @param destination Compressed data
+         * @param capacity Size of destination buffer
+         * @return Compressed size, 0 if data does not fit into destination
+         */
+        static size_t Compress(const uint8_t* source, const size_t size, uint8_t* destination, const size_t capacity)
+        {
+            size_t read = 0;
+            size_t written = 0;
+
+            while (read < size)
+            {
+                // Measure run of same bytes
+                size_t run = 1;
+
+                while (read + run < size && run < 128 && source[read + run] == source[read])
+                {
+                    run++;
+                }
+
+                if (run >= 3)
+                {
+                    if (written + 2 > capacity)
+                    {
+                        return 0;
+                    }
+
+                    destination[written++] = static_cast<uint8_t>(257 - run);
+                    destination[written++] = source[read];
+                    read += run;
+                }
+                else
+                {
+                    // Literals until next run of at least 3 bytes
+                    size_t literals = 0;
+
+                    while (read + literals < size && literals < 128)
+                    {
+                        if (read + literals + 2 < size &&
+                            source[read + literals] == source[read + literals + 1] &&
+                            source[read + literals] == source[read + literals + 2])
+                        {
+                            break;
+                        }
+
+                        literals++;
+                    }
+
+                    if (written + literals + 1 > capacity)
+                    {
+                        return 0;
+                    }
+
+                    destination[written++] = static_cast<uint8_t>(literals - 1);
+
+                    for (size_t index = 0; index < literals; index++)
+                    {
+                        destination[written++] = source[read++];
+                    }
+                }
+            }
+
+            return written;
+        }
+
+        /** @brief Decompress data compressed by SRL::Save::Compress()
+         * @param source Compressed data
+         * @param size Compressed data size
+         * @param destination Decompressed data
+         * @param capacity Size of destination buffer
+         * @return Decompressed size, 0 if data is malformed or does not fit into destination
+         */
+        static size_t Decompress(const uint8_t* source, const size_t size, uint8_t* destination, const size_t capacity)
+        {
+            size_t read = 0;
+            size_t written = 0;
+
+            while (read < size)
+            {
+                const uint8_t control = source[read++];
+
+                if (control < 128)
+                {
+                    const size_t literals = control + 1;
+
+                    if (read + literals > size || written + literals > capacity)
+                    {
+                        return 0;
+                    }
+
+                    for (size_t index = 0; index < literals; index++)
+                    {
+                        destination[written++] = source[read++];
+                    }
+                }
+                else if (control > 128)
+                {
+                    const size_t run = 257 - control;
+
+                    if (read >= size || written + run > capacity)
+                    {
+                        return 0;
+                    }
+
+                    for (size_t index = 0; index < run; index++)
+                    {
+                        destination[written++] = source[read];
+                    }
+
+                    read++;
+                }
+            }
+
+            return written;
+        }
+
+        /** @brief Typed save slot
+         * @tparam T Save data type, must be trivially copyable
+         */
+        template <typename T>
+        class Slot
+        {
+        private:
+
+            /** @brief Number of chunks
+             */
+            static constexpr size_t ChunkCount = (sizeof(T) + Save::ChunkSize - 1) / Save::ChunkSize;
+
+            static_assert(Slot::ChunkCount <= 256, "Save data is too large");
+
+            /** @brief Slot name
+             */
+            char name[Save::MaxNameLength + 1];
+
+            /** @brief Comment shown in backup memory manager
+             */
+            const char* comment;
+
+            /** @brief Backup device
+             */
+            Device device;
+
+            /** @brief Data version
+             */
+            uint16_t version;
+
+            /** @brief Image last written to or read from device
+             */
+            alignas(4) uint8_t image[sizeof(T)];
+
+            /** @brief Image matches content of device
+             */
+            bool hasImage;
+
+            /** @brief Statistics of last operation
+             */
+            Save::Timing timing;
+
+        public:
+
+            /** @brief Construct save slot
+             * @param name Slot name (up to 8 characters)
+             * @param device Backup device
+             * @param comment Comment shown in backup memory manager (up to 10 characters)
+             * @param version Data version, slot with different version is considered invalid
+             */
+            Slot(const char* name, const Device device = Device::Internal, const char* comment = "SRL save", const uint16_t version = 0) :
+                comment(comment), device(device), version(version), hasImage(false), timing({ 0, 0, 0, 0 })
+            {
+                size_t length = 0;
+
+                while (length < Save::MaxNameLength && name[length] != '\0')
+                {
+                    this->name[length] = name[length];
+                    length++;
+                }
+
+                this->name[length] = '\0';
+            }
+
+            /** @brief Write data into slot
+             * @note Only chunks that differ from last read or written image are rewritten
+             * @param data Data to save
+             * @return Result of the operation
+             */
+            Result Write(const T& data)
+            {
+                if (!Save::IsInitialized())
+                {
+                    return Result::NotInitialized;
+                }
+
+                Timer::Stopwatch stopwatch;
+                stopwatch.Start();
+                this->timing = { 0, 0, 0, 0 };
+
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&data);
+                uint8_t fileName[12];
+                Result result = Result::Ok;
+
+                for (size_t chunk = 0; chunk < Slot::ChunkCount; chunk++)
+                {
+                    const size_t offset = chunk * Save::ChunkSize;
+                    const size_t size = Math::Min<size_t>(Save::ChunkSize, sizeof(T) - offset);
+                    bool changed = !this->hasImage;
+
+                    for (size_t index = 0; !changed && index < size; index++)
+                    {
+                        changed = bytes[offset + index] != this->image[offset + index];
+                    }
+
+                    if (!changed)
+                    {
+                        this->timing.ChunksSkipped++;
+                        continue;
+                    }
+
+                    ChunkHeader* header = reinterpret_cast<ChunkHeader*>(Save::transfer);
+                    uint8_t* payload = Save::transfer + sizeof(ChunkHeader);
+                    size_t stored = Save::Compress(bytes + offset, size, payload, size - 1);
+
+                    header->Crc = Save::Crc32(bytes + offset, size);
+                    header->Size = size;
+
+                    if (stored == 0)
+                    {
+                        // Compression did not help
+                        for (size_t index = 0; index < size; index++)
+                        {
+                            payload[index] = bytes[offset + index];
+                        }
+
+                        stored = size;
+                        header->Stored = Save::RawChunk | size;
+                    }
+                    else
+                    {
+                        header->Stored = stored;
+                    }
+
+                    Save::GetFileName(this->name, chunk, fileName);
+                    result = Save::WriteFile(this->device, fileName, this->comment, Save::transfer, sizeof(ChunkHeader) + stored);
+
+                    if (result != Result::Ok)
+                    {
+                        // Device content is unknown now
+                        this->hasImage = false;
+                        return result;
+                    }
+
+                    this->timing.ChunksTransferred++;
+                    this->timing.Bytes += sizeof(ChunkHeader) + stored;
+                    stopwatch.Lap();
+                }
+
+                // Slot header is written last, so interrupted save is detected by CRC mismatch
+                Header header = { Save::Magic, sizeof(T), Save::Crc32(bytes, sizeof(T)), Slot::ChunkCount, this->version };
+                Save::GetFileName(this->name, -1, fileName);
+                result = Save::WriteFile(this->device, fileName, this->comment, reinterpret_cast<uint8_t*>(&header), sizeof(Header));
+
+                if (result == Result::Ok)
+                {
+                    for (size_t index = 0; index < sizeof(T); index++)
+                    {
+                        this->image[index] = bytes[index];
+                    }
+
+                    this->hasImage = true;
+                    this->timing.Bytes += sizeof(Header);
+                }
+                else
+                {
+                    this->hasImage = false;
+                }
+
+                this->timing.Microseconds = stopwatch.GetMicroseconds();
+                return result;
+            }
+
+            /** @brief Read data from slot
+             * @param data Where to load data into, left untouched on failure
+             * @return Result of the operation
+             */
+            Result Read(T& data)
+            {
+                if (!Save::IsInitialized())
+                {
+                    return Result::NotInitialized;
+                }
+
+                Timer::Stopwatch stopwatch;
+                stopwatch.Start();
+                this->timing = { 0, 0, 0, 0 };
+                this->hasImage = false;
+
+                uint8_t fileName[12];
+                Header header;
+                Save::GetFileName(this->name, -1, fileName);
+
+                if (Save::GetFileSize(this->device, fileName) != sizeof(Header))
+                {
+                    return Result::NotFound;
+                }
+
+                Result result = static_cast<Result>(BUP_Read(static_cast<uint32_t>(this->device), fileName, reinterpret_cast<uint8_t*>(&header)));
+
+                if (result != Result::Ok)
+                {
+                    return result;
+                }
+
+                if (header.Magic != Save::Magic || header.Size != sizeof(T) || header.Chunks != Slot::ChunkCount || header.Version != this->version)
+                {
+                    return Result::InvalidData;
+                }
+
+                this->timing.Bytes += sizeof(Header);
+
+                for (size_t chunk = 0; chunk < Slot::ChunkCount; chunk++)
+                {
+                    const size_t offset = chunk * Save::ChunkSize;
+                    const size_t size = Math::Min<size_t>(Save::ChunkSize, sizeof(T) - offset);
+                    Save::GetFileName(this->name, chunk, fileName);
+
+                    const size_t fileSize = Save::GetFileSize(this->device, fileName);
+
+                    if (fileSize <= sizeof(ChunkHeader) || fileSize > sizeof(Save::transfer))
+                    {
+                        return Result::NotFound;
+                    }
+
+                    result = static_cast<Result>(BUP_Read(static_cast<uint32_t>(this->device), fileName, Save::transfer));
+
+                    if (result != Result::Ok)
+                    {
+                        return result;
+                    }
+
+                    const ChunkHeader* chunkHeader = reinterpret_cast<const ChunkHeader*>(Save::transfer);
+                    const uint8_t* payload = Save::transfer + sizeof(ChunkHeader);
+                    const size_t stored = chunkHeader->Stored & ~Save::RawChunk;
+
+                    if (chunkHeader->Size != size || sizeof(ChunkHeader) + stored > fileSize)
+                    {
+                        return Result::InvalidData;
+                    }
+
+                    if ((chunkHeader->Stored & Save::RawChunk) != 0)
+                    {
+                        for (size_t index = 0; index < size; index++)
+                        {
+                            this->image[offset + index] = payload[index];
+                        }
+                    }
+                    else if (Save::Decompress(payload, stored, this->image + offset, size) != size)
+                    {
+                        return Result::InvalidData;
+                    }
+
+                    if (Save::Crc32(this->image + offset, size) != chunkHeader->Crc)
+                    {
+                        return Result::CrcMismatch;
+                    }
+
+                    this->timing.ChunksTransferred++;
+                    this->timing.Bytes += fileSize;
+                    stopwatch.Lap();
+                }
+
+                if (Save::Crc32(this->image, sizeof(T)) != header.Crc)
+                {
+                    return Result::CrcMismatch;
+                }
+
+                uint8_t* bytes = reinterpret_cast<uint8_t*>(&data);
+
+                for (size_t index = 0; index < sizeof(T); index++)
+                {
+                    bytes[index] = this->image[index];
+                }
+
+                this->hasImage = true;
+                this->timing.Microseconds = stopwatch.GetMicroseconds();
+                return Result::Ok;
+            }
+
+            /** @brief Check whether slot exists on device
+             * @return True if slot header exists
+             */
+            bool Exists()
+            {
+                uint8_t fileName[12];
+                Save::GetFileName(this->name, -1, fileName);
+                return Save::IsInitialized() && Save::GetFileSize(this->device, fileName) == sizeof(Header);
+            }
+
+            /** @brief Delete slot from device
+             * @return Result of the operation
+             */
+            Result Delete()
+            {
+                if (!Save::IsInitialized())
+                {
+                    return Result::NotInitialized;
+                }
+
+                uint8_t fileName[12];
+                Save::GetFileName(this->name, -1, fileName);
+                Result result = static_cast<Result>(BUP_Delete(static_cast<uint32_t>(this->device), fileName));
+
+                for (size_t chunk = 0; chunk < Slot::ChunkCount; chunk++)
+                {
+                    Save::GetFileName(this->name, chunk, fileName);
+                    BUP_Delete(static_cast<uint32_t>(this->device), fileName);
+                }
+
+                this->hasImage = false;
+                return result;
+            }
+
+            /** @brief Forget last written image, next write rewrites all chunks
+             */
+            void Invalidate()
+            {
+                this->hasImage = false;
+            }
+
+            /** @brief Get statistics of last read or write
+             * @return Timing and transfer statistics
+             */
+            const Save::Timing& GetTiming() const
+            {
+                return this->timing;
+            }
+        };
+    };
+}
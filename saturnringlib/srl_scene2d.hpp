@@ -5,10 +5,16 @@
 
 namespace SRL
 {
+    class ParticleSystem;
+
     /** @brief Rendering of VDP1 sprites and shapes
      */
     class Scene2D
     {
+        /** @brief Particle system needs to build shared sprite attribute
+         */
+        friend class SRL::ParticleSystem;
+
     public:
     
         /** @brief Clipping effect mode
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_slave.hpp"
+
+extern "C"
+{
+    /** @brief Start of the code and data linked to the scratchpad
+     * @note Defined within linker script
+     */
+    extern uint8_t _scratchpad_start;
+
+    /** @brief End of the code and data linked to the scratchpad
+     * @note Defined within linker script
+     */
+    extern uint8_t _scratchpad_end;
+
+    /** @brief Location of the scratchpad image in HWRam
+     * @note Defined within linker script
+     */
+    extern uint8_t _scratchpad_load;
+}
+
+/** @brief Place function into the scratchpad
+ * @details Function is linked to the scratchpad address and copied there by SRL::Scratchpad::Enable()
+ */
+#define SRL_SCRATCHPAD_CODE __attribute__((section(".scratchpad.text"), noinline))
+
+/** @brief Place variable into the scratchpad
+ * @note Variable must not have a constructor, only its initial value is copied by SRL::Scratchpad::Enable()
+ */
+#define SRL_SCRATCHPAD_DATA __attribute__((section(".scratchpad.data")))
+
+namespace SRL
+{
+    /** @brief SH2 cache used as on-chip RAM
+     * @details Each SH2 can switch its 4KB cache into two-way mode, where two of the ways keep working as cache
+     * and the other two become 2KB of RAM at the same address on both CPUs. It is the fastest memory in the system,
+     * without any wait states for both reads and instruction fetches, which makes it a good place for short hot loops
+     * (vertex transforms, decompression, sound mixing) and the data they work on.
+     *
+     * Code and data marked with SRL_SCRATCHPAD_CODE and SRL_SCRATCHPAD_DATA is linked to the scratchpad and
+     * copied there every time it is enabled, the rest of the 2KB can be filled at runtime with Copy() or Allocate().
+     * Each CPU has its own scratchpad, so slave must enable it separately before running kernels from it.
+     * @code {.cpp}
+     * SRL_SCRATCHPAD_CODE void Kernel(Vector3D* points, size_t count)
+     * {
+     *     // Runs without touching main RAM for instruction fetches
+     * }
+     *
+     * SRL::Scratchpad::Enable();
+     * Vector3D* fast = reinterpret_cast<Vector3D*>(SRL::Scratchpad::Copy(points, sizeof(Vector3D) * count));
+     * Kernel(fast, count);
+     * @endcode
+     * @note Enabling the scratchpad halves the cache of the CPU, code that does not use it can become slower.
+     * Contents are lost when the scratchpad is disabled.
+     */
+    class Scratchpad
+    {
+    private:
+
+        /** @brief Cache control register
+         */
+        inline static volatile uint8_t* const CacheControl = (volatile uint8_t*)0xfffffe92;
+
+        /** @brief Bus control register 1, tells which CPU reads it
+         */
+        inline static volatile uint32_t* const BusControl = (volatile uint32_t*)0xffffffe0;
+
+        /** @brief Cache enable bit of cache control register
+         */
+        static constexpr uint8_t CacheEnable = 0x01;
+
+        /** @brief Two-way mode bit of cache control register
+         */
+        static constexpr uint8_t TwoWay = 0x08;
+
+        /** @brief Cache purge bit of cache control register
+         */
+        static constexpr uint8_t CachePurge = 0x10;
+
+        /** @brief Slave mode bit of bus control register 1
+         */
+        static constexpr uint32_t SlaveMode = 0x8000;
+
+        /** @brief Address of cache-through mirror of main memory
+         */
+        static constexpr uint32_t CacheThrough = 0x20000000;
+
+        /** @brief Number of used bytes in scratchpad of each CPU
+         */
+        inline static size_t used[2] = { 0, 0 };
+
+        /** @brief Task switching scratchpad of slave CPU
+         */
+        class ModeTask : public Types::ITask
+        {
+        public:
+            /** @brief Enable or disable the scratchpad
+             */
+            bool Enable;
+
+        protected:
+            /** @brief Switch mode on slave
+             */
+            void Do() override
+            {
+                if (this->Enable)
+                {
+                    Scratchpad::Enable();
+                }
+                else
+                {
+                    Scratchpad::Disable();
+                }
+            }
+        };
+
+        /** @brief Disable constructor
+         */
+        Scratchpad() = delete;
+
+        /** @brief Disable destructor
+         */
+        ~Scratchpad() = delete;
+
+        /** @brief Get index of the calling CPU
+         * @return 0 on master, 1 on slave
+         */
+        static size_t GetCpu()
+        {
+            return (*Scratchpad::BusControl & Scratchpad::SlaveMode) != 0 ? 1 : 0;
+        }
+
+        /** @brief Switch cache mode
+         * @note Must be executed from cache-through address, cache contents are purged
+         * @param mode Two-way mode bit or 0 for four-way mode
+         */
+        __attribute__((noinline)) static void SetMode(uint8_t mode)
+        {
+            const uint8_t control = *Scratchpad::CacheControl & ~(Scratchpad::CacheEnable | Scratchpad::TwoWay);
+            *Scratchpad::CacheControl = control;
+            *Scratchpad::CacheControl = control | mode | Scratchpad::CachePurge;
+            *Scratchpad::CacheControl = control | mode | Scratchpad::CacheEnable;
+        }
+
+        /** @brief Switch cache mode of the calling CPU
+         * @param mode Two-way mode bit or 0 for four-way mode
+         */
+        static void SwitchMode(uint8_t mode)
+        {
+            void (*setMode)(uint8_t) = reinterpret_cast<void (*)(uint8_t)>(reinterpret_cast<uint32_t>(&Scratchpad::SetMode) | Scratchpad::CacheThrough);
+            setMode(mode);
+        }
+
+    public:
+
+        /** @brief Size of the scratchpad in bytes
+         */
+        static constexpr size_t Size = 2048;
+
+        /** @brief Get start of the scratchpad
+         * @return Pointer to the on-chip RAM, same on both CPUs
+         */
+        static void* GetStart()
+        {
+            return reinterpret_cast<void*>(0xc0000000);
+        }
+
+        /** @brief Get size of code and data linked to the scratchpad
+         * @return Size in bytes
+         */
+        static size_t GetLinkedSize()
+        {
+            return &_scratchpad_end - &_scratchpad_start;
+        }
+
+        /** @brief Get number of bytes used in scratchpad of the calling CPU
+         * @return Size of linked code and data and of all allocations
+         */
+        static size_t GetUsed()
+        {
+            return Scratchpad::used[Scratchpad::GetCpu()];
+        }
+
+        /** @brief Check whether scratchpad of the calling CPU is enabled
+         * @return True if cache is in two-way mode
+         */
+        static bool IsEnabled()
+        {
+            return (*Scratchpad::CacheControl & Scratchpad::TwoWay) != 0;
+        }
+
+        /** @brief Enable scratchpad of the calling CPU and copy linked code and data into it
+         * @note Previous contents and allocations are discarded
+         */
+        static void Enable()
+        {
+            Scratchpad::SwitchMode(Scratchpad::TwoWay);
+
+            const uint32_t* source = reinterpret_cast<const uint32_t*>(&_scratchpad_load);
+            uint32_t* destination = reinterpret_cast<uint32_t*>(&_scratchpad_start);
+
+            for (size_t word = 0; word < (Scratchpad::GetLinkedSize() >> 2); word++)
+            {
+                destination[word] = source[word];
+            }
+
+            Scratchpad::used[Scratchpad::GetCpu()] = Scratchpad::GetLinkedSize();
+        }
+
+        /** @brief Disable scratchpad of the calling CPU and give its memory back to the cache
+         */
+        static void Disable()
+        {
+            Scratchpad::SwitchMode(0);
+            Scratchpad::used[Scratchpad::GetCpu()] = 0;
+        }
+
+        /** @brief Enable scratchpad of slave CPU and copy linked code and data into it
+         * @note Waits until slave is done
+         */
+        static void EnableOnSlave()
+        {
+            ModeTask task;
+            task.Enable = true;
+            Slave::ExecuteOnSlave(task);
+            while (!task.IsDone());
+        }
+
+        /** @brief Disable scratchpad of slave CPU
+         * @note Waits until slave is done
+         */
+        static void DisableOnSlave()
+        {
+            ModeTask task;
+            task.Enable = false;
+            Slave::ExecuteOnSlave(task);
+            while (!task.IsDone());
+        }
+
+        /** @brief Allocate memory in scratchpad of the calling CPU
+         * @param size Number of bytes, rounded up to multiple of 4
+         * @return Pointer to allocated memory or nullptr if scratchpad is disabled or full
+         */
+        static void* Allocate(size_t size)
+        {
+            const size_t cpu = Scratchpad::GetCpu();
+            size = (size + 3) & ~3;
+
+            if (!Scratchpad::IsEnabled() || size > Scratchpad::Size - Scratchpad::used[cpu])
+            {
+                return nullptr;
+            }
+
+            void* allocated = reinterpret_cast<uint8_t*>(Scratchpad::GetStart()) + Scratchpad::used[cpu];
+            Scratchpad::used[cpu] += size;
+            return allocated;
+        }
+
+        /** @brief Copy data into scratchpad of the calling CPU
+         * @param source Data to copy
+         * @param size Number of bytes
+         * @return Pointer to the copy or nullptr if scratchpad is disabled or full
+         */
+        static void* Copy(const void* source, size_t size)
+        {
+            uint8_t* destination = reinterpret_cast<uint8_t*>(Scratchpad::Allocate(size));
+
+            if (destination != nullptr)
+            {
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(source);
+
+                for (size_t byte = 0; byte < size; byte++)
+                {
+                    destination[byte] = bytes[byte];
+                }
+            }
+
+            return destination;
+        }
+
+        /** @brief Release all runtime allocations of the calling CPU
+         * @note Linked code and data stays in place
+         */
+        static void Release()
+        {
+            Scratchpad::used[Scratchpad::GetCpu()] = Scratchpad::IsEnabled() ? Scratchpad::GetLinkedSize() : 0;
+        }
+    };
+}
@@ -0,0 +1,640 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_debug.hpp"
+#include "srl_event.hpp"
+#include "srl_slave.hpp"
+
+namespace SRL
+{
+    /** @brief SCU DSP program loading and execution
+     * @details The SCU DSP is a fixed-point coprocessor with 256 words of program RAM and four banks of 64 words of data RAM.
+     * Data RAM can be accessed by the CPU only while the DSP is stopped, DSP programs can stream data from and to the work RAM-H on their own with the DMA instruction.
+     * @code {.cpp}
+     * // Load and run a custom program
+     * SRL::ScuDsp::LoadProgram(myProgram, myProgramLength);
+     * SRL::ScuDsp::WriteData(SRL::ScuDsp::DataBank::Bank0, 0, parameters, parameterCount);
+     * SRL::ScuDsp::Start();
+     *
+     * // Do some other work, then wait for the program to end
+     * SRL::ScuDsp::Wait();
+     * @endcode
+     */
+    class ScuDsp
+    {
+    private:
+
+        /** @brief Program control port
+         */
+        inline static volatile uint32_t* const ProgramControlPort = (volatile uint32_t*)0x25fe0080;
+
+        /** @brief Program RAM data port
+         */
+        inline static volatile uint32_t* const ProgramDataPort = (volatile uint32_t*)0x25fe0084;
+
+        /** @brief Data RAM address port
+         */
+        inline static volatile uint32_t* const DataAddressPort = (volatile uint32_t*)0x25fe0088;
+
+        /** @brief Data RAM data port
+         */
+        inline static volatile uint32_t* const DataDataPort = (volatile uint32_t*)0x25fe008c;
+
+        /** @brief Program counter load enable flag
+         */
+        static constexpr uint32_t LoadEnableFlag = 0x00008000;
+
+        /** @brief Execute flag
+         */
+        static constexpr uint32_t ExecuteFlag = 0x00010000;
+
+        /** @brief Indicates whether end interrupt handler was registered
+         */
+        inline static bool interruptRegistered = false;
+
+        /** @brief Handle DSP end interrupt
+         */
+        inline static void EndInterruptHandler()
+        {
+            ScuDsp::OnEnd.Invoke();
+        }
+
+        /** @brief Disable constructor
+         */
+        ScuDsp() = delete;
+
+        /** @brief Disable destructor
+         */
+        ~ScuDsp() = delete;
+
+    public:
+
+        /** @brief Number of words in program RAM
+         */
+        static constexpr size_t ProgramSize = 256;
+
+        /** @brief Number of words in single data RAM bank
+         */
+        static constexpr size_t DataBankSize = 64;
+
+        /** @brief Data RAM banks
+         */
+        enum class DataBank : uint8_t
+        {
+            /** @brief Data RAM 0 (M0)
+             */
+            Bank0 = 0,
+
+            /** @brief Data RAM 1 (M1)
+             */
+            Bank1 = 1,
+
+            /** @brief Data RAM 2 (M2)
+             */
+            Bank2 = 2,
+
+            /** @brief Data RAM 3 (M3)
+             */
+            Bank3 = 3
+        };
+
+        /** @brief Event triggered when DSP program ends with ENDI instruction
+         * @note Event is invoked from interrupt, enable it with SRL::ScuDsp::SetEndInterrupt()
+         */
+        inline static SRL::Types::Event<> OnEnd;
+
+        /** @brief Enable or disable DSP end interrupt, that invokes SRL::ScuDsp::OnEnd
+         * @param enabled Whether interrupt is enabled
+         */
+        inline static void SetEndInterrupt(const bool enabled)
+        {
+            if (enabled)
+            {
+                if (!ScuDsp::interruptRegistered)
+                {
+                    INT_SetScuFunc(INT_SCU_DSP, ScuDsp::EndInterruptHandler);
+                    ScuDsp::interruptRegistered = true;
+                }
+
+                INT_ChgMsk(INT_MSK_DSP, INT_MSK_NULL);
+            }
+            else
+            {
+                INT_ChgMsk(INT_MSK_NULL, INT_MSK_DSP);
+            }
+        }
+
+        /** @brief Stop currently running program
+         */
+        inline static void Stop()
+        {
+            *ScuDsp::ProgramControlPort = 0;
+        }
+
+        /** @brief Load program into program RAM
+         * @note Running program is stopped
+         * @param program Program instructions
+         * @param length Number of instructions
+         * @param address Program RAM address to load program at
+         */
+        inline static void LoadProgram(const uint32_t* program, const size_t length, const uint8_t address = 0)
+        {
+            ScuDsp::Stop();
+            *ScuDsp::ProgramControlPort = ScuDsp::LoadEnableFlag | address;
+
+            for (size_t instruction = 0; instruction < length && address + instruction < ScuDsp::ProgramSize; instruction++)
+            {
+                *ScuDsp::ProgramDataPort = program[instruction];
+            }
+        }
+
+        /** @brief Start program execution
+         * @param address Program RAM address to start execution at
+         */
+        inline static void Start(const uint8_t address = 0)
+        {
+            *ScuDsp::ProgramControlPort = ScuDsp::ExecuteFlag | ScuDsp::LoadEnableFlag | address;
+        }
+
+        /** @brief Check whether program is being executed
+         * @return true if DSP is running
+         */
+        inline static bool IsRunning()
+        {
+            return (*ScuDsp::ProgramControlPort & ScuDsp::ExecuteFlag) != 0;
+        }
+
+        /** @brief Wait until program execution ends
+         */
+        inline static void Wait()
+        {
+            while (ScuDsp::IsRunning());
+        }
+
+        /** @brief Write words into data RAM
+         * @warning DSP must be stopped
+         * @param bank Data RAM bank
+         * @param offset Word offset in the bank
+         * @param data Data to write
+         * @param count Number of words to write
+         */
+        inline static void WriteData(const ScuDsp::DataBank bank, const uint8_t offset, const uint32_t* data, const size_t count)
+        {
+            *ScuDsp::DataAddressPort = (static_cast<uint8_t>(bank) << 6) | (offset & 0x3f);
+
+            for (size_t word = 0; word < count && offset + word < ScuDsp::DataBankSize; word++)
+            {
+                *ScuDsp::DataDataPort = data[word];
+            }
+        }
+
+        /** @brief Write single word into data RAM
+         * @warning DSP must be stopped
+         * @param bank Data RAM bank
+         * @param offset Word offset in the bank
+         * @param value Value to write
+         */
+        inline static void WriteData(const ScuDsp::DataBank bank, const uint8_t offset, const uint32_t value)
+        {
+            ScuDsp::WriteData(bank, offset, &value, 1);
+        }
+
+        /** @brief Read words from data RAM
+         * @warning DSP must be stopped
+         * @param bank Data RAM bank
+         * @param offset Word offset in the bank
+         * @param data Buffer to read data into
+         * @param count Number of words to read
+         */
+        inline static void ReadData(const ScuDsp::DataBank bank, const uint8_t offset, uint32_t* data, const size_t count)
+        {
+            *ScuDsp::DataAddressPort = (static_cast<uint8_t>(bank) << 6) | (offset & 0x3f);
+
+            for (size_t word = 0; word < count && offset + word < ScuDsp::DataBankSize; word++)
+            {
+                data[word] = *ScuDsp::DataDataPort;
+            }
+        }
+
+        /** @brief Read single word from data RAM
+         * @warning DSP must be stopped
+         * @param bank Data RAM bank
+         * @param offset Word offset in the bank
+         * @return Read value
+         */
+        inline static uint32_t ReadData(const ScuDsp::DataBank bank, const uint8_t offset)
+        {
+            uint32_t value;
+            ScuDsp::ReadData(bank, offset, &value, 1);
+            return value;
+        }
+
+        /** @brief Convert CPU address to address used by the DSP DMA (RA0/WA0 registers)
+         * @note DSP DMA can access only work RAM-H, A-Bus and B-Bus
+         * @param address CPU address (cached or cache-through)
+         * @return DSP DMA address
+         */
+        inline static uint32_t ToDmaAddress(const void* address)
+        {
+            return (reinterpret_cast<uint32_t>(address) & 0x07ffffff) >> 2;
+        }
+
+        /** @brief Check whether memory can be accessed by the DSP DMA
+         * @param address Address to check
+         * @return true if address is in work RAM-H (cached or cache-through)
+         */
+        inline static bool IsDmaReachable(const void* address)
+        {
+            const uint32_t physical = reinterpret_cast<uint32_t>(address) & 0x0fffffff;
+            return physical >= 0x06000000 && physical < 0x08000000;
+        }
+
+        /** @brief Purge CPU cache lines covering specified memory area
+         * @details Must be called before CPU reads data written by the DSP DMA
+         * @param address Start of the memory area
+         * @param size Size of the memory area in bytes
+         */
+        inline static void PurgeCache(const void* address, const size_t size)
+        {
+            uint32_t line = reinterpret_cast<uint32_t>(address) & 0x07fffff0;
+            const uint32_t end = (reinterpret_cast<uint32_t>(address) & 0x07ffffff) + size;
+
+            for (; line < end; line += 16)
+            {
+                *reinterpret_cast<volatile uint32_t*>(0x40000000 | line) = 0;
+            }
+        }
+
+        /** @brief 3D point transformation kernel
+         * @details Transforms points by a matrix the same way as slCalcPoint() does.
+         * Work can be split between the DSP, slave CPU and master CPU with SRL::ScuDsp::PointTransform::TransformParallel().
+         * @code {.cpp}
+         * // Transform mesh vertices by current SGL matrix
+         * SRL::Math::Types::Vector3D* transformed = new SRL::Math::Types::Vector3D[mesh.VertexCount];
+         * SRL::ScuDsp::PointTransform::TransformParallel(mesh.Vertices, transformed, mesh.VertexCount);
+         * @endcode
+         * @warning Source and destination buffers must be in work RAM-H
+         */
+        class PointTransform
+        {
+        private:
+
+            /** @brief Transformation matrix rows in data RAM 0
+             */
+            static constexpr uint8_t MatrixOffset = 0;
+
+            /** @brief Scratch vertex copy in data RAM 3, followed by constant 1.0
+             */
+            static constexpr uint8_t ScratchOffset = 0;
+
+            /** @brief Batch parameters in data RAM 3 (source, destination, word count, vertex count - 1)
+             */
+            static constexpr uint8_t ParameterOffset = 4;
+
+            /** @brief Kernel program
+             * @details Data RAM layout:
+             * bank | offset | content
+             * -----|--------|--------
+             * M0   | 0-11   | Matrix rows (m00 m01 m02 m03, m10 ... m23)
+             * M1   | 0-62   | Input points
+             * M2   | 0-62   | Output points
+             * M3   | 0-2    | Current point copy
+             * M3   | 3      | 1.0 constant
+             * M3   | 4-7    | Source >> 2, destination >> 2, number of words, number of points - 1
+             */
+            inline static const uint32_t Program[] = {
+                0x00001F04, // 00: MOV #4,CT3
+                0x00003607, // 01: MOV MC3,RA0
+                0x00003707, // 02: MOV MC3,WA0
+                0x00001D00, // 03: MOV #0,CT1
+                0xC000A103, // 04: DMA D0,MC1,M3
+                0xD3400005, // 05: JMP T0,$05
+                0x00000000, // 06: NOP
+                0x00001F07, // 07: MOV #7,CT3
+                0x00003A03, // 08: MOV M3,LOP
+                0x00001D00, // 09: MOV #0,CT1
+                0x00001E00, // 0A: MOV #0,CT2
+                0x00001B0C, // 0B: MOV #$0C,TOP
+                0x00001F00, // 0C: MOV #0,CT3
+                0x00003305, // 0D: MOV MC1,MC3
+                0x00003305, // 0E: MOV MC1,MC3
+                0x00003305, // 0F: MOV MC1,MC3
+                0x00001C00, // 10: MOV #0,CT0
+                0x00001F00, // 11: MOV #0,CT3
+                0x0249C000, // 12: MOV MC0,X  MOV MC3,Y
+                0x034BC000, // 13: MOV MUL,P  MOV MC0,X  MOV MC3,Y  CLR A
+                0x1B4DC000, // 14: AD2  MOV MUL,P  MOV MC0,X  MOV MC3,Y  MOV ALU,A
+                0x1B4DC000, // 15: AD2  MOV MUL,P  MOV MC0,X  MOV MC3,Y  MOV ALU,A
+                0x19040000, // 16: AD2  MOV MUL,P  MOV ALU,A
+                0x18040000, // 17: AD2  MOV ALU,A
+                0x0000320A, // 18: MOV ALH,MC2
+                0x00001F00, // 19: MOV #0,CT3
+                0x0249C000, // 1A: MOV MC0,X  MOV MC3,Y
+                0x034BC000, // 1B: MOV MUL,P  MOV MC0,X  MOV MC3,Y  CLR A
+                0x1B4DC000, // 1C: AD2  MOV MUL,P  MOV MC0,X  MOV MC3,Y  MOV ALU,A
+                0x1B4DC000, // 1D: AD2  MOV MUL,P  MOV MC0,X  MOV MC3,Y  MOV ALU,A
+                0x19040000, // 1E: AD2  MOV MUL,P  MOV ALU,A
+                0x18040000, // 1F: AD2  MOV ALU,A
+                0x0000320A, // 20: MOV ALH,MC2
+                0x00001F00, // 21: MOV #0,CT3
+                0x0249C000, // 22: MOV MC0,X  MOV MC3,Y
+                0x034BC000, // 23: MOV MUL,P  MOV MC0,X  MOV MC3,Y  CLR A
+                0x1B4DC000, // 24: AD2  MOV MUL,P  MOV MC0,X  MOV MC3,Y  MOV ALU,A
+                0x1B4DC000, // 25: AD2  MOV MUL,P  MOV MC0,X  MOV MC3,Y  MOV ALU,A
+                0x19040000, // 26: AD2  MOV MUL,P  MOV ALU,A
+                0x18040000, // 27: AD2  MOV ALU,A
+                0x0000320A, // 28: MOV ALH,MC2
+                0xE0000000, // 29: BTM
+                0x00000000, // 2A: NOP
+                0x00001F06, // 2B: MOV #6,CT3
+                0x00001E00, // 2C: MOV #0,CT2
+                0xC000B203, // 2D: DMA MC2,D0,M3
+                0xD340002E, // 2E: JMP T0,$2E
+                0x00000000, // 2F: NOP
+                0xF8000000  // 30: ENDI
+            };
+
+            /** @brief Slave CPU part of the parallel transformation
+             */
+            class SlaveTransform : public SRL::Types::ITask
+            {
+            public:
+
+                /** @brief Transformation matrix
+                 */
+                const FIXED (*Matrix)[3];
+
+                /** @brief Source points
+                 */
+                const SRL::Math::Types::Vector3D* Source;
+
+                /** @brief Destination points
+                 */
+                SRL::Math::Types::Vector3D* Destination;
+
+                /** @brief Number of points
+                 */
+                size_t Count;
+
+            protected:
+
+                /** @brief Transform points on slave
+                 */
+                void Do() override
+                {
+                    // Task fields, matrix and source points were written by master
+                    slCashPurge();
+                    PointTransform::TransformOnCpu(this->Matrix, this->Source, this->Destination, this->Count);
+                }
+            };
+
+            /** @brief Currently transformed source points
+             */
+            inline static const SRL::Math::Types::Vector3D* source = nullptr;
+
+            /** @brief Currently transformed destination points
+             */
+            inline static SRL::Math::Types::Vector3D* destination = nullptr;
+
+            /** @brief Number of points left to be sent to the DSP
+             */
+            inline static size_t remaining = 0;
+
+            /** @brief Number of points in the batch currently processed by the DSP
+             */
+            inline static size_t inFlight = 0;
+
+            /** @brief Start DSP on next batch of points
+             */
+            inline static void StartBatch()
+            {
+                const size_t count = SRL::Math::Min<size_t>(PointTransform::remaining, PointTransform::MaxBatch);
+                const uint32_t parameters[4] = {
+                    ScuDsp::ToDmaAddress(PointTransform::source),
+                    ScuDsp::ToDmaAddress(PointTransform::destination),
+                    count * 3,
+                    count - 1
+                };
+
+                ScuDsp::WriteData(ScuDsp::DataBank::Bank3, PointTransform::ParameterOffset, parameters, 4);
+                ScuDsp::Start();
+
+                PointTransform::inFlight = count;
+                PointTransform::remaining -= count;
+            }
+
+        public:
+
+            /** @brief Maximal number of points transformed by a single DSP run
+             */
+            static constexpr size_t MaxBatch = ScuDsp::DataBankSize / 3;
+
+            /** @brief Transform points on the current CPU
+             * @param matrix Transformation matrix in SGL layout
+             * @param source Points to transform
+             * @param destination Transformed points
+             * @param count Number of points
+             */
+            inline static void TransformOnCpu(const FIXED matrix[4][3], const SRL::Math::Types::Vector3D* source, SRL::Math::Types::Vector3D* destination, const size_t count)
+            {
+                for (size_t point = 0; point < count; point++)
+                {
+                    const int64_t x = source[point].X.RawValue();
+                    const int64_t y = source[point].Y.RawValue();
+                    const int64_t z = source[point].Z.RawValue();
+
+                    destination[point] = SRL::Math::Types::Vector3D(
+                        SRL::Math::Types::Fxp::BuildRaw(static_cast<int32_t>(((x * matrix[0][0]) + (y * matrix[1][0]) + (z * matrix[2][0])) >> 16) + matrix[3][0]),
+                        SRL::Math::Types::Fxp::BuildRaw(static_cast<int32_t>(((x * matrix[0][1]) + (y * matrix[1][1]) + (z * matrix[2][1])) >> 16) + matrix[3][1]),
+                        SRL::Math::Types::Fxp::BuildRaw(static_cast<int32_t>(((x * matrix[0][2]) + (y * matrix[1][2]) + (z * matrix[2][2])) >> 16) + matrix[3][2]));
+                }
+            }
+
+            /** @brief Load kernel into the DSP and set transformation matrix
+             * @note Must be called again if another program was loaded into the DSP in the meantime
+             * @param matrix Transformation matrix in SGL layout
+             */
+            inline static void Load(const FIXED matrix[4][3])
+            {
+                ScuDsp::LoadProgram(PointTransform::Program, sizeof(PointTransform::Program) / sizeof(uint32_t));
+                PointTransform::SetMatrix(matrix);
+            }
+
+            /** @brief Load kernel into the DSP and set transformation matrix
+             * @param matrix Transformation matrix
+             */
+            inline static void Load(const SRL::Math::Matrix43& matrix)
+            {
+                PointTransform::Load((const FIXED(*)[3])&matrix);
+            }
+
+            /** @brief Load kernel into the DSP and use current SGL matrix
+             */
+            inline static void Load()
+            {
+                MATRIX current;
+                slGetMatrix(current);
+                PointTransform::Load(current);
+            }
+
+            /** @brief Set transformation matrix of already loaded kernel
+             * @warning DSP must be stopped
+             * @param matrix Transformation matrix in SGL layout
+             */
+            inline static void SetMatrix(const FIXED matrix[4][3])
+            {
+                uint32_t rows[12];
+
+                for (size_t row = 0; row < 3; row++)
+                {
+                    for (size_t column = 0; column < 4; column++)
+                    {
+                        rows[(row << 2) + column] = matrix[column][row];
+                    }
+                }
+
+                ScuDsp::WriteData(ScuDsp::DataBank::Bank0, PointTransform::MatrixOffset, rows, 12);
+                ScuDsp::WriteData(ScuDsp::DataBank::Bank3, PointTransform::ScratchOffset + 3, static_cast<uint32_t>(1 << 16));
+            }
+
+            /** @brief Start asynchronous transformation of points on the DSP
+             * @note SRL::ScuDsp::PointTransform::Update() must be called until SRL::ScuDsp::PointTransform::IsDone() returns true
+             * @param source Points to transform (must be in work RAM-H)
+             * @param destination Transformed points (must be in work RAM-H)
+             * @param count Number of points
+             */
+            inline static void Begin(const SRL::Math::Types::Vector3D* source, SRL::Math::Types::Vector3D* destination, const size_t count)
+            {
+                if (count > 0 && (!ScuDsp::IsDmaReachable(source) || !ScuDsp::IsDmaReachable(destination)))
+                {
+                    SRL::Debug::Assert("DSP point transform buffers must be in work RAM-H");
+                }
+
+                PointTransform::source = source;
+                PointTransform::destination = destination;
+                PointTransform::remaining = count;
+                PointTransform::inFlight = 0;
+
+                if (count > 0)
+                {
+                    PointTransform::StartBatch();
+                }
+            }
+
+            /** @brief Feed next batch to the DSP if the previous one is done
+             * @return true if all points were transformed
+             */
+            inline static bool Update()
+            {
+                if (PointTransform::inFlight > 0 && !ScuDsp::IsRunning())
+                {
+                    ScuDsp::PurgeCache(PointTransform::destination, PointTransform::inFlight * sizeof(SRL::Math::Types::Vector3D));
+                    PointTransform::source += PointTransform::inFlight;
+                    PointTransform::destination += PointTransform::inFlight;
+                    PointTransform::inFlight = 0;
+
+                    if (PointTransform::remaining > 0)
+                    {
+                        PointTransform::StartBatch();
+                    }
+                }
+
+                return PointTransform::IsDone();
+            }
+
+            /** @brief Check whether asynchronous transformation is done
+             * @return true if all points were transformed
+             */
+            inline static bool IsDone()
+            {
+                return PointTransform::inFlight == 0 && PointTransform::remaining == 0;
+            }
+
+            /** @brief Transform points on the DSP and wait for the result
+             * @note Kernel must be loaded with SRL::ScuDsp::PointTransform::Load()
+             * @param source Points to transform (must be in work RAM-H)
+             * @param destination Transformed points (must be in work RAM-H)
+             * @param count Number of points
+             */
+            inline static void Transform(const SRL::Math::Types::Vector3D* source, SRL::Math::Types::Vector3D* destination, const size_t count)
+            {
+                PointTransform::Begin(source, destination, count);
+                while (!PointTransform::Update());
+            }
+
+            /** @brief Transform points with the DSP, slave CPU and master CPU at the same time
+             * @details Loads the kernel, points are split between the processors by given weights, master CPU keeps feeding the DSP between its own chunks.
+             * @param matrix Transformation matrix in SGL layout
+             * @param source Points to transform (must be in work RAM-H)
+             * @param destination Transformed points (must be in work RAM-H)
+             * @param count Number of points
+             * @param dspShare Share of points processed by the DSP (0-256)
+             * @param slaveShare Share of points processed by the slave CPU (0-256)
+             */
+            inline static void TransformParallel(
+                const FIXED matrix[4][3],
+                const SRL::Math::Types::Vector3D* source,
+                SRL::Math::Types::Vector3D* destination,
+                const size_t count,
+                const uint16_t dspShare = 64,
+                const uint16_t slaveShare = 96)
+            {
+                const size_t dspCount = (count * dspShare) >> 8;
+                const size_t slaveCount = SRL::Math::Min<size_t>((count * slaveShare) >> 8, count - dspCount);
+                const size_t masterStart = dspCount + slaveCount;
+
+                // DSP takes the first part
+                PointTransform::Load(matrix);
+                PointTransform::Begin(source, destination, dspCount);
+
+                // Slave takes the second part
+                static PointTransform::SlaveTransform slaveTask;
+
+                if (slaveCount > 0)
+                {
+                    slaveTask.Matrix = matrix;
+                    slaveTask.Source = source + dspCount;
+                    slaveTask.Destination = destination + dspCount;
+                    slaveTask.Count = slaveCount;
+                    SRL::Slave::ExecuteOnSlave(slaveTask);
+                }
+
+                // Master does the rest in small chunks, so DSP does not stay idle for long
+                for (size_t point = masterStart; point < count; point += PointTransform::MaxBatch)
+                {
+                    PointTransform::TransformOnCpu(matrix, source + point, destination + point, SRL::Math::Min<size_t>(PointTransform::MaxBatch, count - point));
+                    PointTransform::Update();
+                }
+
+                while (!PointTransform::Update());
+
+                if (slaveCount > 0)
+                {
+                    while (!slaveTask.IsDone());
+
+                    // Slave results may still be in master cache from before
+                    slCashPurge();
+                }
+            }
+
+            /** @brief Transform points with the DSP, slave CPU and master CPU at the same time using current SGL matrix
+             * @param source Points to transform (must be in work RAM-H)
+             * @param destination Transformed points (must be in work RAM-H)
+             * @param count Number of points
+             * @param dspShare Share of points processed by the DSP (0-256)
+             * @param slaveShare Share of points processed by the slave CPU (0-256)
+             */
+            inline static void TransformParallel(
+                const SRL::Math::Types::Vector3D* source,
+                SRL::Math::Types::Vector3D* destination,
+                const size_t count,
+                const uint16_t dspShare = 64,
+                const uint16_t slaveShare = 96)
+            {
+                static MATRIX current;
+                slGetMatrix(current);
+                PointTransform::TransformParallel(current, source, destination, count, dspShare, slaveShare);
+            }
+        };
+    };
+}
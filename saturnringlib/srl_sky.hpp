@@ -0,0 +1,288 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_scene3d.hpp"
+#include "srl_tilemap_interfaces.hpp"
+#include "srl_tv.hpp"
+#include "srl_vdp2.hpp"
+
+/** @brief Sky and horizon drawn by VDP2 scroll screens
+ */
+namespace SRL::Sky
+{
+    /** @brief Camera orientation followed by sky layers
+     * @details Yaw of 0 looks along positive Z axis and grows towards positive X axis.
+     * Positive pitch looks up (towards negative Y axis, same as SRL::Scene3D).
+     */
+    struct Orientation
+    {
+        /** @brief Rotation around vertical axis
+         */
+        Math::Types::Angle Yaw;
+
+        /** @brief Rotation above or below the horizon
+         */
+        Math::Types::Angle Pitch;
+
+        /** @brief Rotation around line of sight
+         */
+        Math::Types::Angle Roll;
+
+        /** @brief Construct orientation looking along positive Z axis
+         */
+        Orientation() : Yaw(Math::Types::Angle::Zero()), Pitch(Math::Types::Angle::Zero()), Roll(Math::Types::Angle::Zero())
+        {
+            // Do nothing
+        }
+
+        /** @brief Construct orientation from angles
+         * @param yaw Rotation around vertical axis
+         * @param pitch Rotation above or below the horizon
+         * @param roll Rotation around line of sight
+         */
+        Orientation(const Math::Types::Angle& yaw, const Math::Types::Angle& pitch, const Math::Types::Angle& roll = Math::Types::Angle::Zero()) :
+            Yaw(yaw),
+            Pitch(pitch),
+            Roll(roll)
+        {
+            // Do nothing
+        }
+
+        /** @brief Get orientation of camera set by SRL::Scene3D::LookAt()
+         * @param camera Camera location
+         * @param target Target point
+         * @param roll Rotation around the line of sight vector
+         * @return Camera orientation
+         */
+        static Orientation FromLookAt(
+            const Math::Types::Vector3D& camera,
+            const Math::Types::Vector3D& target,
+            const Math::Types::Angle& roll = Math::Types::Angle::Zero())
+        {
+            const int64_t x = static_cast<int64_t>(target.X.RawValue()) - camera.X.RawValue();
+            const int64_t y = static_cast<int64_t>(target.Y.RawValue()) - camera.Y.RawValue();
+            const int64_t z = static_cast<int64_t>(target.Z.RawValue()) - camera.Z.RawValue();
+
+            // Length of the direction projected onto the ground plane
+            uint64_t square = (x * x) + (z * z);
+            uint64_t length = 0;
+
+            for (uint64_t bit = static_cast<uint64_t>(1) << 62; bit != 0; bit >>= 2)
+            {
+                if (square >= length + bit)
+                {
+                    square -= length + bit;
+                    length = (length >> 1) + bit;
+                }
+                else
+                {
+                    length >>= 1;
+                }
+            }
+
+            return Orientation(
+                Math::Types::Angle::BuildRaw(Orientation::Atan2(x, z)),
+                Math::Types::Angle::BuildRaw(Orientation::Atan2(-y, static_cast<int64_t>(length))),
+                roll);
+        }
+
+    private:
+
+        /** @brief Get angle of a vector
+         * @details Uses polynomial approximation of arctangent on one octant, error is below 0.1 degree
+         * @param y Vector Y component
+         * @param x Vector X component
+         * @return Angle in 1/65536 of a turn
+         */
+        static uint16_t Atan2(const int64_t y, const int64_t x)
+        {
+            if (x == 0 && y == 0)
+            {
+                return 0;
+            }
+
+            const int64_t absoluteX = x < 0 ? -x : x;
+            const int64_t absoluteY = y < 0 ? -y : y;
+            const int64_t ratio = absoluteX >= absoluteY ? (absoluteY << 16) / absoluteX : (absoluteX << 16) / absoluteY;
+
+            // atan(r) = r * pi/4 + r * (1 - r) * (0.2447 + 0.0663 * r), scaled to 0x10000 per turn
+            int32_t angle = static_cast<int32_t>(((ratio * 8192) + ((((ratio * (0x10000 - ratio)) >> 16) * (2552 + ((691 * ratio) >> 16))))) >> 16);
+
+            if (absoluteY > absoluteX)
+            {
+                angle = 0x4000 - angle;
+            }
+
+            if (x < 0)
+            {
+                angle = 0x8000 - angle;
+            }
+
+            if (y < 0)
+            {
+                angle = -angle;
+            }
+
+            return static_cast<uint16_t>(angle);
+        }
+    };
+
+    /** @brief Panorama on a normal scroll screen that follows camera rotation
+     * @details Turning the camera scrolls the panorama horizontally, one full turn scrolls it by its whole width,
+     * so the panorama has to wrap around seamlessly at that width (512 pixels for one page of 16x16 tiles).
+     * Looking up or down moves the panorama vertically, so its horizon row stays on the projected horizon of SRL::Scene3D.
+     * Angular speed of the panorama matches the 3D scene when its width is close to 2 * pi * MsScreenDist
+     * (about 1000 pixels at 90 degree perspective), narrower panoramas turn slower than the scene.
+     * @note Scroll screens cannot rotate around line of sight, roll is ignored. Use SRL::Sky::Plane for rolling camera.
+     * @tparam Screen Normal scroll screen (SRL::VDP2::NBG0 to SRL::VDP2::NBG3)
+     * @code {.cpp}
+     * SRL::Sky::Panorama<SRL::VDP2::NBG0> sky(512, 200);
+     * sky.Load(panoramaBitmap);
+     *
+     * // Each frame, with same camera as the 3D scene
+     * SRL::Scene3D::LookAt(camera, target, 0);
+     * sky.Update(SRL::Sky::Orientation::FromLookAt(camera, target));
+     * @endcode
+     */
+    template<class Screen>
+    class Panorama
+    {
+    private:
+
+        /** @brief Largest pitch used for projection of the horizon (80 degrees)
+         */
+        static constexpr int32_t MaxPitch = 0x38e3;
+
+        /** @brief Panorama width in pixels (scrolled by one full turn)
+         */
+        uint16_t width;
+
+        /** @brief Row of the panorama at the horizon
+         */
+        int16_t horizon;
+
+    public:
+
+        /** @brief Create panorama
+         * @param width Panorama width in pixels, scrolled by one full turn of the camera
+         * @param horizon Row of the panorama that lies on the horizon
+         */
+        Panorama(const uint16_t width, const int16_t horizon) : width(width), horizon(horizon)
+        {
+            // Do nothing
+        }
+
+        /** @brief Load panorama tilemap and display it behind everything else
+         * @param tilemap Panorama tilemap
+         * @param priority Scroll screen priority
+         */
+        void Load(Tilemap::ITilemap& tilemap, const VDP2::Priority priority = VDP2::Priority::Layer1)
+        {
+            Screen::LoadTilemap(tilemap);
+            Screen::SetPriority(priority);
+            Screen::ScrollEnable();
+        }
+
+        /** @brief Convert panorama bitmap to tiles, load it and display it behind everything else
+         * @note Bitmap is limited to 512x512 pixels (see SRL::Tilemap::Interfaces::Bmp2Tile), tiles are not kept after loading
+         * @param bitmap Panorama image
+         * @param priority Scroll screen priority
+         */
+        void Load(Bitmap::IBitmap& bitmap, const VDP2::Priority priority = VDP2::Priority::Layer1)
+        {
+            Tilemap::Interfaces::Bmp2Tile tilemap(bitmap);
+            this->Load(tilemap, priority);
+        }
+
+        /** @brief Get scroll position for camera orientation
+         * @param orientation Camera orientation
+         * @return Scroll position of the screen
+         */
+        Math::Types::Vector2D GetPosition(const Orientation& orientation) const
+        {
+            // Panorama column in the middle of the screen follows yaw
+            const int32_t wrap = this->width << 16;
+            int32_t x = (static_cast<int32_t>(orientation.Yaw.RawValue() & 0xffff) * this->width) - ((TV::Width >> 1) << 16);
+            x = ((x % wrap) + wrap) % wrap;
+
+            // Horizon is projected at screen distance times tangent of the pitch below screen center
+            int32_t pitch = static_cast<int16_t>(orientation.Pitch.RawValue());
+            pitch = Math::Max<int32_t>(-Panorama::MaxPitch, Math::Min<int32_t>(pitch, Panorama::MaxPitch));
+
+            const Math::Types::Angle clamped = Math::Types::Angle::BuildRaw(static_cast<uint16_t>(pitch));
+            const int32_t sin = Math::Trigonometry::Sin(clamped).RawValue();
+            const int32_t cos = Math::Trigonometry::Cos(clamped).RawValue();
+            const int32_t screenHorizon = ((TV::Height >> 1) << 16) + static_cast<int32_t>((static_cast<int64_t>(MsScreenDist) * sin) / cos);
+
+            return Math::Types::Vector2D(
+                Math::Types::Fxp::BuildRaw(x),
+                Math::Types::Fxp::BuildRaw((this->horizon << 16) - screenHorizon));
+        }
+
+        /** @brief Scroll panorama to match camera orientation
+         * @param orientation Camera orientation
+         */
+        void Update(const Orientation& orientation)
+        {
+            Math::Types::Vector2D position = this->GetPosition(orientation);
+            Screen::SetPosition(position);
+        }
+    };
+
+    /** @brief Cloud layer or ground on rotating scroll screen that follows camera orientation
+     * @details Plane is tilted by the camera pitch and turned by its yaw through RBG0 rotation parameters,
+     * same way as in the RBG0 rotation sample. Camera position scrolls the plane, so it drifts as the camera moves.
+     * RBG0 has to be loaded with SRL::VDP2::RotationMode::TwoAxis, or ThreeAxis when roll is used.
+     * @code {.cpp}
+     * SRL::VDP2::RBG0::SetRotationMode(SRL::VDP2::RotationMode::TwoAxis);
+     * SRL::VDP2::RBG0::LoadTilemap(clouds);
+     * SRL::VDP2::RBG0::ScrollEnable();
+     *
+     * // Each frame
+     * SRL::Sky::Plane::Update(SRL::Sky::Orientation::FromLookAt(camera, target), camera, 100.0, true);
+     * @endcode
+     */
+    class Plane
+    {
+        /** @brief Make class purely static
+         */
+        Plane() = delete;
+
+        /** @brief Make class purely static
+         */
+        ~Plane() = delete;
+
+    public:
+
+        /** @brief Set RBG0 rotation parameters from camera
+         * @param orientation Camera orientation
+         * @param camera Camera location, X and Z scroll the plane
+         * @param altitude Distance between camera and the plane
+         * @param ceiling True for plane above camera (clouds), false for plane below it (ground)
+         * @param scale Number of plane pixels per unit of camera movement
+         */
+        static void Update(
+            const Orientation& orientation,
+            const Math::Types::Vector3D& camera,
+            const Math::Types::Fxp altitude,
+            const bool ceiling,
+            const Math::Types::Fxp scale = 1.0)
+        {
+            Scene3D::PushMatrix();
+            {
+                Scene3D::Translate(0.0, ceiling ? Math::Types::Fxp::BuildRaw(-altitude.RawValue()) : altitude, Math::Types::Fxp::BuildRaw(MsScreenDist));
+                Scene3D::RotateZ(orientation.Roll);
+
+                // Plane faces the screen, lay it down above or below the camera and tilt it by pitch
+                Scene3D::RotateX(Math::Types::Angle::BuildRaw(static_cast<uint16_t>((ceiling ? -0x4000 : 0x4000) + orientation.Pitch.RawValue())));
+                Scene3D::RotateZ(orientation.Yaw);
+                Scene3D::Translate(
+                    Math::Types::Fxp::BuildRaw(-static_cast<int32_t>((static_cast<int64_t>(camera.X.RawValue()) * scale.RawValue()) >> 16)),
+                    Math::Types::Fxp::BuildRaw(-static_cast<int32_t>((static_cast<int64_t>(camera.Z.RawValue()) * scale.RawValue()) >> 16)),
+                    0.0);
+                VDP2::RBG0::SetCurrentTransform();
+            }
+            Scene3D::PopMatrix();
+        }
+    };
+}
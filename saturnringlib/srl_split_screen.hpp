@@ -0,0 +1,577 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_memory.hpp"
+#include "srl_mesh.hpp"
+#include "srl_renderer.hpp"
+#include "srl_scene3d.hpp"
+#include "srl_slave.hpp"
+#include "srl_tv.hpp"
+
+namespace SRL
+{
+    /** @brief Split screen drawing of one scene from several cameras
+     * @details Objects are added once per frame with their world transformation, every viewport combines it with its own camera,
+     * culls object bounding spheres against its own frustum and draws the visible ones with its own SRL::Renderer3D limited to the viewport.
+     * Viewports are split between CPUs, slave CPU draws the first half of them while master CPU draws the rest, command tables are then
+     * submitted to SGL by master CPU.
+     *
+     * Each viewport keeps horizontal field of view set by SRL::Scene3D::SetPerspective(), so narrower viewports use shorter focal length.
+     * @note Object transformation should not contain the camera, call SRL::Scene3D::LoadIdentity() before placing objects
+     * @code {.cpp}
+     * // Two players, up to 64 objects, 1000 vertices per mesh and 1500 commands per viewport
+     * SRL::SplitScreen screen(2, 64, 1000, 1500);
+     *
+     * // Each frame
+     * screen.SetCamera(0, playerOne.Camera, playerOne.Position, SRL::Math::Types::Angle::FromDegrees(0.0));
+     * screen.SetCamera(1, playerTwo.Camera, playerTwo.Position, SRL::Math::Types::Angle::FromDegrees(0.0));
+     * screen.Begin();
+     *
+     * for (Car& car : cars)
+     * {
+     *     SRL::Scene3D::LoadIdentity();
+     *     SRL::Scene3D::Translate(car.Position);
+     *     SRL::Scene3D::RotateY(car.Heading);
+     *     screen.Add(car.Mesh, car.Radius);
+     * }
+     *
+     * screen.End();
+     * SRL::Core::Synchronize();
+     * @endcode
+     */
+    class SplitScreen
+    {
+    public:
+
+        /** @brief Maximal number of viewports
+         */
+        static constexpr uint8_t MaxViewports = 4;
+
+    private:
+
+        /** @brief Object added this frame
+         */
+        struct Object
+        {
+            /** @brief Flat shaded mesh, nullptr if object is smooth mesh
+             */
+            const Types::Mesh* FlatMesh;
+
+            /** @brief Smooth mesh, nullptr if object is flat shaded mesh
+             */
+            const Types::SmoothMesh* SmoothMesh;
+
+            /** @brief World transformation
+             */
+            FIXED Matrix[4][3];
+
+            /** @brief Radius of bounding sphere around object origin as raw value
+             */
+            int32_t Radius;
+        };
+
+        /** @brief Viewport
+         */
+        struct Viewport
+        {
+            /** @brief Renderer limited to the viewport
+             */
+            Renderer3D* Renderer;
+
+            /** @brief Camera transformation
+             */
+            FIXED View[4][3];
+
+            /** @brief Half of viewport width in pixels
+             */
+            int32_t HalfWidth;
+
+            /** @brief Half of viewport height in pixels
+             */
+            int32_t HalfHeight;
+
+            /** @brief Focal length in pixels
+             */
+            int32_t FocalLength;
+
+            /** @brief Length of left and right plane normal (FocalLength, HalfWidth)
+             */
+            int32_t SideLength;
+
+            /** @brief Length of top and bottom plane normal (FocalLength, HalfHeight)
+             */
+            int32_t EdgeLength;
+
+            /** @brief Number of objects culled in the last frame
+             */
+            uint16_t Culled;
+        };
+
+        /** @brief Viewports drawn on slave CPU
+         */
+        class ViewportTask : public Types::ITask
+        {
+        public:
+
+            /** @brief Split screen to draw viewports of
+             */
+            SplitScreen* Screen;
+
+            /** @brief Number of viewports drawn on slave, starting from the first one
+             */
+            uint8_t Count;
+
+        protected:
+
+            /** @brief Draw viewports on slave
+             */
+            void Do() override
+            {
+                // Objects and cameras were written by master
+                slCashPurge();
+
+                for (uint8_t viewport = 0; viewport < this->Count; viewport++)
+                {
+                    this->Screen->DrawViewport(viewport);
+                }
+            }
+        };
+
+        /** @brief Viewports
+         */
+        Viewport viewports[SplitScreen::MaxViewports];
+
+        /** @brief Number of viewports
+         */
+        uint8_t viewportCount;
+
+        /** @brief Objects added this frame
+         */
+        Object* objects;
+
+        /** @brief Number of objects added this frame
+         */
+        size_t objectCount;
+
+        /** @brief Maximal number of objects per frame
+         */
+        size_t maxObjects;
+
+        /** @brief Near plane distance
+         */
+        Math::Types::Fxp nearPlane;
+
+        /** @brief Far plane distance
+         */
+        Math::Types::Fxp farPlane;
+
+        /** @brief Light direction in world space
+         */
+        Math::Types::Vector3D lightDirection;
+
+        /** @brief Gouraud table entry of the darkest light level
+         */
+        uint16_t lightEntry;
+
+        /** @brief Is flat light enabled
+         */
+        bool hasLight;
+
+        /** @brief Slave CPU task
+         */
+        SplitScreen::ViewportTask task;
+
+        /** @brief Integer square root
+         * @param value Value
+         * @return Square root rounded down
+         */
+        static int32_t SquareRoot(const int32_t value)
+        {
+            // Digit by digit method
+            int32_t root = 0;
+            int32_t remainder = value;
+            int32_t bit = 1 << 30;
+
+            while (bit > remainder)
+            {
+                bit >>= 2;
+            }
+
+            while (bit != 0)
+            {
+                if (remainder >= root + bit)
+                {
+                    remainder -= root + bit;
+                    root = (root >> 1) + bit;
+                }
+                else
+                {
+                    root >>= 1;
+                }
+
+                bit >>= 2;
+            }
+
+            return root;
+        }
+
+        /** @brief Combine world transformation with camera
+         * @param world World transformation
+         * @param view Camera transformation
+         * @param result Transformation into view space
+         */
+        static void Multiply(const FIXED world[4][3], const FIXED view[4][3], FIXED result[4][3])
+        {
+            for (size_t row = 0; row < 4; row++)
+            {
+                for (size_t column = 0; column < 3; column++)
+                {
+                    const int64_t value =
+                        (static_cast<int64_t>(world[row][0]) * view[0][column]) +
+                        (static_cast<int64_t>(world[row][1]) * view[1][column]) +
+                        (static_cast<int64_t>(world[row][2]) * view[2][column]);
+
+                    result[row][column] = static_cast<FIXED>(value >> 16) + (row == 3 ? view[3][column] : 0);
+                }
+            }
+        }
+
+        /** @brief Check whether bounding sphere intersects viewport frustum
+         * @param viewport Viewport
+         * @param position Sphere center in view space
+         * @param radius Sphere radius as raw value
+         * @return True if sphere is at least partially visible
+         */
+        bool IsVisible(const Viewport& viewport, const FIXED position[3], const int32_t radius) const
+        {
+            const int64_t x = position[0] < 0 ? -static_cast<int64_t>(position[0]) : position[0];
+            const int64_t y = position[1] < 0 ? -static_cast<int64_t>(position[1]) : position[1];
+            const int64_t z = position[2];
+
+            if (z + radius < this->nearPlane.RawValue() || z - radius > this->farPlane.RawValue())
+            {
+                return false;
+            }
+
+            // Distance from side planes scaled by length of their normals
+            if ((x * viewport.FocalLength) - (z * viewport.HalfWidth) > static_cast<int64_t>(radius) * viewport.SideLength)
+            {
+                return false;
+            }
+
+            return (y * viewport.FocalLength) - (z * viewport.HalfHeight) <= static_cast<int64_t>(radius) * viewport.EdgeLength;
+        }
+
+        /** @brief Cull and draw objects of one viewport
+         * @param index Viewport index
+         */
+        void DrawViewport(const uint8_t index)
+        {
+            Viewport& viewport = this->viewports[index];
+            Renderer3D& renderer = *viewport.Renderer;
+            FIXED matrix[4][3];
+            viewport.Culled = 0;
+            renderer.Begin();
+
+            for (size_t object = 0; object < this->objectCount; object++)
+            {
+                const Object& current = this->objects[object];
+                SplitScreen::Multiply(current.Matrix, viewport.View, matrix);
+
+                if (!this->IsVisible(viewport, matrix[3], current.Radius))
+                {
+                    viewport.Culled++;
+                    continue;
+                }
+
+                if (current.FlatMesh != nullptr)
+                {
+                    renderer.Draw(*current.FlatMesh, matrix);
+                }
+                else
+                {
+                    renderer.Draw(*current.SmoothMesh, matrix);
+                }
+            }
+
+            renderer.Finish();
+        }
+
+    public:
+
+        /** @brief Construct split screen
+         * @details Screen is split into equal viewports, two viewports are stacked, third one takes the top half and splits bottom half with the second one,
+         * four viewports are quarters of the screen. Each viewport allocates its own command tables in VDP1 memory.
+         * @param viewportCount Number of viewports (1-4)
+         * @param maxObjects Maximal number of objects per frame
+         * @param maxVertices Maximal number of vertices of a single mesh
+         * @param maxCommands Maximal number of VDP1 commands per viewport and frame
+         * @param zone Memory zone to allocate work buffers in
+         */
+        SplitScreen(const uint8_t viewportCount, const size_t maxObjects, const size_t maxVertices, const size_t maxCommands, const Memory::Zone zone = Memory::Zone::HWRam) :
+            viewportCount(Math::Clamp<uint8_t>(viewportCount, 1, SplitScreen::MaxViewports)),
+            objectCount(0),
+            maxObjects(maxObjects),
+            nearPlane(1.0),
+            farPlane(4000.0),
+            lightDirection(),
+            lightEntry(0),
+            hasLight(false)
+        {
+            this->objects = reinterpret_cast<Object*>(Memory::Malloc(sizeof(Object) * Math::Max<size_t>(1, maxObjects), zone));
+            this->task.Screen = this;
+
+            const int16_t width = TV::Width;
+            const int16_t height = TV::Height;
+
+            // Left, top, right and bottom edge of each viewport for each viewport count
+            const int16_t layouts[SplitScreen::MaxViewports][SplitScreen::MaxViewports][4] = {
+                { { 0, 0, width, height } },
+                { { 0, 0, width, height >> 1 }, { 0, height >> 1, width, height } },
+                { { 0, 0, width, height >> 1 }, { 0, height >> 1, width >> 1, height }, { width >> 1, height >> 1, width, height } },
+                { { 0, 0, width >> 1, height >> 1 }, { width >> 1, 0, width, height >> 1 }, { 0, height >> 1, width >> 1, height }, { width >> 1, height >> 1, width, height } } };
+
+            for (uint8_t index = 0; index < this->viewportCount; index++)
+            {
+                Viewport& viewport = this->viewports[index];
+                const int16_t* edges = layouts[this->viewportCount - 1][index];
+                viewport.Renderer = new Renderer3D(maxVertices, maxCommands, zone);
+                viewport.Culled = 0;
+                this->SetViewport(index, edges[0], edges[1], edges[2] - 1, edges[3] - 1);
+
+                // Slave is busy with its own viewports
+                viewport.Renderer->SetSlaveShare(this->viewportCount > 1 ? 0 : 128);
+
+                for (size_t row = 0; row < 4; row++)
+                {
+                    for (size_t column = 0; column < 3; column++)
+                    {
+                        viewport.View[row][column] = row == column ? (1 << 16) : 0;
+                    }
+                }
+            }
+        }
+
+        /** @brief Disable copying
+         */
+        SplitScreen(const SplitScreen&) = delete;
+
+        /** @brief Disable copying
+         */
+        SplitScreen& operator=(const SplitScreen&) = delete;
+
+        /** @brief Destroy split screen
+         * @note Command tables stay allocated in VDP1 memory until texture heap is reset
+         */
+        ~SplitScreen()
+        {
+            for (uint8_t index = 0; index < this->viewportCount; index++)
+            {
+                delete this->viewports[index].Renderer;
+            }
+
+            Memory::Free(this->objects);
+        }
+
+        /** @brief Change area of a viewport
+         * @param index Viewport index
+         * @param left Left edge in screen pixels
+         * @param top Top edge in screen pixels
+         * @param right Right edge in screen pixels (inclusive)
+         * @param bottom Bottom edge in screen pixels (inclusive)
+         */
+        void SetViewport(const uint8_t index, const int16_t left, const int16_t top, const int16_t right, const int16_t bottom)
+        {
+            if (index >= this->viewportCount)
+            {
+                return;
+            }
+
+            Viewport& viewport = this->viewports[index];
+            viewport.HalfWidth = Math::Max<int32_t>(1, (right - left + 1) >> 1);
+            viewport.HalfHeight = Math::Max<int32_t>(1, (bottom - top + 1) >> 1);
+            viewport.Renderer->SetViewport(left, top, right, bottom);
+        }
+
+        /** @brief Place camera of a viewport
+         * @param index Viewport index
+         * @param camera Camera location
+         * @param target Point camera looks at
+         * @param roll Camera roll
+         */
+        void SetCamera(const uint8_t index, const Math::Types::Vector3D& camera, const Math::Types::Vector3D& target, const Math::Types::Angle& roll)
+        {
+            if (index >= this->viewportCount)
+            {
+                return;
+            }
+
+            Scene3D::PushMatrix();
+            Scene3D::LoadIdentity();
+            Scene3D::LookAt(camera, target, roll);
+            slGetMatrix(this->viewports[index].View);
+            Scene3D::PopMatrix();
+        }
+
+        /** @brief Set distance of near and far planes of all viewports
+         * @param nearPlane Near plane distance (must be greater than 0)
+         * @param farPlane Far plane distance
+         */
+        void SetDepthRange(const Math::Types::Fxp& nearPlane, const Math::Types::Fxp& farPlane)
+        {
+            this->nearPlane = nearPlane;
+            this->farPlane = farPlane;
+
+            for (uint8_t index = 0; index < this->viewportCount; index++)
+            {
+                this->viewports[index].Renderer->SetDepthRange(nearPlane, farPlane);
+            }
+        }
+
+        /** @brief Enable flat light on faces with SRL::Types::Attribute::DisplayOption::EnableFlatLight in all viewports
+         * @param direction Direction the light travels in world space (unit vector)
+         * @param firstEntry First of SRL::Renderer3D::LightLevels gouraud table entries used by light levels
+         */
+        void SetDirectionalLight(const Math::Types::Vector3D& direction, const uint16_t firstEntry)
+        {
+            this->lightDirection = direction;
+            this->lightEntry = firstEntry;
+            this->hasLight = true;
+        }
+
+        /** @brief Disable flat light in all viewports
+         */
+        void DisableLight()
+        {
+            this->hasLight = false;
+
+            for (uint8_t index = 0; index < this->viewportCount; index++)
+            {
+                this->viewports[index].Renderer->DisableLight();
+            }
+        }
+
+        /** @brief Start new frame
+         */
+        void Begin()
+        {
+            this->objectCount = 0;
+        }
+
+        /** @brief Add object with current matrix as its world transformation
+         * @param mesh Object mesh
+         * @param radius Radius of bounding sphere around object origin
+         * @return True on success, false if there are too many objects
+         */
+        bool Add(const Types::Mesh& mesh, const Math::Types::Fxp& radius)
+        {
+            if (this->objectCount >= this->maxObjects)
+            {
+                return false;
+            }
+
+            Object& object = this->objects[this->objectCount++];
+            object.FlatMesh = &mesh;
+            object.SmoothMesh = nullptr;
+            object.Radius = radius.RawValue();
+            slGetMatrix(object.Matrix);
+            return true;
+        }
+
+        /** @brief Add object with current matrix as its world transformation
+         * @note Vertex normals are not used, faces are shaded by their gouraud table entries
+         * @param mesh Object mesh
+         * @param radius Radius of bounding sphere around object origin
+         * @return True on success, false if there are too many objects
+         */
+        bool Add(const Types::SmoothMesh& mesh, const Math::Types::Fxp& radius)
+        {
+            if (this->objectCount >= this->maxObjects)
+            {
+                return false;
+            }
+
+            Object& object = this->objects[this->objectCount++];
+            object.FlatMesh = nullptr;
+            object.SmoothMesh = &mesh;
+            object.Radius = radius.RawValue();
+            slGetMatrix(object.Matrix);
+            return true;
+        }
+
+        /** @brief Draw all viewports and submit them to VDP1
+         * @param sort Z order of the viewports among sprites and polygons drawn by SGL
+         */
+        void End(const Math::Types::Fxp& sort = 1000.0)
+        {
+            // Focal length follows current perspective, read on master since it is SGL state
+            const int32_t screenFocal = MsScreenDist >> 16;
+
+            for (uint8_t index = 0; index < this->viewportCount; index++)
+            {
+                Viewport& viewport = this->viewports[index];
+                viewport.FocalLength = Math::Max<int32_t>(1, (screenFocal * (viewport.HalfWidth << 1)) / TV::Width);
+                viewport.SideLength = SplitScreen::SquareRoot((viewport.FocalLength * viewport.FocalLength) + (viewport.HalfWidth * viewport.HalfWidth));
+                viewport.EdgeLength = SplitScreen::SquareRoot((viewport.FocalLength * viewport.FocalLength) + (viewport.HalfHeight * viewport.HalfHeight));
+                viewport.Renderer->SetFocalLength(Math::Types::Fxp::BuildRaw(viewport.FocalLength << 16));
+
+                if (this->hasLight)
+                {
+                    viewport.Renderer->SetDirectionalLight(this->lightDirection, this->lightEntry, viewport.View);
+                }
+            }
+
+            const uint8_t slaveCount = this->viewportCount >> 1;
+
+            if (slaveCount > 0)
+            {
+                this->task.Count = slaveCount;
+                Slave::ExecuteOnSlave(this->task);
+            }
+
+            for (uint8_t index = slaveCount; index < this->viewportCount; index++)
+            {
+                this->DrawViewport(index);
+            }
+
+            if (slaveCount > 0)
+            {
+                while (!this->task.IsDone());
+
+                // Drop stale lines of data written by slave
+                slCashPurge();
+            }
+
+            for (uint8_t index = 0; index < this->viewportCount; index++)
+            {
+                this->viewports[index].Renderer->End(sort);
+            }
+        }
+
+        /** @brief Get number of viewports
+         * @return Number of viewports
+         */
+        uint8_t GetViewportCount() const
+        {
+            return this->viewportCount;
+        }
+
+        /** @brief Get renderer of a viewport
+         * @param index Viewport index
+         * @return Renderer with statistics of the viewport
+         */
+        Renderer3D& GetRenderer(const uint8_t index)
+        {
+            return *this->viewports[Math::Min<uint8_t>(index, this->viewportCount - 1)].Renderer;
+        }
+
+        /** @brief Get number of objects culled by a viewport in the last frame
+         * @param index Viewport index
+         * @return Number of culled objects
+         */
+        uint16_t GetCulledObjects(const uint8_t index) const
+        {
+            return this->viewports[Math::Min<uint8_t>(index, this->viewportCount - 1)].Culled;
+        }
+    };
+}
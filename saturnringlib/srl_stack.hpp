@@ -0,0 +1,284 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_core.hpp"
+#include "srl_log.hpp"
+#include "srl_slave.hpp"
+
+extern "C"
+{
+    /** @brief Initial stack pointer of slave CPU
+     * @note Defined within workarea.c
+     */
+    extern const void* SlaveStack;
+}
+
+#ifndef SRL_MASTER_STACK_SIZE
+/** @brief Size of master CPU stack in bytes
+ * @details Master stack grows down from <tt>MasterStack</tt> (0x060ffc00) towards the DMA transfer list at 0x060fb800
+ */
+#define SRL_MASTER_STACK_SIZE 0x3000
+#endif
+
+#ifndef SRL_SLAVE_STACK_SIZE
+/** @brief Size of slave CPU stack in bytes
+ * @details Slave stack grows down from <tt>SlaveStack</tt> (0x06001e00)
+ */
+#define SRL_SLAVE_STACK_SIZE 0xe00
+#endif
+
+#ifndef SRL_STACK_GUARD_SIZE
+/** @brief Number of bytes at the bottom of each stack checked by the overflow guard
+ */
+#define SRL_STACK_GUARD_SIZE 64
+#endif
+
+namespace SRL
+{
+    /** @brief Stack usage monitoring of both CPUs
+     * @details Unused part of each stack is filled with a known pattern, the deepest word that no longer holds it
+     * marks the highest stack usage since painting. Report shows how much headroom is left, so stack sizes can be tuned.
+     * Optional guard checks bottom of both stacks every frame and logs fatal message once the pattern there gets overwritten,
+     * which means stack overflowed into memory below it.
+     * @code {.cpp}
+     * SRL::Core::Initialize(HighColor::Colors::Black);
+     * SRL::Stack::Paint();
+     * SRL::Stack::EnableGuard();
+     *
+     * // Later, for example in debug menu
+     * SRL::Stack::Report report = SRL::Stack::GetReport(SRL::Stack::Cpu::Slave);
+     * SRL::Debug::Print(1, 1, "Slave stack %d / %d", report.HighWater, report.Size);
+     * @endcode
+     * @note Stack usage before painting is not measured
+     */
+    class Stack
+    {
+    public:
+
+        /** @brief CPU identifier
+         */
+        enum class Cpu : uint8_t
+        {
+            /** @brief Master SH2
+             */
+            Master = 0,
+
+            /** @brief Slave SH2
+             */
+            Slave = 1
+        };
+
+        /** @brief Stack usage report
+         */
+        struct Report
+        {
+            /** @brief Total size of the stack in bytes
+             */
+            size_t Size;
+
+            /** @brief Highest number of bytes used since painting
+             */
+            size_t HighWater;
+
+            /** @brief Number of bytes that were never used since painting
+             */
+            size_t Free;
+
+            /** @brief Stack grew into the guard area at the bottom of the stack
+             */
+            bool Overflow;
+        };
+
+    private:
+
+        /** @brief Value stack is painted with
+         */
+        static constexpr uint32_t Pattern = 0xa5a5a5a5;
+
+        /** @brief Address of cache-through mirror of the system RAM
+         */
+        static constexpr uint32_t CacheThrough = 0x20000000;
+
+        /** @brief Number of bytes right below the caller left unpainted
+         */
+        static constexpr uint32_t PaintMargin = 64;
+
+        /** @brief Stack was painted
+         */
+        inline static bool painted[2] = { false, false };
+
+        /** @brief Overflow was already reported
+         */
+        inline static bool reported[2] = { false, false };
+
+        /** @brief Task painting stack of slave CPU
+         */
+        class PaintTask : public Types::ITask
+        {
+        protected:
+            /** @brief Paint slave stack
+             */
+            void Do() override
+            {
+                Stack::PaintCurrent(Stack::GetBottom(Cpu::Slave));
+            }
+        };
+
+        /** @brief Disable constructor
+         */
+        Stack() = delete;
+
+        /** @brief Disable destructor
+         */
+        ~Stack() = delete;
+
+        /** @brief Get initial stack pointer
+         * @param cpu CPU to get stack of
+         * @return Address stack grows down from
+         */
+        static uint32_t GetTop(const Cpu cpu)
+        {
+            return reinterpret_cast<uint32_t>(cpu == Cpu::Master ? MasterStack : SlaveStack);
+        }
+
+        /** @brief Get lowest address of the stack
+         * @param cpu CPU to get stack of
+         * @return Address stack must not grow below
+         */
+        static uint32_t GetBottom(const Cpu cpu)
+        {
+            return Stack::GetTop(cpu) - Stack::GetSize(cpu);
+        }
+
+        /** @brief Read stack word bypassing cache, stack of the other CPU is not coherent with own cache
+         * @param address Word address
+         * @return Word value
+         */
+        static uint32_t ReadWord(const uint32_t address)
+        {
+            return *reinterpret_cast<volatile uint32_t*>(address | Stack::CacheThrough);
+        }
+
+        /** @brief Fill stack of the calling CPU from its bottom up to the caller
+         * @param bottom Lowest address of the stack
+         */
+        __attribute__((noinline)) static void PaintCurrent(const uint32_t bottom)
+        {
+            volatile uint32_t marker = 0;
+            const uint32_t end = (reinterpret_cast<uint32_t>(&marker) - Stack::PaintMargin) & ~3;
+
+            for (uint32_t address = bottom; address < end; address += sizeof(uint32_t))
+            {
+                *reinterpret_cast<volatile uint32_t*>(address) = Stack::Pattern;
+            }
+        }
+
+        /** @brief Check guard of both stacks and report overflow
+         */
+        static void GuardHandler()
+        {
+            const Cpu cpus[2] = { Cpu::Master, Cpu::Slave };
+
+            for (const Cpu cpu : cpus)
+            {
+                const uint8_t index = static_cast<uint8_t>(cpu);
+
+                if (!Stack::reported[index] && !Stack::Check(cpu))
+                {
+                    Stack::reported[index] = true;
+                    SRL::Logger::LogFatal("%s stack overflow, size %d bytes", cpu == Cpu::Master ? "Master" : "Slave", Stack::GetSize(cpu));
+                }
+            }
+        }
+
+    public:
+
+        /** @brief Get stack size
+         * @param cpu CPU to get stack of
+         * @return Size in bytes
+         */
+        static size_t GetSize(const Cpu cpu)
+        {
+            return cpu == Cpu::Master ? SRL_MASTER_STACK_SIZE : SRL_SLAVE_STACK_SIZE;
+        }
+
+        /** @brief Fill unused part of both stacks with the pattern
+         * @note Must be called from master after SRL::Core::Initialize(), waits until slave is done.
+         * Can be called again to restart measurement.
+         */
+        static void Paint()
+        {
+            Stack::PaintCurrent(Stack::GetBottom(Cpu::Master));
+            Stack::painted[static_cast<uint8_t>(Cpu::Master)] = true;
+            Stack::reported[static_cast<uint8_t>(Cpu::Master)] = false;
+
+            PaintTask task;
+            Slave::ExecuteOnSlave(task);
+            while (!task.IsDone());
+            Stack::painted[static_cast<uint8_t>(Cpu::Slave)] = true;
+            Stack::reported[static_cast<uint8_t>(Cpu::Slave)] = false;
+        }
+
+        /** @brief Check whether the guard area at the bottom of the stack is intact
+         * @param cpu CPU to check stack of
+         * @return False if stack overflowed into its guard area, true otherwise or if stack was not painted
+         */
+        static bool Check(const Cpu cpu)
+        {
+            if (!Stack::painted[static_cast<uint8_t>(cpu)])
+            {
+                return true;
+            }
+
+            const uint32_t bottom = Stack::GetBottom(cpu);
+
+            for (uint32_t address = bottom; address < bottom + SRL_STACK_GUARD_SIZE; address += sizeof(uint32_t))
+            {
+                if (Stack::ReadWord(address) != Stack::Pattern)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief Get stack usage report
+         * @param cpu CPU to get report of
+         * @return Stack usage since last painting, only size is set if stack was not painted
+         */
+        static Report GetReport(const Cpu cpu)
+        {
+            if (!Stack::painted[static_cast<uint8_t>(cpu)])
+            {
+                return Report { Stack::GetSize(cpu), 0, 0, false };
+            }
+
+            const uint32_t bottom = Stack::GetBottom(cpu);
+            const uint32_t top = Stack::GetTop(cpu);
+            uint32_t address = bottom;
+
+            while (address < top && Stack::ReadWord(address) == Stack::Pattern)
+            {
+                address += sizeof(uint32_t);
+            }
+
+            return Report { Stack::GetSize(cpu), top - address, address - bottom, !Stack::Check(cpu) };
+        }
+
+        /** @brief Check both stacks after every frame and log fatal message on overflow
+         * @note Each overflow is logged only once
+         */
+        static void EnableGuard()
+        {
+            Core::OnAfterSync += Stack::GuardHandler;
+        }
+
+        /** @brief Stop checking stacks every frame
+         */
+        static void DisableGuard()
+        {
+            Core::OnAfterSync -= Stack::GuardHandler;
+        }
+    };
+}
@@ -0,0 +1,1243 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_cd.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_mesh.hpp"
+#include "srl_scene3d.hpp"
+
+#ifndef SRL_TERRAIN_POLYGONS
+/** @brief Maximal number of polygons terrain can draw in one frame
+ */
+#define SRL_TERRAIN_POLYGONS SGL_MAX_POLYGONS
+#endif
+
+#ifndef SRL_TERRAIN_VERTICES
+/** @brief Maximal number of vertices terrain can draw in one frame
+ */
+#define SRL_TERRAIN_VERTICES SGL_MAX_VERTICES
+#endif
+
+namespace SRL
+{
+    /** @brief Heightmap terrain drawn as patches with level of detail
+     * @details Heightmap is made of 8-bit samples split into square blocks of SRL::Terrain::BlockSize samples.
+     * Only a square window of blocks around the camera is kept in memory, blocks that enter the window
+     * as the camera moves are loaded from memory or CD in SRL::Terrain::Update(), a few each frame.
+     * Blocks on CD are read in the background one at a time, so Update() never waits for the drive.
+     *
+     * Visible part of the window is covered by patches of 8x8 quads selected from a quadtree.
+     * Patch with the largest geometric error relative to its distance from the camera is split first,
+     * splitting stops when the error is small enough or when more patches would not fit into the polygon budget
+     * (SRL_TERRAIN_POLYGONS and SRL_TERRAIN_VERTICES, by default SGL limits), so far view distance never overflows SGL buffers.
+     * Patches outside of the view are dropped during selection. Edges of a patch next to a coarser patch
+     * are flattened onto the coarser edge, so there are no cracks between levels up to three levels apart.
+     *
+     * Heightmap file on CD starts with one sector long header (big endian "HMAP", 16-bit width and 16-bit height),
+     * followed by blocks in row order, each block is 64x64 samples in row order.
+     * Heights go up, so terrain lies in negative Y from the base plane at Y = 0.
+     * @code {.cpp}
+     * SRL::Terrain terrain("VALLEY.HMP", 4, 8.0, 0.5);
+     *
+     * while (!terrain.Update(camera, 16))
+     * {
+     *     // Load whole window before first frame
+     * }
+     *
+     * // Each frame
+     * terrain.Update(camera);
+     * SRL::Scene3D::PushMatrix();
+     * {
+     *     SRL::Scene3D::LookAt(camera, target, 0);
+     *     terrain.Draw(camera);
+     * }
+     * SRL::Scene3D::PopMatrix();
+     * @endcode
+     */
+    class Terrain
+    {
+    public:
+
+        /** @brief Number of samples along each side of a block
+         */
+        static constexpr uint16_t BlockSize = 64;
+
+        /** @brief Number of quads along each side of a patch
+         */
+        static constexpr uint16_t PatchSize = 8;
+
+        /** @brief Number of vertices of a patch
+         */
+        static constexpr uint16_t PatchVertices = (PatchSize + 1) * (PatchSize + 1);
+
+        /** @brief Number of polygons of a patch
+         */
+        static constexpr uint16_t PatchPolygons = PatchSize * PatchSize;
+
+        /** @brief Statistics of last frame
+         */
+        struct Statistics
+        {
+            /** @brief Number of drawn patches
+             */
+            uint16_t Patches;
+
+            /** @brief Number of drawn polygons
+             */
+            uint16_t Polygons;
+
+            /** @brief Number of quadtree nodes outside of the view
+             */
+            uint16_t Culled;
+
+            /** @brief Number of quadtree nodes skipped because their block is not loaded yet
+             */
+            uint16_t Missing;
+
+            /** @brief Number of blocks loaded by last update
+             */
+            uint16_t Loaded;
+
+            /** @brief Number of blocks in the window waiting to be loaded
+             */
+            uint16_t Pending;
+        };
+
+    private:
+
+        /** @brief Height bounds of a quadtree node inside of a block
+         */
+        struct Bounds
+        {
+            /** @brief Lowest sample
+             */
+            uint8_t Min;
+
+            /** @brief Highest sample
+             */
+            uint8_t Max;
+
+            /** @brief Largest difference between samples and node drawn at its level
+             */
+            uint8_t Error;
+
+            /** @brief Padding
+             */
+            uint8_t Reserved;
+        };
+
+        /** @brief Quadtree node
+         */
+        struct Node
+        {
+            /** @brief First sample column
+             */
+            uint16_t X;
+
+            /** @brief First sample row
+             */
+            uint16_t Y;
+
+            /** @brief Level, node covers PatchSize << Level samples
+             */
+            uint8_t Level;
+
+            /** @brief Node will not be split any further
+             */
+            bool Final;
+
+            /** @brief Whole node is loaded and can be drawn
+             */
+            bool Resident;
+
+            /** @brief Projected error (larger is split first)
+             */
+            int32_t Priority;
+        };
+
+        /** @brief Result of node preparation
+         */
+        enum class NodeState : uint8_t
+        {
+            /** @brief Node is visible
+             */
+            Visible,
+
+            /** @brief Node is outside of the view
+             */
+            Culled,
+
+            /** @brief Node is not loaded
+             */
+            Missing
+        };
+
+        /** @brief Number of bytes in a block
+         */
+        static constexpr size_t BlockBytes = BlockSize * BlockSize;
+
+        /** @brief Number of CD sectors in a block
+         */
+        static constexpr size_t BlockSectors = BlockBytes / 2048;
+
+        /** @brief Number of node levels that fit into one block
+         */
+        static constexpr uint8_t BlockLevels = 4;
+
+        /** @brief Number of node bounds kept for each block
+         */
+        static constexpr uint16_t BoundsPerBlock = 64 + 16 + 4 + 1;
+
+        /** @brief Offset of first bounds entry of each level
+         */
+        static constexpr uint16_t BoundsOffset[BlockLevels] = { 0, 64, 80, 84 };
+
+        /** @brief Level of area not covered by any patch
+         */
+        static constexpr uint8_t NoLevel = 0xff;
+
+        /** @brief Heightmap file identifier ("HMAP")
+         */
+        static constexpr uint32_t Magic = 0x484d4150;
+
+        /** @brief Heightmap width in samples
+         */
+        uint16_t width;
+
+        /** @brief Heightmap height in samples
+         */
+        uint16_t height;
+
+        /** @brief Number of blocks per window side
+         */
+        uint8_t window;
+
+        /** @brief Level of quadtree root covering whole window
+         */
+        uint8_t rootLevel;
+
+        /** @brief First block column of the window
+         */
+        uint16_t windowX;
+
+        /** @brief First block row of the window
+         */
+        uint16_t windowY;
+
+        /** @brief Distance between samples
+         */
+        Math::Types::Fxp cellSize;
+
+        /** @brief Height of one sample step
+         */
+        Math::Types::Fxp heightScale;
+
+        /** @brief Allowed ratio between geometric error and distance
+         */
+        Math::Types::Fxp tolerance;
+
+        /** @brief Heightmap in memory, or nullptr
+         */
+        const uint8_t* source;
+
+        /** @brief Heightmap file on CD, or nullptr
+         */
+        Cd::File* file;
+
+        /** @brief Buffer for block being read from CD, nullptr if heightmap is in memory
+         */
+        uint8_t* staging;
+
+        /** @brief Block being read from CD, -1 if none
+         */
+        int32_t reading;
+
+        /** @brief Samples of resident blocks
+         */
+        uint8_t* samples;
+
+        /** @brief Block held by each slot, -1 if empty
+         */
+        int32_t* slots;
+
+        /** @brief Node bounds of resident blocks
+         */
+        Bounds* bounds;
+
+        /** @brief Level of patch covering each cell of the window, one cell is PatchSize samples
+         */
+        uint8_t* levels;
+
+        /** @brief Maximal number of patches
+         */
+        uint16_t maxPatches;
+
+        /** @brief Number of selected patches
+         */
+        uint16_t leafCount;
+
+        /** @brief Selected patches
+         */
+        Node* leaves;
+
+        /** @brief Vertices of drawn patches
+         */
+        Math::Types::Vector3D* vertices;
+
+        /** @brief SGL meshes of drawn patches
+         */
+        PDATA* patches;
+
+        /** @brief Faces shared by all patches
+         */
+        Types::Polygon faces[PatchPolygons];
+
+        /** @brief Attributes shared by all patches
+         */
+        Types::Attribute attributes[PatchPolygons];
+
+        /** @brief Statistics of last frame
+         */
+        Statistics statistics;
+
+        /** @brief Allocate buffers and build shared patch faces
+         * @param zone Memory zone
+         */
+        void Initialize(const Memory::Zone zone)
+        {
+            if ((this->width % Terrain::BlockSize) != 0 || (this->height % Terrain::BlockSize) != 0)
+            {
+                SRL::Debug::Assert("Terrain size %dx%d is not multiple of block size", this->width, this->height);
+            }
+
+            if ((this->window & (this->window - 1)) != 0 ||
+                this->window > this->width / Terrain::BlockSize ||
+                this->window > this->height / Terrain::BlockSize)
+            {
+                SRL::Debug::Assert("Terrain window %d is not power of two or is larger than map", this->window);
+            }
+
+            if (this->maxPatches == 0)
+            {
+                SRL::Debug::Assert("Terrain polygon budget is smaller than one patch");
+            }
+
+            // World coordinates of the whole map and of the highest sample must fit into fixed point,
+            // half of the range is left so sums of node coordinates and sizes do not overflow
+            if (static_cast<int64_t>(Math::Max<uint16_t>(this->width, this->height)) * this->cellSize.RawValue() > (INT32_MAX >> 1) ||
+                static_cast<int64_t>(0xff) * this->heightScale.RawValue() > (INT32_MAX >> 1))
+            {
+                SRL::Debug::Assert("Terrain %dx%d is too large for its cell size or height scale", this->width, this->height);
+            }
+
+            // Window of 1 block is covered by root of level 3, every doubling adds one level
+            this->rootLevel = Terrain::BlockLevels - 1;
+
+            for (uint8_t size = this->window; size > 1; size >>= 1)
+            {
+                this->rootLevel++;
+            }
+
+            const size_t blocks = this->window * this->window;
+            const size_t cells = (this->window * (Terrain::BlockSize / Terrain::PatchSize)) * (this->window * (Terrain::BlockSize / Terrain::PatchSize));
+            this->maxPatches = Math::Min<size_t>(this->maxPatches, SRL_TERRAIN_VERTICES / Terrain::PatchVertices);
+
+            this->samples = reinterpret_cast<uint8_t*>(Memory::Malloc(Terrain::BlockBytes * blocks, zone));
+            this->slots = reinterpret_cast<int32_t*>(Memory::Malloc(sizeof(int32_t) * blocks, zone));
+            this->bounds = reinterpret_cast<Bounds*>(Memory::Malloc(sizeof(Bounds) * Terrain::BoundsPerBlock * blocks, zone));
+            this->levels = reinterpret_cast<uint8_t*>(Memory::Malloc(cells, zone));
+            this->leaves = reinterpret_cast<Node*>(Memory::Malloc(sizeof(Node) * this->maxPatches, zone));
+            this->vertices = reinterpret_cast<Math::Types::Vector3D*>(Memory::Malloc(sizeof(Math::Types::Vector3D) * Terrain::PatchVertices * this->maxPatches, zone));
+            this->patches = reinterpret_cast<PDATA*>(Memory::Malloc(sizeof(PDATA) * this->maxPatches, zone));
+
+            for (size_t slot = 0; slot < blocks; slot++)
+            {
+                this->slots[slot] = -1;
+            }
+
+            for (uint16_t row = 0; row < Terrain::PatchSize; row++)
+            {
+                for (uint16_t column = 0; column < Terrain::PatchSize; column++)
+                {
+                    const uint16_t first = (row * (Terrain::PatchSize + 1)) + column;
+                    const uint16_t face[4] = {
+                        first,
+                        static_cast<uint16_t>(first + 1),
+                        static_cast<uint16_t>(first + Terrain::PatchSize + 2),
+                        static_cast<uint16_t>(first + Terrain::PatchSize + 1) };
+
+                    this->faces[(row * Terrain::PatchSize) + column] = Types::Polygon(Math::Types::Vector3D(0.0, -1.0, 0.0), face);
+                }
+            }
+
+            this->SetAttribute(Types::Attribute(
+                Types::Attribute::FaceVisibility::DoubleSided,
+                Types::Attribute::SortMode::Center,
+                No_Texture,
+                Types::HighColor::Colors::White,
+                CL32KRGB,
+                CL32KRGB,
+                sprPolygon,
+                No_Option));
+        }
+
+        /** @brief Get slot of a block
+         * @param blockX Block column
+         * @param blockY Block row
+         * @return Slot index
+         */
+        size_t GetSlot(const uint16_t blockX, const uint16_t blockY) const
+        {
+            return ((blockY & (this->window - 1)) * this->window) + (blockX & (this->window - 1));
+        }
+
+        /** @brief Check whether block is loaded
+         * @param blockX Block column
+         * @param blockY Block row
+         * @return True if block is loaded
+         */
+        bool IsResident(const uint16_t blockX, const uint16_t blockY) const
+        {
+            return this->slots[this->GetSlot(blockX, blockY)] == (blockY * (this->width / Terrain::BlockSize)) + blockX;
+        }
+
+        /** @brief Get sample of a loaded block
+         * @details Sample on the first row or column of a block that is not loaded is taken from the previous block instead,
+         * so patches on the edge of loaded area can still be drawn.
+         * @param x Sample column
+         * @param y Sample row
+         * @return Sample value, 0 if block is not loaded
+         */
+        uint8_t GetSample(int32_t x, int32_t y) const
+        {
+            x = Math::Max<int32_t>(0, Math::Min<int32_t>(x, this->width - 1));
+            y = Math::Max<int32_t>(0, Math::Min<int32_t>(y, this->height - 1));
+
+            if (!this->IsResident(x / Terrain::BlockSize, y / Terrain::BlockSize) && x > 0 && (x % Terrain::BlockSize) == 0)
+            {
+                x--;
+            }
+
+            if (!this->IsResident(x / Terrain::BlockSize, y / Terrain::BlockSize) && y > 0 && (y % Terrain::BlockSize) == 0)
+            {
+                y--;
+            }
+
+            if (!this->IsResident(x / Terrain::BlockSize, y / Terrain::BlockSize))
+            {
+                return 0;
+            }
+
+            return this->samples[(this->GetSlot(x / Terrain::BlockSize, y / Terrain::BlockSize) * Terrain::BlockBytes) +
+                ((y % Terrain::BlockSize) * Terrain::BlockSize) + (x % Terrain::BlockSize)];
+        }
+
+        /** @brief Compute node bounds of a freshly loaded block
+         * @param slot Slot holding the block
+         */
+        void ComputeBounds(const size_t slot)
+        {
+            const uint8_t* data = this->samples + (slot * Terrain::BlockBytes);
+
+            for (uint8_t level = 0; level < Terrain::BlockLevels; level++)
+            {
+                const uint16_t nodeSize = Terrain::PatchSize << level;
+                const uint16_t nodes = Terrain::BlockSize / nodeSize;
+                const uint16_t step = 1 << level;
+
+                for (uint16_t nodeY = 0; nodeY < nodes; nodeY++)
+                {
+                    for (uint16_t nodeX = 0; nodeX < nodes; nodeX++)
+                    {
+                        Bounds& result = this->bounds[(slot * Terrain::BoundsPerBlock) + Terrain::BoundsOffset[level] + (nodeY * nodes) + nodeX];
+                        result.Min = 0xff;
+                        result.Max = 0;
+                        result.Error = 0;
+
+                        for (uint16_t y = nodeY * nodeSize; y < (nodeY + 1) * nodeSize; y++)
+                        {
+                            for (uint16_t x = nodeX * nodeSize; x < (nodeX + 1) * nodeSize; x++)
+                            {
+                                const int32_t sample = data[(y * Terrain::BlockSize) + x];
+                                result.Min = Math::Min<int32_t>(result.Min, sample);
+                                result.Max = Math::Max<int32_t>(result.Max, sample);
+
+                                if (level > 0)
+                                {
+                                    // Sample interpolated from vertices of a patch at this level (block edge is clamped)
+                                    const int32_t x0 = x & ~(step - 1);
+                                    const int32_t y0 = y & ~(step - 1);
+                                    const int32_t x1 = Math::Min<int32_t>(x0 + step, Terrain::BlockSize - 1);
+                                    const int32_t y1 = Math::Min<int32_t>(y0 + step, Terrain::BlockSize - 1);
+                                    const int32_t fractionX = x - x0;
+                                    const int32_t fractionY = y - y0;
+                                    const int32_t top = (data[(y0 * Terrain::BlockSize) + x0] * (step - fractionX)) + (data[(y0 * Terrain::BlockSize) + x1] * fractionX);
+                                    const int32_t bottom = (data[(y1 * Terrain::BlockSize) + x0] * (step - fractionX)) + (data[(y1 * Terrain::BlockSize) + x1] * fractionX);
+                                    const int32_t interpolated = ((top * (step - fractionY)) + (bottom * fractionY)) >> (level << 1);
+
+                                    result.Error = Math::Max<int32_t>(result.Error, Math::Abs(sample - interpolated));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        /** @brief Load block into its slot
+         * @note Blocks that are not in memory or in SRL::Cd::Cache are read by SRL::Terrain::StartRead() instead
+         * @param blockX Block column
+         * @param blockY Block row
+         * @return True on success
+         */
+        bool LoadBlock(const uint16_t blockX, const uint16_t blockY)
+        {
+            const size_t slot = this->GetSlot(blockX, blockY);
+            const int32_t block = (blockY * (this->width / Terrain::BlockSize)) + blockX;
+            uint8_t* destination = this->samples + (slot * Terrain::BlockBytes);
+            this->slots[slot] = -1;
+
+            if (this->source != nullptr)
+            {
+                for (uint16_t row = 0; row < Terrain::BlockSize; row++)
+                {
+                    const uint8_t* line = this->source + ((((blockY * Terrain::BlockSize) + row) * this->width) + (blockX * Terrain::BlockSize));
+
+                    for (uint16_t column = 0; column < Terrain::BlockSize; column++)
+                    {
+                        destination[(row * Terrain::BlockSize) + column] = line[column];
+                    }
+                }
+            }
+            else if (this->file == nullptr ||
+                this->file->LoadBytes(1 + (block * Terrain::BlockSectors), Terrain::BlockBytes, destination) != static_cast<int32_t>(Terrain::BlockBytes))
+            {
+                return false;
+            }
+
+            this->ComputeBounds(slot);
+            this->slots[slot] = block;
+            return true;
+        }
+
+        /** @brief Start reading block from CD into staging buffer
+         * @param blockX Block column
+         * @param blockY Block row
+         * @return True if read was started
+         */
+        bool StartRead(const uint16_t blockX, const uint16_t blockY)
+        {
+            const int32_t block = (blockY * (this->width / Terrain::BlockSize)) + blockX;
+
+            if (!this->file->Open() ||
+                GFS_Seek(this->file->Handle, 1 + (block * Terrain::BlockSectors), Cd::SeekMode::Absolute) < 0 ||
+                GFS_NwFread(this->file->Handle, Terrain::BlockSectors, this->staging, Terrain::BlockBytes) < 0)
+            {
+                return false;
+            }
+
+            this->reading = block;
+            return true;
+        }
+
+        /** @brief Check whether block read from CD arrived and swap it into its slot
+         * @details Block stays in staging buffer until whole block is read, so slot keeps its old block until then.
+         * Block that left the window while it was being read is dropped.
+         * @return True if block was swapped in
+         */
+        bool FinishRead()
+        {
+            GFS_NwExecOne(this->file->Handle);
+
+            if (!GFS_NwIsComplete(this->file->Handle))
+            {
+                return false;
+            }
+
+            int32_t mode;
+            int32_t bytes;
+            GFS_NwGetStat(this->file->Handle, &mode, &bytes);
+
+            const int32_t block = this->reading;
+            const uint16_t blockX = block % (this->width / Terrain::BlockSize);
+            const uint16_t blockY = block / (this->width / Terrain::BlockSize);
+            this->reading = -1;
+
+            if (bytes < static_cast<int32_t>(Terrain::BlockBytes))
+            {
+                SRL::Debug::Assert("Heightmap block %d,%d could not be loaded", blockX, blockY);
+            }
+
+            if (blockX < this->windowX || blockY < this->windowY || blockX >= this->windowX + this->window || blockY >= this->windowY + this->window)
+            {
+                return false;
+            }
+
+            // Block was transferred past the cache, drop stale lines of the staging buffer
+            slCashPurge();
+
+            const size_t slot = this->GetSlot(blockX, blockY);
+            uint8_t* destination = this->samples + (slot * Terrain::BlockBytes);
+
+            for (size_t sample = 0; sample < Terrain::BlockBytes; sample++)
+            {
+                destination[sample] = this->staging[sample];
+            }
+
+            this->ComputeBounds(slot);
+            this->slots[slot] = block;
+            return true;
+        }
+
+        /** @brief Get height bounds of a node
+         * @param node Quadtree node
+         * @param result Node bounds
+         * @return False if part of the node is not loaded
+         */
+        bool GetBounds(const Node& node, Bounds& result) const
+        {
+            if (node.Level < Terrain::BlockLevels)
+            {
+                const uint16_t blockX = node.X / Terrain::BlockSize;
+                const uint16_t blockY = node.Y / Terrain::BlockSize;
+
+                if (!this->IsResident(blockX, blockY))
+                {
+                    return false;
+                }
+
+                const uint16_t nodeSize = Terrain::PatchSize << node.Level;
+                const uint16_t nodes = Terrain::BlockSize / nodeSize;
+                result = this->bounds[(this->GetSlot(blockX, blockY) * Terrain::BoundsPerBlock) + Terrain::BoundsOffset[node.Level] +
+                    (((node.Y % Terrain::BlockSize) / nodeSize) * nodes) + ((node.X % Terrain::BlockSize) / nodeSize)];
+
+                return true;
+            }
+
+            // Node spans several blocks, combine whole block bounds
+            const uint16_t blocks = 1 << (node.Level - (Terrain::BlockLevels - 1));
+            bool resident = true;
+            result.Min = 0xff;
+            result.Max = 0;
+
+            for (uint16_t blockY = node.Y / Terrain::BlockSize; blockY < (node.Y / Terrain::BlockSize) + blocks; blockY++)
+            {
+                for (uint16_t blockX = node.X / Terrain::BlockSize; blockX < (node.X / Terrain::BlockSize) + blocks; blockX++)
+                {
+                    if (!this->IsResident(blockX, blockY))
+                    {
+                        resident = false;
+                        continue;
+                    }
+
+                    const Bounds& block = this->bounds[(this->GetSlot(blockX, blockY) * Terrain::BoundsPerBlock) + Terrain::BoundsOffset[Terrain::BlockLevels - 1]];
+                    result.Min = Math::Min<uint8_t>(result.Min, block.Min);
+                    result.Max = Math::Max<uint8_t>(result.Max, block.Max);
+                }
+            }
+
+            // Error of such coarse node is not known, height range is its upper limit
+            result.Error = result.Max >= result.Min ? result.Max - result.Min : 0;
+            return resident;
+        }
+
+        /** @brief Compute visibility and priority of a node
+         * @param node Quadtree node
+         * @param camera Camera position
+         * @return Node state
+         */
+        NodeState Prepare(Node& node, const Math::Types::Vector3D& camera) const
+        {
+            Bounds nodeBounds;
+            node.Resident = this->GetBounds(node, nodeBounds);
+            node.Final = node.Level == 0;
+
+            if (!node.Resident && node.Level < Terrain::BlockLevels)
+            {
+                return NodeState::Missing;
+            }
+
+            if (!node.Resident)
+            {
+                // Cannot draw it as whole, split until loaded parts are found
+                node.Priority = INT32_MAX;
+                nodeBounds.Min = 0;
+                nodeBounds.Max = 0xff;
+            }
+
+            // Node box in world space
+            const int32_t size = (Terrain::PatchSize << node.Level) * this->cellSize.RawValue();
+            const int32_t left = node.X * this->cellSize.RawValue();
+            const int32_t front = node.Y * this->cellSize.RawValue();
+            const int32_t top = -(nodeBounds.Max * this->heightScale.RawValue());
+            const int32_t bottom = -(nodeBounds.Min * this->heightScale.RawValue());
+
+            // Bounding sphere is a bit larger than half of the diagonal (1.5 instead of square root of 2)
+            const int32_t half = size >> 1;
+            const Math::Types::Vector3D center(
+                Math::Types::Fxp::BuildRaw(left + half),
+                Math::Types::Fxp::BuildRaw((top + bottom) >> 1),
+                Math::Types::Fxp::BuildRaw(front + half));
+
+            if (!Scene3D::IsOnScreen(center, Math::Types::Fxp::BuildRaw(half + (half >> 1) + ((bottom - top) >> 1))))
+            {
+                return NodeState::Culled;
+            }
+
+            if (node.Resident)
+            {
+                // Distance from camera to the box, largest axis is enough
+                // Camera can be anywhere, so differences are kept in 64 bits
+                const int64_t distanceX = Math::Max<int64_t>(0, Math::Max<int64_t>(static_cast<int64_t>(left) - camera.X.RawValue(), static_cast<int64_t>(camera.X.RawValue()) - (left + size)));
+                const int64_t distanceY = Math::Max<int64_t>(0, Math::Max<int64_t>(static_cast<int64_t>(top) - camera.Y.RawValue(), static_cast<int64_t>(camera.Y.RawValue()) - bottom));
+                const int64_t distanceZ = Math::Max<int64_t>(0, Math::Max<int64_t>(static_cast<int64_t>(front) - camera.Z.RawValue(), static_cast<int64_t>(camera.Z.RawValue()) - (front + size)));
+                const int64_t distance = Math::Max<int64_t>(0x10000, Math::Max<int64_t>(distanceX, Math::Max<int64_t>(distanceY, distanceZ)));
+                const int64_t error = static_cast<int64_t>(nodeBounds.Error) * this->heightScale.RawValue();
+
+                node.Priority = static_cast<int32_t>(Math::Min<int64_t>((error << 16) / distance, INT32_MAX - 1));
+            }
+
+            return NodeState::Visible;
+        }
+
+        /** @brief Select patches to draw
+         * @param camera Camera position
+         */
+        void Select(const Math::Types::Vector3D& camera)
+        {
+            Node root = { static_cast<uint16_t>(this->windowX * Terrain::BlockSize), static_cast<uint16_t>(this->windowY * Terrain::BlockSize), this->rootLevel, false, false, 0 };
+            this->leafCount = 0;
+
+            switch (this->Prepare(root, camera))
+            {
+            case NodeState::Visible:
+                this->leaves[this->leafCount++] = root;
+                break;
+
+            case NodeState::Culled:
+                this->statistics.Culled++;
+                break;
+
+            default:
+                this->statistics.Missing++;
+                break;
+            }
+
+            while (true)
+            {
+                int32_t best = -1;
+
+                for (uint16_t leaf = 0; leaf < this->leafCount; leaf++)
+                {
+                    const Node& node = this->leaves[leaf];
+
+                    if (!node.Final && node.Priority > this->tolerance.RawValue() && (best < 0 || node.Priority > this->leaves[best].Priority))
+                    {
+                        best = leaf;
+                    }
+                }
+
+                if (best < 0)
+                {
+                    break;
+                }
+
+                // Prepare children first, split only if visible ones fit into the budget
+                const Node& parent = this->leaves[best];
+                const uint16_t half = (Terrain::PatchSize << parent.Level) >> 1;
+                Node children[4];
+                uint16_t visible = 0;
+                uint16_t culled = 0;
+                uint16_t missing = 0;
+
+                for (uint8_t child = 0; child < 4; child++)
+                {
+                    Node& node = children[visible];
+                    node.X = parent.X + ((child & 1) * half);
+                    node.Y = parent.Y + ((child >> 1) * half);
+                    node.Level = parent.Level - 1;
+
+                    switch (this->Prepare(node, camera))
+                    {
+                    case NodeState::Visible:
+                        visible++;
+                        break;
+
+                    case NodeState::Culled:
+                        culled++;
+                        break;
+
+                    default:
+                        missing++;
+                        break;
+                    }
+                }
+
+                if (this->leafCount - 1 + visible > this->maxPatches)
+                {
+                    this->leaves[best].Final = true;
+                    continue;
+                }
+
+                this->statistics.Culled += culled;
+                this->statistics.Missing += missing;
+
+                // First child takes place of the parent, others are added at the end
+                if (visible == 0)
+                {
+                    this->leaves[best] = this->leaves[--this->leafCount];
+                    continue;
+                }
+
+                this->leaves[best] = children[0];
+
+                for (uint16_t child = 1; child < visible; child++)
+                {
+                    this->leaves[this->leafCount++] = children[child];
+                }
+            }
+        }
+
+        /** @brief Get level of patch covering a window cell
+         * @param cellX Cell column relative to window
+         * @param cellY Cell row relative to window
+         * @return Patch level or NoLevel
+         */
+        uint8_t GetLevel(const int32_t cellX, const int32_t cellY) const
+        {
+            const int32_t cells = this->window * (Terrain::BlockSize / Terrain::PatchSize);
+
+            if (cellX < 0 || cellY < 0 || cellX >= cells || cellY >= cells)
+            {
+                return Terrain::NoLevel;
+            }
+
+            return this->levels[(cellY * cells) + cellX];
+        }
+
+        /** @brief Flatten patch edge onto edge of a coarser neighbour
+         * @param points Patch vertices
+         * @param first First vertex of the edge
+         * @param stride Distance between edge vertices
+         * @param difference Number of levels the neighbour is coarser
+         */
+        static void Stitch(Math::Types::Vector3D* points, const uint16_t first, const uint16_t stride, const uint8_t difference)
+        {
+            const uint16_t step = 1 << difference;
+
+            for (uint16_t vertex = 0; vertex <= Terrain::PatchSize; vertex++)
+            {
+                const uint16_t offset = vertex & (step - 1);
+
+                if (offset != 0)
+                {
+                    const int32_t from = points[first + ((vertex - offset) * stride)].Y.RawValue();
+                    const int32_t to = points[first + ((vertex - offset + step) * stride)].Y.RawValue();
+                    points[first + (vertex * stride)].Y = Math::Types::Fxp::BuildRaw(from + (((to - from) * offset) >> difference));
+                }
+            }
+        }
+
+        /** @brief Get how many levels coarser the neighbour is
+         * @param level Patch level
+         * @param neighbour Neighbour level
+         * @return Level difference (up to 3), 0 if neighbour is not coarser
+         */
+        static uint8_t GetDifference(const uint8_t level, const uint8_t neighbour)
+        {
+            if (neighbour == Terrain::NoLevel || neighbour <= level)
+            {
+                return 0;
+            }
+
+            return Math::Min<uint8_t>(neighbour - level, 3);
+        }
+
+    public:
+
+        /** @brief Create terrain from heightmap in memory
+         * @note Heightmap must stay valid for lifetime of the terrain
+         * @param heights Samples in row order
+         * @param width Number of samples in a row (multiple of SRL::Terrain::BlockSize)
+         * @param height Number of rows (multiple of SRL::Terrain::BlockSize)
+         * @param window Number of blocks along each side of resident window (power of two)
+         * @param cellSize Distance between samples
+         * @param heightScale Height of one sample step
+         * @param polygons Maximal number of polygons drawn in one frame
+         * @param zone Memory zone for window and patch buffers
+         */
+        Terrain(
+            const uint8_t* heights,
+            const uint16_t width,
+            const uint16_t height,
+            const uint8_t window,
+            const Math::Types::Fxp cellSize,
+            const Math::Types::Fxp heightScale,
+            const size_t polygons = SRL_TERRAIN_POLYGONS,
+            const Memory::Zone zone = Memory::Zone::HWRam) :
+            width(width),
+            height(height),
+            window(window),
+            windowX(0),
+            windowY(0),
+            cellSize(cellSize),
+            heightScale(heightScale),
+            tolerance(0.01),
+            source(heights),
+            file(nullptr),
+            staging(nullptr),
+            reading(-1),
+            maxPatches(polygons / Terrain::PatchPolygons),
+            leafCount(0),
+            statistics({ 0, 0, 0, 0, 0, 0 })
+        {
+            this->Initialize(zone);
+        }
+
+        /** @brief Create terrain streamed from heightmap file on CD
+         * @param fileName Heightmap file name
+         * @param window Number of blocks along each side of resident window (power of two)
+         * @param cellSize Distance between samples
+         * @param heightScale Height of one sample step
+         * @param polygons Maximal number of polygons drawn in one frame
+         * @param zone Memory zone for window and patch buffers
+         */
+        Terrain(
+            const char* fileName,
+            const uint8_t window,
+            const Math::Types::Fxp cellSize,
+            const Math::Types::Fxp heightScale,
+            const size_t polygons = SRL_TERRAIN_POLYGONS,
+            const Memory::Zone zone = Memory::Zone::HWRam) :
+            width(0),
+            height(0),
+            window(window),
+            windowX(0),
+            windowY(0),
+            cellSize(cellSize),
+            heightScale(heightScale),
+            tolerance(0.01),
+            source(nullptr),
+            file(new Cd::File(fileName)),
+            staging(nullptr),
+            reading(-1),
+            maxPatches(polygons / Terrain::PatchPolygons),
+            leafCount(0),
+            statistics({ 0, 0, 0, 0, 0, 0 })
+        {
+            // Header takes whole sector
+            uint8_t* header = reinterpret_cast<uint8_t*>(Memory::Malloc(2048, zone));
+
+            if (!this->file->Exists() || this->file->LoadBytes(0, 2048, header) <= 8 || *reinterpret_cast<uint32_t*>(header) != Terrain::Magic)
+            {
+                SRL::Debug::Assert("Heightmap file '%s' is missing or not valid", fileName);
+            }
+
+            this->width = *reinterpret_cast<uint16_t*>(header + 4);
+            this->height = *reinterpret_cast<uint16_t*>(header + 6);
+            Memory::Free(header);
+
+            this->Initialize(zone);
+            this->staging = reinterpret_cast<uint8_t*>(Memory::Malloc(Terrain::BlockBytes, zone));
+        }
+
+        /** @brief Disable copying
+         */
+        Terrain(const Terrain&) = delete;
+
+        /** @brief Disable copying
+         */
+        Terrain& operator=(const Terrain&) = delete;
+
+        /** @brief Destroy the terrain
+         */
+        ~Terrain()
+        {
+            Memory::Free(this->samples);
+            Memory::Free(this->slots);
+            Memory::Free(this->bounds);
+            Memory::Free(this->levels);
+            Memory::Free(this->leaves);
+            Memory::Free(this->vertices);
+            Memory::Free(this->patches);
+
+            if (this->file != nullptr)
+            {
+                if (this->reading >= 0)
+                {
+                    GFS_NwStop(this->file->Handle);
+                }
+
+                Memory::Free(this->staging);
+                delete this->file;
+            }
+        }
+
+        /** @brief Set attribute of all terrain polygons
+         * @param attribute Polygon attribute
+         */
+        void SetAttribute(const Types::Attribute& attribute)
+        {
+            for (uint16_t face = 0; face < Terrain::PatchPolygons; face++)
+            {
+                this->attributes[face] = attribute;
+            }
+        }
+
+        /** @brief Set allowed ratio between geometric error of a patch and its distance from the camera
+         * @details Smaller value draws finer patches further away, as long as polygon budget allows it
+         * @param ratio Error to distance ratio (default is 0.01)
+         */
+        void SetTolerance(const Math::Types::Fxp ratio)
+        {
+            this->tolerance = ratio;
+        }
+
+        /** @brief Move the window around the camera and load blocks that are missing
+         * @details Blocks closest to the camera are loaded first. Blocks in memory or in SRL::Cd::Cache are copied right away.
+         * Blocks on CD (2 sectors each) are read in the background one at a time, each update checks whether the read
+         * finished and swaps the block in, then starts reading the next one.
+         * @param camera Camera position
+         * @param loads Maximal number of blocks to load
+         * @return True if whole window is loaded
+         */
+        bool Update(const Math::Types::Vector3D& camera, const uint16_t loads = 1)
+        {
+            const int32_t blocksX = this->width / Terrain::BlockSize;
+            const int32_t blocksY = this->height / Terrain::BlockSize;
+            const int32_t sampleX = Math::Max<int32_t>(0, camera.X.RawValue() / this->cellSize.RawValue());
+            const int32_t sampleY = Math::Max<int32_t>(0, camera.Z.RawValue() / this->cellSize.RawValue());
+            const int32_t cameraX = sampleX / Terrain::BlockSize;
+            const int32_t cameraY = sampleY / Terrain::BlockSize;
+
+            // Window is centered on the nearest block corner
+            this->windowX = Math::Max<int32_t>(0, Math::Min<int32_t>(((sampleX + (Terrain::BlockSize >> 1)) / Terrain::BlockSize) - (this->window >> 1), blocksX - this->window));
+            this->windowY = Math::Max<int32_t>(0, Math::Min<int32_t>(((sampleY + (Terrain::BlockSize >> 1)) / Terrain::BlockSize) - (this->window >> 1), blocksY - this->window));
+            this->statistics.Loaded = 0;
+            this->statistics.Pending = 0;
+
+            if (this->reading >= 0 && this->FinishRead())
+            {
+                this->statistics.Loaded++;
+            }
+
+            for (uint16_t load = 0; load <= loads; load++)
+            {
+                int32_t bestX = -1;
+                int32_t bestY = -1;
+                int32_t bestDistance = INT32_MAX;
+                uint16_t pending = 0;
+
+                for (int32_t blockY = this->windowY; blockY < this->windowY + this->window; blockY++)
+                {
+                    for (int32_t blockX = this->windowX; blockX < this->windowX + this->window; blockX++)
+                    {
+                        if (!this->IsResident(blockX, blockY))
+                        {
+                            const int32_t distance = Math::Max<int32_t>(Math::Abs(blockX - cameraX), Math::Abs(blockY - cameraY));
+                            pending++;
+
+                            if (distance < bestDistance && (blockY * blocksX) + blockX != this->reading)
+                            {
+                                bestDistance = distance;
+                                bestX = blockX;
+                                bestY = blockY;
+                            }
+                        }
+                    }
+                }
+
+                this->statistics.Pending = pending;
+
+                if (bestX < 0 || load == loads)
+                {
+                    break;
+                }
+
+                if (this->staging != nullptr && !this->file->IsCached())
+                {
+                    // Drive reads one block at a time, the next one is started once this one is swapped in
+                    if (this->reading < 0 && !this->StartRead(bestX, bestY))
+                    {
+                        SRL::Debug::Assert("Heightmap block %d,%d could not be loaded", bestX, bestY);
+                    }
+
+                    break;
+                }
+
+                if (!this->LoadBlock(bestX, bestY))
+                {
+                    SRL::Debug::Assert("Heightmap block %d,%d could not be loaded", bestX, bestY);
+                }
+
+                this->statistics.Loaded++;
+            }
+
+            return this->statistics.Pending == 0;
+        }
+
+        /** @brief Select and draw terrain patches
+         * @note Current matrix must be the camera view, same as when drawing any other mesh
+         * @param camera Camera position
+         * @param slaveOnly Whether patches should be processed only on the slave CPU
+         */
+        void Draw(const Math::Types::Vector3D& camera, const bool slaveOnly = false)
+        {
+            this->statistics.Patches = 0;
+            this->statistics.Polygons = 0;
+            this->statistics.Culled = 0;
+            this->statistics.Missing = 0;
+            this->Select(camera);
+
+            // Mark level of every window cell, so patches can find coarser neighbours
+            const int32_t cells = this->window * (Terrain::BlockSize / Terrain::PatchSize);
+            const int32_t originX = this->windowX * Terrain::BlockSize;
+            const int32_t originY = this->windowY * Terrain::BlockSize;
+
+            for (int32_t cell = 0; cell < cells * cells; cell++)
+            {
+                this->levels[cell] = Terrain::NoLevel;
+            }
+
+            for (uint16_t leaf = 0; leaf < this->leafCount; leaf++)
+            {
+                const Node& node = this->leaves[leaf];
+
+                if (node.Resident)
+                {
+                    const int32_t cellX = (node.X - originX) / Terrain::PatchSize;
+                    const int32_t cellY = (node.Y - originY) / Terrain::PatchSize;
+
+                    for (int32_t y = cellY; y < cellY + (1 << node.Level); y++)
+                    {
+                        for (int32_t x = cellX; x < cellX + (1 << node.Level); x++)
+                        {
+                            this->levels[(y * cells) + x] = node.Level;
+                        }
+                    }
+                }
+            }
+
+            for (uint16_t leaf = 0; leaf < this->leafCount; leaf++)
+            {
+                const Node& node = this->leaves[leaf];
+
+                if (!node.Resident)
+                {
+                    continue;
+                }
+
+                const uint16_t patch = this->statistics.Patches++;
+                const int32_t step = 1 << node.Level;
+                Math::Types::Vector3D* points = this->vertices + (patch * Terrain::PatchVertices);
+
+                for (uint16_t row = 0; row <= Terrain::PatchSize; row++)
+                {
+                    for (uint16_t column = 0; column <= Terrain::PatchSize; column++)
+                    {
+                        const int32_t x = node.X + (column * step);
+                        const int32_t y = node.Y + (row * step);
+
+                        points[(row * (Terrain::PatchSize + 1)) + column] = Math::Types::Vector3D(
+                            Math::Types::Fxp::BuildRaw(x * this->cellSize.RawValue()),
+                            Math::Types::Fxp::BuildRaw(-(this->GetSample(x, y) * this->heightScale.RawValue())),
+                            Math::Types::Fxp::BuildRaw(y * this->cellSize.RawValue()));
+                    }
+                }
+
+                // Stitch edges that touch coarser patches
+                const int32_t cellX = (node.X - originX) / Terrain::PatchSize;
+                const int32_t cellY = (node.Y - originY) / Terrain::PatchSize;
+                const int32_t span = 1 << node.Level;
+                const uint8_t top = Terrain::GetDifference(node.Level, this->GetLevel(cellX, cellY - 1));
+                const uint8_t bottom = Terrain::GetDifference(node.Level, this->GetLevel(cellX, cellY + span));
+                const uint8_t left = Terrain::GetDifference(node.Level, this->GetLevel(cellX - 1, cellY));
+                const uint8_t right = Terrain::GetDifference(node.Level, this->GetLevel(cellX + span, cellY));
+
+                if (top != 0)
+                {
+                    Terrain::Stitch(points, 0, 1, top);
+                }
+
+                if (bottom != 0)
+                {
+                    Terrain::Stitch(points, Terrain::PatchSize * (Terrain::PatchSize + 1), 1, bottom);
+                }
+
+                if (left != 0)
+                {
+                    Terrain::Stitch(points, 0, Terrain::PatchSize + 1, left);
+                }
+
+                if (right != 0)
+                {
+                    Terrain::Stitch(points, Terrain::PatchSize, Terrain::PatchSize + 1, right);
+                }
+
+                PDATA& mesh = this->patches[patch];
+                mesh.pntbl = reinterpret_cast<POINT*>(points);
+                mesh.nbPoint = Terrain::PatchVertices;
+                mesh.pltbl = this->faces[0].SglPtr();
+                mesh.nbPolygon = Terrain::PatchPolygons;
+                mesh.attbl = this->attributes[0].SglPtr();
+
+                if (slaveOnly)
+                {
+                    slPutPolygonS(&mesh);
+                }
+                else
+                {
+                    slPutPolygon(&mesh);
+                }
+
+                this->statistics.Polygons += Terrain::PatchPolygons;
+            }
+        }
+
+        /** @brief Get terrain height at a point
+         * @param x Point X coordinate
+         * @param z Point Z coordinate
+         * @return Y coordinate of terrain surface (0 where heightmap is not loaded)
+         */
+        Math::Types::Fxp GetHeight(const Math::Types::Fxp x, const Math::Types::Fxp z) const
+        {
+            const int64_t sampleX = Math::Max<int64_t>(0, (static_cast<int64_t>(x.RawValue()) << 16) / this->cellSize.RawValue());
+            const int64_t sampleY = Math::Max<int64_t>(0, (static_cast<int64_t>(z.RawValue()) << 16) / this->cellSize.RawValue());
+            const int32_t column = static_cast<int32_t>(sampleX >> 16);
+            const int32_t row = static_cast<int32_t>(sampleY >> 16);
+            const int64_t fractionX = sampleX & 0xffff;
+            const int64_t fractionY = sampleY & 0xffff;
+
+            const int64_t top = (this->GetSample(column, row) * (0x10000 - fractionX)) + (this->GetSample(column + 1, row) * fractionX);
+            const int64_t bottom = (this->GetSample(column, row + 1) * (0x10000 - fractionX)) + (this->GetSample(column + 1, row + 1) * fractionX);
+            const int64_t sample = ((top * (0x10000 - fractionY)) + (bottom * fractionY)) >> 16;
+
+            return Math::Types::Fxp::BuildRaw(static_cast<int32_t>(-((sample * this->heightScale.RawValue()) >> 16)));
+        }
+
+        /** @brief Get heightmap width
+         * @return Number of samples in a row
+         */
+        uint16_t GetColumns() const
+        {
+            return this->width;
+        }
+
+        /** @brief Get heightmap height
+         * @return Number of rows
+         */
+        uint16_t GetRows() const
+        {
+            return this->height;
+        }
+
+        /** @brief Get statistics of last frame
+         * @return Statistics
+         */
+        const Statistics& GetStatistics() const
+        {
+            return this->statistics;
+        }
+    };
+}
@@ -0,0 +1,1088 @@
+#pragma once
+
+#include "srl_base.hpp"
+#include "srl_bitmap.hpp"
+#include "srl_core.hpp"
+#include "srl_debug.hpp"
+#include "srl_memory.hpp"
+#include "srl_mesh.hpp"
+#include "srl_vdp1.hpp"
+
+#ifndef SRL_TEXTURE_LOD_MAX_LEVELS
+/** @brief Maximal number of levels in texture LOD chain (full size level included)
+ */
+#define SRL_TEXTURE_LOD_MAX_LEVELS 4
+#endif
+
+#ifndef SRL_TEXTURE_LOD_VBLANK_BYTES
+/** @brief Maximal number of bytes copied to VDP1 memory by SRL::TextureLod during one vblank
+ */
+#define SRL_TEXTURE_LOD_VBLANK_BYTES 8192
+#endif
+
+namespace SRL
+{
+    /** @brief Texture level of detail chains with VDP1 memory residency manager
+     * @details Each texture is kept in work RAM as a chain of levels, every level is half the size of the previous one.
+     * Only the levels needed by the current frame are kept in a pool of VDP1 memory, distant faces draw from the small levels,
+     * which saves both VDP1 memory and VDP1 fill time.
+     *
+     * Every chain gets its own entry in SRL::VDP1::Textures, faces refer to it as to any other texture, manager changes the entry to point
+     * at the level being drawn. This works with both SRL::Scene3D::DrawMesh() and SRL::Renderer3D.
+     *
+     * Each frame meshes are passed to SRL::TextureLod::Request() with the same matrix they are drawn with, level of each textured face is picked
+     * from its projected size. SRL::TextureLod::Update() then loads the levels that are missing, evicting levels not drawn for a while when the pool is full.
+     * Levels are copied to VDP1 memory during vblank, until a level arrives, the nearest level already in VDP1 memory is drawn instead.
+     * The smallest level of each chain never leaves VDP1 memory, so there is always something to draw.
+     * @note Scaling of the current matrix is not taken into account when picking the level
+     * @code {.cpp}
+     * // 128KB of VDP1 memory for up to 32 textures
+     * SRL::TextureLod lod(128 * 1024, 32);
+     * SRL::Bitmap::TGA* grass = new SRL::Bitmap::TGA("GRASS.TGA");
+     * mesh.Attributes[0].Texture = lod.Add(grass);
+     * delete grass;
+     *
+     * // Each frame
+     * SRL::Scene3D::PushMatrix();
+     * SRL::Scene3D::Translate(position);
+     * lod.Request(mesh);
+     * SRL::Scene3D::DrawMesh(mesh);
+     * SRL::Scene3D::PopMatrix();
+     * lod.Update();
+     * SRL::Core::Synchronize();
+     * @endcode
+     */
+    class TextureLod
+    {
+    public:
+
+        /** @brief Statistics of the last update
+         */
+        struct Statistics
+        {
+            /** @brief Number of textures requested
+             */
+            uint16_t Requested;
+
+            /** @brief Number of textures drawn from another level than requested because the level is not in VDP1 memory yet
+             */
+            uint16_t Misses;
+
+            /** @brief Number of levels queued for copying to VDP1 memory
+             */
+            uint16_t Loads;
+
+            /** @brief Number of levels evicted from VDP1 memory
+             */
+            uint16_t Evictions;
+
+            /** @brief Number of bytes of the pool in use
+             */
+            size_t UsedMemory;
+        };
+
+        /** @brief Maximal number of levels in a chain
+         */
+        static constexpr uint8_t MaxLevels = SRL_TEXTURE_LOD_MAX_LEVELS;
+
+        /** @brief Number of updates level must stay unused before it can be evicted
+         * @details VDP1 draws the previous frame while the current one is being built, level memory can be reused only after both are done
+         */
+        static constexpr uint16_t EvictionDelay = 2;
+
+    private:
+
+        /** @brief Where the level data is
+         */
+        enum class LevelState : uint8_t
+        {
+            /** @brief Level is only in work RAM
+             */
+            Absent,
+
+            /** @brief Level has memory in the pool and waits for vblank to be copied there
+             */
+            Queued,
+
+            /** @brief Level is in VDP1 memory
+             */
+            Resident
+        };
+
+        /** @brief Level of a chain
+         */
+        struct Level
+        {
+            /** @brief Level image data in work RAM
+             */
+            uint8_t* Data;
+
+            /** @brief Size of the image data in bytes
+             */
+            uint32_t Size;
+
+            /** @brief Offset of the level in the pool
+             */
+            uint32_t Offset;
+
+            /** @brief Level width
+             */
+            uint16_t Width;
+
+            /** @brief Level height
+             */
+            uint16_t Height;
+
+            /** @brief Last update the level was drawn in
+             */
+            uint16_t LastUsed;
+
+            /** @brief Where the level data is
+             */
+            volatile LevelState State;
+        };
+
+        /** @brief Texture LOD chain
+         */
+        struct Chain
+        {
+            /** @brief Levels from the full size one
+             */
+            Level Levels[TextureLod::MaxLevels];
+
+            /** @brief Number of levels
+             */
+            uint8_t LevelCount;
+
+            /** @brief Most detailed level requested since last update
+             */
+            uint8_t Wanted;
+
+            /** @brief Level the texture entry points to
+             */
+            uint8_t Shown;
+        };
+
+        /** @brief Part of the pool
+         */
+        struct Block
+        {
+            /** @brief Offset from pool start
+             */
+            uint32_t Offset;
+
+            /** @brief Size in bytes
+             */
+            uint32_t Size;
+
+            /** @brief Level occupying the block (chain * SRL::TextureLod::MaxLevels + level), -1 if free
+             */
+            int16_t Owner;
+        };
+
+        /** @brief Level waiting to be copied to VDP1 memory
+         */
+        struct Upload
+        {
+            /** @brief Chain index
+             */
+            uint16_t Chain;
+
+            /** @brief Level index
+             */
+            uint8_t Level;
+        };
+
+        /** @brief Value of SRL::TextureLod::Chain::Wanted when texture was not requested
+         */
+        static constexpr uint8_t NotRequested = 0xff;
+
+        /** @brief Texture chains
+         */
+        Chain* chains;
+
+        /** @brief Number of added chains
+         */
+        uint16_t chainCount;
+
+        /** @brief Maximal number of chains
+         */
+        uint16_t maxTextures;
+
+        /** @brief Texture entry of the first chain, chains have consecutive entries
+         */
+        int32_t firstHandle;
+
+        /** @brief Pool address in VDP1 memory divided by 8
+         */
+        uint16_t poolAddress;
+
+        /** @brief Pool size in bytes
+         */
+        uint32_t poolSize;
+
+        /** @brief Pool blocks ordered by offset
+         */
+        Block* blocks;
+
+        /** @brief Number of pool blocks
+         */
+        uint16_t blockCount;
+
+        /** @brief Maximal number of pool blocks
+         */
+        uint16_t maxBlocks;
+
+        /** @brief Levels waiting for vblank, ring buffer filled by SRL::TextureLod::Update() and emptied in vblank
+         */
+        Upload* uploads;
+
+        /** @brief Capacity of the upload ring buffer
+         */
+        uint16_t uploadCapacity;
+
+        /** @brief First waiting upload
+         */
+        volatile uint16_t uploadHead;
+
+        /** @brief Slot for next upload
+         */
+        volatile uint16_t uploadTail;
+
+        /** @brief Number of bytes of the first waiting upload already copied
+         */
+        uint32_t uploadProgress;
+
+        /** @brief Levels are being copied by SRL::TextureLod::Flush()
+         */
+        volatile bool isFlushing;
+
+        /** @brief Update counter
+         */
+        uint16_t frame;
+
+        /** @brief Memory zone of chain data
+         */
+        Memory::Zone zone;
+
+        /** @brief Current matrix
+         */
+        FIXED matrix[4][3];
+
+        /** @brief Statistics of last update
+         */
+        TextureLod::Statistics statistics;
+
+        /** @brief Vblank handler copying levels
+         */
+        Types::MemberProxy<> uploadProxy;
+
+        /** @brief Get size of image data
+         * @param width Image width
+         * @param height Image height
+         * @param colorMode Image color mode
+         * @return Size in bytes
+         */
+        static uint32_t GetDataSize(const uint16_t width, const uint16_t height, const CRAM::TextureColorMode colorMode)
+        {
+            switch (colorMode)
+            {
+            case CRAM::TextureColorMode::RGB555:
+                return (width * height) << 1;
+
+            case CRAM::TextureColorMode::Paletted16:
+                return (width * height) >> 1;
+
+            default:
+                return width * height;
+            }
+        }
+
+        /** @brief Make image half the size
+         * @details RGB555 images average each 2x2 block of pixels, block with more transparent than opaque pixels becomes transparent.
+         * Paletted images keep the top left pixel of each block.
+         * @param source Source image data
+         * @param destination Destination image data
+         * @param width Source width
+         * @param height Source height
+         * @param colorMode Image color mode
+         */
+        static void Downscale(const uint8_t* source, uint8_t* destination, const uint16_t width, const uint16_t height, const CRAM::TextureColorMode colorMode)
+        {
+            const uint16_t halfWidth = width >> 1;
+            const uint16_t halfHeight = height >> 1;
+
+            if (colorMode == CRAM::TextureColorMode::RGB555)
+            {
+                const uint16_t* input = reinterpret_cast<const uint16_t*>(source);
+                uint16_t* output = reinterpret_cast<uint16_t*>(destination);
+
+                for (uint16_t y = 0; y < halfHeight; y++)
+                {
+                    for (uint16_t x = 0; x < halfWidth; x++)
+                    {
+                        const uint16_t* top = input + ((y << 1) * width) + (x << 1);
+                        const uint16_t pixels[4] = { top[0], top[1], top[width], top[width + 1] };
+                        uint16_t red = 0;
+                        uint16_t green = 0;
+                        uint16_t blue = 0;
+                        uint8_t opaque = 0;
+
+                        for (uint8_t pixel = 0; pixel < 4; pixel++)
+                        {
+                            if (pixels[pixel] != 0)
+                            {
+                                red += pixels[pixel] & 0x1f;
+                                green += (pixels[pixel] >> 5) & 0x1f;
+                                blue += (pixels[pixel] >> 10) & 0x1f;
+                                opaque++;
+                            }
+                        }
+
+                        output[(y * halfWidth) + x] = opaque < 2 ? 0 : 0x8000 | ((blue / opaque) << 10) | ((green / opaque) << 5) | (red / opaque);
+                    }
+                }
+            }
+            else if (colorMode == CRAM::TextureColorMode::Paletted16)
+            {
+                // Two pixels per byte, left one in the upper nibble
+                const uint16_t rowBytes = width >> 1;
+                const uint16_t halfRowBytes = halfWidth >> 1;
+
+                for (uint16_t y = 0; y < halfHeight; y++)
+                {
+                    const uint8_t* row = source + ((y << 1) * rowBytes);
+
+                    for (uint16_t x = 0; x < halfRowBytes; x++)
+                    {
+                        destination[(y * halfRowBytes) + x] = (row[x << 1] & 0xf0) | (row[(x << 1) + 1] >> 4);
+                    }
+                }
+            }
+            else
+            {
+                for (uint16_t y = 0; y < halfHeight; y++)
+                {
+                    const uint8_t* row = source + ((y << 1) * width);
+
+                    for (uint16_t x = 0; x < halfWidth; x++)
+                    {
+                        destination[(y * halfWidth) + x] = row[x << 1];
+                    }
+                }
+            }
+        }
+
+        /** @brief Allocate part of the pool
+         * @param size Size in bytes (multiple of 32)
+         * @param owner Level that will occupy the block
+         * @return Offset from pool start, -1 if there is no free block large enough
+         */
+        int32_t Allocate(const uint32_t size, const int16_t owner)
+        {
+            for (uint16_t block = 0; block < this->blockCount; block++)
+            {
+                Block& current = this->blocks[block];
+
+                if (current.Owner >= 0 || current.Size < size)
+                {
+                    continue;
+                }
+
+                if (current.Size > size)
+                {
+                    if (this->blockCount >= this->maxBlocks)
+                    {
+                        return -1;
+                    }
+
+                    for (uint16_t next = this->blockCount; next > block + 1; next--)
+                    {
+                        this->blocks[next] = this->blocks[next - 1];
+                    }
+
+                    this->blocks[block + 1] = Block { current.Offset + size, current.Size - size, -1 };
+                    this->blockCount++;
+                    current.Size = size;
+                }
+
+                current.Owner = owner;
+                return current.Offset;
+            }
+
+            return -1;
+        }
+
+        /** @brief Return block to the pool and merge it with free neighbors
+         * @param offset Offset of the block
+         */
+        void Release(const uint32_t offset)
+        {
+            uint16_t block = 0;
+
+            while (block < this->blockCount && this->blocks[block].Offset != offset)
+            {
+                block++;
+            }
+
+            if (block >= this->blockCount)
+            {
+                return;
+            }
+
+            this->blocks[block].Owner = -1;
+
+            if (block + 1 < this->blockCount && this->blocks[block + 1].Owner < 0)
+            {
+                this->Merge(block);
+            }
+
+            if (block > 0 && this->blocks[block - 1].Owner < 0)
+            {
+                this->Merge(block - 1);
+            }
+        }
+
+        /** @brief Merge block with the one following it
+         * @param block Block index
+         */
+        void Merge(const uint16_t block)
+        {
+            this->blocks[block].Size += this->blocks[block + 1].Size;
+            this->blockCount--;
+
+            for (uint16_t next = block + 1; next < this->blockCount; next++)
+            {
+                this->blocks[next] = this->blocks[next + 1];
+            }
+        }
+
+        /** @brief Rounded size of level in the pool
+         * @param level Level
+         * @return Size in bytes
+         */
+        static uint32_t GetPoolSize(const Level& level)
+        {
+            return (level.Size + 0x1f) & ~0x1f;
+        }
+
+        /** @brief Evict least recently used level that is safe to evict
+         * @return True if a level was evicted
+         */
+        bool Evict()
+        {
+            int32_t oldestChain = -1;
+            uint8_t oldestLevel = 0;
+            uint16_t oldestAge = 0;
+
+            for (uint16_t chain = 0; chain < this->chainCount; chain++)
+            {
+                Chain& current = this->chains[chain];
+
+                // Smallest level stays
+                for (uint8_t level = 0; level + 1 < current.LevelCount; level++)
+                {
+                    Level& candidate = current.Levels[level];
+                    const uint16_t age = this->frame - candidate.LastUsed;
+
+                    if (candidate.State == LevelState::Resident &&
+                        age >= TextureLod::EvictionDelay &&
+                        age >= oldestAge)
+                    {
+                        oldestChain = chain;
+                        oldestLevel = level;
+                        oldestAge = age;
+                    }
+                }
+            }
+
+            if (oldestChain < 0)
+            {
+                return false;
+            }
+
+            // Texture not drawn for a while falls back to its smallest level
+            Chain& owner = this->chains[oldestChain];
+
+            if (owner.Shown == oldestLevel)
+            {
+                this->Show(oldestChain, owner.LevelCount - 1);
+            }
+
+            owner.Levels[oldestLevel].State = LevelState::Absent;
+            this->Release(owner.Levels[oldestLevel].Offset);
+            this->statistics.Evictions++;
+            return true;
+        }
+
+        /** @brief Reserve pool memory for level and queue it for copying
+         * @param chain Chain index
+         * @param level Level index
+         */
+        void Load(const uint16_t chain, const uint8_t level)
+        {
+            Level& target = this->chains[chain].Levels[level];
+            const uint32_t size = TextureLod::GetPoolSize(target);
+            int32_t offset = this->Allocate(size, (chain * TextureLod::MaxLevels) + level);
+
+            while (offset < 0 && this->Evict())
+            {
+                offset = this->Allocate(size, (chain * TextureLod::MaxLevels) + level);
+            }
+
+            if (offset < 0)
+            {
+                return;
+            }
+
+            target.Offset = offset;
+            target.State = LevelState::Queued;
+            this->uploads[this->uploadTail] = Upload { chain, level };
+            this->uploadTail = (this->uploadTail + 1) % this->uploadCapacity;
+            this->statistics.Loads++;
+        }
+
+        /** @brief Point texture entry of the chain at level
+         * @param chain Chain index
+         * @param level Level index, must be in VDP1 memory
+         */
+        void Show(const uint16_t chain, const uint8_t level)
+        {
+            Chain& current = this->chains[chain];
+            const Level& shown = current.Levels[level];
+            current.Shown = level;
+            VDP1::Textures[this->firstHandle + chain] = VDP1::Texture(shown.Width, shown.Height, this->poolAddress + (shown.Offset >> 3));
+        }
+
+        /** @brief Copy queued levels to VDP1 memory
+         * @param budget Maximal number of bytes to copy
+         */
+        void CopyLevels(uint32_t budget)
+        {
+            while (budget > 0 && this->uploadHead != this->uploadTail)
+            {
+                const Upload& upload = this->uploads[this->uploadHead];
+                Level& level = this->chains[upload.Chain].Levels[upload.Level];
+                const uint32_t count = Math::Min<uint32_t>(budget, level.Size - this->uploadProgress);
+
+                // Sizes are multiples of 4, VDP1 memory is written by long words
+                const uint32_t* source = reinterpret_cast<const uint32_t*>(level.Data + this->uploadProgress);
+                uint32_t* destination = reinterpret_cast<uint32_t*>(SpriteVRAM + (this->poolAddress << 3) + level.Offset + this->uploadProgress);
+
+                for (uint32_t word = 0; word < (count >> 2); word++)
+                {
+                    destination[word] = source[word];
+                }
+
+                budget -= count;
+                this->uploadProgress += count;
+
+                if (this->uploadProgress >= level.Size)
+                {
+                    level.State = LevelState::Resident;
+                    this->uploadProgress = 0;
+                    this->uploadHead = (this->uploadHead + 1) % this->uploadCapacity;
+                }
+            }
+        }
+
+        /** @brief Vblank handler
+         */
+        void CopyLevelsInVblank()
+        {
+            if (this->isFlushing)
+            {
+                return;
+            }
+
+            this->CopyLevels(SRL_TEXTURE_LOD_VBLANK_BYTES);
+        }
+
+        /** @brief Pick coarsest level that still has at least one texel per pixel along the edge
+         * @param chain Texture chain
+         * @param texels Returns number of texels along the edge at given level
+         * @param edge Squared edge length in 1/16 units
+         * @param depth Face depth in 1/16 units
+         * @return Level index
+         */
+        template <typename Texels>
+        static uint8_t PickLevel(const Chain& chain, Texels texels, const int64_t edge, const int64_t depth)
+        {
+            const int64_t focal = MsScreenDist >> 16;
+
+            // Edge spans (edge * focal^2 / depth^2) pixels squared, very long edges need the full size level
+            if (edge > (INT64_MAX / Math::Max<int64_t>(1, focal * focal)))
+            {
+                return 0;
+            }
+
+            const int64_t pixels = edge * focal * focal;
+            const int64_t depthSquared = depth * depth;
+
+            for (uint8_t level = chain.LevelCount - 1; level > 0; level--)
+            {
+                const int64_t size = texels(chain.Levels[level]);
+
+                if (size * size * depthSquared >= pixels)
+                {
+                    return level;
+                }
+            }
+
+            return 0;
+        }
+
+        /** @brief Squared distance between two points in 1/16 units
+         * @param a First point
+         * @param b Second point
+         * @return Squared distance
+         */
+        static int64_t GetEdge(const Math::Types::Vector3D& a, const Math::Types::Vector3D& b)
+        {
+            const int64_t x = (static_cast<int64_t>(b.X.RawValue()) - a.X.RawValue()) >> 12;
+            const int64_t y = (static_cast<int64_t>(b.Y.RawValue()) - a.Y.RawValue()) >> 12;
+            const int64_t z = (static_cast<int64_t>(b.Z.RawValue()) - a.Z.RawValue()) >> 12;
+            return (x * x) + (y * y) + (z * z);
+        }
+
+        /** @brief Request levels for textured faces
+         * @param vertices Mesh vertices
+         * @param faces Mesh faces
+         * @param attributes Face attributes
+         * @param faceCount Number of faces
+         */
+        void RequestFaces(const Math::Types::Vector3D* vertices, const Types::Polygon* faces, const Types::Attribute* attributes, const size_t faceCount)
+        {
+            slGetMatrix(this->matrix);
+
+            for (size_t face = 0; face < faceCount; face++)
+            {
+                const Types::Attribute& attribute = attributes[face];
+                const int32_t chain = static_cast<int32_t>(attribute.Texture) - this->firstHandle;
+
+                if ((attribute.Sort & UseTexture) == 0 || chain < 0 || chain >= this->chainCount || this->chains[chain].Wanted == 0)
+                {
+                    continue;
+                }
+
+                const Types::Polygon& polygon = faces[face];
+                const Math::Types::Vector3D& a = vertices[polygon.Vertices[0]];
+                const Math::Types::Vector3D& b = vertices[polygon.Vertices[1]];
+                const Math::Types::Vector3D& c = vertices[polygon.Vertices[2]];
+                const Math::Types::Vector3D& d = vertices[polygon.Vertices[3]];
+
+                // Depth of the middle of the face diagonal
+                const int64_t x = (static_cast<int64_t>(a.X.RawValue()) + c.X.RawValue()) >> 1;
+                const int64_t y = (static_cast<int64_t>(a.Y.RawValue()) + c.Y.RawValue()) >> 1;
+                const int64_t z = (static_cast<int64_t>(a.Z.RawValue()) + c.Z.RawValue()) >> 1;
+                const int64_t depth = (((x * this->matrix[0][2]) + (y * this->matrix[1][2]) + (z * this->matrix[2][2])) >> 16) + this->matrix[3][2];
+                Chain& current = this->chains[chain];
+                uint8_t level = 0;
+
+                if (depth > (1 << 16))
+                {
+                    // Texture width maps to edge AB, texture height to edge AD
+                    const uint8_t horizontal = TextureLod::PickLevel(current, [](const Level& item) { return item.Width; }, TextureLod::GetEdge(a, b), depth >> 12);
+                    const uint8_t vertical = TextureLod::PickLevel(current, [](const Level& item) { return item.Height; }, TextureLod::GetEdge(a, d), depth >> 12);
+                    level = Math::Min<uint8_t>(horizontal, vertical);
+                }
+
+                current.Wanted = Math::Min<uint8_t>(current.Wanted, level);
+            }
+        }
+
+        /** @brief Add chain with prepared levels
+         * @param levels Image data of each level
+         * @param widths Width of each level
+         * @param heights Height of each level
+         * @param count Number of levels
+         * @param colorMode Image color mode
+         * @param palette Palette identifier (not used in RGB555 mode)
+         * @return Texture entry of the chain, -1 on failure
+         */
+        int32_t AddChain(uint8_t* const* levels, const uint16_t* widths, const uint16_t* heights, const uint8_t count, const CRAM::TextureColorMode colorMode, const uint16_t palette)
+        {
+            const uint16_t index = this->chainCount;
+            Chain& chain = this->chains[index];
+            chain.LevelCount = count;
+            chain.Wanted = TextureLod::NotRequested;
+
+            for (uint8_t level = 0; level < count; level++)
+            {
+                chain.Levels[level].Data = levels[level];
+                chain.Levels[level].Size = TextureLod::GetDataSize(widths[level], heights[level], colorMode);
+                chain.Levels[level].Offset = 0;
+                chain.Levels[level].Width = widths[level];
+                chain.Levels[level].Height = heights[level];
+                chain.Levels[level].LastUsed = this->frame;
+                chain.Levels[level].State = LevelState::Absent;
+            }
+
+            // Smallest level is copied right away and stays in VDP1 memory
+            Level& smallest = chain.Levels[count - 1];
+            const int32_t offset = this->Allocate(TextureLod::GetPoolSize(smallest), (index * TextureLod::MaxLevels) + count - 1);
+
+            if (offset < 0)
+            {
+                SRL::Debug::Assert("Texture LOD pool is too small for the smallest level");
+
+                for (uint8_t level = 0; level < count; level++)
+                {
+                    Memory::Free(levels[level]);
+                }
+
+                return -1;
+            }
+
+            smallest.Offset = offset;
+            slDMACopy(smallest.Data, reinterpret_cast<void*>(SpriteVRAM + (this->poolAddress << 3) + offset), smallest.Size);
+            slDMAWait();
+            smallest.State = LevelState::Resident;
+
+            VDP1::Metadata[this->firstHandle + index] = VDP1::TextureMetadata(colorMode, palette);
+            this->chainCount++;
+            this->Show(index, count - 1);
+            return this->firstHandle + index;
+        }
+
+    public:
+
+        /** @brief Construct texture LOD manager
+         * @details Texture entries of all chains and the pool are allocated in VDP1 memory right away
+         * @param poolSize Size of the VDP1 memory pool in bytes
+         * @param maxTextures Maximal number of texture chains
+         * @param zone Memory zone to keep level image data in
+         */
+        TextureLod(const size_t poolSize, const uint16_t maxTextures, const Memory::Zone zone = Memory::Zone::LWRam) :
+            chainCount(0),
+            maxTextures(0),
+            firstHandle(-1),
+            poolAddress(0),
+            poolSize(0),
+            blockCount(1),
+            uploadHead(0),
+            uploadTail(0),
+            uploadProgress(0),
+            isFlushing(false),
+            frame(0),
+            zone(zone),
+            statistics { 0, 0, 0, 0, 0 },
+            uploadProxy(this, &TextureLod::CopyLevelsInVblank)
+        {
+            this->chains = reinterpret_cast<Chain*>(Memory::Malloc(sizeof(Chain) * Math::Max<size_t>(1, maxTextures), zone));
+            this->maxBlocks = (maxTextures * TextureLod::MaxLevels * 2) + 1;
+            this->blocks = reinterpret_cast<Block*>(Memory::Malloc(sizeof(Block) * this->maxBlocks, zone));
+            this->uploadCapacity = (maxTextures * TextureLod::MaxLevels) + 1;
+            this->uploads = reinterpret_cast<Upload*>(Memory::Malloc(sizeof(Upload) * this->uploadCapacity, zone));
+
+            // Texture entries take no memory, pool is allocated after them so that the entries can point anywhere in it
+            for (uint16_t texture = 0; texture < maxTextures; texture++)
+            {
+                const int32_t handle = VDP1::TryAllocateTexture(0, 0, CRAM::TextureColorMode::RGB555, 0);
+
+                if (handle < 0)
+                {
+                    break;
+                }
+
+                this->firstHandle = texture == 0 ? handle : this->firstHandle;
+                this->maxTextures++;
+            }
+
+            // Pool is a 16 pixel wide RGB555 texture, 32 bytes per row
+            const int32_t pool = VDP1::TryAllocateTexture(16, static_cast<uint16_t>(Math::Min<size_t>(poolSize >> 5, 0xffff)), CRAM::TextureColorMode::RGB555, 0);
+
+            if (pool < 0 || this->maxTextures < maxTextures)
+            {
+                SRL::Debug::Assert("Not enough VDP1 memory for texture LOD pool of %d bytes", poolSize);
+                this->maxTextures = 0;
+            }
+            else
+            {
+                this->poolAddress = VDP1::Textures[pool].Address;
+                this->poolSize = VDP1::Textures[pool].Height << 5;
+            }
+
+            this->blocks[0] = Block { 0, this->poolSize, -1 };
+            Core::OnVblank += &this->uploadProxy;
+        }
+
+        /** @brief Disable copying
+         */
+        TextureLod(const TextureLod&) = delete;
+
+        /** @brief Disable copying
+         */
+        TextureLod& operator=(const TextureLod&) = delete;
+
+        /** @brief Destroy texture LOD manager
+         * @note Texture entries and the pool stay allocated in VDP1 memory until texture heap is reset
+         */
+        ~TextureLod()
+        {
+            Core::OnVblank -= &this->uploadProxy;
+
+            for (uint16_t chain = 0; chain < this->chainCount; chain++)
+            {
+                for (uint8_t level = 0; level < this->chains[chain].LevelCount; level++)
+                {
+                    Memory::Free(this->chains[chain].Levels[level].Data);
+                }
+            }
+
+            Memory::Free(this->chains);
+            Memory::Free(this->blocks);
+            Memory::Free(this->uploads);
+        }
+
+        /** @brief Add texture and build its chain by halving it until width is no longer a multiple of 8
+         * @details Image data is copied, bitmap can be deleted afterwards
+         * @param bitmap Full size texture (width must be a multiple of 8)
+         * @param palette Palette identifier (not used in RGB555 mode)
+         * @param levels Maximal number of levels
+         * @return Texture entry to use in face attributes, -1 on failure
+         */
+        int32_t Add(Bitmap::IBitmap* bitmap, const uint16_t palette = 0, const uint8_t levels = TextureLod::MaxLevels)
+        {
+            if (this->chainCount >= this->maxTextures)
+            {
+                return -1;
+            }
+
+            const Bitmap::BitmapInfo info = bitmap->GetInfo();
+            uint8_t* data[TextureLod::MaxLevels];
+            uint16_t widths[TextureLod::MaxLevels];
+            uint16_t heights[TextureLod::MaxLevels];
+            uint8_t count = 1;
+            widths[0] = info.Width;
+            heights[0] = info.Height;
+
+            while (count < Math::Min<uint8_t>(levels, TextureLod::MaxLevels) &&
+                ((widths[count - 1] >> 1) & 0x7) == 0 &&
+                (widths[count - 1] >> 1) >= 8 &&
+                (heights[count - 1] >> 1) >= 1)
+            {
+                widths[count] = widths[count - 1] >> 1;
+                heights[count] = heights[count - 1] >> 1;
+                count++;
+            }
+
+            for (uint8_t level = 0; level < count; level++)
+            {
+                data[level] = reinterpret_cast<uint8_t*>(Memory::Malloc(TextureLod::GetDataSize(widths[level], heights[level], info.ColorMode), this->zone));
+
+                if (level == 0)
+                {
+                    slDMACopy(bitmap->GetData(), data[0], TextureLod::GetDataSize(info.Width, info.Height, info.ColorMode));
+                    slDMAWait();
+
+                    // DMA bypasses cache, lines of previous use of this memory would be read by Downscale
+                    slCashPurge();
+                }
+                else
+                {
+                    TextureLod::Downscale(data[level - 1], data[level], widths[level - 1], heights[level - 1], info.ColorMode);
+                }
+            }
+
+            return this->AddChain(data, widths, heights, count, info.ColorMode, palette);
+        }
+
+        /** @brief Add texture with levels prepared in advance
+         * @details Image data is copied, bitmaps can be deleted afterwards
+         * @param levels Levels from the full size one, all in the same color mode (widths must be multiples of 8)
+         * @param count Number of levels
+         * @param palette Palette identifier (not used in RGB555 mode)
+         * @return Texture entry to use in face attributes, -1 on failure
+         */
+        int32_t Add(Bitmap::IBitmap* const* levels, const uint8_t count, const uint16_t palette = 0)
+        {
+            if (this->chainCount >= this->maxTextures || count == 0 || count > TextureLod::MaxLevels)
+            {
+                return -1;
+            }
+
+            uint8_t* data[TextureLod::MaxLevels];
+            uint16_t widths[TextureLod::MaxLevels];
+            uint16_t heights[TextureLod::MaxLevels];
+            const CRAM::TextureColorMode colorMode = levels[0]->GetInfo().ColorMode;
+
+            for (uint8_t level = 0; level < count; level++)
+            {
+                const Bitmap::BitmapInfo info = levels[level]->GetInfo();
+                const uint32_t size = TextureLod::GetDataSize(info.Width, info.Height, colorMode);
+                widths[level] = info.Width;
+                heights[level] = info.Height;
+                data[level] = reinterpret_cast<uint8_t*>(Memory::Malloc(size, this->zone));
+                slDMACopy(levels[level]->GetData(), data[level], size);
+                slDMAWait();
+            }
+
+            // DMA bypasses cache, drop stale lines of the new buffers before CPU reads them
+            slCashPurge();
+
+            return this->AddChain(data, widths, heights, count, colorMode, palette);
+        }
+
+        /** @brief Request levels for textured faces of a mesh using the current matrix
+         * @details Faces using textures not added to this manager are skipped
+         * @param mesh Mesh about to be drawn
+         */
+        void Request(const Types::Mesh& mesh)
+        {
+            this->RequestFaces(mesh.Vertices, mesh.Faces, mesh.Attributes, mesh.FaceCount);
+        }
+
+        /** @brief Request levels for textured faces of a mesh using the current matrix
+         * @details Faces using textures not added to this manager are skipped
+         * @param mesh Mesh about to be drawn
+         */
+        void Request(const Types::SmoothMesh& mesh)
+        {
+            this->RequestFaces(mesh.Vertices, mesh.Faces, mesh.Attributes, mesh.FaceCount);
+        }
+
+        /** @brief Request level of a texture directly
+         * @param texture Texture entry returned by SRL::TextureLod::Add()
+         * @param level Level index, 0 is the full size
+         */
+        void Request(const uint16_t texture, const uint8_t level)
+        {
+            const int32_t chain = static_cast<int32_t>(texture) - this->firstHandle;
+
+            if (chain >= 0 && chain < this->chainCount)
+            {
+                Chain& current = this->chains[chain];
+                current.Wanted = Math::Min<uint8_t>(current.Wanted, Math::Min<uint8_t>(level, current.LevelCount - 1));
+            }
+        }
+
+        /** @brief Load requested levels and point texture entries at the best levels in VDP1 memory
+         * @details Call once per frame after all requests. Textures not requested keep their level, their levels can be evicted
+         * once they were not drawn for SRL::TextureLod::EvictionDelay updates.
+         */
+        void Update()
+        {
+            this->statistics = TextureLod::Statistics { 0, 0, 0, 0, 0 };
+            this->frame++;
+
+            for (uint16_t chain = 0; chain < this->chainCount; chain++)
+            {
+                Chain& current = this->chains[chain];
+
+                if (current.Wanted == TextureLod::NotRequested)
+                {
+                    continue;
+                }
+
+                const uint8_t wanted = current.Wanted;
+                current.Wanted = TextureLod::NotRequested;
+                this->statistics.Requested++;
+
+                if (current.Levels[wanted].State == LevelState::Absent)
+                {
+                    this->Load(chain, wanted);
+                }
+
+                // Nearest level in VDP1 memory, more detailed one is preferred, smallest level is always there
+                uint8_t best = current.LevelCount - 1;
+
+                for (uint8_t distance = 0; distance < current.LevelCount; distance++)
+                {
+                    if (wanted >= distance && current.Levels[wanted - distance].State == LevelState::Resident)
+                    {
+                        best = wanted - distance;
+                        break;
+                    }
+
+                    if (wanted + distance < current.LevelCount && current.Levels[wanted + distance].State == LevelState::Resident)
+                    {
+                        best = wanted + distance;
+                        break;
+                    }
+                }
+
+                if (best != wanted)
+                {
+                    this->statistics.Misses++;
+                }
+
+                // Previous level was drawn until now
+                current.Levels[current.Shown].LastUsed = this->frame;
+
+                if (best != current.Shown)
+                {
+                    this->Show(chain, best);
+                }
+
+                current.Levels[best].LastUsed = this->frame;
+            }
+
+            for (uint16_t block = 0; block < this->blockCount; block++)
+            {
+                if (this->blocks[block].Owner >= 0)
+                {
+                    this->statistics.UsedMemory += this->blocks[block].Size;
+                }
+            }
+        }
+
+        /** @brief Copy all queued levels to VDP1 memory right away instead of waiting for vblanks
+         * @note Use when VDP1 is not drawing, for example on a loading screen
+         */
+        void Flush()
+        {
+            // Keep vblank handler from copying the same level
+            this->isFlushing = true;
+            this->CopyLevels(this->poolSize);
+            this->isFlushing = false;
+        }
+
+        /** @brief Check whether some levels still wait to be copied to VDP1 memory
+         * @return True if copying is not finished
+         */
+        bool IsLoading() const
+        {
+            return this->uploadHead != this->uploadTail;
+        }
+
+        /** @brief Get level the texture is drawn with
+         * @param texture Texture entry returned by SRL::TextureLod::Add()
+         * @return Level index, 0 is the full size
+         */
+        uint8_t GetLevel(const uint16_t texture) const
+        {
+            const int32_t chain = static_cast<int32_t>(texture) - this->firstHandle;
+            return chain >= 0 && chain < this->chainCount ? this->chains[chain].Shown : 0;
+        }
+
+        /** @brief Get number of levels of the texture
+         * @param texture Texture entry returned by SRL::TextureLod::Add()
+         * @return Number of levels
+         */
+        uint8_t GetLevelCount(const uint16_t texture) const
+        {
+            const int32_t chain = static_cast<int32_t>(texture) - this->firstHandle;
+            return chain >= 0 && chain < this->chainCount ? this->chains[chain].LevelCount : 0;
+        }
+
+        /** @brief Get image data of a level kept in work RAM
+         * @param texture Texture entry returned by SRL::TextureLod::Add()
+         * @param level Level index, 0 is the full size
+         * @return Image data, nullptr if there is no such level
+         */
+        const uint8_t* GetLevelData(const uint16_t texture, const uint8_t level) const
+        {
+            const int32_t chain = static_cast<int32_t>(texture) - this->firstHandle;
+            return chain >= 0 && chain < this->chainCount && level < this->chains[chain].LevelCount ? this->chains[chain].Levels[level].Data : nullptr;
+        }
+
+        /** @brief Get statistics of the last update
+         * @return Statistics
+         */
+        const TextureLod::Statistics& GetStatistics() const
+        {
+            return this->statistics;
+        }
+    };
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "srl_base.hpp"
+
+namespace SRL
+{
+    /** @brief CPU free running timer, used to measure execution time of code
+     * @details Each SH2 has its own 16-bit free running timer (FRT), measurements are valid only on the CPU that started them.
+     * @code {.cpp}
+     * SRL::Timer::Stopwatch stopwatch;
+     * stopwatch.Start();
+     *
+     * // Code to measure
+     *
+     * uint32_t time = stopwatch.GetMicroseconds();
+     * @endcode
+     */
+    class Timer
+    {
+    private:
+
+        /** @brief Free running counter high byte register
+         * @note High byte must be read first, reading it latches low byte
+         */
+        inline static volatile uint8_t* const CounterHigh = (volatile uint8_t*)0xfffffe12;
+
+        /** @brief Free running counter low byte register
+         */
+        inline static volatile uint8_t* const CounterLow = (volatile uint8_t*)0xfffffe13;
+
+        /** @brief Timer control register
+         */
+        inline static volatile uint8_t* const Control = (volatile uint8_t*)0xfffffe16;
+
+        /** @brief Disable constructor
+         */
+        Timer() = delete;
+
+        /** @brief Disable destructor
+         */
+        ~Timer() = delete;
+
+    public:
+
+        /** @brief CPU clock frequency in Hz
+         * @note Depends on horizontal resolution of the selected TV mode
+         */
+#if defined(SRL_MODE_PAL)
+    #if defined(SRL_HIGH_RES)
+        static constexpr uint32_t CpuClock = 28437500;
+    #else
+        static constexpr uint32_t CpuClock = 26687500;
+    #endif
+#else
+    #if defined(SRL_HIGH_RES)
+        static constexpr uint32_t CpuClock = 28636360;
+    #else
+        static constexpr uint32_t CpuClock = 26846587;
+    #endif
+#endif
+
+        /** @brief Timer clock divider
+         */
+        enum class Divider : uint8_t
+        {
+            /** @brief Counter increases every 8 CPU cycles
+             */
+            By8 = 0,
+
+            /** @brief Counter increases every 32 CPU cycles
+             */
+            By32 = 1,
+
+            /** @brief Counter increases every 128 CPU cycles
+             */
+            By128 = 2
+        };
+
+        /** @brief Set clock divider of the free running timer of the current CPU
+         * @param divider Clock divider
+         */
+        inline static void SetDivider(const Timer::Divider divider)
+        {
+            *Timer::Control = (*Timer::Control & 0xfc) | static_cast<uint8_t>(divider);
+        }
+
+        /** @brief Get clock divider of the free running timer of the current CPU
+         * @return Clock divider
+         */
+        inline static Timer::Divider GetDivider()
+        {
+            return static_cast<Timer::Divider>(*Timer::Control & 0x03);
+        }
+
+        /** @brief Get current value of the free running counter of the current CPU
+         * @return Counter value
+         */
+        inline static uint16_t GetTicks()
+        {
+            uint16_t high = *Timer::CounterHigh;
+            return (high << 8) | *Timer::CounterLow;
+        }
+
+        /** @brief Convert timer ticks to microseconds
+         * @param ticks Number of ticks
+         * @param divider Clock divider the ticks were measured with
+         * @return Number of microseconds
+         */
+        inline static uint32_t TicksToMicroseconds(const uint32_t ticks, const Timer::Divider divider)
+        {
+            const uint64_t cycles = static_cast<uint64_t>(ticks) << (3 + (static_cast<uint8_t>(divider) << 1));
+            return static_cast<uint32_t>((cycles * 1000000) / Timer::CpuClock);
+        }
+
+        /** @brief Measures elapsed time on the current CPU
+         * @warning Counter wraps around after 65536 ticks (about 312ms with default divider), use SRL::Timer::Stopwatch::Lap() to measure longer intervals
+         */
+        class Stopwatch
+        {
+        private:
+
+            /** @brief Counter value at last lap
+             */
+            uint16_t lastTicks;
+
+            /** @brief Accumulated ticks
+             */
+            uint32_t elapsed;
+
+            /** @brief Clock divider used
+             */
+            Timer::Divider divider;
+
+        public:
+
+            /** @brief Construct a new stopwatch
+             * @param divider Clock divider to use, this changes divider of the timer of the current CPU when started
+             */
+            Stopwatch(const Timer::Divider divider = Timer::Divider::By128) : lastTicks(0), elapsed(0), divider(divider) { }
+
+            /** @brief Reset and start measuring
+             */
+            void Start()
+            {
+                Timer::SetDivider(this->divider);
+                this->elapsed = 0;
+                this->lastTicks = Timer::GetTicks();
+            }
+
+            /** @brief Accumulate ticks elapsed since last call, call this at least once per counter wrap around
+             * @return Number of ticks elapsed since start
+             */
+            uint32_t Lap()
+            {
+                const uint16_t now = Timer::GetTicks();
+                this->elapsed += static_cast<uint16_t>(now - this->lastTicks);
+                this->lastTicks = now;
+                return this->elapsed;
+            }
+
+            /** @brief Get number of ticks elapsed since start
+             * @return Number of ticks
+             */
+            uint32_t GetTicks()
+            {
+                return this->Lap();
+            }
+
+            /** @brief Get number of microseconds elapsed since start
+             * @return Number of microseconds
+             */
+            uint32_t GetMicroseconds()
+            {
+                return Timer::TicksToMicroseconds(this->Lap(), this->divider);
+            }
+        };
+    };
+}
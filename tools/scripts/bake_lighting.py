@@ -0,0 +1,276 @@
+import argparse
+import math
+import struct
+
+from optimize_mesh import FIXED_ONE, compute_normals, cross, dot, normalize, read_nya, subtract
+
+# Baked table file layout (see SRL::BakedLighting in saturnringlib/srl_lighting.hpp)
+# Header: "BAKE", number of entries, followed by four RGB555 colors per entry (one entry per face)
+# Everything is big endian
+MAGIC = b"BAKE"
+
+# Gouraud value that leaves face color unchanged
+NEUTRAL = 16
+
+# Leaf size of ray tracing hierarchy
+LEAF_SIZE = 4
+
+
+def parse_numbers(text, count, name):
+    values = [float(value) for value in text.split(",")]
+
+    if len(values) != count:
+        raise ValueError("{0} expects {1} comma separated numbers, got '{2}'".format(name, count, text))
+
+    return values
+
+
+class Occluders:
+    """Bounding volume hierarchy over triangles answering whether a segment hits anything."""
+
+    def __init__(self, triangles):
+        self.triangles = triangles
+        self.nodes = []
+        self.order = list(range(len(triangles)))
+        self.centers = [tuple((a[axis] + b[axis] + c[axis]) / 3.0 for axis in range(3)) for a, b, c in triangles]
+
+        if triangles:
+            self.build(0, len(triangles))
+
+    def build(self, start, end):
+        """Build node over triangles in order[start:end], returns node index.
+        Node is (minimum, maximum, first child or -1, second child or first triangle, triangle count)."""
+        minimum = [float("inf")] * 3
+        maximum = [float("-inf")] * 3
+
+        for index in self.order[start:end]:
+            for point in self.triangles[index]:
+                for axis in range(3):
+                    minimum[axis] = min(minimum[axis], point[axis])
+                    maximum[axis] = max(maximum[axis], point[axis])
+
+        node = len(self.nodes)
+        self.nodes.append(None)
+
+        if end - start <= LEAF_SIZE:
+            self.nodes[node] = (minimum, maximum, -1, start, end - start)
+            return node
+
+        # Split at median of the longest axis
+        axis = max(range(3), key=lambda value: maximum[value] - minimum[value])
+        self.order[start:end] = sorted(self.order[start:end], key=lambda index: self.centers[index][axis])
+        middle = (start + end) // 2
+        first = self.build(start, middle)
+        second = self.build(middle, end)
+        self.nodes[node] = (minimum, maximum, first, second, 0)
+        return node
+
+    @staticmethod
+    def hits_box(origin, inverse, length, minimum, maximum):
+        near = 0.0
+        far = length
+
+        for axis in range(3):
+            if inverse[axis] is None:
+                if origin[axis] < minimum[axis] or origin[axis] > maximum[axis]:
+                    return False
+
+                continue
+
+            first = (minimum[axis] - origin[axis]) * inverse[axis]
+            second = (maximum[axis] - origin[axis]) * inverse[axis]
+
+            if first > second:
+                first, second = second, first
+
+            near = max(near, first)
+            far = min(far, second)
+
+            if near > far:
+                return False
+
+        return True
+
+    def hits_triangle(self, origin, direction, length, triangle):
+        """Moller-Trumbore intersection, hits closer than length count."""
+        a, b, c = self.triangles[triangle]
+        edge_first = subtract(b, a)
+        edge_second = subtract(c, a)
+        p = cross(direction, edge_second)
+        determinant = dot(edge_first, p)
+
+        if abs(determinant) < 1e-12:
+            return False
+
+        inverse = 1.0 / determinant
+        offset = subtract(origin, a)
+        u = dot(offset, p) * inverse
+
+        if u < 0.0 or u > 1.0:
+            return False
+
+        q = cross(offset, edge_first)
+        v = dot(direction, q) * inverse
+
+        if v < 0.0 or u + v > 1.0:
+            return False
+
+        distance = dot(edge_second, q) * inverse
+        return 0.0 < distance < length
+
+    def is_blocked(self, origin, direction, length):
+        """Check whether anything lies on segment from origin along unit direction."""
+        if not self.nodes:
+            return False
+
+        inverse = [None if abs(component) < 1e-12 else 1.0 / component for component in direction]
+        stack = [0]
+
+        while stack:
+            minimum, maximum, first, second, count = self.nodes[stack.pop()]
+
+            if not Occluders.hits_box(origin, inverse, length, minimum, maximum):
+                continue
+
+            if first < 0:
+                for index in self.order[second:second + count]:
+                    if self.hits_triangle(origin, direction, length, index):
+                        return True
+            else:
+                stack.append(first)
+                stack.append(second)
+
+        return False
+
+
+def hemisphere(count):
+    """Cosine weighted directions around +Z axis on a spiral, same for every vertex so bakes are repeatable."""
+    golden = math.pi * (3.0 - math.sqrt(5.0))
+    directions = []
+
+    for index in range(count):
+        radius = math.sqrt((index + 0.5) / count)
+        angle = index * golden
+        directions.append((radius * math.cos(angle), radius * math.sin(angle), math.sqrt(max(0.0, 1.0 - (radius * radius)))))
+
+    return directions
+
+
+def to_basis(direction, normal):
+    """Rotate direction around +Z axis into space around normal."""
+    helper = (1.0, 0.0, 0.0) if abs(normal[0]) < 0.9 else (0.0, 1.0, 0.0)
+    tangent = normalize(cross(helper, normal))
+    bitangent = cross(normal, tangent)
+    return tuple((tangent[axis] * direction[0]) + (bitangent[axis] * direction[1]) + (normal[axis] * direction[2]) for axis in range(3))
+
+
+def bake(meshes, arguments):
+    """Compute four gouraud colors for each face of each mesh, returns list of colors per face."""
+    points = [[tuple(coordinate / FIXED_ONE for coordinate in point) for point in mesh.points] for mesh in meshes]
+    triangles = []
+
+    # Whole model shades itself
+    for mesh, mesh_points in zip(meshes, points):
+        for face in mesh.faces:
+            for corner in range(1, len(face) - 1):
+                triangles.append((mesh_points[face[0]], mesh_points[face[corner]], mesh_points[face[corner + 1]]))
+
+    occluders = Occluders(triangles)
+    everything = [point for mesh_points in points for point in mesh_points]
+
+    if not everything:
+        return []
+
+    diagonal = math.sqrt(sum((max(point[axis] for point in everything) - min(point[axis] for point in everything)) ** 2 for axis in range(3)))
+    ao_distance = arguments.ao_distance if arguments.ao_distance is not None else diagonal * 0.1
+    bias = max(diagonal * 1e-4, 1e-4)
+    directions = hemisphere(arguments.ao_rays)
+    ambient = parse_numbers(arguments.ambient, 3, "--ambient")
+    lights = [parse_numbers(light, 7, "--light") for light in arguments.light]
+    suns = [parse_numbers(sun, 6, "--sun") for sun in arguments.sun]
+    entries = []
+
+    for mesh, mesh_points in zip(meshes, points):
+        _, vertex_normals = compute_normals(mesh)
+        colors = []
+
+        for point, normal in zip(mesh_points, vertex_normals):
+            origin = tuple(point[axis] + (normal[axis] * bias) for axis in range(3))
+
+            # Ambient occlusion, share of hemisphere rays that escape
+            visible = 1.0
+
+            if directions and ao_distance > 0.0 and normal != (0.0, 0.0, 0.0):
+                blocked = sum(1 for direction in directions if occluders.is_blocked(origin, to_basis(direction, normal), ao_distance))
+                visible = 1.0 - (arguments.ao_strength * blocked / len(directions))
+
+            color = [channel * visible for channel in ambient]
+
+            for x, y, z, radius, red, green, blue in lights:
+                offset = (x - point[0], y - point[1], z - point[2])
+                distance = math.sqrt(dot(offset, offset))
+
+                if distance >= radius:
+                    continue
+
+                intensity = 1.0 - (distance / radius)
+
+                if distance > 0.0:
+                    direction = (offset[0] / distance, offset[1] / distance, offset[2] / distance)
+                    intensity *= dot(direction, normal)
+
+                    if intensity <= 0.0 or (arguments.shadows and occluders.is_blocked(origin, direction, distance)):
+                        continue
+
+                color = [color[0] + (red * intensity), color[1] + (green * intensity), color[2] + (blue * intensity)]
+
+            for dx, dy, dz, red, green, blue in suns:
+                # Direction the light travels, towards the light is the opposite
+                direction = normalize((-dx, -dy, -dz))
+                intensity = dot(direction, normal)
+
+                if intensity <= 0.0 or (arguments.shadows and occluders.is_blocked(origin, direction, diagonal * 2.0)):
+                    continue
+
+                color = [color[0] + (red * intensity), color[1] + (green * intensity), color[2] + (blue * intensity)]
+
+            channels = [max(0, min(31, int(round(channel)))) for channel in color]
+            colors.append(0x8000 | (channels[2] << 10) | (channels[1] << 5) | channels[0])
+
+        for face in mesh.faces:
+            corners = face + [face[2]] if len(face) == 3 else face
+            entries.append([colors[corner] for corner in corners])
+
+    return entries
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Bake ambient occlusion and static lights of a model into gouraud table loaded by SRL::BakedLighting")
+    parser.add_argument("input", help="Model file (.NYA), faces are baked in the order they are stored")
+    parser.add_argument("output", help="Output baked table file")
+    parser.add_argument("--ambient", default="{0},{0},{0}".format(NEUTRAL), help="Ambient color R,G,B (0-31, 16 leaves face color unchanged)")
+    parser.add_argument("--light", action="append", default=[], help="Point light X,Y,Z,RADIUS,R,G,B in model coordinates, can be repeated")
+    parser.add_argument("--sun", action="append", default=[], help="Directional light DX,DY,DZ,R,G,B (direction the light travels), can be repeated")
+    parser.add_argument("--ao-rays", type=int, default=32, help="Number of ambient occlusion rays per vertex, 0 disables ambient occlusion")
+    parser.add_argument("--ao-distance", type=float, default=None, help="Length of ambient occlusion rays (default is 10%% of model size)")
+    parser.add_argument("--ao-strength", type=float, default=1.0, help="How much fully occluded vertex loses of ambient color (0-1)")
+    parser.add_argument("--shadows", action="store_true", help="Lights are blocked by the model")
+    arguments = parser.parse_args()
+
+    _, meshes, _ = read_nya(arguments.input)
+    entries = bake(meshes, arguments)
+
+    output = bytearray(MAGIC + struct.pack(">I", len(entries)))
+
+    for entry in entries:
+        output += struct.pack(">HHHH", *entry)
+
+    with open(arguments.output, "wb") as file:
+        file.write(output)
+
+    print("{0} meshes, {1} points, {2} entries, {3} bytes".format(
+        len(meshes), sum(len(mesh.points) for mesh in meshes), len(entries), len(output)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,190 @@
+import argparse
+import struct
+
+# LZ4 block format constants
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MATCH_SEARCH_LIMIT = 12
+MAX_OFFSET = 0xffff
+HASH_BITS = 16
+
+# Boot stub header offsets (see modules/sgl/SRC/bootstub.c)
+HEADER_IMAGE_SIZE = 4
+HEADER_UNCOMPRESSED_SIZE = 8
+
+# CD sector size and single/double speed transfer rates (bytes per second)
+SECTOR_SIZE = 2048
+CD_SPEED_1X = 150 * 1024
+CD_SPEED_2X = 300 * 1024
+
+# Assumed LZ4 decompression speed on SH2 from HWRam to HWRam (bytes per second), not measured on hardware
+SH2_DECOMPRESS_SPEED = 4 * 1024 * 1024
+
+
+def write_length(output, length):
+    """Write LZ4 extended length (length - 15 was already subtracted by caller)."""
+    while length >= 255:
+        output.append(255)
+        length -= 255
+    output.append(length)
+
+
+def write_sequence(output, literals, match_length, offset):
+    """Write one LZ4 sequence, match_length of 0 means last sequence without match."""
+    literal_length = len(literals)
+    token = min(literal_length, 15) << 4
+
+    if match_length > 0:
+        token |= min(match_length - MIN_MATCH, 15)
+
+    output.append(token)
+
+    if literal_length >= 15:
+        write_length(output, literal_length - 15)
+
+    output += literals
+
+    if match_length > 0:
+        output += struct.pack("<H", offset)
+
+        if match_length - MIN_MATCH >= 15:
+            write_length(output, match_length - MIN_MATCH - 15)
+
+
+def compress(data):
+    """Compress data into LZ4 block format using greedy hash matching."""
+    output = bytearray()
+    table = {}
+    size = len(data)
+    anchor = 0
+    position = 0
+    match_limit = size - MATCH_SEARCH_LIMIT
+    end_limit = size - LAST_LITERALS
+
+    while position < match_limit:
+        sequence = data[position:position + MIN_MATCH]
+        candidate = table.get(sequence)
+        table[sequence] = position
+
+        if candidate is None or position - candidate > MAX_OFFSET:
+            position += 1
+            continue
+
+        # Extend match forward, last bytes must stay literals
+        length = MIN_MATCH
+        while position + length < end_limit and data[candidate + length] == data[position + length]:
+            length += 1
+
+        write_sequence(output, data[anchor:position], length, position - candidate)
+
+        # Remember positions inside of the match for better ratio
+        for inner in range(position + 1, min(position + length, match_limit)):
+            table[data[inner:inner + MIN_MATCH]] = inner
+
+        position += length
+        anchor = position
+
+    write_sequence(output, data[anchor:], 0, 0)
+    return output
+
+
+def decompress(data, size):
+    """Reference decompressor, used to verify output."""
+    output = bytearray()
+    position = 0
+
+    while len(output) < size:
+        token = data[position]
+        position += 1
+        length = token >> 4
+
+        if length == 15:
+            while True:
+                extra = data[position]
+                position += 1
+                length += extra
+                if extra != 255:
+                    break
+
+        output += data[position:position + length]
+        position += length
+
+        if len(output) >= size:
+            break
+
+        offset = data[position] | (data[position + 1] << 8)
+        position += 2
+        length = token & 0x0f
+
+        if length == 15:
+            while True:
+                extra = data[position]
+                position += 1
+                length += extra
+                if extra != 255:
+                    break
+
+        length += MIN_MATCH
+        start = len(output) - offset
+
+        for index in range(length):
+            output.append(output[start + index])
+
+    return bytes(output)
+
+
+def align(data, alignment):
+    """Pad data with zeroes to alignment."""
+    return data + bytes((alignment - (len(data) % alignment)) % alignment)
+
+
+def sectors(size):
+    return (size + SECTOR_SIZE - 1) // SECTOR_SIZE
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compress main binary and prepend self-decompressing boot stub.")
+    parser.add_argument("stub", help="Boot stub binary")
+    parser.add_argument("binary", help="Main binary to compress")
+    parser.add_argument("output", help="Output binary (stub + compressed main binary)")
+    args = parser.parse_args()
+
+    with open(args.stub, "rb") as file:
+        stub = bytearray(align(file.read(), 4))
+
+    with open(args.binary, "rb") as file:
+        binary = file.read()
+
+    payload = bytes(compress(binary))
+
+    if decompress(payload, len(binary)) != binary:
+        raise SystemExit("Compression verification failed")
+
+    payload = align(payload, 4)
+    struct.pack_into(">I", stub, HEADER_IMAGE_SIZE, len(stub) + len(payload))
+    struct.pack_into(">I", stub, HEADER_UNCOMPRESSED_SIZE, len(binary))
+
+    with open(args.output, "wb") as file:
+        file.write(stub)
+        file.write(payload)
+
+    before = len(binary)
+    after = len(stub) + len(payload)
+
+    # Estimate only: nominal CD transfer rate and assumed decompression speed, seek time and BIOS overhead are not included
+    decompress_time = before * 1000 / SH2_DECOMPRESS_SPEED
+
+    print("****** Compressed binary ******")
+    print(f"Uncompressed : {before} bytes ({sectors(before)} sectors)")
+    print(f"Compressed   : {after} bytes ({sectors(after)} sectors, stub {len(stub)} bytes)")
+    print(f"Ratio        : {after * 100 / max(before, 1):.1f}%")
+    print(f"Disc read    : {before} -> {after} bytes")
+    print("Estimated time to main, not measured on hardware:")
+    print(f"  2x CD speed : ~{before * 1000 / CD_SPEED_2X:.0f} ms -> ~{after * 1000 / CD_SPEED_2X + decompress_time:.0f} ms")
+    print(f"  1x CD speed : ~{before * 1000 / CD_SPEED_1X:.0f} ms -> ~{after * 1000 / CD_SPEED_1X + decompress_time:.0f} ms")
+    print(f"  Includes ~{decompress_time:.0f} ms of decompression at assumed {SH2_DECOMPRESS_SPEED // 1024} KB/s")
+    print("*******************************")
+
+
+if __name__ == "__main__":
+    main()
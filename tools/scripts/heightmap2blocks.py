@@ -0,0 +1,91 @@
+import argparse
+import struct
+
+# Heightmap file layout (see saturnringlib/srl_terrain.hpp)
+SECTOR_SIZE = 2048
+BLOCK_SIZE = 64
+MAGIC = b"HMAP"
+
+
+def read_pgm(path):
+    """Read binary 8-bit PGM (P5) image, returns (width, height, samples)."""
+    with open(path, "rb") as file:
+        data = file.read()
+
+    fields = []
+    position = 0
+
+    # Magic, width, height and maximal value separated by whitespace, comments start with #
+    while len(fields) < 4:
+        while data[position:position + 1].isspace():
+            position += 1
+
+        if data[position:position + 1] == b"#":
+            while data[position:position + 1] not in (b"\n", b""):
+                position += 1
+            continue
+
+        start = position
+
+        while not data[position:position + 1].isspace():
+            position += 1
+
+        fields.append(data[start:position])
+
+    if fields[0] != b"P5" or int(fields[3]) > 255:
+        raise ValueError("Only binary 8-bit PGM images are supported")
+
+    width = int(fields[1])
+    height = int(fields[2])
+    position += 1
+    return width, height, data[position:position + (width * height)]
+
+
+def convert(width, height, samples):
+    """Reorder samples into header sector followed by 64x64 blocks in row order."""
+    if width % BLOCK_SIZE != 0 or height % BLOCK_SIZE != 0:
+        raise ValueError("Heightmap size {0}x{1} is not multiple of {2}".format(width, height, BLOCK_SIZE))
+
+    output = bytearray(MAGIC + struct.pack(">HH", width, height))
+    output += bytes(SECTOR_SIZE - len(output))
+
+    for block_y in range(height // BLOCK_SIZE):
+        for block_x in range(width // BLOCK_SIZE):
+            for row in range(BLOCK_SIZE):
+                start = (((block_y * BLOCK_SIZE) + row) * width) + (block_x * BLOCK_SIZE)
+                output += samples[start:start + BLOCK_SIZE]
+
+    return output
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert 8-bit heightmap into block file streamed by SRL::Terrain")
+    parser.add_argument("input", help="Binary PGM image or raw 8-bit samples")
+    parser.add_argument("output", help="Output heightmap file")
+    parser.add_argument("--width", type=int, help="Width of raw input")
+    parser.add_argument("--height", type=int, help="Height of raw input")
+    arguments = parser.parse_args()
+
+    if arguments.width is not None and arguments.height is not None:
+        with open(arguments.input, "rb") as file:
+            samples = file.read()
+
+        width = arguments.width
+        height = arguments.height
+    else:
+        width, height, samples = read_pgm(arguments.input)
+
+    if len(samples) < width * height:
+        raise ValueError("Input has {0} samples, {1} expected".format(len(samples), width * height))
+
+    output = convert(width, height, samples)
+
+    with open(arguments.output, "wb") as file:
+        file.write(output)
+
+    print("{0}x{1} samples, {2} blocks, {3} bytes".format(
+        width, height, (width // BLOCK_SIZE) * (height // BLOCK_SIZE), len(output)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,184 @@
+import argparse
+import re
+
+# Memory regions of the Saturn CPU address space (start, end, name)
+REGIONS = [
+    (0x00200000, 0x00300000, "LWRam"),
+    (0x06000000, 0x08000000, "HWRam"),
+    (0xC0000000, 0xC0000800, "Cache"),
+]
+
+# Output sections that only describe layout and do not hold anything
+IGNORED_SECTIONS = {"WORK_AREA_DUMMY", "HEAP"}
+
+# Input sections placed by SRL_HOT and SRL_COLD / SRL_LWRAM_DATA
+HOT_PREFIX = ".text.hot"
+LWRAM_PREFIX = ".lwram."
+
+# Number of largest HWRam input sections listed as candidates for LWRam
+CANDIDATE_COUNT = 20
+
+OUTPUT_SECTION = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?")
+INPUT_SECTION = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$")
+WRAPPED_VALUES = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.+))?$")
+SYMBOL = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([^\s=]+)\s*$")
+
+
+class Section:
+    """Output section or input section of the map file."""
+
+    def __init__(self, name, address, size, source=""):
+        self.name = name
+        self.address = address
+        self.size = size
+        self.source = source
+        self.inputs = []
+        self.symbols = []
+
+
+def get_region(section):
+    """Name of the memory region section is linked to."""
+    if section.name.startswith("OVL_"):
+        return "Overlay"
+
+    for start, end, name in REGIONS:
+        if start <= section.address < end:
+            return name
+
+    return "Other"
+
+
+def parse(path):
+    """Read output sections with their input sections and symbols from GNU ld map file."""
+    with open(path, "r", errors="replace") as file:
+        lines = file.read().splitlines()
+
+    sections = []
+    current = None
+    last_input = None
+    pending = None
+    started = False
+
+    for line in lines:
+        if not started:
+            started = line.startswith("Linker script and memory map")
+            continue
+
+        if line.startswith("OUTPUT("):
+            break
+
+        # Long section names are followed by their address and size on the next line
+        if pending is not None:
+            values = WRAPPED_VALUES.match(line)
+            name, is_input = pending
+            pending = None
+
+            if values:
+                section = Section(name, int(values.group(1), 16), int(values.group(2), 16), values.group(3) or "")
+
+                if is_input and current is not None:
+                    current.inputs.append(section)
+                    last_input = section
+                elif not is_input:
+                    current = section
+                    last_input = None
+                    sections.append(current)
+
+                continue
+
+        if line and not line[0].isspace():
+            match = OUTPUT_SECTION.match(line)
+
+            if match:
+                current = Section(match.group(1), int(match.group(2), 16), int(match.group(3), 16))
+                last_input = None
+                sections.append(current)
+            elif " " not in line.strip():
+                pending = (line.strip(), False)
+
+            continue
+
+        if current is None or line.startswith(" *"):
+            continue
+
+        match = INPUT_SECTION.match(line)
+
+        if match:
+            last_input = Section(match.group(1), int(match.group(2), 16), int(match.group(3), 16), match.group(4).strip())
+            current.inputs.append(last_input)
+            continue
+
+        if line.startswith(" .") and " " not in line.strip():
+            pending = (line.strip(), True)
+            continue
+
+        match = SYMBOL.match(line)
+
+        if match and last_input is not None:
+            last_input.symbols.append(match.group(2))
+
+    return [section for section in sections if section.size > 0 and section.name not in IGNORED_SECTIONS]
+
+
+def describe(section):
+    """One line description of input section."""
+    symbols = ", ".join(section.symbols[:4]) + (", ..." if len(section.symbols) > 4 else "")
+    return f"    0x{section.address:08x} {section.size:8d}  {section.name:<24} {section.source}" + (f"  [{symbols}]" if symbols else "")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report what code and data ended up in which memory region.")
+    parser.add_argument("map", help="Linker map file")
+    parser.add_argument("output", nargs="?", help="Detailed report file")
+    args = parser.parse_args()
+
+    sections = parse(args.map)
+    totals = {}
+
+    for section in sections:
+        region = get_region(section)
+        totals[region] = totals.get(region, 0) + section.size
+
+    inputs = [(section, item) for section in sections for item in section.inputs if item.size > 0]
+    hot = [item for section, item in inputs if item.name.startswith(HOT_PREFIX)]
+    lwram = [item for section, item in inputs if item.name.startswith(LWRAM_PREFIX)]
+    candidates = sorted(
+        (item for section, item in inputs
+         if get_region(section) == "HWRam" and section.name not in (".bss", "COMMON", "WORK_AREA") and not item.name.startswith(HOT_PREFIX)),
+        key=lambda item: item.size,
+        reverse=True)[:CANDIDATE_COUNT]
+
+    print("****** Memory placement ******")
+    print(f"{'Section':<16} {'Region':<8} {'Address':<10} {'Size':>8}")
+
+    for section in sections:
+        print(f"{section.name:<16} {get_region(section):<8} 0x{section.address:08x} {section.size:8d}")
+
+    print("")
+
+    for region in sorted(totals):
+        print(f"{region:<15} : {totals[region]} bytes")
+
+    print(f"Hot code        : {sum(item.size for item in hot)} bytes in {len(hot)} section(s)")
+    print(f"Linked to LWRam : {sum(item.size for item in lwram)} bytes in {len(lwram)} section(s), rest of LWRam is heap")
+    print("******************************")
+
+    if args.output:
+        with open(args.output, "w") as file:
+            for section in sections:
+                file.write(f"{section.name} ({get_region(section)}) 0x{section.address:08x} {section.size} bytes\n")
+
+                for item in sorted(section.inputs, key=lambda item: item.size, reverse=True):
+                    if item.size > 0:
+                        file.write(describe(item) + "\n")
+
+                file.write("\n")
+
+            file.write("Largest HWRam code and data (candidates for SRL_COLD / SRL_LWRAM_DATA)\n")
+
+            for item in candidates:
+                file.write(describe(item) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,474 @@
+import argparse
+import math
+import os
+import struct
+
+# Model file layout (see ModelObject in "Samples/VDP1 - 3D - Smooth teapot/src/modelObject.hpp")
+# Header: type (0 = flat PDATA, 1 = smooth XPDATA), mesh count, texture count
+# Mesh: point count, polygon count, points, polygons, attributes, vertex normals (smooth only)
+# Texture: width, height, RGB1555 pixels
+# Everything is big endian, coordinates are 16.16 fixed point
+HEADER = struct.Struct(">III")
+MESH_HEADER = struct.Struct(">II")
+POINT = struct.Struct(">iii")
+POLYGON = struct.Struct(">iiiHHHH")
+ATTRIBUTE = struct.Struct(">BBHi")
+TEXTURE_HEADER = struct.Struct(">HH")
+
+FIXED_ONE = 65536
+
+# First attribute byte (bit fields are allocated from the highest bit)
+HAS_TEXTURE = 0x80
+HAS_FLAT_SHADING = 0x08
+
+
+class Mesh:
+    """Mesh with 16.16 fixed point points, faces of 3 or 4 point indices and one attribute per face."""
+
+    def __init__(self, points=None, faces=None, attributes=None):
+        self.points = points if points is not None else []
+        self.faces = faces if faces is not None else []
+        self.attributes = attributes if attributes is not None else []
+
+    def count_triangles(self):
+        return sum(1 for face in self.faces if len(face) == 3)
+
+
+def to_fixed(value):
+    return int(round(value * FIXED_ONE))
+
+
+def color_to_rgb555(red, green, blue):
+    """Convert color with components in 0-1 range to opaque ABGR1555 value."""
+    channels = [max(0, min(31, int(round(component * 31.0)))) for component in (red, green, blue)]
+    return 0x8000 | (channels[2] << 10) | (channels[1] << 5) | channels[0]
+
+
+def read_materials(path):
+    """Read diffuse colors from OBJ material library, returns name -> color."""
+    materials = {}
+    name = None
+
+    if not os.path.exists(path):
+        print("Warning: material library {0} not found, default color is used".format(path))
+        return materials
+
+    with open(path, "r") as file:
+        for line in file:
+            fields = line.split()
+
+            if not fields:
+                continue
+
+            if fields[0] == "newmtl":
+                name = " ".join(fields[1:])
+                materials[name] = 0xffff
+            elif fields[0] == "Kd" and name is not None:
+                materials[name] = color_to_rgb555(*[float(value) for value in fields[1:4]])
+            elif fields[0] == "map_Kd" and name is not None:
+                print("Warning: texture of material {0} is not supported, diffuse color is used".format(name))
+
+    return materials
+
+
+def read_obj(path, scale, smooth):
+    """Read Wavefront OBJ, each object (o) becomes one mesh.
+    Y and Z axes are flipped, Saturn Y axis points down."""
+    meshes = []
+    vertices = []
+    materials = {}
+    color = 0xffff
+    mesh = None
+    remap = {}
+    flags = 0 if smooth else HAS_FLAT_SHADING
+
+    with open(path, "r") as file:
+        for line in file:
+            fields = line.split()
+
+            if not fields:
+                continue
+
+            if fields[0] == "v":
+                x, y, z = [float(value) * scale for value in fields[1:4]]
+                vertices.append((to_fixed(x), to_fixed(-y), to_fixed(-z)))
+            elif fields[0] == "mtllib":
+                materials.update(read_materials(os.path.join(os.path.dirname(path), " ".join(fields[1:]))))
+            elif fields[0] == "usemtl":
+                color = materials.get(" ".join(fields[1:]), 0xffff)
+            elif fields[0] == "o":
+                mesh = None
+            elif fields[0] == "f":
+                if mesh is None:
+                    mesh = Mesh()
+                    meshes.append(mesh)
+                    remap = {}
+
+                indices = []
+
+                for corner in fields[1:]:
+                    index = int(corner.split("/")[0])
+                    index = index - 1 if index > 0 else len(vertices) + index
+
+                    # Each mesh gets only points it uses
+                    if index not in remap:
+                        remap[index] = len(mesh.points)
+                        mesh.points.append(vertices[index])
+
+                    indices.append(remap[index])
+
+                # Larger polygons are split into a fan, triangles are merged back into quads later
+                if len(indices) == 4:
+                    mesh.faces.append(indices)
+                    mesh.attributes.append((flags, 0, color, 0))
+                else:
+                    for corner in range(1, len(indices) - 1):
+                        mesh.faces.append([indices[0], indices[corner], indices[corner + 1]])
+                        mesh.attributes.append((flags, 0, color, 0))
+
+    return (1 if smooth else 0), meshes, []
+
+
+def read_nya(path):
+    """Read model file, returns (type, meshes, textures)."""
+    with open(path, "rb") as file:
+        data = file.read()
+
+    mesh_type, mesh_count, texture_count = HEADER.unpack_from(data, 0)
+    position = HEADER.size
+    meshes = []
+
+    for _ in range(mesh_count):
+        point_count, polygon_count = MESH_HEADER.unpack_from(data, position)
+        position += MESH_HEADER.size
+        mesh = Mesh()
+
+        for point in range(point_count):
+            mesh.points.append(POINT.unpack_from(data, position + (point * POINT.size)))
+
+        position += point_count * POINT.size
+
+        for polygon in range(polygon_count):
+            indices = list(POLYGON.unpack_from(data, position + (polygon * POLYGON.size))[3:])
+
+            # Triangles repeat their last point
+            if indices[3] == indices[2]:
+                indices.pop()
+
+            mesh.faces.append(indices)
+
+        position += polygon_count * POLYGON.size
+
+        for polygon in range(polygon_count):
+            mesh.attributes.append(ATTRIBUTE.unpack_from(data, position + (polygon * ATTRIBUTE.size)))
+
+        position += polygon_count * ATTRIBUTE.size
+
+        # Normals are computed again
+        if mesh_type == 1:
+            position += point_count * POINT.size
+
+        meshes.append(mesh)
+
+    # Textures are copied as they are
+    textures = []
+
+    for _ in range(texture_count):
+        width, height = TEXTURE_HEADER.unpack_from(data, position)
+        size = TEXTURE_HEADER.size + (width * height * 2)
+        textures.append(data[position:position + size])
+        position += size
+
+    return mesh_type, meshes, textures
+
+
+def weld(mesh, tolerance):
+    """Merge points closer than tolerance (fixed point units on each axis), drop faces that collapsed."""
+    cell_size = max(1, tolerance)
+    cells = {}
+    remap = []
+    points = []
+
+    for point in mesh.points:
+        cell = tuple(coordinate // cell_size for coordinate in point)
+        found = None
+
+        # Look into neighbouring cells too, close points can fall on both sides of a cell border
+        for dx in (-1, 0, 1):
+            for dy in (-1, 0, 1):
+                for dz in (-1, 0, 1):
+                    for candidate in cells.get((cell[0] + dx, cell[1] + dy, cell[2] + dz), []):
+                        other = points[candidate]
+
+                        if max(abs(other[axis] - point[axis]) for axis in range(3)) <= tolerance:
+                            found = candidate
+                            break
+
+                    if found is not None:
+                        break
+
+                if found is not None:
+                    break
+
+            if found is not None:
+                break
+
+        if found is None:
+            found = len(points)
+            points.append(point)
+            cells.setdefault(cell, []).append(found)
+
+        remap.append(found)
+
+    faces = []
+    attributes = []
+
+    for face, attribute in zip(mesh.faces, mesh.attributes):
+        indices = []
+
+        for index in face:
+            if remap[index] not in indices:
+                indices.append(remap[index])
+
+        if len(indices) >= 3:
+            faces.append(indices)
+            attributes.append(attribute)
+
+    return Mesh(points, faces, attributes)
+
+
+def subtract(a, b):
+    return (a[0] - b[0], a[1] - b[1], a[2] - b[2])
+
+
+def cross(a, b):
+    return ((a[1] * b[2]) - (a[2] * b[1]), (a[2] * b[0]) - (a[0] * b[2]), (a[0] * b[1]) - (a[1] * b[0]))
+
+
+def dot(a, b):
+    return (a[0] * b[0]) + (a[1] * b[1]) + (a[2] * b[2])
+
+
+def normalize(vector):
+    length = math.sqrt(dot(vector, vector))
+
+    if length == 0.0:
+        return (0.0, 0.0, 0.0)
+
+    return (vector[0] / length, vector[1] / length, vector[2] / length)
+
+
+def face_normal(points, face):
+    """Newell normal of a polygon, its length is twice the polygon area."""
+    normal = [0.0, 0.0, 0.0]
+
+    for corner in range(len(face)):
+        a = points[face[corner]]
+        b = points[face[(corner + 1) % len(face)]]
+        normal[0] += float(a[1] - b[1]) * float(a[2] + b[2])
+        normal[1] += float(a[2] - b[2]) * float(a[0] + b[0])
+        normal[2] += float(a[0] - b[0]) * float(a[1] + b[1])
+
+    return tuple(normal)
+
+
+def is_convex(points, quad, normal):
+    """Check that quad turns the same way at each corner."""
+    for corner in range(4):
+        a = points[quad[corner]]
+        b = points[quad[(corner + 1) % 4]]
+        c = points[quad[(corner + 2) % 4]]
+
+        if dot(cross(subtract(b, a), subtract(c, b)), normal) <= 0:
+            return False
+
+    return True
+
+
+def merge_quads(mesh, max_angle):
+    """Join pairs of neighbouring triangles with same attribute that lie in one plane into convex quads."""
+    threshold = math.cos(math.radians(max_angle))
+    normals = [normalize(face_normal(mesh.points, face)) for face in mesh.faces]
+    edges = {}
+
+    for index, face in enumerate(mesh.faces):
+        if len(face) == 3:
+            for corner in range(3):
+                edges.setdefault((face[corner], face[(corner + 1) % 3]), []).append(index)
+
+    # Collect candidate pairs, flattest pairs are merged first
+    candidates = []
+
+    for (start, end), triangles in edges.items():
+        for first in triangles:
+            for second in edges.get((end, start), []):
+                if first >= second or mesh.attributes[first] != mesh.attributes[second]:
+                    continue
+
+                planarity = dot(normals[first], normals[second])
+
+                if planarity < threshold:
+                    continue
+
+                # Quad goes around both triangles without the shared edge
+                opposite_first = [index for index in mesh.faces[first] if index not in (start, end)][0]
+                opposite_second = [index for index in mesh.faces[second] if index not in (start, end)][0]
+                quad = [end, opposite_first, start, opposite_second]
+
+                if is_convex(mesh.points, quad, normals[first]):
+                    candidates.append((planarity, first, second, quad))
+
+    candidates.sort(key=lambda candidate: (-candidate[0], candidate[1], candidate[2]))
+    merged = {}
+    removed = set()
+
+    for _, first, second, quad in candidates:
+        if first in merged or second in merged or first in removed or second in removed:
+            continue
+
+        merged[first] = quad
+        removed.add(second)
+
+    faces = []
+    attributes = []
+
+    for index, face in enumerate(mesh.faces):
+        if index in removed:
+            continue
+
+        faces.append(merged.get(index, face))
+        attributes.append(mesh.attributes[index])
+
+    return Mesh(mesh.points, faces, attributes)
+
+
+def order_faces(mesh, group):
+    """Group faces with same attribute together (keeping their original order inside the group)
+    and renumber points in order of first use, unused points are dropped."""
+    order = list(range(len(mesh.faces)))
+
+    if group:
+        order.sort(key=lambda index: (mesh.attributes[index][3], mesh.attributes[index][0], mesh.attributes[index][2], mesh.attributes[index][1], index))
+
+    remap = {}
+    points = []
+    faces = []
+    attributes = []
+
+    for index in order:
+        face = []
+
+        for point in mesh.faces[index]:
+            if point not in remap:
+                remap[point] = len(points)
+                points.append(mesh.points[point])
+
+            face.append(remap[point])
+
+        faces.append(face)
+        attributes.append(mesh.attributes[index])
+
+    return Mesh(points, faces, attributes)
+
+
+def count_attribute_switches(mesh):
+    return sum(1 for index in range(1, len(mesh.attributes)) if mesh.attributes[index] != mesh.attributes[index - 1])
+
+
+def compute_normals(mesh):
+    """Get unit face normals and area weighted vertex normals."""
+    face_normals = []
+    vertex_normals = [(0.0, 0.0, 0.0)] * len(mesh.points)
+
+    for face in mesh.faces:
+        normal = face_normal(mesh.points, face)
+        face_normals.append(normalize(normal))
+
+        for point in face:
+            sum_normal = vertex_normals[point]
+            vertex_normals[point] = (sum_normal[0] + normal[0], sum_normal[1] + normal[1], sum_normal[2] + normal[2])
+
+    return face_normals, [normalize(normal) for normal in vertex_normals]
+
+
+def write_nya(path, mesh_type, meshes, textures):
+    output = bytearray(HEADER.pack(mesh_type, len(meshes), len(textures)))
+
+    for mesh in meshes:
+        face_normals, vertex_normals = compute_normals(mesh)
+        output += MESH_HEADER.pack(len(mesh.points), len(mesh.faces))
+
+        for point in mesh.points:
+            output += POINT.pack(*point)
+
+        for face, normal in zip(mesh.faces, face_normals):
+            indices = face + [face[2]] if len(face) == 3 else face
+            output += POLYGON.pack(*([to_fixed(component) for component in normal] + indices))
+
+        for attribute in mesh.attributes:
+            output += ATTRIBUTE.pack(*attribute)
+
+        if mesh_type == 1:
+            for normal in vertex_normals:
+                output += POINT.pack(*[to_fixed(component) for component in normal])
+
+    for texture in textures:
+        output += texture
+
+    with open(path, "wb") as file:
+        file.write(output)
+
+    return len(output)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Optimize mesh and convert it into model file loaded by the samples (.NYA)")
+    parser.add_argument("input", help="Wavefront OBJ or model file (.NYA)")
+    parser.add_argument("output", help="Output model file")
+    parser.add_argument("--scale", type=float, default=1.0, help="Scale of OBJ coordinates")
+    parser.add_argument("--flat", action="store_true", help="Write OBJ as flat shaded mesh without vertex normals")
+    parser.add_argument("--weld", type=float, default=1.0 / 1024.0, help="Largest distance between welded points on each axis")
+    parser.add_argument("--angle", type=float, default=1.0, help="Largest angle in degrees between triangles merged into a quad")
+    parser.add_argument("--keep-order", action="store_true", help="Do not reorder faces by attribute")
+    arguments = parser.parse_args()
+
+    if arguments.input.lower().endswith(".obj"):
+        mesh_type, meshes, textures = read_obj(arguments.input, arguments.scale, not arguments.flat)
+    else:
+        mesh_type, meshes, textures = read_nya(arguments.input)
+
+    if any(len(mesh.points) > 0xffff for mesh in meshes):
+        raise ValueError("Mesh has more than 65535 points")
+
+    totals = [0] * 8
+    optimized = []
+
+    for index, mesh in enumerate(meshes):
+        before = (len(mesh.points), len(mesh.faces), mesh.count_triangles(), count_attribute_switches(mesh))
+        mesh = weld(mesh, to_fixed(arguments.weld))
+        mesh = merge_quads(mesh, arguments.angle)
+        mesh = order_faces(mesh, not arguments.keep_order)
+
+        after = (len(mesh.points), len(mesh.faces), mesh.count_triangles(), count_attribute_switches(mesh))
+        optimized.append(mesh)
+
+        print("Mesh {0}: points {1} -> {2}, polygons {3} -> {4}, triangles {5} -> {6}, attribute changes {7} -> {8}".format(
+            index, before[0], after[0], before[1], after[1], before[2], after[2], before[3], after[3]))
+
+        for value in range(4):
+            totals[value] += before[value]
+            totals[value + 4] += after[value]
+
+    size = write_nya(arguments.output, mesh_type, optimized, textures)
+
+    def reduction(before, after):
+        return 0.0 if before == 0 else 100.0 * (before - after) / before
+
+    print("Total: points {0} -> {1} (-{2:.1f}%), polygons {3} -> {4} (-{5:.1f}%), {6} meshes, {7} textures, {8} bytes".format(
+        totals[0], totals[4], reduction(totals[0], totals[4]),
+        totals[1], totals[5], reduction(totals[1], totals[5]),
+        len(optimized), len(textures), size))
+
+
+if __name__ == "__main__":
+    main()